@@ -49,7 +49,7 @@
 
 #if defined(PTW32_STATIC_LIB)
 
-#if defined(PTW32_CONFIG_MINGW) || defined(_MSC_VER)
+#if defined(PTW32_CONFIG_MINGW) || defined(_MSC_VER) || defined(PTW32_HOST)
 
 /* For an explanation of this code (at least the MSVC parts), refer to
  *
@@ -80,7 +80,10 @@ static int on_process_exit(void)
     return 0;
 }
 
-#if defined(PTW32_CONFIG_MINGW)
+#if defined(PTW32_HOST)
+__attribute__((constructor)) static void host_ctor(void) { (void) on_process_init(); }
+__attribute__((destructor)) static void host_dtor(void) { (void) on_process_exit(); }
+#elif defined(PTW32_CONFIG_MINGW)
 __attribute__((section(".ctors"), used)) static int (*gcc_ctor)(void) = on_process_init;
 __attribute__((section(".dtors"), used)) static int (*gcc_dtor)(void) = on_process_exit;
 #elif defined(_MSC_VER)
@@ -98,7 +101,7 @@ static int (*msc_dtor)(void) = on_process_exit;
 #  endif
 #endif
 
-#endif /* defined(PTW32_CONFIG_MINGW) || defined(_MSC_VER) */
+#endif /* defined(PTW32_CONFIG_MINGW) || defined(_MSC_VER) || defined(PTW32_HOST) */
 
 /* This dummy function exists solely to be referenced by other modules
  * (specifically, in implement.h), so that the linker can't optimize away
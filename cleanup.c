@@ -48,9 +48,57 @@
 /*
  * The functions ptw32_pop_cleanup and ptw32_push_cleanup
  * are implemented here for applications written in C with no
- * SEH or C++ destructor support. 
+ * SEH or C++ destructor support. Since the C versions of
+ * pthread_cleanup_push and pthread_cleanup_pop now link and unlink
+ * handlers inline through ptw32_cleanup_stack, they remain for
+ * applications built against earlier headers.
  */
 
+ptw32_cleanup_t **
+ptw32_cleanup_stack (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns the address of the head of the calling
+      *      thread's stack of cleanup handlers.
+      *
+      * PARAMETERS
+      *      N/A
+      *
+      *
+      * DESCRIPTION
+      *      The stack is kept in the thread's ptw32_thread_t, so
+      *      pushing and popping a handler are pointer operations
+      *      on the returned address. A Win32 thread without a
+      *      POSIX handle is given an implicit one (see
+      *      pthread_self).
+      *
+      * RESULTS
+      *              ptw32_cleanup_t **
+      *                              address of the stack head, or
+      *                              NULL if the thread has no POSIX
+      *                              handle and one couldn't be made
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_getspecific (ptw32_selfThreadKey);
+
+  if (sp == NULL)
+    {
+      sp = (ptw32_thread_t *) pthread_self ().p;
+
+      if (sp == NULL)
+	{
+	  return NULL;
+	}
+    }
+
+  return &sp->cleanupStack;
+
+}				/* ptw32_cleanup_stack */
+
+
 ptw32_cleanup_t *
 ptw32_pop_cleanup (int execute)
      /*
@@ -68,7 +116,8 @@ ptw32_pop_cleanup (int execute)
       * DESCRIPTION
       *      This function pops the most recently pushed cleanup
       *      handler. If execute is nonzero, then the cleanup handler
-      *      is executed if non-null.
+      *      is executed if non-null. The handler is unlinked before
+      *      it runs.
       *      NOTE: specify 'execute' as nonzero to avoid duplication
       *                of common cleanup code.
       *
@@ -78,21 +127,19 @@ ptw32_pop_cleanup (int execute)
       * ------------------------------------------------------
       */
 {
-  ptw32_cleanup_t *cleanup;
+  ptw32_cleanup_t **stack = ptw32_cleanup_stack ();
+  ptw32_cleanup_t *cleanup = NULL;
 
-  cleanup = (ptw32_cleanup_t *) pthread_getspecific (ptw32_cleanupKey);
-
-  if (cleanup != NULL)
+  if (stack != NULL && (cleanup = *stack) != NULL)
     {
+      *stack = cleanup->prev;
+
       if (execute && (cleanup->routine != NULL))
 	{
 
 	  (*cleanup->routine) (cleanup->arg);
 
 	}
-
-      pthread_setspecific (ptw32_cleanupKey, (void *) cleanup->prev);
-
     }
 
   return (cleanup);
@@ -143,11 +190,16 @@ ptw32_push_cleanup (ptw32_cleanup_t * cleanup,
       * ------------------------------------------------------
       */
 {
+  ptw32_cleanup_t **stack = ptw32_cleanup_stack ();
+
   cleanup->routine = routine;
   cleanup->arg = arg;
+  cleanup->prev = NULL;
 
-  cleanup->prev = (ptw32_cleanup_t *) pthread_getspecific (ptw32_cleanupKey);
-
-  pthread_setspecific (ptw32_cleanupKey, (void *) cleanup);
+  if (stack != NULL)
+    {
+      cleanup->prev = *stack;
+      *stack = cleanup;
+    }
 
 }				/* ptw32_push_cleanup */
@@ -0,0 +1,111 @@
+/*
+ * clock_nanosleep.c
+ *
+ * Description:
+ * This translation unit implements POSIX sleep primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+clock_nanosleep (clockid_t clock_id, int flags,
+                 const struct timespec * rqtp, struct timespec * rmtp)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Suspends the calling thread for an interval or until
+      *      a time.
+      *
+      * PARAMETERS
+      *      clock_id
+      *              CLOCK_REALTIME or CLOCK_MONOTONIC
+      *
+      *      flags
+      *              0 or TIMER_ABSTIME
+      *
+      *      rqtp
+      *              the interval, or the time if 'flags' is
+      *              TIMER_ABSTIME
+      *
+      *      rmtp
+      *              not used: the sleep can't be interrupted
+      *
+      * DESCRIPTION
+      *      This function suspends the calling thread for at least
+      *      the interval 'rqtp', or until 'clock_id' reads at least
+      *      'rqtp' if 'flags' is TIMER_ABSTIME, as nanosleep()
+      *      does. An absolute CLOCK_REALTIME time is converted to
+      *      the monotonic clock on entry, so the sleep doesn't
+      *      follow later changes to the system time.
+      *
+      *      This function is a cancellation point.
+      *
+      * RESULTS
+      *              0               slept until due,
+      *              EINVAL          an argument is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONGLONG deadline;
+
+  if ((clock_id != CLOCK_REALTIME && clock_id != CLOCK_MONOTONIC)
+      || rqtp == NULL
+      || rqtp->tv_sec < 0
+      || rqtp->tv_nsec < 0
+      || rqtp->tv_nsec >= 1000000000)
+    {
+      return EINVAL;
+    }
+
+  pthread_testcancel ();
+
+  deadline = ptw32_timespec_to_ns (rqtp);
+
+  if (!(flags & TIMER_ABSTIME))
+    {
+      deadline += ptw32_clock_ns (CLOCK_MONOTONIC);
+    }
+  else if (clock_id == CLOCK_REALTIME)
+    {
+      deadline += ptw32_clock_ns (CLOCK_MONOTONIC) - ptw32_clock_ns (CLOCK_REALTIME);
+    }
+
+  return ptw32_delay (deadline, ptw32_delay_mode == PTHREAD_DELAY_PRECISE_NP);
+}				/* clock_nanosleep */
@@ -11,10 +11,12 @@ DLL_OBJS	= \
 STATIC_OBJS	= \
 		autostatic.$(OBJEXT) \
 		cleanup.$(OBJEXT) \
+		clock_nanosleep.$(OBJEXT) \
 		create.$(OBJEXT) \
 		dll.$(OBJEXT) \
 		errno.$(OBJEXT) \
 		global.$(OBJEXT) \
+		nanosleep.$(OBJEXT) \
 		pthread_attr_destroy.$(OBJEXT) \
 		pthread_attr_getaffinity_np.$(OBJEXT) \
 		pthread_attr_getdetachstate.$(OBJEXT) \
@@ -40,6 +42,32 @@ STATIC_OBJS	= \
 		pthread_barrier_wait.$(OBJEXT) \
 		pthread_barrierattr_destroy.$(OBJEXT) \
 		pthread_barrierattr_getpshared.$(OBJEXT) \
+		pthread_combiner_init_np.$(OBJEXT) \
+		pthread_combiner_destroy_np.$(OBJEXT) \
+		pthread_combiner_execute_np.$(OBJEXT) \
+		pthread_seqlock_init_np.$(OBJEXT) \
+		pthread_seqlock_destroy_np.$(OBJEXT) \
+		pthread_seqlock_read_begin_np.$(OBJEXT) \
+		pthread_seqlock_read_retry_np.$(OBJEXT) \
+		pthread_seqlock_write_lock_np.$(OBJEXT) \
+		pthread_seqlock_write_unlock_np.$(OBJEXT) \
+		pthread_eventcount_init_np.$(OBJEXT) \
+		pthread_eventcount_destroy_np.$(OBJEXT) \
+		pthread_eventcount_prepare_wait_np.$(OBJEXT) \
+		pthread_eventcount_commit_wait_np.$(OBJEXT) \
+		pthread_eventcount_cancel_wait_np.$(OBJEXT) \
+		pthread_eventcount_notify_np.$(OBJEXT) \
+		pthread_latch_init_np.$(OBJEXT) \
+		pthread_latch_destroy_np.$(OBJEXT) \
+		pthread_latch_count_down_np.$(OBJEXT) \
+		pthread_latch_wait_np.$(OBJEXT) \
+		pthread_latch_try_wait_np.$(OBJEXT) \
+		pthread_pool_init_np.$(OBJEXT) \
+		pthread_pool_destroy_np.$(OBJEXT) \
+		pthread_pool_submit_np.$(OBJEXT) \
+		pthread_pool_submit_batch_np.$(OBJEXT) \
+		pthread_pool_wait_idle_np.$(OBJEXT) \
+		pthread_parallel_for_np.$(OBJEXT) \
 		pthread_barrierattr_init.$(OBJEXT) \
 		pthread_barrierattr_setpshared.$(OBJEXT) \
 		pthread_cancel.$(OBJEXT) \
@@ -52,6 +80,8 @@ STATIC_OBJS	= \
 		pthread_condattr_init.$(OBJEXT) \
 		pthread_condattr_setpshared.$(OBJEXT) \
 		pthread_delay_np.$(OBJEXT) \
+		pthread_setdelaymode_np.$(OBJEXT) \
+		pthread_getdelaymode_np.$(OBJEXT) \
 		pthread_detach.$(OBJEXT) \
 		pthread_equal.$(OBJEXT) \
 		pthread_exit.$(OBJEXT) \
@@ -67,6 +97,7 @@ STATIC_OBJS	= \
 		pthread_key_create.$(OBJEXT) \
 		pthread_key_delete.$(OBJEXT) \
 		pthread_kill.$(OBJEXT) \
+		pthread_lockprof_np.$(OBJEXT) \
 		pthread_mutex_consistent.$(OBJEXT) \
 		pthread_mutex_destroy.$(OBJEXT) \
 		pthread_mutex_init.$(OBJEXT) \
@@ -85,6 +116,8 @@ STATIC_OBJS	= \
 		pthread_mutexattr_setrobust.$(OBJEXT) \
 		pthread_mutexattr_settype.$(OBJEXT) \
 		pthread_num_processors_np.$(OBJEXT) \
+		pthread_wait_on_address_np.$(OBJEXT) \
+		pthread_wake_address_np.$(OBJEXT) \
 		pthread_once.$(OBJEXT) \
 		pthread_rwlock_destroy.$(OBJEXT) \
 		pthread_rwlock_init.$(OBJEXT) \
@@ -95,10 +128,14 @@ STATIC_OBJS	= \
 		pthread_rwlock_trywrlock.$(OBJEXT) \
 		pthread_rwlock_unlock.$(OBJEXT) \
 		pthread_rwlock_wrlock.$(OBJEXT) \
+		pthread_rwlock_upgrade_np.$(OBJEXT) \
+		pthread_rwlock_downgrade_np.$(OBJEXT) \
 		pthread_rwlockattr_destroy.$(OBJEXT) \
 		pthread_rwlockattr_getpshared.$(OBJEXT) \
 		pthread_rwlockattr_init.$(OBJEXT) \
 		pthread_rwlockattr_setpshared.$(OBJEXT) \
+		pthread_rwlockattr_setkind_np.$(OBJEXT) \
+		pthread_rwlockattr_getkind_np.$(OBJEXT) \
 		pthread_self.$(OBJEXT) \
 		pthread_setaffinity.$(OBJEXT) \
 		pthread_setcancelstate.$(OBJEXT) \
@@ -120,14 +157,28 @@ STATIC_OBJS	= \
 		ptw32_calloc.$(OBJEXT) \
 		ptw32_cond_check_need_init.$(OBJEXT) \
 		ptw32_getprocessors.$(OBJEXT) \
+		ptw32_cpugroups.$(OBJEXT) \
+		ptw32_lazy_handle.$(OBJEXT) \
 		ptw32_is_attr.$(OBJEXT) \
+		ptw32_lockprof.$(OBJEXT) \
 		ptw32_mutex_check_need_init.$(OBJEXT) \
+		ptw32_mutex_bias.$(OBJEXT) \
+		ptw32_mutex_fair.$(OBJEXT) \
 		ptw32_new.$(OBJEXT) \
+		ptw32_park.$(OBJEXT) \
+		ptw32_eventcount.$(OBJEXT) \
+		ptw32_pool.$(OBJEXT) \
+		ptw32_parallel.$(OBJEXT) \
+		ptw32_clock.$(OBJEXT) \
+		ptw32_timer.$(OBJEXT) \
+		ptw32_delay.$(OBJEXT) \
 		ptw32_processInitialize.$(OBJEXT) \
 		ptw32_processTerminate.$(OBJEXT) \
 		ptw32_relmillisecs.$(OBJEXT) \
 		ptw32_reuse.$(OBJEXT) \
 		ptw32_rwlock_cancelwrwait.$(OBJEXT) \
+		ptw32_rwlock_bigreader.$(OBJEXT) \
+		ptw32_rwlock_prefer.$(OBJEXT) \
 		ptw32_rwlock_check_need_init.$(OBJEXT) \
 		ptw32_semwait.$(OBJEXT) \
 		ptw32_spinlock_check_need_init.$(OBJEXT) \
@@ -155,6 +206,11 @@ STATIC_OBJS	= \
 		sem_unlink.$(OBJEXT) \
 		sem_wait.$(OBJEXT) \
 		signal.$(OBJEXT) \
+		timer_create.$(OBJEXT) \
+		timer_delete.$(OBJEXT) \
+		timer_getoverrun.$(OBJEXT) \
+		timer_gettime.$(OBJEXT) \
+		timer_settime.$(OBJEXT) \
 		w32_CancelableWait.$(OBJEXT)
 
 PTHREAD_SRCS	= \
@@ -171,14 +227,28 @@ PTHREAD_SRCS	= \
 		ptw32_timespec.c \
 		ptw32_throw.c \
 		ptw32_getprocessors.c \
+		ptw32_cpugroups.c \
+		ptw32_lazy_handle.c \
+		ptw32_lockprof.c \
 		ptw32_calloc.c \
 		ptw32_new.c \
+		ptw32_park.c \
+		ptw32_eventcount.c \
+		ptw32_pool.c \
+		ptw32_parallel.c \
+		ptw32_clock.c \
+		ptw32_timer.c \
+		ptw32_delay.c \
 		ptw32_reuse.c \
 		ptw32_relmillisecs.c \
 		ptw32_cond_check_need_init.c \
 		ptw32_mutex_check_need_init.c \
+		ptw32_mutex_bias.c \
+		ptw32_mutex_fair.c \
 		ptw32_rwlock_check_need_init.c \
 		ptw32_rwlock_cancelwrwait.c \
+		ptw32_rwlock_bigreader.c \
+		ptw32_rwlock_prefer.c \
 		ptw32_spinlock_check_need_init.c \
 		pthread_attr_init.c \
 		pthread_attr_destroy.c \
@@ -201,6 +271,32 @@ PTHREAD_SRCS	= \
 		pthread_barrierattr_destroy.c \
 		pthread_barrierattr_setpshared.c \
 		pthread_barrierattr_getpshared.c \
+		pthread_combiner_init_np.c \
+		pthread_combiner_destroy_np.c \
+		pthread_combiner_execute_np.c \
+		pthread_seqlock_init_np.c \
+		pthread_seqlock_destroy_np.c \
+		pthread_seqlock_read_begin_np.c \
+		pthread_seqlock_read_retry_np.c \
+		pthread_seqlock_write_lock_np.c \
+		pthread_seqlock_write_unlock_np.c \
+		pthread_eventcount_init_np.c \
+		pthread_eventcount_destroy_np.c \
+		pthread_eventcount_prepare_wait_np.c \
+		pthread_eventcount_commit_wait_np.c \
+		pthread_eventcount_cancel_wait_np.c \
+		pthread_eventcount_notify_np.c \
+		pthread_latch_init_np.c \
+		pthread_latch_destroy_np.c \
+		pthread_latch_count_down_np.c \
+		pthread_latch_wait_np.c \
+		pthread_latch_try_wait_np.c \
+		pthread_pool_init_np.c \
+		pthread_pool_destroy_np.c \
+		pthread_pool_submit_np.c \
+		pthread_pool_submit_batch_np.c \
+		pthread_pool_wait_idle_np.c \
+		pthread_parallel_for_np.c \
 		pthread_setcancelstate.c \
 		pthread_setcanceltype.c \
 		pthread_testcancel.c \
@@ -246,9 +342,14 @@ PTHREAD_SRCS	= \
 		pthread_mutexattr_getkind_np.c \
 		pthread_getw32threadhandle_np.c \
 		pthread_getunique_np.c \
+		pthread_lockprof_np.c \
 		pthread_setaffinity.c \
 		pthread_delay_np.c \
+		pthread_setdelaymode_np.c \
+		pthread_getdelaymode_np.c \
 		pthread_num_processors_np.c \
+		pthread_wait_on_address_np.c \
+		pthread_wake_address_np.c \
 		pthread_win32_attach_detach_np.c \
 		pthread_timechange_handler_np.c \
 		pthread_rwlock_init.c \
@@ -257,9 +358,13 @@ PTHREAD_SRCS	= \
 		pthread_rwlockattr_destroy.c \
 		pthread_rwlockattr_getpshared.c \
 		pthread_rwlockattr_setpshared.c \
+		pthread_rwlockattr_setkind_np.c \
+		pthread_rwlockattr_getkind_np.c \
 		pthread_rwlock_rdlock.c \
 		pthread_rwlock_timedrdlock.c \
 		pthread_rwlock_wrlock.c \
+		pthread_rwlock_upgrade_np.c \
+		pthread_rwlock_downgrade_np.c \
 		pthread_rwlock_timedwrlock.c \
 		pthread_rwlock_unlock.c \
 		pthread_rwlock_tryrdlock.c \
@@ -291,6 +396,13 @@ PTHREAD_SRCS	= \
 		sem_open.c \
 		sem_close.c \
 		sem_unlink.c \
+		timer_create.c \
+		timer_delete.c \
+		timer_settime.c \
+		timer_gettime.c \
+		timer_getoverrun.c \
+		nanosleep.c \
+		clock_nanosleep.c \
 		pthread_spin_init.c \
 		pthread_spin_destroy.c \
 		pthread_spin_lock.c \
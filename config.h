@@ -54,12 +54,38 @@
  * __sync_lock_* is implemented in mingw32 gcc 4.5.2 at least
  * so this define does not turn those on or off. If you get an
  * error from __sync_lock* then consider upgrading your gcc.
+ *
+ * With GCC 4.7 or later (or clang) this also selects the __atomic
+ * builtins in place of inline assembler for the library's x86/x64
+ * atomic operations, allowing acquire and release orderings. Other
+ * targets always use the __atomic builtins.
  */
 #undef HAVE_GCC_ATOMIC_BUILTINS
 
 /* Define if you have the timespec struct */
 #undef HAVE_STRUCT_TIMESPEC
 
+/* Define if you have the itimerspec struct */
+#undef HAVE_STRUCT_ITIMERSPEC
+
+/* Define if you have clockid_t */
+#undef HAVE_CLOCKID_T
+
+/* Define if you have timer_t */
+#undef HAVE_TIMER_T
+
+/* Define if you have the sigval union */
+#undef HAVE_UNION_SIGVAL
+
+/* Define if you have the sigevent struct */
+#undef HAVE_STRUCT_SIGEVENT
+
+/* Define if your time.h declares nanosleep() */
+#undef HAVE_NANOSLEEP
+
+/* Define if your time.h declares clock_nanosleep() */
+#undef HAVE_CLOCK_NANOSLEEP
+
 /* Define if you don't have the GetProcessAffinityMask() */
 #undef NEED_PROCESS_AFFINITY_MASK
 
@@ -137,10 +163,17 @@
 #if defined(__MINGW64__)
 #define HAVE_MODE_T
 #define HAVE_STRUCT_TIMESPEC
+#define HAVE_STRUCT_ITIMERSPEC
 #elif defined(__MINGW32__)
 #define HAVE_MODE_T
 #endif
 
+/* A POSIX host build through the platform layer in host/ */
+#if defined(PTW32_HOST)
+#define HAVE_STRUCT_TIMESPEC
+#define HAVE_GCC_ATOMIC_BUILTINS
+#endif
+
 #if defined(__BORLANDC__)
 #endif
 
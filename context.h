@@ -40,6 +40,10 @@
 
 #undef PTW32_PROGCTR
 
+#if defined(PTW32_HOST)
+#define PTW32_PROGCTR(Context)  ((Context).Pc)
+#else
+
 #if defined(_M_IX86) || (defined(_X86_) && !defined(__amd64__))
 #define PTW32_PROGCTR(Context)  ((Context).Eip)
 #endif
@@ -68,6 +72,8 @@
 #define PTW32_PROGCTR(Context)  ((Context).Pc)
 #endif
 
+#endif /* PTW32_HOST */
+
 #if !defined(PTW32_PROGCTR)
 #error Module contains CPU-specific code; modify and recompile.
 #endif
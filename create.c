@@ -148,19 +148,19 @@ pthread_create (pthread_t * tid,
 #endif
 #if defined(HAVE_CPU_AFFINITY)
   tp->cpuset = sp->cpuset;
+  tp->cpuGroup = sp->cpuGroup;
 #endif
 
   if (a != NULL)
     {
 #if defined(HAVE_CPU_AFFINITY)
-      cpu_set_t none;
-      cpu_set_t attr_cpuset;
-      ((_sched_cpu_set_vector_*)&attr_cpuset)->_cpuset = a->cpuset;
+      DWORD_PTR mask;
+      int group = ptw32_cpuset_next_group (sizeof (cpu_set_t), &a->cpuset, &mask);
 
-      CPU_ZERO(&none);
-      if (! CPU_EQUAL(&attr_cpuset, &none))
+      if (group >= 0)
         {
-          tp->cpuset = a->cpuset;
+          tp->cpuset = (size_t) mask;
+          tp->cpuGroup = group;
         }
 #endif
       stackSize = (unsigned int)a->stacksize;
@@ -241,7 +241,7 @@ pthread_create (pthread_t * tid,
 
 #if defined(HAVE_CPU_AFFINITY)
 
-      SetThreadAffinityMask(tp->threadH, tp->cpuset);
+      (void) ptw32_set_thread_affinity (tp->threadH, tp->cpuGroup, (DWORD_PTR) tp->cpuset);
 
 #endif
 
@@ -293,7 +293,7 @@ pthread_create (pthread_t * tid,
 
 #if defined(HAVE_CPU_AFFINITY)
 
-        SetThreadAffinityMask(tp->threadH, tp->cpuset);
+        (void) ptw32_set_thread_affinity (tp->threadH, tp->cpuGroup, (DWORD_PTR) tp->cpuset);
 
 #endif
 
@@ -40,6 +40,7 @@
 # include <config.h>
 #endif
 
+#include <stddef.h>
 #include "pthread.h"
 #include "implement.h"
 
@@ -48,9 +49,8 @@ int ptw32_processInitialized = PTW32_FALSE;
 ptw32_thread_t * ptw32_threadReuseTop = PTW32_THREAD_REUSE_EMPTY;
 ptw32_thread_t * ptw32_threadReuseBottom = PTW32_THREAD_REUSE_EMPTY;
 pthread_key_t ptw32_selfThreadKey = NULL;
-pthread_key_t ptw32_cleanupKey = NULL;
-pthread_cond_t ptw32_cond_list_head = NULL;
-pthread_cond_t ptw32_cond_list_tail = NULL;
+ptw32_cond_shard_t ptw32_cond_shards[PTW32_COND_SHARDS];
+ptw32_wait_bucket_t ptw32_wait_table[PTW32_WAIT_TABLE_SIZE];
 
 int ptw32_concurrency = 0;
 
@@ -69,6 +69,25 @@ unsigned __int64 ptw32_threadSeqNumber = 0;
  */
 DWORD (*ptw32_register_cancellation) (PAPCFUNC, HANDLE, DWORD) = NULL;
 
+/*
+ * Function pointer to GetCurrentProcessorNumber if the system has it
+ * (Vista or later).
+ */
+DWORD (WINAPI *ptw32_get_processor_number) (VOID) = NULL;
+
+/*
+ * The active processor groups, the CPU number of each group's first
+ * processor (with the total after the last), each group's active
+ * processors, and the group functions (Windows 7 or later).
+ * See ptw32_cpugroups.c.
+ */
+int ptw32_cpu_groups = 1;
+int ptw32_cpu_group_first[PTW32_MAX_CPU_GROUPS + 1] = {0, (int) (8 * sizeof (DWORD_PTR))};
+DWORD_PTR ptw32_cpu_group_active[PTW32_MAX_CPU_GROUPS] = {~(DWORD_PTR) 0};
+BOOL (WINAPI *ptw32_get_process_group_affinity) (HANDLE, WORD *, WORD *) = NULL;
+BOOL (WINAPI *ptw32_get_thread_group_affinity) (HANDLE, ptw32_group_affinity_t *) = NULL;
+BOOL (WINAPI *ptw32_set_thread_group_affinity) (HANDLE, const ptw32_group_affinity_t *, ptw32_group_affinity_t *) = NULL;
+
 /*
  * Global lock for managing pthread_t struct reuse.
  */
@@ -98,11 +117,59 @@ ptw32_mcs_lock_t ptw32_rwlock_test_init_lock = 0;
 ptw32_mcs_lock_t ptw32_spinlock_test_init_lock = 0;
 
 /*
- * Global lock for condition variable linked list. The list exists
- * to wake up CVs when a WM_TIMECHANGE message arrives. See
- * w32_TimeChangeHandler.c.
+ * Lock profiler state. See ptw32_lockprof.c.
+ */
+int ptw32_lockprof_enabled = PTW32_FALSE;
+int ptw32_lockprof_sample = 0;
+LONGLONG ptw32_lockprof_frequency = 0;
+ptw32_lockprof_t * ptw32_lockprof_list_head = NULL;
+ptw32_mcs_lock_t ptw32_lockprof_list_lock = 0;
+
+/*
+ * Inline fast paths in pthread.h (PTW32_INLINE_FASTPATH). Non-zero while
+ * applications may take uncontended locks inline; cleared for good once
+ * lock profiling is enabled.
+ */
+int ptw32_fastpath_v1 = PTW32_TRUE;
+
+/*
+ * The inline code sees mutexes and spin locks through the layout views
+ * in pthread.h. Refuse to build if they no longer match implement.h;
+ * see PTW32_FASTPATH_VERSION.
+ */
+typedef char ptw32_fastpath_layout_check[
+  (offsetof (struct pthread_mutex_t_, lock_idx) == offsetof (struct ptw32_mutex_fastpath_t_, lock_idx)
+   && offsetof (struct pthread_mutex_t_, kind) == offsetof (struct ptw32_mutex_fastpath_t_, kind)
+   && sizeof (((struct pthread_mutex_t_ *) 0)->lock_idx) == sizeof (PTW32_FASTPATH_LONG)
+   && offsetof (struct pthread_spinlock_t_, interlock) == offsetof (struct ptw32_spin_fastpath_t_, interlock)
+   && sizeof (((struct pthread_spinlock_t_ *) 0)->interlock) == sizeof (PTW32_FASTPATH_LONG)
+   && PTW32_SPIN_UNLOCKED == PTW32_FASTPATH_SPIN_UNLOCKED
+   && PTW32_SPIN_LOCKED == PTW32_FASTPATH_SPIN_LOCKED) ? 1 : -1];
+
+/*
+ * Performance counter frequency, read on first use. See ptw32_clock.c.
+ */
+LONGLONG ptw32_clock_frequency = 0;
+
+/*
+ * Timer wheel behind timer_create(). See ptw32_timer.c.
+ */
+ptw32_timer_wheel_t ptw32_timer_wheel;
+
+/*
+ * pthread_delay_np() mode, and how long before they are due precise
+ * delays stop sleeping. See ptw32_delay.c.
+ */
+int ptw32_delay_mode = PTHREAD_DELAY_COARSE_NP;
+volatile LONG ptw32_delay_slack = PTW32_DELAY_SLACK_INIT;
+
+/*
+ * Worker team shared by pthread_parallel_for_np() calls, created on
+ * first use. See ptw32_parallel.c.
  */
-ptw32_mcs_lock_t ptw32_cond_list_lock = 0;
+pthread_pool_t ptw32_parallel_team = NULL;
+volatile LONG ptw32_parallel_team_size = -1;
+ptw32_mcs_lock_t ptw32_parallel_team_lock = 0;
 
 #if defined(_UWIN)
 /*
@@ -0,0 +1,269 @@
+/*
+ * hostbench.c
+ *
+ * Description:
+ * Times the common synchronisation operations through nothing but the
+ * POSIX API, so that the same source can be built against this library
+ * on the host and against the C library's own threads (glibc NPTL).
+ * See "make bench-nptl".
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Operations, each timed uncontended (one thread) and contended
+ * (NTHREADS threads sharing one object):
+ * - mutex lock/unlock, spin lock/unlock, rwlock read lock/unlock,
+ *   sem_post/sem_wait and pthread_once.
+ * Then a condition variable ping-pong between two threads, reported
+ * per round trip.
+ */
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <assert.h>
+
+#define ITERATIONS      4000000L
+#define ROUNDTRIPS      100000L
+#define NTHREADS        4
+
+enum {
+  OP_MUTEX,
+  OP_SPIN,
+  OP_RWLOCK,
+  OP_SEM,
+  OP_ONCE,
+  OP_COUNT
+};
+
+static const char * opNames[OP_COUNT] = {
+  "mutex (normal)",
+  "spin lock",
+  "rwlock (read)",
+  "sem_post/wait",
+  "pthread_once"
+};
+
+static pthread_mutex_t mx;
+static pthread_spinlock_t spin;
+static pthread_rwlock_t rwl;
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+static sem_t sema;
+static volatile long shared = 0;
+
+static pthread_mutex_t pingLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pingCV = PTHREAD_COND_INITIALIZER;
+static long turn = 0;
+
+static void
+initRoutine (void)
+{
+  shared++;
+}
+
+static double
+nowNs (void)
+{
+  struct timespec ts;
+
+  (void) timespec_get (&ts, TIME_UTC);
+  return (double) ts.tv_sec * 1E9 + (double) ts.tv_nsec;
+}
+
+static void
+runOp (int op, long n)
+{
+  long i;
+
+  switch (op)
+    {
+    case OP_MUTEX:
+      for (i = 0; i < n; i++)
+        {
+          (void) pthread_mutex_lock (&mx);
+          shared++;
+          (void) pthread_mutex_unlock (&mx);
+        }
+      break;
+    case OP_SPIN:
+      for (i = 0; i < n; i++)
+        {
+          (void) pthread_spin_lock (&spin);
+          shared++;
+          (void) pthread_spin_unlock (&spin);
+        }
+      break;
+    case OP_RWLOCK:
+      for (i = 0; i < n; i++)
+        {
+          (void) pthread_rwlock_rdlock (&rwl);
+          (void) pthread_rwlock_unlock (&rwl);
+        }
+      break;
+    case OP_SEM:
+      for (i = 0; i < n; i++)
+        {
+          (void) sem_post (&sema);
+          (void) sem_wait (&sema);
+        }
+      break;
+    case OP_ONCE:
+      for (i = 0; i < n; i++)
+        {
+          (void) pthread_once (&once, initRoutine);
+        }
+      break;
+    }
+}
+
+static void *
+worker (void * arg)
+{
+  runOp ((int) (size_t) arg, ITERATIONS / NTHREADS);
+
+  return NULL;
+}
+
+static double
+runContended (int op)
+{
+  pthread_t t[NTHREADS];
+  double start;
+  int i;
+
+  start = nowNs ();
+  for (i = 0; i < NTHREADS; i++)
+    {
+      assert (pthread_create (&t[i], NULL, worker, (void *) (size_t) op) == 0);
+    }
+  for (i = 0; i < NTHREADS; i++)
+    {
+      assert (pthread_join (t[i], NULL) == 0);
+    }
+
+  return (nowNs () - start) / ITERATIONS;
+}
+
+static double
+runUncontended (int op)
+{
+  double start;
+
+  start = nowNs ();
+  runOp (op, ITERATIONS);
+
+  return (nowNs () - start) / ITERATIONS;
+}
+
+/*
+ * Each side waits for its turn, then hands the turn over.
+ */
+static void
+pingPong (long me)
+{
+  long i;
+
+  for (i = 0; i < ROUNDTRIPS; i++)
+    {
+      (void) pthread_mutex_lock (&pingLock);
+      while (turn != me)
+        {
+          (void) pthread_cond_wait (&pingCV, &pingLock);
+        }
+      turn = 1 - me;
+      (void) pthread_cond_signal (&pingCV);
+      (void) pthread_mutex_unlock (&pingLock);
+    }
+}
+
+static void *
+ponger (void * arg)
+{
+  pingPong ((long) (size_t) arg);
+
+  return NULL;
+}
+
+static double
+runPingPong (void)
+{
+  pthread_t t;
+  double start;
+
+  start = nowNs ();
+  assert (pthread_create (&t, NULL, ponger, (void *) 1) == 0);
+  pingPong (0);
+  assert (pthread_join (t, NULL) == 0);
+
+  return (nowNs () - start) / ROUNDTRIPS;
+}
+
+
+int
+main (int argc, char * argv[])
+{
+  int op;
+
+  assert (pthread_mutex_init (&mx, NULL) == 0);
+  assert (pthread_spin_init (&spin, PTHREAD_PROCESS_PRIVATE) == 0);
+  assert (pthread_rwlock_init (&rwl, NULL) == 0);
+  assert (sem_init (&sema, 0, 0) == 0);
+
+  /* Warm up: take any lazy initialisation out of the timings. */
+  for (op = 0; op < OP_COUNT; op++)
+    {
+      runOp (op, 1000);
+    }
+
+  printf ("%s: %ld operations, %d threads when contended.\n\n",
+          (argc > 1) ? argv[1] : "Host benchmark", ITERATIONS, NTHREADS);
+  printf ("%-20s %25s %25s\n",
+          "Operation", "uncontended(nsec/op)", "contended(nsec/op)");
+  printf ("-----------------------------------------------------------------------------\n");
+
+  for (op = 0; op < OP_COUNT; op++)
+    {
+      double u = runUncontended (op);
+      double c = runContended (op);
+
+      printf ("%-20s %25.2f %25.2f\n", opNames[op], u, c);
+    }
+
+  printf ("%-20s %25.2f %25s\n", "cond ping-pong", runPingPong (), "(nsec/round trip)");
+  printf ("\n");
+
+  assert (sem_destroy (&sema) == 0);
+  assert (pthread_rwlock_destroy (&rwl) == 0);
+  assert (pthread_spin_destroy (&spin) == 0);
+  assert (pthread_mutex_destroy (&mx) == 0);
+
+  return 0;
+}
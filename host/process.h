@@ -0,0 +1,9 @@
+/*
+ * process.h
+ *
+ * Description:
+ * _beginthreadex() and _endthreadex() come with windows.h in the host
+ * platform layer.
+ */
+
+#include "windows.h"
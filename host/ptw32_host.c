@@ -0,0 +1,1916 @@
+/*
+ * ptw32_host.c
+ *
+ * Description:
+ * The host platform layer: the Win32 subset declared in host/windows.h,
+ * implemented on Linux futexes and C11 threads.
+ *
+ * This file is compiled against the system headers, not the library's,
+ * and links into the same program as the library, whose pthread_*,
+ * sem_*, sched_*, nanosleep and timer_* definitions take the place of
+ * the C library's. So nothing here may call those functions; threads
+ * and thread locals come from <threads.h>, and anything else goes
+ * straight to the kernel.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "windows.h"
+#include "sys/timeb.h"
+
+/*
+ * Objects
+ * -------
+ * Every handle is a host_object_t. Whether an object is signalled is
+ * kept in 'state':
+ *
+ *   event      1 if set
+ *   mutex      the owner's thread id, 0 if free
+ *   semaphore  the count
+ *   thread     1 once the thread has finished
+ *   timer      1 if expired; 'due' holds the next expiry
+ *
+ * Waiting threads link a host_waiter_t into the 'waiters' list of each
+ * object they wait on, then sleep on a futex word that the entries
+ * point to. Anything that may signal an object advances the word of
+ * every linked waiter. The list is protected by a small spin lock; if
+ * it is empty, signalling costs no more than the update of 'state'.
+ */
+
+enum {
+  HOST_EVENT,
+  HOST_MUTEX,
+  HOST_SEMAPHORE,
+  HOST_THREAD,
+  HOST_TIMER
+};
+
+#define HOST_NEVER              LLONG_MAX
+#define HOST_CURRENT_PROCESS    ((HANDLE) (LONG_PTR) -1)
+#define HOST_CURRENT_THREAD     ((HANDLE) (LONG_PTR) -2)
+
+/*
+ * The signal used to suspend threads. glibc keeps the first real time
+ * signals for itself.
+ */
+#define HOST_SIGSUSPEND         (SIGRTMIN + 4)
+
+/*
+ * 'suspend' holds the suspend count, times two, and HOST_STOPPED while
+ * the thread is actually stopped.
+ */
+#define HOST_STOPPED            1
+#define HOST_SUSPEND_ONE        2
+
+/*
+ * Affinity masks cover up to 1024 CPUs, in processor groups of one
+ * DWORD_PTR each.
+ */
+#define HOST_GROUP_BITS         ((int) (8 * sizeof (DWORD_PTR)))
+#define HOST_CPU_WORDS          (1024 / HOST_GROUP_BITS)
+
+typedef struct host_waiter_t_ host_waiter_t;
+typedef struct host_object_t_ host_object_t;
+
+struct host_waiter_t_ {
+  volatile int * word;          /* Shared by all of one wait's entries */
+  host_waiter_t * next;
+  host_waiter_t * prev;
+};
+
+struct host_object_t_ {
+  int kind;
+  int manual;                   /* Manual reset event or timer */
+  volatile long state;
+  long max;                     /* Semaphore maximum count; mutex recursion */
+  volatile LONGLONG due;        /* Timer expiry, monotonic ns */
+  LONGLONG period;              /* Timer period, ns */
+  volatile long refs;
+  volatile int lock;
+  host_waiter_t * waiters;
+
+  /* Threads */
+  unsigned (__stdcall * start) (void *);
+  void * arg;
+  unsigned exitCode;
+  unsigned id;
+  volatile pid_t tid;
+  volatile int started;
+  volatile int suspend;
+  volatile DWORD_PTR redirect;  /* New program counter */
+  DWORD_PTR affinity[HOST_CPU_WORDS]; /* Set before the thread started */
+  int affinitySet;
+  int priority;
+};
+
+static _Thread_local host_object_t * host_self;
+static _Thread_local DWORD host_lastError;
+
+/*
+ * Suspension is deferred while a thread is inside this layer, so that
+ * it is never stopped, or sent elsewhere by SetThreadContext(), part
+ * way through an operation or while holding an object lock.
+ */
+static _Thread_local volatile int host_depth;
+static _Thread_local volatile int host_pending;
+static _Thread_local volatile int * host_waitWord;
+
+static volatile unsigned host_nextId = 0;
+static tss_t host_selfKey;
+static LONGLONG host_epoch;
+
+
+static long
+host_futex_wait (volatile int * word, int value, LONGLONG timeout)
+{
+  struct timespec ts;
+
+  if (timeout < 0)
+    {
+      return syscall (SYS_futex, word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+    }
+
+  ts.tv_sec = (time_t) (timeout / 1000000000LL);
+  ts.tv_nsec = (long) (timeout % 1000000000LL);
+  return syscall (SYS_futex, word, FUTEX_WAIT_PRIVATE, value, &ts, NULL, 0);
+}
+
+static void
+host_futex_wake (volatile int * word, int count)
+{
+  (void) syscall (SYS_futex, word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+static LONGLONG
+host_now (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (LONGLONG) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void
+host_lock (host_object_t * o)
+{
+  while (__atomic_exchange_n (&o->lock, 1, __ATOMIC_ACQUIRE))
+    {
+      while (__atomic_load_n (&o->lock, __ATOMIC_RELAXED))
+        {
+          thrd_yield ();
+        }
+    }
+}
+
+static void
+host_unlock (host_object_t * o)
+{
+  __atomic_store_n (&o->lock, 0, __ATOMIC_RELEASE);
+}
+
+
+/*
+ * Suspension
+ * ----------
+ */
+
+static void
+host_stop (host_object_t * self)
+{
+  int s;
+
+  s = __atomic_or_fetch (&self->suspend, HOST_STOPPED, __ATOMIC_SEQ_CST);
+  host_futex_wake (&self->suspend, INT_MAX);
+
+  for (;;)
+    {
+      if (s >= HOST_SUSPEND_ONE)
+        {
+          (void) host_futex_wait (&self->suspend, s, -1);
+          s = __atomic_load_n (&self->suspend, __ATOMIC_SEQ_CST);
+        }
+      else if (__atomic_compare_exchange_n (&self->suspend, &s, 0, 0,
+                                            __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+        {
+          break;
+        }
+    }
+}
+
+/*
+ * Stop now if suspended, then go wherever SetThreadContext() said.
+ */
+static void
+host_suspended (host_object_t * self)
+{
+  DWORD_PTR pc;
+
+  host_stop (self);
+
+  pc = __atomic_exchange_n (&self->redirect, 0, __ATOMIC_SEQ_CST);
+  if (pc != 0)
+    {
+      ((void (*) (void)) pc) ();
+    }
+}
+
+static void
+host_signal_handler (int sig)
+{
+  int saved = errno;
+  host_object_t * self = host_self;
+
+  (void) sig;
+
+  if (self != NULL)
+    {
+      if (host_depth > 0)
+        {
+          host_pending = 1;
+          if (host_waitWord != NULL)
+            {
+              __atomic_add_fetch (host_waitWord, 1, __ATOMIC_SEQ_CST);
+            }
+        }
+      else
+        {
+          errno = saved;
+          host_suspended (self);
+        }
+    }
+
+  errno = saved;
+}
+
+#define HOST_ENTER()   (++host_depth, __atomic_signal_fence (__ATOMIC_SEQ_CST))
+
+static void
+host_leave (void)
+{
+  __atomic_signal_fence (__ATOMIC_SEQ_CST);
+  if (--host_depth == 0)
+    {
+      __atomic_signal_fence (__ATOMIC_SEQ_CST);
+      if (host_pending)
+        {
+          host_pending = 0;
+          host_suspended (host_self);
+        }
+    }
+}
+
+
+/*
+ * Objects
+ * -------
+ */
+
+static host_object_t *
+host_new (int kind)
+{
+  host_object_t * o = (host_object_t *) calloc (1, sizeof (*o));
+
+  if (o == NULL)
+    {
+      host_lastError = ERROR_NOT_ENOUGH_MEMORY;
+      return NULL;
+    }
+
+  o->kind = kind;
+  o->refs = 1;
+  o->due = HOST_NEVER;
+  return o;
+}
+
+static void
+host_release (host_object_t * o)
+{
+  if (__atomic_sub_fetch (&o->refs, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+      free (o);
+    }
+}
+
+static void
+host_thread_key_destroy (void * arg)
+{
+  host_object_t * o = (host_object_t *) arg;
+
+  /*
+   * An implicit thread is finishing: it can no longer be suspended.
+   */
+  host_lock (o);
+  __atomic_store_n (&o->state, 1, __ATOMIC_SEQ_CST);
+  host_unlock (o);
+  host_release (o);
+}
+
+/*
+ * The object for the calling thread. Threads the library didn't start
+ * get one when first asked.
+ */
+static host_object_t *
+host_current (void)
+{
+  host_object_t * o = host_self;
+
+  if (o == NULL && (o = host_new (HOST_THREAD)) != NULL)
+    {
+      o->id = __atomic_add_fetch (&host_nextId, 1, __ATOMIC_RELAXED);
+      o->tid = (pid_t) syscall (SYS_gettid);
+      o->started = 1;
+      host_self = o;
+      (void) tss_set (host_selfKey, o);
+    }
+
+  return o;
+}
+
+static host_object_t *
+host_object (HANDLE h)
+{
+  if (h == HOST_CURRENT_THREAD)
+    {
+      return host_current ();
+    }
+  if (h == NULL || h == HOST_CURRENT_PROCESS)
+    {
+      host_lastError = ERROR_INVALID_HANDLE;
+      return NULL;
+    }
+  return (host_object_t *) h;
+}
+
+/*
+ * Tell every waiter on 'o' to look at it again.
+ */
+static void
+host_notify (host_object_t * o)
+{
+  host_waiter_t * w;
+
+  __atomic_thread_fence (__ATOMIC_SEQ_CST);
+
+  if (__atomic_load_n (&o->waiters, __ATOMIC_SEQ_CST) == NULL)
+    {
+      return;
+    }
+
+  host_lock (o);
+  for (w = o->waiters; w != NULL; w = w->next)
+    {
+      __atomic_add_fetch (w->word, 1, __ATOMIC_SEQ_CST);
+      host_futex_wake (w->word, 1);
+    }
+  host_unlock (o);
+}
+
+static void
+host_link (host_object_t * o, host_waiter_t * w)
+{
+  host_lock (o);
+  w->prev = NULL;
+  w->next = o->waiters;
+  if (w->next != NULL)
+    {
+      w->next->prev = w;
+    }
+  __atomic_store_n (&o->waiters, w, __ATOMIC_SEQ_CST);
+  host_unlock (o);
+}
+
+static void
+host_unlink (host_object_t * o, host_waiter_t * w)
+{
+  host_lock (o);
+  if (w->prev != NULL)
+    {
+      w->prev->next = w->next;
+    }
+  else
+    {
+      o->waiters = w->next;
+    }
+  if (w->next != NULL)
+    {
+      w->next->prev = w->prev;
+    }
+  host_unlock (o);
+}
+
+/*
+ * Expire a timer if it is due.
+ */
+static void
+host_timer_poll (host_object_t * o, LONGLONG now)
+{
+  LONGLONG due = __atomic_load_n (&o->due, __ATOMIC_SEQ_CST);
+
+  if (due <= now)
+    {
+      LONGLONG next = (o->period > 0) ? now + o->period : HOST_NEVER;
+
+      if (__atomic_compare_exchange_n (&o->due, &due, next, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+        {
+          __atomic_store_n (&o->state, 1, __ATOMIC_SEQ_CST);
+        }
+    }
+}
+
+/*
+ * Take the object if it is signalled, as a successful wait would.
+ */
+static int
+host_try (host_object_t * o, LONGLONG now)
+{
+  long s;
+  long self;
+
+  switch (o->kind)
+    {
+    case HOST_TIMER:
+      host_timer_poll (o, now);
+      /* Fall through */
+    case HOST_EVENT:
+      if (o->manual)
+        {
+          return __atomic_load_n (&o->state, __ATOMIC_SEQ_CST) != 0;
+        }
+      s = 1;
+      return __atomic_compare_exchange_n (&o->state, &s, 0, 0,
+                                          __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    case HOST_MUTEX:
+      /*
+       * 'state' is the owner's thread id.
+       */
+      self = (long) GetCurrentThreadId ();
+      if (__atomic_load_n (&o->state, __ATOMIC_SEQ_CST) == self)
+        {
+          o->max++;
+          return 1;
+        }
+      s = 0;
+      if (__atomic_compare_exchange_n (&o->state, &s, self, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+        {
+          o->max = 1;
+          return 1;
+        }
+      return 0;
+    case HOST_SEMAPHORE:
+      s = __atomic_load_n (&o->state, __ATOMIC_SEQ_CST);
+      while (s > 0)
+        {
+          if (__atomic_compare_exchange_n (&o->state, &s, s - 1, 0,
+                                           __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            {
+              return 1;
+            }
+        }
+      return 0;
+    case HOST_THREAD:
+      return __atomic_load_n (&o->state, __ATOMIC_SEQ_CST) != 0;
+    }
+
+  return 0;
+}
+
+static DWORD
+host_wait (host_object_t ** objects, DWORD count, DWORD milliseconds)
+{
+  host_waiter_t waiters[MAXIMUM_WAIT_OBJECTS];
+  volatile int shared = 0;
+  LONGLONG deadline;
+  LONGLONG now;
+  LONGLONG wake;
+  DWORD result = WAIT_TIMEOUT;
+  DWORD i;
+  int linked = 0;
+  int word = 0;
+
+  now = host_now ();
+  deadline = (milliseconds == INFINITE)
+             ? HOST_NEVER
+             : now + (LONGLONG) milliseconds * 1000000LL;
+
+  for (;;)
+    {
+      for (i = 0; i < count; i++)
+        {
+          if (host_try (objects[i], now))
+            {
+              result = WAIT_OBJECT_0 + i;
+              goto done;
+            }
+        }
+
+      if (now >= deadline)
+        {
+          goto done;
+        }
+
+      if (!linked)
+        {
+          for (i = 0; i < count; i++)
+            {
+              waiters[i].word = &shared;
+              host_link (objects[i], &waiters[i]);
+            }
+          host_waitWord = &shared;
+          linked = 1;
+          word = __atomic_load_n (&shared, __ATOMIC_SEQ_CST);
+          now = host_now ();
+          continue;
+        }
+
+      wake = deadline;
+      for (i = 0; i < count; i++)
+        {
+          if (objects[i]->kind == HOST_TIMER)
+            {
+              LONGLONG due = __atomic_load_n (&objects[i]->due, __ATOMIC_SEQ_CST);
+
+              if (due < wake)
+                {
+                  wake = due;
+                }
+            }
+        }
+
+      if (host_pending)
+        {
+          /*
+           * Suspended while waiting. The waiter entries stay linked
+           * unless the thread is sent somewhere else.
+           */
+          host_pending = 0;
+          host_stop (host_self);
+          if (host_self->redirect != 0)
+            {
+              host_pending = 1;
+              goto done;
+            }
+        }
+      else if (wake > now)
+        {
+          (void) host_futex_wait (&shared, word,
+                                  (wake == HOST_NEVER) ? -1 : wake - now);
+        }
+
+      word = __atomic_load_n (&shared, __ATOMIC_SEQ_CST);
+      now = host_now ();
+    }
+
+done:
+  if (linked)
+    {
+      host_waitWord = NULL;
+      for (i = 0; i < count; i++)
+        {
+          host_unlink (objects[i], &waiters[i]);
+        }
+    }
+
+  return result;
+}
+
+static void
+host_set (host_object_t * o, long state)
+{
+  __atomic_store_n (&o->state, state, __ATOMIC_SEQ_CST);
+  host_notify (o);
+}
+
+
+HANDLE
+CreateEvent (LPSECURITY_ATTRIBUTES sa, BOOL manualReset, BOOL initialState, LPCSTR name)
+{
+  host_object_t * o = host_new (HOST_EVENT);
+
+  (void) sa;
+  (void) name;
+
+  if (o != NULL)
+    {
+      o->manual = manualReset;
+      o->state = initialState ? 1 : 0;
+    }
+
+  return (HANDLE) o;
+}
+
+BOOL
+SetEvent (HANDLE h)
+{
+  host_object_t * o = host_object (h);
+
+  if (o == NULL || o->kind != HOST_EVENT)
+    {
+      return FALSE;
+    }
+
+  HOST_ENTER ();
+  host_set (o, 1);
+  host_leave ();
+
+  return TRUE;
+}
+
+BOOL
+ResetEvent (HANDLE h)
+{
+  host_object_t * o = host_object (h);
+
+  if (o == NULL || o->kind != HOST_EVENT)
+    {
+      return FALSE;
+    }
+
+  __atomic_store_n (&o->state, 0, __ATOMIC_SEQ_CST);
+  return TRUE;
+}
+
+HANDLE
+CreateSemaphore (LPSECURITY_ATTRIBUTES sa, LONG initialCount, LONG maximumCount, LPCSTR name)
+{
+  host_object_t * o;
+
+  (void) sa;
+  (void) name;
+
+  if (initialCount < 0 || maximumCount <= 0 || initialCount > maximumCount)
+    {
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return NULL;
+    }
+
+  if ((o = host_new (HOST_SEMAPHORE)) != NULL)
+    {
+      o->state = initialCount;
+      o->max = maximumCount;
+    }
+
+  return (HANDLE) o;
+}
+
+BOOL
+ReleaseSemaphore (HANDLE h, LONG releaseCount, LPLONG previousCount)
+{
+  host_object_t * o = host_object (h);
+  long s;
+
+  if (o == NULL || o->kind != HOST_SEMAPHORE || releaseCount <= 0)
+    {
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return FALSE;
+    }
+
+  HOST_ENTER ();
+
+  s = __atomic_load_n (&o->state, __ATOMIC_SEQ_CST);
+  do
+    {
+      if (s > o->max - releaseCount)
+        {
+          host_leave ();
+          host_lastError = ERROR_INVALID_PARAMETER;
+          return FALSE;
+        }
+    }
+  while (!__atomic_compare_exchange_n (&o->state, &s, s + releaseCount, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+
+  if (previousCount != NULL)
+    {
+      *previousCount = s;
+    }
+
+  host_notify (o);
+  host_leave ();
+
+  return TRUE;
+}
+
+HANDLE
+CreateMutex (LPSECURITY_ATTRIBUTES sa, BOOL initialOwner, LPCSTR name)
+{
+  host_object_t * o = host_new (HOST_MUTEX);
+
+  (void) sa;
+  (void) name;
+
+  if (o != NULL && initialOwner)
+    {
+      o->state = (long) GetCurrentThreadId ();
+      o->max = 1;
+    }
+
+  return (HANDLE) o;
+}
+
+BOOL
+ReleaseMutex (HANDLE h)
+{
+  host_object_t * o = host_object (h);
+
+  if (o == NULL || o->kind != HOST_MUTEX
+      || __atomic_load_n (&o->state, __ATOMIC_SEQ_CST) != (long) GetCurrentThreadId ())
+    {
+      host_lastError = ERROR_NOT_OWNER;
+      return FALSE;
+    }
+
+  if (--o->max > 0)
+    {
+      return TRUE;
+    }
+
+  HOST_ENTER ();
+  __atomic_store_n (&o->state, 0, __ATOMIC_SEQ_CST);
+  host_notify (o);
+  host_leave ();
+
+  return TRUE;
+}
+
+HANDLE
+CreateWaitableTimer (LPSECURITY_ATTRIBUTES sa, BOOL manualReset, LPCSTR name)
+{
+  host_object_t * o = host_new (HOST_TIMER);
+
+  (void) sa;
+  (void) name;
+
+  if (o != NULL)
+    {
+      o->manual = manualReset;
+    }
+
+  return (HANDLE) o;
+}
+
+BOOL
+SetWaitableTimer (HANDLE h, const LARGE_INTEGER * dueTime, LONG period,
+                  PVOID completionRoutine, LPVOID arg, BOOL resume)
+{
+  host_object_t * o = host_object (h);
+  LONGLONG now = host_now ();
+  LONGLONG due;
+
+  (void) arg;
+  (void) resume;
+
+  if (o == NULL || o->kind != HOST_TIMER || completionRoutine != NULL || period < 0)
+    {
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return FALSE;
+    }
+
+  if (dueTime->QuadPart < 0)
+    {
+      /* Relative, in 100 ns units */
+      due = now - dueTime->QuadPart * 100;
+    }
+  else
+    {
+      /* Absolute FILETIME */
+      FILETIME ft;
+      LONGLONG wall;
+
+      GetSystemTimeAsFileTime (&ft);
+      wall = ((LONGLONG) ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+      due = now + (dueTime->QuadPart - wall) * 100;
+    }
+
+  HOST_ENTER ();
+  o->period = (LONGLONG) period * 1000000LL;
+  __atomic_store_n (&o->state, 0, __ATOMIC_SEQ_CST);
+  __atomic_store_n (&o->due, due, __ATOMIC_SEQ_CST);
+  host_notify (o);
+  host_leave ();
+
+  return TRUE;
+}
+
+BOOL
+CancelWaitableTimer (HANDLE h)
+{
+  host_object_t * o = host_object (h);
+
+  if (o == NULL || o->kind != HOST_TIMER)
+    {
+      return FALSE;
+    }
+
+  __atomic_store_n (&o->due, HOST_NEVER, __ATOMIC_SEQ_CST);
+  return TRUE;
+}
+
+BOOL
+CloseHandle (HANDLE h)
+{
+  host_object_t * o = (host_object_t *) h;
+
+  if (h == HOST_CURRENT_THREAD || h == HOST_CURRENT_PROCESS)
+    {
+      return TRUE;
+    }
+
+  if (o == NULL)
+    {
+      host_lastError = ERROR_INVALID_HANDLE;
+      return FALSE;
+    }
+
+  host_release (o);
+  return TRUE;
+}
+
+BOOL
+DuplicateHandle (HANDLE sourceProcess, HANDLE source, HANDLE targetProcess,
+                 PHANDLE target, DWORD access, BOOL inherit, DWORD options)
+{
+  host_object_t * o = host_object (source);
+
+  (void) sourceProcess;
+  (void) targetProcess;
+  (void) access;
+  (void) inherit;
+  (void) options;
+
+  if (o == NULL || target == NULL)
+    {
+      return FALSE;
+    }
+
+  __atomic_add_fetch (&o->refs, 1, __ATOMIC_RELAXED);
+  *target = (HANDLE) o;
+
+  return TRUE;
+}
+
+DWORD
+WaitForSingleObject (HANDLE h, DWORD milliseconds)
+{
+  host_object_t * o = host_object (h);
+  DWORD result;
+
+  if (o == NULL)
+    {
+      return WAIT_FAILED;
+    }
+
+  HOST_ENTER ();
+  result = host_wait (&o, 1, milliseconds);
+  host_leave ();
+
+  return result;
+}
+
+DWORD
+WaitForMultipleObjects (DWORD count, const HANDLE * handles, BOOL waitAll, DWORD milliseconds)
+{
+  host_object_t * objects[MAXIMUM_WAIT_OBJECTS];
+  DWORD result;
+  DWORD i;
+
+  if (count == 0 || count > MAXIMUM_WAIT_OBJECTS || waitAll)
+    {
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return WAIT_FAILED;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      if ((objects[i] = host_object (handles[i])) == NULL)
+        {
+          return WAIT_FAILED;
+        }
+    }
+
+  HOST_ENTER ();
+  result = host_wait (objects, count, milliseconds);
+  host_leave ();
+
+  return result;
+}
+
+
+/*
+ * Threads
+ * -------
+ */
+
+static void
+host_thread_exit (host_object_t * self, unsigned code)
+{
+  HOST_ENTER ();
+  host_lock (self);
+  self->exitCode = code;
+  __atomic_store_n (&self->state, 1, __ATOMIC_SEQ_CST);
+  host_unlock (self);
+  host_notify (self);
+  host_leave ();
+
+  /*
+   * host_self stays set: a suspend signal sent just before the thread
+   * was marked finished may still arrive, and must be answered.
+   */
+  host_release (self);
+}
+
+static int
+host_thread_start (void * arg)
+{
+  host_object_t * self = (host_object_t *) arg;
+  unsigned code;
+
+  host_self = self;
+  __atomic_store_n (&self->tid, (pid_t) syscall (SYS_gettid), __ATOMIC_SEQ_CST);
+
+  if (self->affinitySet)
+    {
+      (void) syscall (SYS_sched_setaffinity, 0, sizeof (self->affinity), self->affinity);
+    }
+
+  /*
+   * Created suspended: wait here until resumed.
+   */
+  __atomic_store_n (&self->started, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n (&self->suspend, __ATOMIC_SEQ_CST) >= HOST_SUSPEND_ONE)
+    {
+      host_stop (self);
+    }
+
+  code = (*self->start) (self->arg);
+  host_thread_exit (self, code);
+
+  return (int) code;
+}
+
+uintptr_t
+_beginthreadex (void * security, unsigned stackSize,
+                unsigned (__stdcall * start) (void *), void * arg,
+                unsigned flags, unsigned * threadId)
+{
+  host_object_t * o = host_new (HOST_THREAD);
+  thrd_t t;
+
+  (void) security;
+  (void) stackSize;
+
+  if (o == NULL)
+    {
+      errno = EAGAIN;
+      return 0;
+    }
+
+  o->start = start;
+  o->arg = arg;
+  o->refs = 2;          /* The caller's handle, and the thread's own */
+  o->id = __atomic_add_fetch (&host_nextId, 1, __ATOMIC_RELAXED);
+  if (flags & CREATE_SUSPENDED)
+    {
+      o->suspend = HOST_SUSPEND_ONE;
+    }
+
+  if (thrd_create (&t, host_thread_start, o) != thrd_success)
+    {
+      free (o);
+      errno = EAGAIN;
+      return 0;
+    }
+
+  (void) thrd_detach (t);
+
+  if (threadId != NULL)
+    {
+      *threadId = o->id;
+    }
+
+  return (uintptr_t) o;
+}
+
+void
+_endthreadex (unsigned exitCode)
+{
+  host_object_t * self = host_self;
+
+  if (self != NULL)
+    {
+      host_thread_exit (self, exitCode);
+    }
+
+  thrd_exit ((int) exitCode);
+}
+
+HANDLE
+GetCurrentThread (void)
+{
+  return HOST_CURRENT_THREAD;
+}
+
+DWORD
+GetCurrentThreadId (void)
+{
+  host_object_t * o = host_current ();
+
+  return (o != NULL) ? o->id : 0;
+}
+
+HANDLE
+GetCurrentProcess (void)
+{
+  return HOST_CURRENT_PROCESS;
+}
+
+DWORD
+GetCurrentProcessId (void)
+{
+  return (DWORD) getpid ();
+}
+
+HANDLE
+OpenProcess (DWORD access, BOOL inherit, DWORD processId)
+{
+  (void) access;
+  (void) inherit;
+
+  /*
+   * Only the calling process can be opened.
+   */
+  if (processId != (DWORD) getpid ())
+    {
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return NULL;
+    }
+
+  return HOST_CURRENT_PROCESS;
+}
+
+DWORD
+SuspendThread (HANDLE h)
+{
+  host_object_t * o = host_object (h);
+  int s;
+
+  if (o == NULL || o->kind != HOST_THREAD || o == host_self)
+    {
+      return (DWORD) -1;
+    }
+
+  HOST_ENTER ();
+  host_lock (o);
+
+  if (__atomic_load_n (&o->state, __ATOMIC_SEQ_CST))
+    {
+      /* Finished */
+      host_unlock (o);
+      host_leave ();
+      return (DWORD) -1;
+    }
+
+  s = __atomic_fetch_add (&o->suspend, HOST_SUSPEND_ONE, __ATOMIC_SEQ_CST);
+
+  if (s < HOST_SUSPEND_ONE && !(s & HOST_STOPPED)
+      && __atomic_load_n (&o->started, __ATOMIC_SEQ_CST))
+    {
+      /*
+       * Running: stop it, and wait until it has stopped so that all of
+       * its earlier stores are visible.
+       */
+      (void) syscall (SYS_tgkill, getpid (), o->tid, HOST_SIGSUSPEND);
+      host_unlock (o);
+
+      while (!((s = __atomic_load_n (&o->suspend, __ATOMIC_SEQ_CST)) & HOST_STOPPED))
+        {
+          (void) host_futex_wait (&o->suspend, s, -1);
+        }
+    }
+  else
+    {
+      host_unlock (o);
+    }
+
+  host_leave ();
+
+  return (DWORD) (s / HOST_SUSPEND_ONE);
+}
+
+DWORD
+ResumeThread (HANDLE h)
+{
+  host_object_t * o = host_object (h);
+  int s;
+
+  if (o == NULL || o->kind != HOST_THREAD)
+    {
+      return (DWORD) -1;
+    }
+
+  s = __atomic_load_n (&o->suspend, __ATOMIC_SEQ_CST);
+  do
+    {
+      if (s < HOST_SUSPEND_ONE)
+        {
+          return 0;
+        }
+    }
+  while (!__atomic_compare_exchange_n (&o->suspend, &s, s - HOST_SUSPEND_ONE, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+
+  if (s / HOST_SUSPEND_ONE == 1)
+    {
+      host_futex_wake (&o->suspend, INT_MAX);
+    }
+
+  return (DWORD) (s / HOST_SUSPEND_ONE);
+}
+
+BOOL
+GetThreadContext (HANDLE h, LPCONTEXT context)
+{
+  host_object_t * o = host_object (h);
+
+  if (o == NULL || o->kind != HOST_THREAD)
+    {
+      return FALSE;
+    }
+
+  /*
+   * The thread is already known to be stopped; nothing of its register
+   * state is available.
+   */
+  context->Pc = 0;
+  return TRUE;
+}
+
+BOOL
+SetThreadContext (HANDLE h, const CONTEXT * context)
+{
+  host_object_t * o = host_object (h);
+
+  if (o == NULL || o->kind != HOST_THREAD
+      || __atomic_load_n (&o->suspend, __ATOMIC_SEQ_CST) < HOST_SUSPEND_ONE)
+    {
+      return FALSE;
+    }
+
+  __atomic_store_n (&o->redirect, context->Pc, __ATOMIC_SEQ_CST);
+  return TRUE;
+}
+
+BOOL
+GetExitCodeThread (HANDLE h, LPDWORD exitCode)
+{
+  host_object_t * o = host_object (h);
+
+  if (o == NULL || o->kind != HOST_THREAD)
+    {
+      return FALSE;
+    }
+
+  *exitCode = __atomic_load_n (&o->state, __ATOMIC_SEQ_CST) ? o->exitCode : 259; /* STILL_ACTIVE */
+  return TRUE;
+}
+
+BOOL
+SetThreadPriority (HANDLE h, int priority)
+{
+  host_object_t * o = host_object (h);
+
+  if (o == NULL || o->kind != HOST_THREAD)
+    {
+      return FALSE;
+    }
+
+  switch (priority)
+    {
+    case THREAD_PRIORITY_IDLE:
+    case THREAD_PRIORITY_LOWEST:
+    case THREAD_PRIORITY_BELOW_NORMAL:
+    case THREAD_PRIORITY_NORMAL:
+    case THREAD_PRIORITY_ABOVE_NORMAL:
+    case THREAD_PRIORITY_HIGHEST:
+    case THREAD_PRIORITY_TIME_CRITICAL:
+      break;
+    default:
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return FALSE;
+    }
+
+  /*
+   * Recorded only: normal Linux threads have no priorities to set.
+   */
+  o->priority = priority;
+  return TRUE;
+}
+
+int
+GetThreadPriority (HANDLE h)
+{
+  host_object_t * o = host_object (h);
+
+  if (o == NULL || o->kind != HOST_THREAD)
+    {
+      return THREAD_PRIORITY_ERROR_RETURN;
+    }
+
+  return o->priority;
+}
+
+static BOOL
+host_get_cpus (pid_t tid, DWORD_PTR * cpus)
+{
+  memset (cpus, 0, HOST_CPU_WORDS * sizeof (DWORD_PTR));
+
+  return syscall (SYS_sched_getaffinity, tid, HOST_CPU_WORDS * sizeof (DWORD_PTR), cpus) >= 0;
+}
+
+static DWORD_PTR
+host_get_affinity (pid_t tid)
+{
+  DWORD_PTR cpus[HOST_CPU_WORDS];
+
+  return host_get_cpus (tid, cpus) ? cpus[0] : 0;
+}
+
+DWORD_PTR
+SetThreadAffinityMask (HANDLE h, DWORD_PTR mask)
+{
+  host_object_t * o = host_object (h);
+  DWORD_PTR previous;
+  pid_t tid;
+
+  if (o == NULL || o->kind != HOST_THREAD || mask == 0)
+    {
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return 0;
+    }
+
+  tid = __atomic_load_n (&o->tid, __ATOMIC_SEQ_CST);
+
+  if (tid == 0)
+    {
+      /*
+       * Not running yet; host_thread_start() will apply it.
+       */
+      previous = o->affinitySet ? o->affinity[0] : host_get_affinity (0);
+      memset (o->affinity, 0, sizeof (o->affinity));
+      o->affinity[0] = mask;
+      o->affinitySet = 1;
+      return previous;
+    }
+
+  previous = host_get_affinity (tid);
+  if (syscall (SYS_sched_setaffinity, tid, sizeof (mask), &mask) < 0)
+    {
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return 0;
+    }
+
+  return previous;
+}
+
+BOOL
+GetProcessAffinityMask (HANDLE h, PDWORD_PTR processMask, PDWORD_PTR systemMask)
+{
+  long n = sysconf (_SC_NPROCESSORS_CONF);
+
+  (void) h;
+
+  *processMask = host_get_affinity (0);
+  *systemMask = (n >= (long) (8 * sizeof (DWORD_PTR)))
+                ? ~(DWORD_PTR) 0
+                : (((DWORD_PTR) 1 << n) - 1);
+
+  return *processMask != 0;
+}
+
+BOOL
+SetProcessAffinityMask (HANDLE h, DWORD_PTR mask)
+{
+  (void) h;
+
+  /*
+   * Only the calling thread's mask is changed; Linux has no process
+   * wide mask.
+   */
+  return syscall (SYS_sched_setaffinity, 0, sizeof (mask), &mask) == 0;
+}
+
+static int
+host_cpus_conf (void)
+{
+  long n = sysconf (_SC_NPROCESSORS_CONF);
+
+  if (n < 1)
+    {
+      return 1;
+    }
+
+  return (n > HOST_CPU_WORDS * HOST_GROUP_BITS) ? HOST_CPU_WORDS * HOST_GROUP_BITS : (int) n;
+}
+
+WORD
+GetActiveProcessorGroupCount (void)
+{
+  return (WORD) ((host_cpus_conf () + HOST_GROUP_BITS - 1) / HOST_GROUP_BITS);
+}
+
+DWORD
+GetMaximumProcessorCount (WORD group)
+{
+  int n = host_cpus_conf () - group * HOST_GROUP_BITS;
+
+  if (n <= 0)
+    {
+      return 0;
+    }
+
+  return (DWORD) ((n > HOST_GROUP_BITS) ? HOST_GROUP_BITS : n);
+}
+
+DWORD
+GetActiveProcessorCount (WORD group)
+{
+  return GetMaximumProcessorCount (group);
+}
+
+BOOL
+GetProcessGroupAffinity (HANDLE h, WORD * groupCount, WORD * groupArray)
+{
+  DWORD_PTR cpus[HOST_CPU_WORDS];
+  WORD count = 0;
+  int g;
+
+  (void) h;
+
+  if (!host_get_cpus (0, cpus))
+    {
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return FALSE;
+    }
+
+  for (g = 0; g < HOST_CPU_WORDS; g++)
+    {
+      if (cpus[g] != 0)
+        {
+          if (count < *groupCount)
+            {
+              groupArray[count] = (WORD) g;
+            }
+          count++;
+        }
+    }
+
+  if (count > *groupCount)
+    {
+      *groupCount = count;
+      host_lastError = ERROR_INSUFFICIENT_BUFFER;
+      return FALSE;
+    }
+
+  *groupCount = count;
+  return TRUE;
+}
+
+/*
+ * A Linux thread can run on CPUs of several groups; it is reported
+ * as being in the first of them.
+ */
+BOOL
+GetThreadGroupAffinity (HANDLE h, PGROUP_AFFINITY affinity)
+{
+  host_object_t * o = host_object (h);
+  DWORD_PTR cpus[HOST_CPU_WORDS];
+  pid_t tid;
+  int g;
+
+  if (o == NULL || o->kind != HOST_THREAD)
+    {
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return FALSE;
+    }
+
+  tid = __atomic_load_n (&o->tid, __ATOMIC_SEQ_CST);
+
+  if (tid == 0 && o->affinitySet)
+    {
+      memcpy (cpus, o->affinity, sizeof (cpus));
+    }
+  else if (!host_get_cpus (tid, cpus))
+    {
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return FALSE;
+    }
+
+  memset (affinity, 0, sizeof (*affinity));
+
+  for (g = 0; g < HOST_CPU_WORDS; g++)
+    {
+      if (cpus[g] != 0)
+        {
+          affinity->Mask = cpus[g];
+          affinity->Group = (WORD) g;
+          break;
+        }
+    }
+
+  return TRUE;
+}
+
+BOOL
+SetThreadGroupAffinity (HANDLE h, const GROUP_AFFINITY * affinity, PGROUP_AFFINITY previous)
+{
+  host_object_t * o = host_object (h);
+  DWORD_PTR cpus[HOST_CPU_WORDS];
+  pid_t tid;
+
+  if (o == NULL || o->kind != HOST_THREAD || affinity->Mask == 0
+      || affinity->Group >= GetActiveProcessorGroupCount ())
+    {
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return FALSE;
+    }
+
+  if (previous != NULL && !GetThreadGroupAffinity (h, previous))
+    {
+      return FALSE;
+    }
+
+  memset (cpus, 0, sizeof (cpus));
+  cpus[affinity->Group] = affinity->Mask;
+
+  tid = __atomic_load_n (&o->tid, __ATOMIC_SEQ_CST);
+
+  if (tid == 0)
+    {
+      /*
+       * Not running yet; host_thread_start() will apply it.
+       */
+      memcpy (o->affinity, cpus, sizeof (cpus));
+      o->affinitySet = 1;
+      return TRUE;
+    }
+
+  if (syscall (SYS_sched_setaffinity, tid, sizeof (cpus), cpus) < 0)
+    {
+      host_lastError = ERROR_INVALID_PARAMETER;
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+BOOL
+SetPriorityClass (HANDLE h, DWORD priorityClass)
+{
+  (void) h;
+  (void) priorityClass;
+
+  /*
+   * Raising the priority class needs privileges a test run won't have.
+   */
+  return TRUE;
+}
+
+static void
+host_filetime (LPFILETIME ft, struct timeval tv)
+{
+  ULONGLONG t = (ULONGLONG) tv.tv_sec * 10000000ULL + (ULONGLONG) tv.tv_usec * 10ULL;
+
+  ft->dwLowDateTime = (DWORD) (t & 0xFFFFFFFFUL);
+  ft->dwHighDateTime = (DWORD) (t >> 32);
+}
+
+static BOOL
+host_times (int who, LPFILETIME creation, LPFILETIME exit, LPFILETIME kernel, LPFILETIME user)
+{
+  struct rusage ru;
+
+  if (getrusage (who, &ru) != 0)
+    {
+      return FALSE;
+    }
+
+  memset (creation, 0, sizeof (*creation));
+  memset (exit, 0, sizeof (*exit));
+  host_filetime (kernel, ru.ru_stime);
+  host_filetime (user, ru.ru_utime);
+
+  return TRUE;
+}
+
+BOOL
+GetProcessTimes (HANDLE h, LPFILETIME creation, LPFILETIME exit, LPFILETIME kernel, LPFILETIME user)
+{
+  (void) h;
+
+  return host_times (RUSAGE_SELF, creation, exit, kernel, user);
+}
+
+BOOL
+GetThreadTimes (HANDLE h, LPFILETIME creation, LPFILETIME exit, LPFILETIME kernel, LPFILETIME user)
+{
+  if (host_object (h) != host_current ())
+    {
+      /*
+       * Only the calling thread's times are available.
+       */
+      host_lastError = ERROR_NOT_SUPPORTED;
+      return FALSE;
+    }
+
+  return host_times (RUSAGE_THREAD, creation, exit, kernel, user);
+}
+
+BOOL
+SwitchToThread (void)
+{
+  thrd_yield ();
+  return TRUE;
+}
+
+void
+Sleep (DWORD milliseconds)
+{
+  struct timespec ts;
+
+  if (milliseconds == 0)
+    {
+      thrd_yield ();
+      return;
+    }
+
+  ts.tv_sec = milliseconds / 1000;
+  ts.tv_nsec = (long) (milliseconds % 1000) * 1000000L;
+  while (thrd_sleep (&ts, &ts) == -1)
+    {
+    }
+}
+
+DWORD
+SleepEx (DWORD milliseconds, BOOL alertable)
+{
+  (void) alertable;
+
+  Sleep (milliseconds);
+  return 0;
+}
+
+void
+GetSystemInfo (LPSYSTEM_INFO info)
+{
+  memset (info, 0, sizeof (*info));
+  info->dwPageSize = (DWORD) sysconf (_SC_PAGESIZE);
+  info->dwNumberOfProcessors = (DWORD) sysconf (_SC_NPROCESSORS_ONLN);
+  info->dwActiveProcessorMask = host_get_affinity (0);
+}
+
+
+/*
+ * Thread local storage
+ * --------------------
+ */
+
+DWORD
+TlsAlloc (void)
+{
+  tss_t key;
+
+  if (tss_create (&key, NULL) != thrd_success)
+    {
+      return TLS_OUT_OF_INDEXES;
+    }
+
+  return (DWORD) key;
+}
+
+BOOL
+TlsFree (DWORD index)
+{
+  tss_delete ((tss_t) index);
+  return TRUE;
+}
+
+LPVOID
+TlsGetValue (DWORD index)
+{
+  return tss_get ((tss_t) index);
+}
+
+BOOL
+TlsSetValue (DWORD index, LPVOID value)
+{
+  return tss_set ((tss_t) index, value) == thrd_success;
+}
+
+
+/*
+ * Time
+ * ----
+ * The performance counter counts nanoseconds on CLOCK_MONOTONIC.
+ */
+
+BOOL
+QueryPerformanceCounter (LARGE_INTEGER * count)
+{
+  count->QuadPart = host_now ();
+  return TRUE;
+}
+
+BOOL
+QueryPerformanceFrequency (LARGE_INTEGER * frequency)
+{
+  frequency->QuadPart = 1000000000LL;
+  return TRUE;
+}
+
+void
+GetSystemTimeAsFileTime (LPFILETIME ft)
+{
+  struct timespec ts;
+  ULONGLONG t;
+
+  clock_gettime (CLOCK_REALTIME, &ts);
+
+  /* 100 ns units since 1601-01-01 */
+  t = (ULONGLONG) ts.tv_sec * 10000000ULL + (ULONGLONG) ts.tv_nsec / 100ULL
+      + 116444736000000000ULL;
+
+  ft->dwLowDateTime = (DWORD) (t & 0xFFFFFFFFUL);
+  ft->dwHighDateTime = (DWORD) (t >> 32);
+}
+
+DWORD
+GetTickCount (void)
+{
+  return (DWORD) ((host_now () - host_epoch) / 1000000LL);
+}
+
+
+/*
+ * Critical sections
+ * -----------------
+ *
+ * LockWord is 0 when free, 1 when held and 2 when held with waiters.
+ */
+
+void
+InitializeCriticalSection (LPCRITICAL_SECTION cs)
+{
+  cs->LockWord = 0;
+  cs->OwningThread = 0;
+  cs->RecursionCount = 0;
+}
+
+void
+DeleteCriticalSection (LPCRITICAL_SECTION cs)
+{
+  (void) cs;
+}
+
+BOOL
+TryEnterCriticalSection (LPCRITICAL_SECTION cs)
+{
+  DWORD self = GetCurrentThreadId ();
+  int expected = 0;
+
+  if (__atomic_load_n (&cs->OwningThread, __ATOMIC_RELAXED) == self)
+    {
+      cs->RecursionCount++;
+      return TRUE;
+    }
+
+  if (!__atomic_compare_exchange_n (&cs->LockWord, &expected, 1, 0,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+      return FALSE;
+    }
+
+  __atomic_store_n (&cs->OwningThread, self, __ATOMIC_RELAXED);
+  cs->RecursionCount = 1;
+  return TRUE;
+}
+
+void
+EnterCriticalSection (LPCRITICAL_SECTION cs)
+{
+  if (TryEnterCriticalSection (cs))
+    {
+      return;
+    }
+
+  while (__atomic_exchange_n (&cs->LockWord, 2, __ATOMIC_ACQUIRE) != 0)
+    {
+      (void) host_futex_wait (&cs->LockWord, 2, -1);
+    }
+
+  __atomic_store_n (&cs->OwningThread, GetCurrentThreadId (), __ATOMIC_RELAXED);
+  cs->RecursionCount = 1;
+}
+
+void
+LeaveCriticalSection (LPCRITICAL_SECTION cs)
+{
+  if (--cs->RecursionCount > 0)
+    {
+      return;
+    }
+
+  __atomic_store_n (&cs->OwningThread, 0, __ATOMIC_RELAXED);
+  if (__atomic_exchange_n (&cs->LockWord, 0, __ATOMIC_RELEASE) == 2)
+    {
+      host_futex_wake (&cs->LockWord, 1);
+    }
+}
+
+
+/*
+ * Errors and modules
+ * ------------------
+ */
+
+DWORD
+GetLastError (void)
+{
+  return host_lastError;
+}
+
+void
+SetLastError (DWORD error)
+{
+  host_lastError = error;
+}
+
+HMODULE
+LoadLibrary (LPCSTR name)
+{
+  (void) name;
+
+  host_lastError = ERROR_NOT_SUPPORTED;
+  return NULL;
+}
+
+BOOL
+FreeLibrary (HMODULE module)
+{
+  (void) module;
+
+  return TRUE;
+}
+
+HMODULE
+GetModuleHandle (LPCSTR name)
+{
+  (void) name;
+
+  return NULL;
+}
+
+static const struct
+{
+  const char * name;
+  FARPROC proc;
+} host_procs[] =
+{
+  { "GetActiveProcessorGroupCount", (FARPROC) GetActiveProcessorGroupCount },
+  { "GetMaximumProcessorCount", (FARPROC) GetMaximumProcessorCount },
+  { "GetActiveProcessorCount", (FARPROC) GetActiveProcessorCount },
+  { "GetProcessGroupAffinity", (FARPROC) GetProcessGroupAffinity },
+  { "GetThreadGroupAffinity", (FARPROC) GetThreadGroupAffinity },
+  { "SetThreadGroupAffinity", (FARPROC) SetThreadGroupAffinity }
+};
+
+FARPROC
+GetProcAddress (HMODULE module, LPCSTR name)
+{
+  size_t i;
+
+  (void) module;
+
+  for (i = 0; name != NULL && i < sizeof (host_procs) / sizeof (host_procs[0]); i++)
+    {
+      if (strcmp (name, host_procs[i].name) == 0)
+        {
+          return host_procs[i].proc;
+        }
+    }
+
+  host_lastError = ERROR_NOT_SUPPORTED;
+  return NULL;
+}
+
+UINT
+GetSystemDirectory (LPSTR buffer, UINT size)
+{
+  (void) buffer;
+  (void) size;
+
+  host_lastError = ERROR_NOT_SUPPORTED;
+  return 0;
+}
+
+DWORD
+GetEnvironmentVariableA (LPCSTR name, LPSTR buffer, DWORD size)
+{
+  const char * value = getenv (name);
+  size_t len;
+
+  if (value == NULL)
+    {
+      return 0;
+    }
+
+  len = strlen (value);
+  if (buffer == NULL || len >= size)
+    {
+      return (DWORD) len + 1;
+    }
+
+  memcpy (buffer, value, len + 1);
+  return (DWORD) len;
+}
+
+void
+_ftime (struct _timeb * tb)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_REALTIME, &ts);
+  tb->time = ts.tv_sec;
+  tb->millitm = (unsigned short) (ts.tv_nsec / 1000000);
+  tb->timezone = 0;
+  tb->dstflag = 0;
+}
+
+char *
+_strdup (const char * s)
+{
+  return strdup (s);
+}
+
+
+/*
+ * Runs before the library's own process attach constructor.
+ */
+__attribute__((constructor (101))) static void
+host_initialize (void)
+{
+  struct sigaction sa;
+
+  host_epoch = host_now () - 1000000LL;
+  (void) tss_create (&host_selfKey, host_thread_key_destroy);
+
+  memset (&sa, 0, sizeof (sa));
+  sa.sa_handler = host_signal_handler;
+  sa.sa_flags = SA_RESTART | SA_NODEFER;
+  sigemptyset (&sa.sa_mask);
+  (void) sigaction (HOST_SIGSUSPEND, &sa, NULL);
+}
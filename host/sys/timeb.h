@@ -0,0 +1,22 @@
+/*
+ * sys/timeb.h
+ *
+ * Description:
+ * The Microsoft C runtime's _ftime() for the host platform layer.
+ */
+
+#if !defined(PTW32_HOST_SYS_TIMEB_H)
+#define PTW32_HOST_SYS_TIMEB_H
+
+#include <time.h>
+
+struct _timeb {
+  time_t time;
+  unsigned short millitm;
+  short timezone;
+  short dstflag;
+};
+
+void _ftime (struct _timeb *);
+
+#endif /* PTW32_HOST_SYS_TIMEB_H */
@@ -0,0 +1,21 @@
+/*
+ * tchar.h
+ *
+ * Description:
+ * The narrow character subset of <tchar.h> for the host platform layer.
+ */
+
+#if !defined(PTW32_HOST_TCHAR_H)
+#define PTW32_HOST_TCHAR_H
+
+#include <string.h>
+#include "windows.h"
+
+#if !defined(_countof)
+#define _countof(a)     (sizeof (a) / sizeof ((a)[0]))
+#endif
+
+#define _tcsncat_s(dst, size, src, count) \
+  (strlen (dst) + (count) < (size) ? (strncat ((dst), (src), (count)), 0) : 34 /* ERANGE */)
+
+#endif /* PTW32_HOST_TCHAR_H */
@@ -0,0 +1,344 @@
+/*
+ * windows.h
+ *
+ * Description:
+ * The platform layer used when building the library for a POSIX host
+ * (PTW32_HOST). It provides the part of the Win32 API that the library
+ * and its tests use, implemented in ptw32_host.c on Linux futexes and
+ * C11 threads, so that the same sources can be run under native
+ * profilers, sanitizers and CI. See host/README.
+ *
+ * Only the semantics the library relies on are provided. Handles are
+ * pointers to host objects; waits accept events, semaphores, threads
+ * and waitable timers, and WaitForMultipleObjects() supports waiting
+ * for any one object only.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ *
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ *
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ *
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#if !defined(PTW32_HOST_WINDOWS_H)
+#define PTW32_HOST_WINDOWS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/*
+ * Calling conventions and storage classes mean nothing here. Like the
+ * Windows compilers, host/GNUmakefile predefines these for the public
+ * headers, which are read before this one.
+ */
+#if !defined(__cdecl)
+#define __cdecl
+#endif
+#if !defined(__stdcall)
+#define __stdcall
+#endif
+#if !defined(__declspec)
+#define __declspec(x)
+#endif
+#define WINAPI
+#define APIENTRY
+#define CALLBACK
+
+/*
+ * Types. LONG, ULONG and DWORD are 32 bits, as on Windows, where the
+ * library and the tests freely pass the address of an int for them.
+ */
+typedef void VOID;
+typedef void * PVOID;
+typedef void * LPVOID;
+typedef void * HANDLE;
+typedef HANDLE * PHANDLE;
+typedef HANDLE HINSTANCE;
+typedef HANDLE HMODULE;
+typedef void (* FARPROC) (void);
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef unsigned short WORD;
+typedef unsigned int UINT;
+typedef int LONG;
+typedef LONG * LPLONG;
+typedef unsigned int ULONG;
+typedef unsigned int DWORD;
+typedef DWORD * LPDWORD;
+typedef long long LONGLONG;
+typedef unsigned long long ULONGLONG;
+typedef long long LONG64;
+typedef unsigned long long ULONG64;
+typedef unsigned long long UINT64;
+typedef intptr_t INT_PTR;
+typedef uintptr_t UINT_PTR;
+typedef intptr_t LONG_PTR;
+typedef uintptr_t ULONG_PTR;
+typedef uintptr_t DWORD_PTR;
+typedef DWORD_PTR * PDWORD_PTR;
+typedef ULONG_PTR KAFFINITY;
+typedef char CHAR;
+typedef char TCHAR;
+typedef char * LPSTR;
+typedef const char * LPCSTR;
+typedef const char * LPCTSTR;
+typedef const unsigned short * LPCWSTR;
+#define _int64 long long
+
+typedef union _LARGE_INTEGER {
+  struct {
+    DWORD LowPart;
+    LONG HighPart;
+  };
+  struct {
+    DWORD LowPart;
+    LONG HighPart;
+  } u;
+  LONGLONG QuadPart;
+} LARGE_INTEGER, * PLARGE_INTEGER;
+
+typedef struct _FILETIME {
+  DWORD dwLowDateTime;
+  DWORD dwHighDateTime;
+} FILETIME, * LPFILETIME;
+
+typedef struct _SECURITY_ATTRIBUTES {
+  DWORD nLength;
+  LPVOID lpSecurityDescriptor;
+  BOOL bInheritHandle;
+} SECURITY_ATTRIBUTES, * LPSECURITY_ATTRIBUTES;
+
+typedef struct _SYSTEM_INFO {
+  DWORD dwOemId;
+  DWORD dwPageSize;
+  DWORD_PTR dwActiveProcessorMask;
+  DWORD dwNumberOfProcessors;
+} SYSTEM_INFO, * LPSYSTEM_INFO;
+
+/*
+ * SetThreadContext() with a new program counter makes the thread call
+ * that address, from a signal handler, when it is resumed.
+ */
+typedef struct _CONTEXT {
+  DWORD ContextFlags;
+  DWORD_PTR Pc;
+} CONTEXT, * LPCONTEXT;
+
+/*
+ * A recursive lock owned by thread id.
+ */
+typedef struct _CRITICAL_SECTION {
+  volatile int LockWord;
+  DWORD OwningThread;
+  LONG RecursionCount;
+} CRITICAL_SECTION, * LPCRITICAL_SECTION;
+
+typedef void (APIENTRY * PAPCFUNC) (ULONG_PTR);
+typedef DWORD (WINAPI * LPTHREAD_START_ROUTINE) (LPVOID);
+
+/*
+ * Constants.
+ */
+#define TRUE                            1
+#define FALSE                           0
+#define INFINITE                        0xFFFFFFFF
+#define WAIT_OBJECT_0                   0
+#define WAIT_ABANDONED                  0x80
+#define WAIT_IO_COMPLETION              0xC0
+#define WAIT_TIMEOUT                    258
+#define WAIT_FAILED                     ((DWORD) 0xFFFFFFFF)
+#define MAXIMUM_WAIT_OBJECTS            64
+#define INVALID_HANDLE_VALUE            ((HANDLE) (LONG_PTR) -1)
+#define TLS_OUT_OF_INDEXES              ((DWORD) 0xFFFFFFFF)
+#define CREATE_SUSPENDED                0x4
+#define DUPLICATE_SAME_ACCESS           0x2
+#define CONTEXT_CONTROL                 0x1
+#define THREAD_PRIORITY_ERROR_RETURN    0x7FFFFFFF
+#define THREAD_PRIORITY_IDLE            (-15)
+#define THREAD_PRIORITY_LOWEST          (-2)
+#define THREAD_PRIORITY_BELOW_NORMAL    (-1)
+#define THREAD_PRIORITY_NORMAL          0
+#define THREAD_PRIORITY_ABOVE_NORMAL    1
+#define THREAD_PRIORITY_HIGHEST         2
+#define THREAD_PRIORITY_TIME_CRITICAL   15
+#define DLL_PROCESS_DETACH              0
+#define DLL_PROCESS_ATTACH              1
+#define DLL_THREAD_ATTACH               2
+#define DLL_THREAD_DETACH               3
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x2
+#define TIMER_ALL_ACCESS                0x1F0003
+#define ERROR_ACCESS_DENIED             5
+#define ERROR_INVALID_HANDLE            6
+#define ERROR_NOT_ENOUGH_MEMORY         8
+#define ERROR_INVALID_PARAMETER         87
+#define ERROR_NOT_SUPPORTED             50
+#define ERROR_INSUFFICIENT_BUFFER       122
+#define ERROR_NOT_OWNER                 288
+#define NORMAL_PRIORITY_CLASS           0x20
+#define HIGH_PRIORITY_CLASS             0x80
+#define REALTIME_PRIORITY_CLASS         0x100
+#define PROCESS_SET_INFORMATION         0x200
+#define PROCESS_QUERY_INFORMATION       0x400
+#define MAX_PATH                        260
+#define TEXT(x)                         x
+#define _T(x)                           x
+
+/*
+ * Kernel objects.
+ */
+HANDLE CreateEvent (LPSECURITY_ATTRIBUTES, BOOL manualReset, BOOL initialState, LPCSTR);
+BOOL SetEvent (HANDLE);
+BOOL ResetEvent (HANDLE);
+HANDLE CreateSemaphore (LPSECURITY_ATTRIBUTES, LONG initialCount, LONG maximumCount, LPCSTR);
+BOOL ReleaseSemaphore (HANDLE, LONG releaseCount, LPLONG previousCount);
+HANDLE CreateMutex (LPSECURITY_ATTRIBUTES, BOOL initialOwner, LPCSTR);
+BOOL ReleaseMutex (HANDLE);
+HANDLE CreateWaitableTimer (LPSECURITY_ATTRIBUTES, BOOL manualReset, LPCSTR);
+BOOL SetWaitableTimer (HANDLE, const LARGE_INTEGER * dueTime, LONG period,
+                       PVOID completionRoutine, LPVOID arg, BOOL resume);
+BOOL CancelWaitableTimer (HANDLE);
+BOOL CloseHandle (HANDLE);
+BOOL DuplicateHandle (HANDLE sourceProcess, HANDLE source, HANDLE targetProcess,
+                      PHANDLE target, DWORD access, BOOL inherit, DWORD options);
+DWORD WaitForSingleObject (HANDLE, DWORD milliseconds);
+DWORD WaitForMultipleObjects (DWORD count, const HANDLE * handles,
+                              BOOL waitAll, DWORD milliseconds);
+
+/*
+ * Threads.
+ */
+uintptr_t _beginthreadex (void * security, unsigned stackSize,
+                          unsigned (__stdcall * start) (void *), void * arg,
+                          unsigned flags, unsigned * threadId);
+void _endthreadex (unsigned exitCode);
+HANDLE GetCurrentThread (void);
+DWORD GetCurrentThreadId (void);
+HANDLE GetCurrentProcess (void);
+DWORD GetCurrentProcessId (void);
+HANDLE OpenProcess (DWORD access, BOOL inherit, DWORD processId);
+DWORD SuspendThread (HANDLE);
+DWORD ResumeThread (HANDLE);
+BOOL GetThreadContext (HANDLE, LPCONTEXT);
+BOOL SetThreadContext (HANDLE, const CONTEXT *);
+BOOL GetExitCodeThread (HANDLE, LPDWORD);
+BOOL SetThreadPriority (HANDLE, int);
+int GetThreadPriority (HANDLE);
+DWORD_PTR SetThreadAffinityMask (HANDLE, DWORD_PTR);
+BOOL GetProcessAffinityMask (HANDLE, PDWORD_PTR processMask, PDWORD_PTR systemMask);
+BOOL SetProcessAffinityMask (HANDLE, DWORD_PTR);
+
+/*
+ * Processor groups: each run of 64 Linux CPUs is a group.
+ */
+typedef struct _GROUP_AFFINITY {
+  DWORD_PTR Mask;
+  WORD Group;
+  WORD Reserved[3];
+} GROUP_AFFINITY, * PGROUP_AFFINITY;
+
+WORD GetActiveProcessorGroupCount (void);
+DWORD GetMaximumProcessorCount (WORD);
+DWORD GetActiveProcessorCount (WORD);
+BOOL GetProcessGroupAffinity (HANDLE, WORD * groupCount, WORD * groupArray);
+BOOL GetThreadGroupAffinity (HANDLE, PGROUP_AFFINITY);
+BOOL SetThreadGroupAffinity (HANDLE, const GROUP_AFFINITY *, PGROUP_AFFINITY previous);
+BOOL SetPriorityClass (HANDLE, DWORD);
+BOOL GetProcessTimes (HANDLE, LPFILETIME, LPFILETIME, LPFILETIME kernel, LPFILETIME user);
+BOOL GetThreadTimes (HANDLE, LPFILETIME, LPFILETIME, LPFILETIME kernel, LPFILETIME user);
+BOOL SwitchToThread (void);
+void Sleep (DWORD milliseconds);
+DWORD SleepEx (DWORD milliseconds, BOOL alertable);
+void GetSystemInfo (LPSYSTEM_INFO);
+
+/*
+ * Thread local storage.
+ */
+DWORD TlsAlloc (void);
+BOOL TlsFree (DWORD);
+LPVOID TlsGetValue (DWORD);
+BOOL TlsSetValue (DWORD, LPVOID);
+
+/*
+ * Time.
+ */
+BOOL QueryPerformanceCounter (LARGE_INTEGER *);
+BOOL QueryPerformanceFrequency (LARGE_INTEGER *);
+void GetSystemTimeAsFileTime (LPFILETIME);
+DWORD GetTickCount (void);
+
+/*
+ * Critical sections.
+ */
+void InitializeCriticalSection (LPCRITICAL_SECTION);
+void DeleteCriticalSection (LPCRITICAL_SECTION);
+void EnterCriticalSection (LPCRITICAL_SECTION);
+BOOL TryEnterCriticalSection (LPCRITICAL_SECTION);
+void LeaveCriticalSection (LPCRITICAL_SECTION);
+
+/*
+ * Errors and modules. No libraries are loaded, so of the optional
+ * Windows functions the library looks up only the processor group
+ * functions above are found.
+ */
+DWORD GetLastError (void);
+void SetLastError (DWORD);
+HMODULE LoadLibrary (LPCSTR);
+BOOL FreeLibrary (HMODULE);
+HMODULE GetModuleHandle (LPCSTR);
+FARPROC GetProcAddress (HMODULE, LPCSTR);
+UINT GetSystemDirectory (LPSTR, UINT);
+DWORD GetEnvironmentVariableA (LPCSTR, LPSTR, DWORD);
+char * _strdup (const char *);
+
+/*
+ * Barriers and Interlocked operations, for the tests.
+ */
+#define MemoryBarrier()                 __atomic_thread_fence (__ATOMIC_SEQ_CST)
+#if defined(__i386__) || defined(__x86_64__)
+#define YieldProcessor()                __builtin_ia32_pause ()
+#else
+#define YieldProcessor()                __atomic_signal_fence (__ATOMIC_SEQ_CST)
+#endif
+#define InterlockedIncrement(p)         __atomic_add_fetch ((p), 1, __ATOMIC_SEQ_CST)
+#define InterlockedDecrement(p)         __atomic_sub_fetch ((p), 1, __ATOMIC_SEQ_CST)
+#define InterlockedExchange(p, v)       __atomic_exchange_n ((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedExchangeAdd(p, v)    __atomic_fetch_add ((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedCompareExchange(p, v, c) __sync_val_compare_and_swap ((p), (c), (v))
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* PTW32_HOST_WINDOWS_H */
@@ -0,0 +1,9 @@
+/*
+ * winsock.h
+ *
+ * Description:
+ * The host platform layer has no sockets; the library only needs
+ * windows.h from here.
+ */
+
+#include "windows.h"
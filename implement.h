@@ -132,9 +132,9 @@ static void ptw32_set_errno(int err) { errno = err; SetLastError(err); }
 # define PTW32_INTERLOCKED_VOLATILE volatile
 #endif
 
-#define PTW32_INTERLOCKED_LONG long
+#define PTW32_INTERLOCKED_LONG LONG
 #define PTW32_INTERLOCKED_PVOID PVOID
-#define PTW32_INTERLOCKED_LONGPTR PTW32_INTERLOCKED_VOLATILE long*
+#define PTW32_INTERLOCKED_LONGPTR PTW32_INTERLOCKED_VOLATILE LONG*
 #define PTW32_INTERLOCKED_PVOID_PTR PTW32_INTERLOCKED_VOLATILE PVOID*
 #if defined(_WIN64)
 #  define PTW32_INTERLOCKED_SIZE LONGLONG
@@ -155,12 +155,18 @@ static void ptw32_set_errno(int err) { errno = err; SetLastError(err); }
 #  endif
 #endif
 
+/*
+ * Time between Jan 1, 1601 and Jan 1, 1970 in units of 100 nanoseconds
+ */
+#define PTW32_TIMESPEC_TO_FILETIME_OFFSET \
+	  ( ((int64_t) 27111902 << 32) + (int64_t) 3577643008 )
+
 /*
  * Don't allow the linker to optimize away autostatic.obj in static builds.
  */
 #if defined(PTW32_STATIC_LIB) && defined(PTW32_BUILD)
   void ptw32_autostatic_anchor(void);
-# if defined(PTW32_CONFIG_MINGW)
+# if defined(PTW32_CONFIG_MINGW) || defined(PTW32_HOST)
     __attribute__((unused, used))
 # endif
   static void (*local_autostatic_anchor)(void) = ptw32_autostatic_anchor;
@@ -193,6 +199,9 @@ typedef struct ptw32_mcs_node_t_     ptw32_mcs_local_node_t;
 typedef struct ptw32_mcs_node_t_*    ptw32_mcs_lock_t;
 typedef struct ptw32_robust_node_t_  ptw32_robust_node_t;
 typedef struct ptw32_thread_t_       ptw32_thread_t;
+typedef struct ptw32_lockprof_t_     ptw32_lockprof_t;
+typedef struct ptw32_mutex_waiter_t_ ptw32_mutex_waiter_t;
+typedef struct ptw32_pool_worker_t_  ptw32_pool_worker_t;
 
 struct ptw32_thread_t_
 {
@@ -203,7 +212,9 @@ struct ptw32_thread_t_
   volatile PThreadState state;
   ptw32_mcs_lock_t threadLock;	/* Used for serialised access to public thread state */
   ptw32_mcs_lock_t stateLock;	/* Used for async-cancel safety */
-  HANDLE cancelEvent;
+  volatile LONG cancelRequested; /* Deferred cancel pending; see ptw32_park.c */
+  HANDLE parkEvent;		/* See ptw32_park.c. Kept when the struct is reused */
+  ptw32_cleanup_t * cleanupStack; /* Handlers pushed by the C pthread_cleanup_push() */
   void *exitStatus;
   void *parms;
   void *keys;
@@ -226,9 +237,14 @@ struct ptw32_thread_t_
   int implicit:1;
   DWORD thread;			/* Windows thread ID */
 #if defined(HAVE_CPU_AFFINITY)
-  size_t cpuset;		/* Thread CPU affinity set */
+  size_t cpuset;		/* Thread CPU affinity mask in cpuGroup */
+  int cpuGroup;			/* Processor group; see ptw32_cpugroups.c */
 #endif
   char * name;                  /* Thread name */
+  int rwlockReadHolds;		/* Read locks held on PTHREAD_RWLOCK_PREFER_WRITER_NP rwlocks */
+  ptw32_pool_worker_t * poolWorker; /* Set while the thread is a pool worker */
+  int parallelLevel;		/* pthread_parallel_for_np() loops the thread is running */
+  HANDLE delayTimer;		/* See ptw32_delay.c. Kept when the struct is reused */
 #if defined(_UWIN)
   DWORD dummy[5];
 #endif
@@ -250,7 +266,7 @@ struct pthread_attr_t_
   struct sched_param param;
   int inheritsched;
   int contentionscope;
-  size_t cpuset;
+  cpu_set_t cpuset;
   char * thrname;
 #if defined(HAVE_SIGSET_T)
   sigset_t sigmask;
@@ -270,10 +286,8 @@ struct sem_t_
 {
   int value;
   ptw32_mcs_lock_t lock;
-  HANDLE sem;
-#if defined(NEED_SEM)
-  int leftToUnblock;
-#endif
+  volatile LONG wakeups;	/* Posts owed to blocked threads. Blocked
+				   threads wait on this address. */
 };
 
 #define PTW32_OBJECT_AUTO_INIT ((void *)(size_t) -1)
@@ -292,10 +306,36 @@ struct pthread_mutex_t_
 				   mutexes only). */
   int kind;			/* Mutex type. */
   pthread_t ownerThread;
-  HANDLE event;			/* Mutex release notification to waiting
-				   threads. */
+  HANDLE event;			/* Release notification to threads waiting
+				   on robust mutexes. Other kinds wait on
+				   &lock_idx (see ptw32_park.c). */
   ptw32_robust_node_t*
                     robustNode; /* Extra state for robust mutexes  */
+  ptw32_lockprof_t* prof;       /* Contention profile or NULL if the
+                                   mutex was created while lock
+                                   profiling was off. */
+  ptw32_mcs_lock_t queueLock;   /* Guards the waiter queue (FAIR_NP). */
+  ptw32_mutex_waiter_t*
+                    queueHead;  /* FIFO of blocked threads (FAIR_NP).  */
+  ptw32_mutex_waiter_t*
+                    queueTail;
+  volatile LONG biasHeld;       /* BIASED_NP: held by the bias owner
+                                   (ownerThread) without lock_idx.
+                                   Written only by that thread. */
+  LONG biasRevoked;             /* BIASED_NP: bias withdrawn for good. */
+};
+
+/*
+ * A thread blocked on a PTHREAD_MUTEX_FAIR_NP mutex. Lives on the
+ * waiter's stack. Ownership is handed directly to the head of the
+ * queue by the unlocking thread, which sets 'granted' and unparks
+ * the waiter.
+ */
+struct ptw32_mutex_waiter_t_
+{
+  ptw32_mutex_waiter_t* next;
+  ptw32_thread_t* thread;
+  volatile LONG granted;
 };
 
 enum ptw32_robust_state_t_
@@ -318,6 +358,47 @@ struct ptw32_robust_node_t_
   ptw32_robust_node_t* next;
 };
 
+/*
+ * Lock profiling - see ptw32_lockprof.c
+ *
+ * Durations are accumulated in performance counter ticks. The histograms
+ * are log2 buckets of microseconds: bucket 0 counts durations under 1us,
+ * bucket n counts [2^(n-1), 2^n) us, and the last bucket is open-ended.
+ */
+#define PTW32_LOCKPROF_BUCKETS   24
+#define PTW32_LOCKPROF_SITES      8
+
+enum {
+  PTW32_LOCKPROF_MUTEX          = 0
+};
+
+typedef struct
+{
+  void * addr;                  /* Return address of the acquiring call */
+  unsigned long count;          /* Contended acquires sampled at addr   */
+} ptw32_lockprof_site_t;
+
+struct ptw32_lockprof_t_
+{
+  void * object;		/* The profiled object                  */
+  int type;			/* PTW32_LOCKPROF_MUTEX ...             */
+  int kind;			/* Object kind at creation time         */
+  LONGLONG acquireTime;		/* When the current owner acquired it   */
+  unsigned __int64 nAcquired;	/* Ownership transfers                  */
+  unsigned __int64 nContended;	/* Acquires that had to wait            */
+  LONG nBusy;			/* Failed trylocks (Interlocked)        */
+  unsigned __int64 waitTotal;
+  unsigned __int64 waitMax;
+  unsigned __int64 holdTotal;
+  unsigned __int64 holdMax;
+  unsigned long waitHist[PTW32_LOCKPROF_BUCKETS];
+  unsigned long holdHist[PTW32_LOCKPROF_BUCKETS];
+  ptw32_lockprof_site_t sites[PTW32_LOCKPROF_SITES];
+  unsigned long nOtherSites;	/* Samples that found the table full    */
+  ptw32_lockprof_t * next;	/* Registry links, guarded by           */
+  ptw32_lockprof_t * prev;	/*   ptw32_lockprof_list_lock           */
+};
+
 struct pthread_mutexattr_t_
 {
   int pshared;
@@ -349,7 +430,7 @@ struct pthread_mutexattr_t_
 
 struct pthread_spinlock_t_
 {
-  long interlock;		/* Locking element for multi-cpus. */
+  LONG interlock;		/* Locking element for multi-cpus. */
   union
   {
     int cpus;			/* No. of cpus if multi cpus, or   */
@@ -376,7 +457,8 @@ struct pthread_barrier_t_
   unsigned int nCurrentBarrierHeight;
   unsigned int nInitialBarrierHeight;
   int pshared;
-  sem_t semBarrierBreeched;
+  volatile LONG generation;	/* Bumped each time the barrier opens.
+				   Waiters wait on this address. */
   ptw32_mcs_lock_t lock;
   ptw32_mcs_local_node_t proxynode;
 };
@@ -386,6 +468,54 @@ struct pthread_barrierattr_t_
   int pshared;
 };
 
+typedef struct ptw32_combiner_request_t_ ptw32_combiner_request_t;
+
+/*
+ * An operation published to a combiner. Lives on the requesting
+ * thread's stack until 'done' is set by whichever thread runs it.
+ */
+struct ptw32_combiner_request_t_
+{
+  ptw32_combiner_request_t * next;
+  void *(PTW32_CDECL *op) (void *);
+  void * arg;
+  void * result;
+  volatile LONG done;
+};
+
+struct pthread_combiner_t_
+{
+  ptw32_mcs_lock_t lock;	/* Held by the combining thread. */
+  ptw32_combiner_request_t *
+              pending;		/* Published requests, newest first. */
+};
+
+struct pthread_seqlock_t_
+{
+  volatile LONG sequence;	/* Odd while a writer is active. */
+  pthread_mutex_t writer;	/* Serialises writers. */
+};
+
+/*
+ * Readers spin this many times on an active writer before yielding.
+ */
+#define PTW32_SEQLOCK_SPIN	100
+
+struct pthread_eventcount_t_
+{
+  volatile LONG epoch;		/* Advanced by a notify that finds waiters;
+				   waiters wait on its address. */
+  volatile LONG waiters;	/* Threads between prepare and commit or
+				   cancel. */
+};
+
+struct pthread_latch_t_
+{
+  volatile LONG count;		/* Count downs still needed. Waiters wait
+				   on its address. */
+  volatile LONG waiters;	/* Threads in pthread_latch_wait_np(). */
+};
+
 struct pthread_key_t_
 {
   DWORD key;
@@ -418,10 +548,22 @@ struct pthread_cond_t_
   pthread_mutex_t mtxUnblockLock;	/* Mutex that guards access to          */
   /* | waiters (to)unblock(ed) counts     */
   /* +-> Optional* Sync.LEVEL-2           */
-  pthread_cond_t next;		/* Doubly linked list                   */
+  pthread_cond_t next;		/* Shard list of CVs with timed waiters */
   pthread_cond_t prev;
+  int nTimedWaiters;		/* Listed while > 0; guarded by shard   */
+  volatile LONG generation;	/* Bumped after each signal/broadcast   */
+  int spin;			/* Waiter spins before blocking         */
 };
 
+/*
+ * Condition variable waiters poll the generation counter this many
+ * times before blocking, on multiprocessors only. Define as 0 to
+ * disable.
+ */
+#if !defined(PTW32_COND_SPIN)
+#define PTW32_COND_SPIN		1000
+#endif
+
 
 struct pthread_condattr_t_
 {
@@ -430,6 +572,225 @@ struct pthread_condattr_t_
 
 #define PTW32_RWLOCK_MAGIC 0xfacade2
 
+/*
+ * One reader count per slot of a PTHREAD_RWLOCK_BIGREADER_NP rwlock.
+ * Padded so that no two counts share a cache line.
+ */
+#define PTW32_CACHE_LINE_SIZE 64
+#define PTW32_RWLOCK_MAX_SLOTS 64
+
+typedef struct ptw32_rwlock_slot_t_ ptw32_rwlock_slot_t;
+
+struct ptw32_rwlock_slot_t_
+{
+  volatile LONG readers;
+  char pad[PTW32_CACHE_LINE_SIZE - sizeof(LONG)];
+};
+
+/*
+ * Condition variables with timed waiters are listed in one of
+ * PTW32_COND_SHARDS lists, chosen by address, so that
+ * pthread_timechange_handler_np() can find them. See
+ * pthread_timechange_handler_np.c.
+ */
+#define PTW32_COND_SHARDS 16
+
+typedef struct ptw32_cond_shard_t_ ptw32_cond_shard_t;
+
+struct ptw32_cond_shard_t_
+{
+  ptw32_mcs_lock_t lock;
+  pthread_cond_t head;
+  char pad[PTW32_CACHE_LINE_SIZE - sizeof(ptw32_mcs_lock_t) - sizeof(pthread_cond_t)];
+};
+
+#define PTW32_COND_SHARD(cv) \
+  (&ptw32_cond_shards[((size_t) (cv) >> 6) & (PTW32_COND_SHARDS - 1)])
+
+/*
+ * Threads waiting for the value at an address to change are queued
+ * in one of PTW32_WAIT_TABLE_SIZE buckets, chosen by address. The
+ * nodes live on the waiters' stacks. See ptw32_park.c.
+ */
+#define PTW32_WAIT_TABLE_SIZE 256
+
+typedef struct ptw32_wait_node_t_ ptw32_wait_node_t;
+
+struct ptw32_wait_node_t_
+{
+  ptw32_wait_node_t * next;
+  ptw32_wait_node_t * prev;
+  volatile LONG * address;
+  ptw32_thread_t * thread;
+  volatile LONG woken;
+};
+
+typedef struct ptw32_wait_bucket_t_ ptw32_wait_bucket_t;
+
+struct ptw32_wait_bucket_t_
+{
+  ptw32_mcs_lock_t lock;
+  ptw32_wait_node_t * head;
+  ptw32_wait_node_t * tail;
+  char pad[PTW32_CACHE_LINE_SIZE - sizeof(ptw32_mcs_lock_t) - 2 * sizeof(ptw32_wait_node_t *)];
+};
+
+#define PTW32_WAIT_BUCKET(addr) \
+  (&ptw32_wait_table[((size_t) (addr) >> 4) & (PTW32_WAIT_TABLE_SIZE - 1)])
+
+/*
+ * Thread pools. Each worker owns a work-stealing deque of tasks;
+ * tasks submitted from outside the pool go on a shared queue. See
+ * ptw32_pool.c.
+ */
+#define PTW32_POOL_DEQUE_SIZE	256	/* Initial deque size, power of 2 */
+#define PTW32_POOL_INJECT_BATCH	32	/* Tasks moved per visit to the shared queue */
+#define PTW32_POOL_IDLE_MSECS	1000	/* Idle time before surplus workers exit */
+
+typedef struct ptw32_pool_task_t_ ptw32_pool_task_t;
+
+struct ptw32_pool_task_t_
+{
+  void (PTW32_CDECL *routine) (void *);
+  void * arg;
+};
+
+typedef struct ptw32_pool_array_t_ ptw32_pool_array_t;
+
+struct ptw32_pool_array_t_
+{
+  LONG mask;			/* Number of tasks - 1 */
+  ptw32_pool_array_t * retired;	/* Smaller arrays this one replaced;
+				   thieves may still be reading them. */
+  ptw32_pool_task_t tasks[1];
+};
+
+enum
+{
+  PTW32_POOL_WORKER_FREE = 0,	/* Slot never used */
+  PTW32_POOL_WORKER_STARTING,	/* Claimed by a thread creating a worker */
+  PTW32_POOL_WORKER_RUNNING,
+  PTW32_POOL_WORKER_RETIRED	/* Worker exited; its thread must be joined */
+};
+
+struct ptw32_pool_worker_t_
+{
+  volatile LONG top;		/* Thieves take from here */
+  char pad1[PTW32_CACHE_LINE_SIZE - sizeof(LONG)];
+  volatile LONG bottom;		/* The owner pushes and pops here */
+  ptw32_pool_array_t * volatile array;
+  pthread_pool_t pool;
+  pthread_t thread;
+  volatile LONG state;
+  unsigned int seed;		/* Chooses steal victims */
+  char pad2[PTW32_CACHE_LINE_SIZE];
+};
+
+struct pthread_pool_t_
+{
+  ptw32_pool_worker_t * workers; /* maxThreads slots */
+  int minThreads;
+  int maxThreads;
+  volatile LONG nThreads;	/* Workers running or starting */
+  pthread_attr_t attr;		/* Used to create the workers */
+  ptw32_mcs_lock_t injectLock;	/* Guards the shared queue */
+  ptw32_pool_task_t * inject;	/* Shared queue; a ring of injectSize */
+  LONG injectHead;
+  LONG injectSize;
+  volatile LONG injected;	/* Tasks in the shared queue */
+  volatile LONG pending;	/* Tasks submitted and not yet finished */
+  volatile LONG shutdown;
+  pthread_eventcount_t wakeup;	/* Idle workers wait here */
+  pthread_eventcount_t idle;	/* pthread_pool_wait_idle_np() waits here */
+};
+
+/*
+ * One pthread_parallel_for_np() loop. It lives on the calling thread's
+ * stack and is shared with helper tasks run by a library-wide pool.
+ * See ptw32_parallel.c.
+ */
+#define PTW32_PARALLEL_DYNAMIC_CHUNKS	8	/* Chunks per thread when grain is 0 */
+#define PTW32_PARALLEL_GUIDED_DIVISOR	2	/* Guided chunk is remaining / (this * threads) */
+#define PTW32_PARALLEL_SUBMIT_BATCH	16	/* Helper tasks queued per lock */
+
+typedef struct ptw32_parallel_job_t_ ptw32_parallel_job_t;
+
+struct ptw32_parallel_job_t_
+{
+  long begin;
+  unsigned long count;		/* Iterations */
+  unsigned long grain;		/* Chunk size; 0 for equal static shares */
+  unsigned long chunks;		/* Number of grain-sized chunks */
+  void (PTW32_CDECL *routine) (long, long, void *);
+  void * arg;
+  int policy;
+  int nThreads;			/* Threads taking part, including the caller */
+  volatile LONG nextId;		/* Static shares claimed so far */
+  volatile LONG helpers;	/* Helper tasks not yet finished */
+  char pad[PTW32_CACHE_LINE_SIZE];
+  volatile LONG cursor;		/* Next chunk (dynamic) or offset (guided) */
+};
+
+/*
+ * Precise delays sleep until ptw32_delay_slack ns before they are due
+ * and spin the rest. The slack follows how late sleeps wake, within
+ * these bounds. See ptw32_delay.c.
+ */
+#define PTW32_DELAY_SLACK_INIT	1000000
+#define PTW32_DELAY_SLACK_MIN	20000
+#define PTW32_DELAY_SLACK_MAX	20000000
+
+/*
+ * POSIX timers. Armed timers hang in a hierarchical timer wheel run by
+ * one service thread; notifications run on a pool. See ptw32_timer.c.
+ */
+#define PTW32_TIMER_TICK_SHIFT	20	/* A wheel tick is 2^20 ns, about 1 ms */
+#define PTW32_TIMER_LEVEL_SHIFT	6
+#define PTW32_TIMER_LEVEL_SIZE	(1 << PTW32_TIMER_LEVEL_SHIFT)
+#define PTW32_TIMER_LEVEL_MASK	(PTW32_TIMER_LEVEL_SIZE - 1)
+#define PTW32_TIMER_LEVELS	5	/* 2^30 ticks, about 35 years */
+#define PTW32_TIMER_NOTIFY_THREADS 16	/* Most notifications run at once */
+#define PTW32_TIMER_NEVER	((LONGLONG) 0x7FFFFFFF << 32)
+
+typedef struct ptw32_timer_t_ ptw32_timer_t;
+
+struct ptw32_timer_t_
+{
+  ptw32_timer_t * next;		/* Wheel slot list */
+  ptw32_timer_t ** prev;	/* Link that points here; NULL if not armed */
+  ptw32_timer_t * fireNext;	/* Notifications the service thread is starting */
+  int level;
+  int slot;
+  LONGLONG expires;		/* Monotonic ns */
+  LONGLONG interval;		/* ns; 0 for a one-shot timer */
+  clockid_t clock;
+  int notify;			/* SIGEV_NONE or SIGEV_THREAD */
+  void (PTW32_CDECL *function) (union sigval);
+  union sigval value;
+  pthread_attr_t attr;		/* Notification thread attributes, or NULL
+				   to use the service's pool */
+  int notifying;		/* A notification is queued or running */
+  int deleted;			/* Free when the notification finishes */
+  int overrun;			/* For timer_getoverrun() */
+  int pendingOverrun;		/* Expirations missed since the last notification */
+};
+
+typedef struct ptw32_timer_wheel_t_ ptw32_timer_wheel_t;
+
+struct ptw32_timer_wheel_t_
+{
+  ptw32_mcs_lock_t lock;	/* Guards everything below and every timer */
+  int started;
+  LONGLONG tick;		/* Next tick to run */
+  LONGLONG wakeTick;		/* When the service thread wakes next */
+  long count;			/* Timers in the wheel */
+  unsigned __int64 occupied[PTW32_TIMER_LEVELS]; /* Non-empty slots */
+  ptw32_timer_t * slots[PTW32_TIMER_LEVELS][PTW32_TIMER_LEVEL_SIZE];
+  HANDLE wakeEvent;		/* Set when an earlier timer is armed */
+  HANDLE waitableTimer;		/* NULL if none could be created */
+  pthread_pool_t pool;		/* Runs notifications */
+};
+
 struct pthread_rwlock_t_
 {
   pthread_mutex_t mtxExclusiveAccess;
@@ -439,18 +800,49 @@ struct pthread_rwlock_t_
   int nExclusiveAccessCount;
   int nCompletedSharedAccessCount;
   int nMagic;
+  int kind;
+  ptw32_rwlock_slot_t * slots;	/* PTHREAD_RWLOCK_BIGREADER_NP only */
+  int nSlots;			/* Power of 2 */
+  volatile LONG writerActive;	/* A writer holds or is draining readers */
+  HANDLE drained;		/* Set by readers leaving while writerActive */
+  volatile LONG state;		/* PTHREAD_RWLOCK_PREFER_*_NP only: see below */
+  ptw32_mcs_lock_t stateLock;	/* Guards the waiter counts */
+  int nReadersWaiting;
+  int nWritersWaiting;
+  int nReadersSignalled;	/* Outstanding readerSema counts */
+  int nWritersSignalled;	/* Outstanding writerSema counts */
+  HANDLE readerSema;
+  HANDLE writerSema;
+  int upgrading;		/* A reader is in pthread_rwlock_upgrade_np() */
+  HANDLE upgradeEvent;
 };
 
+/*
+ * pthread_rwlock_t_.state bits for the PTHREAD_RWLOCK_PREFER_*_NP kinds.
+ * The reader count is held in the bits above PTW32_RWLOCK_WAITING.
+ */
+#define PTW32_RWLOCK_WRITER   0x1	/* A writer holds the lock */
+#define PTW32_RWLOCK_WAITING  0x2	/* Threads are waiting: unlock must wake */
+#define PTW32_RWLOCK_READER   0x4	/* One reader */
+
 struct pthread_rwlockattr_t_
 {
   int pshared;
+  int kind;
 };
 
-typedef union
+/*
+ * Processor groups; see ptw32_cpugroups.c. ptw32_group_affinity_t has
+ * the layout of GROUP_AFFINITY, which older headers don't define.
+ */
+#define PTW32_MAX_CPU_GROUPS 32
+
+typedef struct
 {
-  char cpuset[CPU_SETSIZE/8];
-  size_t _cpuset;
-} _sched_cpu_set_vector_;
+  DWORD_PTR Mask;
+  WORD Group;
+  WORD Reserved[3];
+} ptw32_group_affinity_t;
 
 typedef struct ThreadKeyAssoc ThreadKeyAssoc;
 
@@ -621,10 +1013,54 @@ struct ThreadKeyAssoc
 #define PTW32_MAX(a,b)  ((a)<(b)?(b):(a))
 #define PTW32_MIN(a,b)  ((a)>(b)?(b):(a))
 
+/*
+ * The address that the enclosing function will return to, i.e. the
+ * call site of a public API routine. Used by the lock profiler.
+ */
+#if defined(__GNUC__)
+#  define PTW32_RETURN_ADDRESS() __builtin_return_address(0)
+#elif defined(_MSC_VER) && _MSC_VER >= 1400
+#  include <intrin.h>
+#  pragma intrinsic(_ReturnAddress)
+#  define PTW32_RETURN_ADDRESS() _ReturnAddress()
+#else
+#  define PTW32_RETURN_ADDRESS() NULL
+#endif
+
+/*
+ * Stops the compiler moving memory accesses across this point. On x86
+ * and x64 that is enough to give plain loads acquire and plain stores
+ * release ordering; other targets get a full fence.
+ */
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#  if defined(__GNUC__)
+#    define PTW32_COMPILER_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+#  elif defined(_MSC_VER)
+#    include <intrin.h>
+#    pragma intrinsic(_ReadWriteBarrier)
+#    define PTW32_COMPILER_BARRIER() _ReadWriteBarrier()
+#  else
+#    define PTW32_COMPILER_BARRIER() MemoryBarrier()
+#  endif
+#else
+#  define PTW32_COMPILER_BARRIER() MemoryBarrier()
+#endif
+
 
 /* Declared in pthread_cancel.c */
 extern DWORD (*ptw32_register_cancellation) (PAPCFUNC, HANDLE, DWORD);
 
+/* Declared in global.c. NULL if the system doesn't provide it. */
+extern DWORD (WINAPI *ptw32_get_processor_number) (VOID);
+
+/* Declared in global.c. Set up by ptw32_cpu_groups_init(). */
+extern int ptw32_cpu_groups;
+extern int ptw32_cpu_group_first[PTW32_MAX_CPU_GROUPS + 1];
+extern DWORD_PTR ptw32_cpu_group_active[PTW32_MAX_CPU_GROUPS];
+extern BOOL (WINAPI *ptw32_get_process_group_affinity) (HANDLE, WORD *, WORD *);
+extern BOOL (WINAPI *ptw32_get_thread_group_affinity) (HANDLE, ptw32_group_affinity_t *);
+extern BOOL (WINAPI *ptw32_set_thread_group_affinity) (HANDLE, const ptw32_group_affinity_t *, ptw32_group_affinity_t *);
+
 /* Thread Reuse stack bottom marker. Must not be NULL or any valid pointer to memory. */
 #define PTW32_THREAD_REUSE_EMPTY ((ptw32_thread_t *)(size_t) 1)
 
@@ -632,9 +1068,8 @@ extern int ptw32_processInitialized;
 extern ptw32_thread_t * ptw32_threadReuseTop;
 extern ptw32_thread_t * ptw32_threadReuseBottom;
 extern pthread_key_t ptw32_selfThreadKey;
-extern pthread_key_t ptw32_cleanupKey;
-extern pthread_cond_t ptw32_cond_list_head;
-extern pthread_cond_t ptw32_cond_list_tail;
+extern ptw32_cond_shard_t ptw32_cond_shards[PTW32_COND_SHARDS];
+extern ptw32_wait_bucket_t ptw32_wait_table[PTW32_WAIT_TABLE_SIZE];
 
 extern int ptw32_mutex_default_kind;
 
@@ -646,11 +1081,25 @@ extern int ptw32_features;
 
 extern ptw32_mcs_lock_t ptw32_thread_reuse_lock;
 extern ptw32_mcs_lock_t ptw32_mutex_test_init_lock;
-extern ptw32_mcs_lock_t ptw32_cond_list_lock;
 extern ptw32_mcs_lock_t ptw32_cond_test_init_lock;
 extern ptw32_mcs_lock_t ptw32_rwlock_test_init_lock;
 extern ptw32_mcs_lock_t ptw32_spinlock_test_init_lock;
 
+extern int ptw32_lockprof_enabled;
+extern int ptw32_lockprof_sample;
+extern LONGLONG ptw32_lockprof_frequency;
+extern ptw32_lockprof_t * ptw32_lockprof_list_head;
+extern ptw32_mcs_lock_t ptw32_lockprof_list_lock;
+
+extern LONGLONG ptw32_clock_frequency;
+extern ptw32_timer_wheel_t ptw32_timer_wheel;
+extern int ptw32_delay_mode;
+extern volatile LONG ptw32_delay_slack;
+
+extern pthread_pool_t ptw32_parallel_team;
+extern volatile LONG ptw32_parallel_team_size;
+extern ptw32_mcs_lock_t ptw32_parallel_team_lock;
+
 #if defined(_UWIN)
 extern int pthread_count;
 #endif
@@ -675,6 +1124,36 @@ extern "C"
   int ptw32_rwlock_check_need_init (pthread_rwlock_t * rwlock);
   int ptw32_spinlock_check_need_init (pthread_spinlock_t * lock);
 
+  int ptw32_mutex_fair_wait (pthread_mutex_t mx, const struct timespec * abstime);
+  int ptw32_mutex_fair_release (pthread_mutex_t mx);
+  int ptw32_mutex_bias_acquired (pthread_mutex_t mx, pthread_t self, int wait);
+
+  int ptw32_rwlock_bigreader_init (pthread_rwlock_t rwl);
+  void ptw32_rwlock_bigreader_destroy (pthread_rwlock_t rwl);
+  int ptw32_rwlock_bigreader_busy (pthread_rwlock_t rwl);
+  int ptw32_rwlock_bigreader_rdlock (pthread_rwlock_t rwl,
+                                     const struct timespec * abstime,
+                                     int trylock);
+  int ptw32_rwlock_bigreader_wrlock (pthread_rwlock_t rwl,
+                                     const struct timespec * abstime,
+                                     int trylock);
+  int ptw32_rwlock_bigreader_unlock (pthread_rwlock_t rwl);
+  int ptw32_rwlock_bigreader_upgrade (pthread_rwlock_t rwl);
+  int ptw32_rwlock_bigreader_downgrade (pthread_rwlock_t rwl);
+
+  int ptw32_rwlock_prefer_init (pthread_rwlock_t rwl);
+  void ptw32_rwlock_prefer_destroy (pthread_rwlock_t rwl);
+  int ptw32_rwlock_prefer_busy (pthread_rwlock_t rwl);
+  int ptw32_rwlock_prefer_rdlock (pthread_rwlock_t rwl,
+                                  const struct timespec * abstime,
+                                  int trylock);
+  int ptw32_rwlock_prefer_wrlock (pthread_rwlock_t rwl,
+                                  const struct timespec * abstime,
+                                  int trylock);
+  int ptw32_rwlock_prefer_unlock (pthread_rwlock_t rwl);
+  int ptw32_rwlock_prefer_upgrade (pthread_rwlock_t rwl);
+  int ptw32_rwlock_prefer_downgrade (pthread_rwlock_t rwl);
+
   int ptw32_robust_mutex_inherit(pthread_mutex_t * mutex);
   void ptw32_robust_mutex_add(pthread_mutex_t* mutex, pthread_t self);
   void ptw32_robust_mutex_remove(pthread_mutex_t* mutex, ptw32_thread_t* otp);
@@ -699,10 +1178,108 @@ extern "C"
 
   int ptw32_getprocessors (int *count);
 
+  void ptw32_cpu_groups_init (void);
+
+  int ptw32_popcount (size_t word);
+
+  DWORD_PTR ptw32_cpuset_get_group (size_t setsize, const cpu_set_t * set, int group);
+
+  int ptw32_cpuset_put_group (size_t setsize, cpu_set_t * set, int group, DWORD_PTR mask);
+
+  int ptw32_cpuset_next_group (size_t setsize, const cpu_set_t * set, DWORD_PTR * mask);
+
+  int ptw32_process_group_affinity (HANDLE process, int group, DWORD_PTR * mask);
+
+  int ptw32_get_thread_affinity (HANDLE threadH, int * group, DWORD_PTR * mask);
+
+  int ptw32_set_thread_affinity (HANDLE threadH, int group, DWORD_PTR mask);
+
+  HANDLE ptw32_lazy_event (HANDLE * handle);
+
+  HANDLE ptw32_lazy_semaphore (HANDLE * handle, LONG maximum);
+
+  ptw32_thread_t * ptw32_park_self (void);
+
+  int ptw32_park (ptw32_thread_t * sp, DWORD milliseconds, int cancelable);
+
+  void ptw32_unpark (ptw32_thread_t * sp);
+
+  int ptw32_wait_on_address (volatile LONG * address, LONG expected,
+                             DWORD milliseconds, int cancelable);
+
+  int ptw32_wake_address (volatile LONG * address, int count);
+
+  int ptw32_sem_block (sem_t s, const struct timespec * abstime, int cancelable);
+
+  int ptw32_eventcount_wait (pthread_eventcount_t ec, unsigned int key,
+                             DWORD milliseconds, int cancelable);
+
+  int ptw32_eventcount_notify (pthread_eventcount_t ec, int count);
+
+  ptw32_pool_worker_t * ptw32_pool_self (pthread_pool_t pool);
+
+  int ptw32_pool_reserve (ptw32_pool_worker_t * w, LONG count);
+
+  int ptw32_pool_push (ptw32_pool_worker_t * w, const ptw32_pool_task_t * task);
+
+  int ptw32_pool_inject (pthread_pool_t pool, const ptw32_pool_task_t * tasks, int count);
+
+  int ptw32_pool_spawn (pthread_pool_t pool);
+
+  void ptw32_pool_wake (pthread_pool_t pool, int count);
+
+  void ptw32_pool_free (pthread_pool_t pool);
+
+  pthread_pool_t ptw32_parallel_get_team (int * size);
+
+  void ptw32_parallel_run (ptw32_parallel_job_t * job);
+
+  void PTW32_CDECL ptw32_parallel_helper (void * arg);
+
+  void PTW32_CDECL ptw32_parallel_finish (void * arg);
+
+  LONGLONG ptw32_clock_ns (clockid_t clock_id);
+
+  LONGLONG ptw32_timespec_to_ns (const struct timespec * ts);
+
+  void ptw32_ns_to_timespec (LONGLONG ns, struct timespec * ts);
+
+  HANDLE ptw32_clock_timer (void);
+
+  int ptw32_timer_start (void);
+
+  void ptw32_timer_arm (ptw32_timer_t * t);
+
+  void ptw32_timer_disarm (ptw32_timer_t * t);
+
+  void ptw32_timer_remaining (ptw32_timer_t * t, LONGLONG now, struct itimerspec * value);
+
+  void ptw32_timer_free (ptw32_timer_t * t);
+
+  int ptw32_delay (LONGLONG deadline, int precise);
+
   int ptw32_setthreadpriority (pthread_t thread, int policy, int priority);
 
   void ptw32_rwlock_cancelwrwait (void *arg);
 
+  LONGLONG ptw32_lockprof_now (void);
+
+  int ptw32_lockprof_attach (void * object, int type, int kind, ptw32_lockprof_t ** prof);
+
+  void ptw32_lockprof_detach (ptw32_lockprof_t * prof);
+
+  void ptw32_lockprof_acquired (pthread_mutex_t mx, LONGLONG waitStart, void * caller);
+
+  void ptw32_lockprof_released (pthread_mutex_t mx);
+
+  void ptw32_lockprof_busy (pthread_mutex_t mx);
+
+  int ptw32_lockprof_dump (const char * path, int top);
+
+  void ptw32_lockprof_initialize (void);
+
+  void ptw32_lockprof_terminate (void);
+
 #if ! defined (PTW32_CONFIG_MINGW) || (defined (__MSVCRT__) && ! defined (__DMC__))
   unsigned __stdcall
 #else
@@ -821,7 +1398,65 @@ extern "C"
 # define PTW32_TO_VLONG64PTR(ptr) (ptr)
 #endif
 
-#if defined(__GNUC__)
+/*
+ * GCC 4.7 and later (and clang) also have __atomic builtins that take a
+ * memory order. They are used when config.h defines
+ * HAVE_GCC_ATOMIC_BUILTINS, and always for targets other than x86 and
+ * x64, which the inline assembler below is written for.
+ */
+#if defined(__GNUC__) && defined(__ATOMIC_SEQ_CST) \
+    && (defined(HAVE_GCC_ATOMIC_BUILTINS) || !(defined(__i386__) || defined(__x86_64__)))
+# define PTW32_ATOMIC_BUILTINS
+#endif
+
+#if defined(PTW32_ATOMIC_BUILTINS)
+/*
+ * Interlocked operations are full barriers, so these are all
+ * sequentially consistent. 'comparand' is copied to a non-volatile
+ * temporary of the location's type, which receives the old value.
+ */
+# if defined(_WIN64)
+# define PTW32_INTERLOCKED_COMPARE_EXCHANGE_64(location, value, comparand) \
+    ({                                                                     \
+      __typeof (*(location) + 0) _result = (comparand);                    \
+      (void) __atomic_compare_exchange_n ((location), &_result, (value),   \
+                                          0, __ATOMIC_SEQ_CST,             \
+                                          __ATOMIC_SEQ_CST);               \
+      _result;                                                             \
+    })
+# define PTW32_INTERLOCKED_EXCHANGE_64(location, value)                    \
+    __atomic_exchange_n ((location), (value), __ATOMIC_SEQ_CST)
+# define PTW32_INTERLOCKED_EXCHANGE_ADD_64(location, value)                \
+    __atomic_fetch_add ((location), (value), __ATOMIC_SEQ_CST)
+# define PTW32_INTERLOCKED_INCREMENT_64(location)                          \
+    __atomic_add_fetch ((location), 1, __ATOMIC_SEQ_CST)
+# define PTW32_INTERLOCKED_DECREMENT_64(location)                          \
+    __atomic_sub_fetch ((location), 1, __ATOMIC_SEQ_CST)
+# endif
+# define PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(location, value, comparand) \
+    ({                                                                     \
+      __typeof (*(location) + 0) _result = (comparand);                    \
+      (void) __atomic_compare_exchange_n ((location), &_result, (value),   \
+                                          0, __ATOMIC_SEQ_CST,             \
+                                          __ATOMIC_SEQ_CST);               \
+      _result;                                                             \
+    })
+# define PTW32_INTERLOCKED_EXCHANGE_LONG(location, value)                  \
+    __atomic_exchange_n ((location), (value), __ATOMIC_SEQ_CST)
+# define PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(location, value)              \
+    __atomic_fetch_add ((location), (value), __ATOMIC_SEQ_CST)
+# define PTW32_INTERLOCKED_INCREMENT_LONG(location)                        \
+    __atomic_add_fetch ((location), 1, __ATOMIC_SEQ_CST)
+# define PTW32_INTERLOCKED_DECREMENT_LONG(location)                        \
+    __atomic_sub_fetch ((location), 1, __ATOMIC_SEQ_CST)
+# define PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR(location, value, comparand) \
+    PTW32_INTERLOCKED_COMPARE_EXCHANGE_SIZE((PTW32_INTERLOCKED_SIZEPTR)location, \
+                                            (PTW32_INTERLOCKED_SIZE)value, \
+                                            (PTW32_INTERLOCKED_SIZE)comparand)
+# define PTW32_INTERLOCKED_EXCHANGE_PTR(location, value) \
+    PTW32_INTERLOCKED_EXCHANGE_SIZE((PTW32_INTERLOCKED_SIZEPTR)location, \
+                                    (PTW32_INTERLOCKED_SIZE)value)
+#elif defined(__GNUC__)
 # if defined(_WIN64)
 # define PTW32_INTERLOCKED_COMPARE_EXCHANGE_64(location, value, comparand) \
     ({                                                                     \
@@ -990,6 +1625,86 @@ extern "C"
 #   define PTW32_INTERLOCKED_DECREMENT_SIZE(p) PTW32_INTERLOCKED_DECREMENT_LONG((p))
 #endif
 
+/*
+ * Ordered atomic operations, for paths where a full barrier is more
+ * than is needed. The LONG forms take a PTW32_INTERLOCKED_LONGPTR and
+ * the _PTR forms a PTW32_INTERLOCKED_PVOID_PTR.
+ *
+ * ACQUIRE: later memory accesses can't move before the operation.
+ * RELEASE: earlier memory accesses can't move after it.
+ * RELAXED: atomic, but no ordering.
+ *
+ * With __atomic builtins each maps to the builtin with that order. On
+ * x86 and x64 plain loads and stores already have acquire and release
+ * ordering in hardware, so they only need a compiler barrier; elsewhere
+ * PTW32_COMPILER_BARRIER() is a full fence. Read-modify-write forms
+ * fall back to the full barrier Interlocked operations.
+ *
+ * PTW32_ATOMIC_THREAD_FENCE() orders a preceding RELEASE operation
+ * before later loads, as a futex style wake needs before it looks for
+ * waiters. The fallbacks above are strong enough that it does nothing
+ * for them.
+ */
+#if defined(PTW32_ATOMIC_BUILTINS)
+# define PTW32_ATOMIC_LOAD_ACQUIRE(p) \
+    __atomic_load_n ((p), __ATOMIC_ACQUIRE)
+# define PTW32_ATOMIC_LOAD_RELAXED(p) \
+    __atomic_load_n ((p), __ATOMIC_RELAXED)
+# define PTW32_ATOMIC_STORE_RELEASE(p, v) \
+    __atomic_store_n ((p), (v), __ATOMIC_RELEASE)
+# define PTW32_ATOMIC_STORE_RELAXED(p, v) \
+    __atomic_store_n ((p), (v), __ATOMIC_RELAXED)
+# define PTW32_ATOMIC_EXCHANGE_RELEASE(p, v) \
+    __atomic_exchange_n ((p), (v), __ATOMIC_RELEASE)
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_ACQUIRE(p, v, c) \
+    ({                                                                     \
+      __typeof (*(p) + 0) _result = (c);                                   \
+      (void) __atomic_compare_exchange_n ((p), &_result, (v), 0,           \
+                                          __ATOMIC_ACQUIRE,                \
+                                          __ATOMIC_RELAXED);               \
+      _result;                                                             \
+    })
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_RELEASE(p, v, c) \
+    ({                                                                     \
+      __typeof (*(p) + 0) _result = (c);                                   \
+      (void) __atomic_compare_exchange_n ((p), &_result, (v), 0,           \
+                                          __ATOMIC_RELEASE,                \
+                                          __ATOMIC_RELAXED);               \
+      _result;                                                             \
+    })
+# define PTW32_ATOMIC_LOAD_ACQUIRE_PTR(p) \
+    ((PTW32_INTERLOCKED_PVOID) PTW32_ATOMIC_LOAD_ACQUIRE ((PTW32_INTERLOCKED_SIZEPTR) (p)))
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_RELEASE_PTR(p, v, c) \
+    ((PTW32_INTERLOCKED_PVOID) PTW32_ATOMIC_COMPARE_EXCHANGE_RELEASE ((PTW32_INTERLOCKED_SIZEPTR) (p), \
+                                                                      (PTW32_INTERLOCKED_SIZE) (v), \
+                                                                      (PTW32_INTERLOCKED_SIZE) (c)))
+# define PTW32_ATOMIC_THREAD_FENCE() __atomic_thread_fence (__ATOMIC_SEQ_CST)
+#else
+# if defined(__GNUC__)
+#  define PTW32_ATOMIC_LOAD_ACQUIRE(p) \
+    ({ __typeof (*(p) + 0) _v = *(p); PTW32_COMPILER_BARRIER (); _v; })
+#  define PTW32_ATOMIC_LOAD_ACQUIRE_PTR(p) \
+    ((PTW32_INTERLOCKED_PVOID) PTW32_ATOMIC_LOAD_ACQUIRE ((PTW32_INTERLOCKED_SIZEPTR) (p)))
+# else
+   /* No statement expressions: read with a no-op Interlocked add. */
+#  define PTW32_ATOMIC_LOAD_ACQUIRE(p) \
+    PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((p), 0)
+#  define PTW32_ATOMIC_LOAD_ACQUIRE_PTR(p) \
+    ((PTW32_INTERLOCKED_PVOID) PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE ((PTW32_INTERLOCKED_SIZEPTR) (p), 0))
+# endif
+# define PTW32_ATOMIC_LOAD_RELAXED(p) (*(p))
+# define PTW32_ATOMIC_STORE_RELEASE(p, v) \
+    do { PTW32_COMPILER_BARRIER (); *(p) = (v); } while (0)
+# define PTW32_ATOMIC_STORE_RELAXED(p, v) \
+    do { *(p) = (v); } while (0)
+# define PTW32_ATOMIC_EXCHANGE_RELEASE(p, v) PTW32_INTERLOCKED_EXCHANGE_LONG ((p), (v))
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_ACQUIRE(p, v, c) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((p), (v), (c))
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_RELEASE(p, v, c) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((p), (v), (c))
+# define PTW32_ATOMIC_COMPARE_EXCHANGE_RELEASE_PTR(p, v, c) \
+    PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((p), (v), (c))
+# define PTW32_ATOMIC_THREAD_FENCE()
+#endif
+
 #if defined(NEED_CREATETHREAD)
 
 /*
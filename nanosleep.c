@@ -0,0 +1,101 @@
+/*
+ * nanosleep.c
+ *
+ * Description:
+ * This translation unit implements POSIX sleep primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+nanosleep (const struct timespec * rqtp, struct timespec * rmtp)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Suspends the calling thread for an interval.
+      *
+      * PARAMETERS
+      *      rqtp
+      *              the interval
+      *
+      *      rmtp
+      *              not used: the sleep can't be interrupted
+      *
+      * DESCRIPTION
+      *      This function suspends the calling thread for at least
+      *      the interval 'rqtp', measured on CLOCK_MONOTONIC, as
+      *      pthread_delay_np() does and in the mode set by
+      *      pthread_setdelaymode_np(). Signals aren't supported,
+      *      so it never fails with EINTR and '*rmtp' is never set.
+      *
+      *      This function is a cancellation point.
+      *
+      * RESULTS
+      *              0               slept for the interval,
+      *              -1              failed, error in errno:
+      *
+      *              EINVAL          'rqtp' is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+
+  if (rqtp == NULL
+      || rqtp->tv_sec < 0
+      || rqtp->tv_nsec < 0
+      || rqtp->tv_nsec >= 1000000000)
+    {
+      PTW32_SET_ERRNO (EINVAL);
+      return -1;
+    }
+
+  pthread_testcancel ();
+
+  result = ptw32_delay (ptw32_clock_ns (CLOCK_MONOTONIC) + ptw32_timespec_to_ns (rqtp),
+                        ptw32_delay_mode == PTHREAD_DELAY_PRECISE_NP);
+
+  if (result != 0)
+    {
+      PTW32_SET_ERRNO (result);
+      return -1;
+    }
+
+  return 0;
+}				/* nanosleep */
@@ -59,14 +59,28 @@
 #include "ptw32_timespec.c"
 #include "ptw32_throw.c"
 #include "ptw32_getprocessors.c"
+#include "ptw32_cpugroups.c"
+#include "ptw32_lazy_handle.c"
+#include "ptw32_lockprof.c"
 #include "ptw32_calloc.c"
 #include "ptw32_new.c"
+#include "ptw32_park.c"
+#include "ptw32_eventcount.c"
+#include "ptw32_pool.c"
+#include "ptw32_parallel.c"
+#include "ptw32_clock.c"
+#include "ptw32_timer.c"
+#include "ptw32_delay.c"
 #include "ptw32_reuse.c"
 #include "ptw32_relmillisecs.c"
 #include "ptw32_cond_check_need_init.c"
 #include "ptw32_mutex_check_need_init.c"
+#include "ptw32_mutex_bias.c"
+#include "ptw32_mutex_fair.c"
 #include "ptw32_rwlock_check_need_init.c"
 #include "ptw32_rwlock_cancelwrwait.c"
+#include "ptw32_rwlock_bigreader.c"
+#include "ptw32_rwlock_prefer.c"
 #include "ptw32_spinlock_check_need_init.c"
 #include "pthread_attr_init.c"
 #include "pthread_attr_destroy.c"
@@ -89,6 +103,32 @@
 #include "pthread_barrierattr_destroy.c"
 #include "pthread_barrierattr_setpshared.c"
 #include "pthread_barrierattr_getpshared.c"
+#include "pthread_combiner_init_np.c"
+#include "pthread_combiner_destroy_np.c"
+#include "pthread_combiner_execute_np.c"
+#include "pthread_seqlock_init_np.c"
+#include "pthread_seqlock_destroy_np.c"
+#include "pthread_seqlock_read_begin_np.c"
+#include "pthread_seqlock_read_retry_np.c"
+#include "pthread_seqlock_write_lock_np.c"
+#include "pthread_seqlock_write_unlock_np.c"
+#include "pthread_eventcount_init_np.c"
+#include "pthread_eventcount_destroy_np.c"
+#include "pthread_eventcount_prepare_wait_np.c"
+#include "pthread_eventcount_commit_wait_np.c"
+#include "pthread_eventcount_cancel_wait_np.c"
+#include "pthread_eventcount_notify_np.c"
+#include "pthread_latch_init_np.c"
+#include "pthread_latch_destroy_np.c"
+#include "pthread_latch_count_down_np.c"
+#include "pthread_latch_wait_np.c"
+#include "pthread_latch_try_wait_np.c"
+#include "pthread_pool_init_np.c"
+#include "pthread_pool_destroy_np.c"
+#include "pthread_pool_submit_np.c"
+#include "pthread_pool_submit_batch_np.c"
+#include "pthread_pool_wait_idle_np.c"
+#include "pthread_parallel_for_np.c"
 #include "pthread_setcancelstate.c"
 #include "pthread_setcanceltype.c"
 #include "pthread_testcancel.c"
@@ -134,11 +174,16 @@
 #include "pthread_mutexattr_getkind_np.c"
 #include "pthread_getw32threadhandle_np.c"
 #include "pthread_getunique_np.c"
+#include "pthread_lockprof_np.c"
 #include "pthread_timedjoin_np.c"
 #include "pthread_tryjoin_np.c"
 #include "pthread_setaffinity.c"
 #include "pthread_delay_np.c"
+#include "pthread_setdelaymode_np.c"
+#include "pthread_getdelaymode_np.c"
 #include "pthread_num_processors_np.c"
+#include "pthread_wait_on_address_np.c"
+#include "pthread_wake_address_np.c"
 #include "pthread_win32_attach_detach_np.c"
 #include "pthread_timechange_handler_np.c"
 #include "pthread_rwlock_init.c"
@@ -147,9 +192,13 @@
 #include "pthread_rwlockattr_destroy.c"
 #include "pthread_rwlockattr_getpshared.c"
 #include "pthread_rwlockattr_setpshared.c"
+#include "pthread_rwlockattr_setkind_np.c"
+#include "pthread_rwlockattr_getkind_np.c"
 #include "pthread_rwlock_rdlock.c"
 #include "pthread_rwlock_timedrdlock.c"
 #include "pthread_rwlock_wrlock.c"
+#include "pthread_rwlock_upgrade_np.c"
+#include "pthread_rwlock_downgrade_np.c"
 #include "pthread_rwlock_timedwrlock.c"
 #include "pthread_rwlock_unlock.c"
 #include "pthread_rwlock_tryrdlock.c"
@@ -179,6 +228,13 @@
 #include "sem_open.c"
 #include "sem_close.c"
 #include "sem_unlink.c"
+#include "timer_create.c"
+#include "timer_delete.c"
+#include "timer_settime.c"
+#include "timer_gettime.c"
+#include "timer_getoverrun.c"
+#include "nanosleep.c"
+#include "clock_nanosleep.c"
 #include "pthread_spin_init.c"
 #include "pthread_spin_destroy.c"
 #include "pthread_spin_lock.c"
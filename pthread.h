@@ -224,9 +224,12 @@ enum {
 #    define HAVE_SIGNAL_H
 #  elif defined(__MINGW64__)
 #    define HAVE_STRUCT_TIMESPEC
+#    define HAVE_STRUCT_ITIMERSPEC
 #    define HAVE_MODE_T
 #  elif defined(__MINGW32__)
 #    define HAVE_MODE_T
+#  elif defined(PTW32_HOST)
+#    define HAVE_STRUCT_TIMESPEC
 #  endif
 #endif
 
@@ -294,7 +297,11 @@ enum {
 #endif
 #if !defined(DWORD)
 # define PTW32__DWORD_DEF
-# define DWORD unsigned long
+# if defined(PTW32_HOST)
+#  define DWORD unsigned int
+# else
+#  define DWORD unsigned long
+# endif
 #endif
 #endif
 
@@ -439,6 +446,12 @@ extern "C"
 #undef _POSIX_ROBUST_MUTEXES
 #define _POSIX_ROBUST_MUTEXES 200809L
 
+#undef _POSIX_TIMERS
+#define _POSIX_TIMERS 200809L
+
+#undef _POSIX_MONOTONIC_CLOCK
+#define _POSIX_MONOTONIC_CLOCK 200809L
+
 /*
  * The following options are not supported
  */
@@ -490,6 +503,10 @@ extern "C"
  *                      The maximum value a semaphore can have.
  *                      (must be at least 32767)
  *
+ * DELAYTIMER_MAX
+ *                      The maximum timer expiration overrun count.
+ *                      (must be at least 32)
+ *
  */
 #undef _POSIX_THREAD_DESTRUCTOR_ITERATIONS
 #define _POSIX_THREAD_DESTRUCTOR_ITERATIONS     4
@@ -526,6 +543,12 @@ extern "C"
 #undef SEM_VALUE_MAX
 #define SEM_VALUE_MAX                           INT_MAX
 
+#undef _POSIX_DELAYTIMER_MAX
+#define _POSIX_DELAYTIMER_MAX                   32
+
+#undef DELAYTIMER_MAX
+#define DELAYTIMER_MAX                          INT_MAX
+
 
 #if defined(__GNUC__) && !defined(__declspec)
 # error Please upgrade your GNU compiler to one that supports __declspec.
@@ -578,6 +601,78 @@ typedef struct pthread_rwlockattr_t_ * pthread_rwlockattr_t;
 typedef struct pthread_spinlock_t_ * pthread_spinlock_t;
 typedef struct pthread_barrier_t_ * pthread_barrier_t;
 typedef struct pthread_barrierattr_t_ * pthread_barrierattr_t;
+typedef struct pthread_combiner_t_ * pthread_combiner_t;
+typedef struct pthread_seqlock_t_ * pthread_seqlock_t;
+typedef struct pthread_eventcount_t_ * pthread_eventcount_t;
+typedef struct pthread_latch_t_ * pthread_latch_t;
+typedef struct pthread_pool_t_ * pthread_pool_t;
+
+/*
+ * Clocks and timers. These belong in <time.h> and <signal.h>, so each
+ * is only defined here if the compiler's headers don't have it. The
+ * HAVE_* macros say they do (see config.h); the __*_defined macros are
+ * those set by glibc style headers, e.g. MinGW-w64's pthread_time.h.
+ */
+#if !defined(HAVE_CLOCKID_T) && !defined(__clockid_t_defined)
+#define HAVE_CLOCKID_T
+typedef int clockid_t;
+#endif /* HAVE_CLOCKID_T */
+
+#if !defined(CLOCK_REALTIME)
+#define CLOCK_REALTIME  0
+#endif /* CLOCK_REALTIME */
+
+#if !defined(CLOCK_MONOTONIC)
+#define CLOCK_MONOTONIC 1
+#endif /* CLOCK_MONOTONIC */
+
+#if !defined(TIMER_ABSTIME)
+#define TIMER_ABSTIME   1
+#endif /* TIMER_ABSTIME */
+
+#if !defined(HAVE_STRUCT_ITIMERSPEC) && !defined(__itimerspec_defined)
+#define HAVE_STRUCT_ITIMERSPEC
+struct itimerspec {
+        struct timespec it_interval;
+        struct timespec it_value;
+};
+#endif /* HAVE_STRUCT_ITIMERSPEC */
+
+#if !defined(SIGEV_NONE)
+#define SIGEV_NONE      0
+#endif /* SIGEV_NONE */
+
+#if !defined(SIGEV_SIGNAL)
+#define SIGEV_SIGNAL    1
+#endif /* SIGEV_SIGNAL */
+
+#if !defined(SIGEV_THREAD)
+#define SIGEV_THREAD    2
+#endif /* SIGEV_THREAD */
+
+#if !defined(HAVE_UNION_SIGVAL) && !defined(__sigval_t_defined)
+#define HAVE_UNION_SIGVAL
+union sigval {
+        int sival_int;
+        void * sival_ptr;
+};
+#endif /* HAVE_UNION_SIGVAL */
+
+#if !defined(HAVE_STRUCT_SIGEVENT) && !defined(__sigevent_t_defined)
+#define HAVE_STRUCT_SIGEVENT
+struct sigevent {
+        int sigev_notify;
+        int sigev_signo;
+        union sigval sigev_value;
+        void (PTW32_CDECL *sigev_notify_function) (union sigval);
+        pthread_attr_t * sigev_notify_attributes;
+};
+#endif /* HAVE_STRUCT_SIGEVENT */
+
+#if !defined(HAVE_TIMER_T) && !defined(__timer_t_defined)
+#define HAVE_TIMER_T
+typedef struct ptw32_timer_t_ * timer_t;
+#endif /* HAVE_TIMER_T */
 
 /*
  * ====================
@@ -698,6 +793,8 @@ enum
   PTHREAD_MUTEX_FAST_NP,
   PTHREAD_MUTEX_RECURSIVE_NP,
   PTHREAD_MUTEX_ERRORCHECK_NP,
+  PTHREAD_MUTEX_FAIR_NP,	/* FIFO ownership handoff; see README.NONPORTABLE */
+  PTHREAD_MUTEX_BIASED_NP,	/* Owner-thread biased; see README.NONPORTABLE */
   PTHREAD_MUTEX_TIMED_NP = PTHREAD_MUTEX_FAST_NP,
   PTHREAD_MUTEX_ADAPTIVE_NP = PTHREAD_MUTEX_FAST_NP,
   /* For compatibility with POSIX */
@@ -707,6 +804,38 @@ enum
   PTHREAD_MUTEX_DEFAULT = PTHREAD_MUTEX_NORMAL
 };
 
+/*
+ * Rwlock kinds. See pthread_rwlockattr_setkind_np().
+ */
+enum
+{
+  PTHREAD_RWLOCK_DEFAULT_NP,	/* Writers favoured */
+  PTHREAD_RWLOCK_BIGREADER_NP,	/* Per-CPU reader slots; see README.NONPORTABLE */
+  /* Compatibility with glibc */
+  PTHREAD_RWLOCK_PREFER_READER_NP,
+  PTHREAD_RWLOCK_PREFER_WRITER_NP,
+  PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP
+};
+
+/*
+ * Loop scheduling policies. See pthread_parallel_for_np().
+ */
+enum
+{
+  PTHREAD_PARALLEL_STATIC_NP,	/* One share per thread, or chunks dealt round robin */
+  PTHREAD_PARALLEL_DYNAMIC_NP,	/* Chunks of 'grain' claimed as threads finish */
+  PTHREAD_PARALLEL_GUIDED_NP	/* Claimed chunks that shrink to 'grain' */
+};
+
+/*
+ * Delay modes. See pthread_setdelaymode_np().
+ */
+enum
+{
+  PTHREAD_DELAY_COARSE_NP,	/* Sleep only */
+  PTHREAD_DELAY_PRECISE_NP	/* Sleep, then spin until due */
+};
+
 
 typedef struct ptw32_cleanup_t ptw32_cleanup_t;
 
@@ -758,17 +887,34 @@ struct ptw32_cleanup_t
 #if defined(__CLEANUP_C)
 
         /*
-         * C implementation of PThreads cancel cleanup
+         * C implementation of PThreads cancel cleanup. The handler
+         * is linked into the thread's stack inline; only finding the
+         * stack costs a call, and pop reuses what push found.
          */
 
 #define pthread_cleanup_push( _rout, _arg ) \
         { \
             ptw32_cleanup_t     _cleanup; \
+            ptw32_cleanup_t **  _cleanupStack = ptw32_cleanup_stack(); \
             \
-            ptw32_push_cleanup( &_cleanup, (ptw32_cleanup_callback_t) (_rout), (_arg) ); \
+            _cleanup.routine    = (ptw32_cleanup_callback_t)(_rout); \
+            _cleanup.arg        = (_arg); \
+            _cleanup.prev       = NULL; \
+            if (_cleanupStack != NULL) \
+              { \
+                _cleanup.prev   = *_cleanupStack; \
+                *_cleanupStack  = &_cleanup; \
+              } \
 
 #define pthread_cleanup_pop( _execute ) \
-            (void) ptw32_pop_cleanup( _execute ); \
+            if (_cleanupStack != NULL) \
+              { \
+                *_cleanupStack  = _cleanup.prev; \
+              } \
+            if ((_execute) && _cleanup.routine != NULL) \
+              { \
+                (*_cleanup.routine)( _cleanup.arg ); \
+              } \
         }
 
 #else /* __CLEANUP_C */
@@ -957,6 +1103,8 @@ PTW32_DLLPORT void PTW32_CDECL pthread_testcancel (void);
 PTW32_DLLPORT int PTW32_CDECL pthread_once (pthread_once_t * once_control,
                           void (PTW32_CDECL *init_routine) (void));
 
+PTW32_DLLPORT ptw32_cleanup_t ** PTW32_CDECL ptw32_cleanup_stack (void);
+
 #if PTW32_LEVEL >= PTW32_LEVEL_MAX
 PTW32_DLLPORT ptw32_cleanup_t * PTW32_CDECL ptw32_pop_cleanup (int execute);
 
@@ -1141,6 +1289,38 @@ PTW32_DLLPORT int PTW32_CDECL pthread_rwlockattr_getpshared (const pthread_rwloc
 PTW32_DLLPORT int PTW32_CDECL pthread_rwlockattr_setpshared (pthread_rwlockattr_t * attr,
                                            int pshared);
 
+/*
+ * Timer and sleep Functions. Should be declared in <time.h> but MSVC
+ * and MinGW have a time.h that doesn't declare these.
+ */
+PTW32_DLLPORT int PTW32_CDECL timer_create (clockid_t clock_id,
+                          struct sigevent * evp,
+                          timer_t * timerid);
+
+PTW32_DLLPORT int PTW32_CDECL timer_delete (timer_t timerid);
+
+PTW32_DLLPORT int PTW32_CDECL timer_settime (timer_t timerid,
+                           int flags,
+                           const struct itimerspec * value,
+                           struct itimerspec * ovalue);
+
+PTW32_DLLPORT int PTW32_CDECL timer_gettime (timer_t timerid,
+                           struct itimerspec * value);
+
+PTW32_DLLPORT int PTW32_CDECL timer_getoverrun (timer_t timerid);
+
+#if !defined(HAVE_NANOSLEEP)
+PTW32_DLLPORT int PTW32_CDECL nanosleep (const struct timespec * rqtp,
+                       struct timespec * rmtp);
+#endif /* HAVE_NANOSLEEP */
+
+#if !defined(HAVE_CLOCK_NANOSLEEP)
+PTW32_DLLPORT int PTW32_CDECL clock_nanosleep (clockid_t clock_id,
+                             int flags,
+                             const struct timespec * rqtp,
+                             struct timespec * rmtp);
+#endif /* HAVE_CLOCK_NANOSLEEP */
+
 #if PTW32_LEVEL >= PTW32_LEVEL_MAX - 1
 
 /*
@@ -1160,6 +1340,10 @@ PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_setkind_np(pthread_mutexattr_t *
                                          int kind);
 PTW32_DLLPORT int PTW32_CDECL pthread_mutexattr_getkind_np(pthread_mutexattr_t * attr,
                                          int *kind);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlockattr_setkind_np(pthread_rwlockattr_t * attr,
+                                         int kind);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlockattr_getkind_np(const pthread_rwlockattr_t * attr,
+                                         int *kind);
 PTW32_DLLPORT int PTW32_CDECL pthread_timedjoin_np(pthread_t thread,
                                          void **value_ptr,
                                          const struct timespec *abstime);
@@ -1176,9 +1360,103 @@ PTW32_DLLPORT int PTW32_CDECL pthread_getaffinity_np(pthread_t thread,
  * Possibly supported by other POSIX threads implementations
  */
 PTW32_DLLPORT int PTW32_CDECL pthread_delay_np (struct timespec * interval);
+PTW32_DLLPORT int PTW32_CDECL pthread_setdelaymode_np (int mode);
+PTW32_DLLPORT int PTW32_CDECL pthread_getdelaymode_np (void);
 PTW32_DLLPORT int PTW32_CDECL pthread_num_processors_np(void);
 PTW32_DLLPORT unsigned __int64 PTW32_CDECL pthread_getunique_np(pthread_t thread);
 
+/*
+ * Rwlock upgrade and downgrade. See README.NONPORTABLE.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlock_upgrade_np (pthread_rwlock_t * rwlock);
+PTW32_DLLPORT int PTW32_CDECL pthread_rwlock_downgrade_np (pthread_rwlock_t * rwlock);
+
+/*
+ * Waiting on an address. See README.NONPORTABLE.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_wait_on_address_np (volatile int * address,
+                                         int expected,
+                                         const struct timespec * abstime);
+PTW32_DLLPORT int PTW32_CDECL pthread_wake_address_np (volatile int * address, int count);
+
+/*
+ * Lock contention profiling. See README.NONPORTABLE.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_lockprof_enable_np (int sampleInterval);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockprof_dump_np (const char * path, int top);
+PTW32_DLLPORT int PTW32_CDECL pthread_lockprof_reset_np (void);
+
+/*
+ * Flat combining. See README.NONPORTABLE.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_combiner_init_np (pthread_combiner_t * combiner);
+PTW32_DLLPORT int PTW32_CDECL pthread_combiner_destroy_np (pthread_combiner_t * combiner);
+PTW32_DLLPORT int PTW32_CDECL pthread_combiner_execute_np (pthread_combiner_t * combiner,
+                                         void *(PTW32_CDECL *op) (void *),
+                                         void * arg,
+                                         void ** result);
+
+/*
+ * Sequence locks. See README.NONPORTABLE.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_init_np (pthread_seqlock_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_destroy_np (pthread_seqlock_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_read_begin_np (pthread_seqlock_t * lock,
+                                         unsigned int * seq);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_read_retry_np (pthread_seqlock_t * lock,
+                                         unsigned int seq);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_write_lock_np (pthread_seqlock_t * lock);
+PTW32_DLLPORT int PTW32_CDECL pthread_seqlock_write_unlock_np (pthread_seqlock_t * lock);
+
+/*
+ * Event counts. See README.NONPORTABLE.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_eventcount_init_np (pthread_eventcount_t * eventcount);
+PTW32_DLLPORT int PTW32_CDECL pthread_eventcount_destroy_np (pthread_eventcount_t * eventcount);
+PTW32_DLLPORT int PTW32_CDECL pthread_eventcount_prepare_wait_np (pthread_eventcount_t * eventcount,
+                                         unsigned int * key);
+PTW32_DLLPORT int PTW32_CDECL pthread_eventcount_commit_wait_np (pthread_eventcount_t * eventcount,
+                                         unsigned int key,
+                                         const struct timespec * abstime);
+PTW32_DLLPORT int PTW32_CDECL pthread_eventcount_cancel_wait_np (pthread_eventcount_t * eventcount);
+PTW32_DLLPORT int PTW32_CDECL pthread_eventcount_notify_np (pthread_eventcount_t * eventcount);
+
+/*
+ * Countdown latches. See README.NONPORTABLE.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_latch_init_np (pthread_latch_t * latch, unsigned int count);
+PTW32_DLLPORT int PTW32_CDECL pthread_latch_destroy_np (pthread_latch_t * latch);
+PTW32_DLLPORT int PTW32_CDECL pthread_latch_count_down_np (pthread_latch_t * latch);
+PTW32_DLLPORT int PTW32_CDECL pthread_latch_wait_np (pthread_latch_t * latch);
+PTW32_DLLPORT int PTW32_CDECL pthread_latch_try_wait_np (pthread_latch_t * latch);
+
+/*
+ * Thread pools. See README.NONPORTABLE.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_pool_init_np (pthread_pool_t * pool,
+                                         const pthread_attr_t * attr,
+                                         int minThreads,
+                                         int maxThreads);
+PTW32_DLLPORT int PTW32_CDECL pthread_pool_destroy_np (pthread_pool_t * pool);
+PTW32_DLLPORT int PTW32_CDECL pthread_pool_submit_np (pthread_pool_t * pool,
+                                         void (PTW32_CDECL *routine) (void *),
+                                         void * arg);
+PTW32_DLLPORT int PTW32_CDECL pthread_pool_submit_batch_np (pthread_pool_t * pool,
+                                         void (PTW32_CDECL *routine) (void *),
+                                         void ** args,
+                                         int count);
+PTW32_DLLPORT int PTW32_CDECL pthread_pool_wait_idle_np (pthread_pool_t * pool);
+
+/*
+ * Parallel loops. See README.NONPORTABLE.
+ */
+PTW32_DLLPORT int PTW32_CDECL pthread_parallel_for_np (long begin,
+                                         long end,
+                                         long grain,
+                                         void (PTW32_CDECL *routine) (long, long, void *),
+                                         void * arg,
+                                         int policy);
+
 /*
  * Useful if an application wants to statically link
  * the lib rather than load the DLL at run-time.
@@ -1339,6 +1617,185 @@ PTW32_DLLPORT DWORD PTW32_CDECL ptw32_get_exception_services_code(void);
 
 #endif /* PTW32_LEVEL >= PTW32_LEVEL_MAX */
 
+/*
+ * Inline fast paths (non-portable).
+ *
+ * Applications compiled with PTW32_INLINE_FASTPATH defined take the
+ * uncontended lock and unlock of PTHREAD_MUTEX_NORMAL mutexes and of
+ * spin locks inline, with a single compare-and-swap, and call into the
+ * library for everything else (static initialisers, other mutex kinds,
+ * contention, errors).
+ *
+ * The inline code sees the library's objects only through the layout
+ * views below. They are layout version PTW32_FASTPATH_VERSION and must
+ * be kept in step with struct pthread_mutex_t_ and struct
+ * pthread_spinlock_t_ in implement.h (global.c checks this at build
+ * time). Any change to those leading members must bump the version and
+ * rename ptw32_fastpath_v<N>: the inline code refers to the versioned
+ * symbol, so an application built against one layout fails to link
+ * against a library built with another rather than misbehaving at run
+ * time. The library clears the flag, permanently, when lock profiling
+ * is enabled, since profiled mutexes must record every acquire and
+ * release.
+ */
+#define PTW32_FASTPATH_VERSION 1
+
+#if defined(PTW32_HOST)
+#  define PTW32_FASTPATH_LONG int
+#else
+#  define PTW32_FASTPATH_LONG long
+#endif
+
+#define PTW32_FASTPATH_SPIN_UNLOCKED    1
+#define PTW32_FASTPATH_SPIN_LOCKED      2
+
+struct ptw32_mutex_fastpath_t_
+{
+  volatile PTW32_FASTPATH_LONG lock_idx;
+  int recursive_count;
+  int kind;
+};
+
+struct ptw32_spin_fastpath_t_
+{
+  volatile PTW32_FASTPATH_LONG interlock;
+};
+
+PTW32_DLLPORT extern int ptw32_fastpath_v1;
+
+#if !defined(PTW32_BUILD) && defined(PTW32_INLINE_FASTPATH)
+
+#if defined(__GNUC__)
+#  define PTW32_FASTPATH_INLINE static __inline__
+#  if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)
+#    define PTW32_FASTPATH_CAS(p, o, n, order) \
+       __extension__ ({ PTW32_FASTPATH_LONG ptw32_o = (o); \
+                        __atomic_compare_exchange_n ((p), &ptw32_o, (n), 0, \
+                                                     (order), __ATOMIC_RELAXED); })
+#    define PTW32_FASTPATH_CAS_ACQUIRE(p, o, n) PTW32_FASTPATH_CAS (p, o, n, __ATOMIC_ACQUIRE)
+#    define PTW32_FASTPATH_CAS_RELEASE(p, o, n) PTW32_FASTPATH_CAS (p, o, n, __ATOMIC_RELEASE)
+#  else
+#    define PTW32_FASTPATH_CAS_ACQUIRE(p, o, n) __sync_bool_compare_and_swap ((p), (o), (n))
+#    define PTW32_FASTPATH_CAS_RELEASE(p, o, n) __sync_bool_compare_and_swap ((p), (o), (n))
+#  endif
+#elif defined(_MSC_VER) && _MSC_VER >= 1400
+#  include <intrin.h>
+#  pragma intrinsic(_InterlockedCompareExchange)
+#  define PTW32_FASTPATH_INLINE static __inline
+#  define PTW32_FASTPATH_CAS_ACQUIRE(p, o, n) \
+     (_InterlockedCompareExchange ((p), (n), (o)) == (o))
+#  define PTW32_FASTPATH_CAS_RELEASE(p, o, n) \
+     (_InterlockedCompareExchange ((p), (n), (o)) == (o))
+#endif
+
+/*
+ * Other compilers quietly get the ordinary calls.
+ */
+#if defined(PTW32_FASTPATH_INLINE)
+
+PTW32_FASTPATH_INLINE int
+ptw32_inline_mutex_lock (pthread_mutex_t * mutex)
+{
+  struct ptw32_mutex_fastpath_t_ * mx = (struct ptw32_mutex_fastpath_t_ *) *mutex;
+
+  if (ptw32_fastpath_v1
+      && mx != NULL
+      && *mutex < PTHREAD_ERRORCHECK_MUTEX_INITIALIZER
+      && mx->kind == PTHREAD_MUTEX_NORMAL
+      && PTW32_FASTPATH_CAS_ACQUIRE (&mx->lock_idx, 0, 1))
+    {
+      return 0;
+    }
+
+  return (pthread_mutex_lock) (mutex);
+}
+
+PTW32_FASTPATH_INLINE int
+ptw32_inline_mutex_unlock (pthread_mutex_t * mutex)
+{
+  struct ptw32_mutex_fastpath_t_ * mx = (struct ptw32_mutex_fastpath_t_ *) *mutex;
+
+  /*
+   * Only 1 -> 0 is done inline; -1 means there are waiters to wake.
+   */
+  if (ptw32_fastpath_v1
+      && mx != NULL
+      && *mutex < PTHREAD_ERRORCHECK_MUTEX_INITIALIZER
+      && mx->kind == PTHREAD_MUTEX_NORMAL
+      && PTW32_FASTPATH_CAS_RELEASE (&mx->lock_idx, 1, 0))
+    {
+      return 0;
+    }
+
+  return (pthread_mutex_unlock) (mutex);
+}
+
+PTW32_FASTPATH_INLINE int
+ptw32_inline_spin_lock (pthread_spinlock_t * lock)
+{
+  struct ptw32_spin_fastpath_t_ * s;
+
+  if (ptw32_fastpath_v1
+      && lock != NULL
+      && *lock != NULL
+      && *lock != PTHREAD_SPINLOCK_INITIALIZER)
+    {
+      s = (struct ptw32_spin_fastpath_t_ *) *lock;
+
+      /*
+       * Look before the CAS: on a uniprocessor, spin locks are mutexes
+       * (PTW32_SPIN_USE_MUTEX) and the CAS could only fail.
+       */
+      if (s->interlock == PTW32_FASTPATH_SPIN_UNLOCKED
+          && PTW32_FASTPATH_CAS_ACQUIRE (&s->interlock,
+                                      PTW32_FASTPATH_SPIN_UNLOCKED,
+                                      PTW32_FASTPATH_SPIN_LOCKED))
+        {
+          return 0;
+        }
+    }
+
+  return (pthread_spin_lock) (lock);
+}
+
+PTW32_FASTPATH_INLINE int
+ptw32_inline_spin_unlock (pthread_spinlock_t * lock)
+{
+  struct ptw32_spin_fastpath_t_ * s;
+
+  if (ptw32_fastpath_v1
+      && lock != NULL
+      && *lock != NULL
+      && *lock != PTHREAD_SPINLOCK_INITIALIZER)
+    {
+      s = (struct ptw32_spin_fastpath_t_ *) *lock;
+
+      if (s->interlock == PTW32_FASTPATH_SPIN_LOCKED
+          && PTW32_FASTPATH_CAS_RELEASE (&s->interlock,
+                                      PTW32_FASTPATH_SPIN_LOCKED,
+                                      PTW32_FASTPATH_SPIN_UNLOCKED))
+        {
+          return 0;
+        }
+    }
+
+  return (pthread_spin_unlock) (lock);
+}
+
+/*
+ * Calls written as pthread_mutex_lock(m) etc. now go inline. Taking the
+ * address of these functions, or calling (pthread_mutex_lock)(m), still
+ * uses the library's entry points.
+ */
+#define pthread_mutex_lock(m)   ptw32_inline_mutex_lock (m)
+#define pthread_mutex_unlock(m) ptw32_inline_mutex_unlock (m)
+#define pthread_spin_lock(l)    ptw32_inline_spin_lock (l)
+#define pthread_spin_unlock(l)  ptw32_inline_spin_unlock (l)
+
+#endif /* PTW32_FASTPATH_INLINE */
+
+#endif /* ! PTW32_BUILD && PTW32_INLINE_FASTPATH */
+
 #if !defined(PTW32_BUILD)
 
 #if defined(__CLEANUP_SEH)
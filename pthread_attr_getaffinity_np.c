@@ -51,7 +51,16 @@ pthread_attr_getaffinity_np (const pthread_attr_t * attr, size_t cpusetsize, cpu
       return EINVAL;
     }
 
-  ((_sched_cpu_set_vector_*)cpuset)->_cpuset = (*attr)->cpuset;
+  if (cpusetsize < sizeof (cpu_set_t)
+      && CPU_COUNT (&(*attr)->cpuset) != CPU_COUNT_S (cpusetsize, &(*attr)->cpuset))
+    {
+      /* Too small for the CPUs in the attribute. */
+      return EINVAL;
+    }
+
+  memset (cpuset, 0, cpusetsize);
+  memcpy (cpuset, &(*attr)->cpuset,
+          (cpusetsize < sizeof (cpu_set_t)) ? cpusetsize : sizeof (cpu_set_t));
 
   return 0;
 }
@@ -71,7 +71,6 @@ pthread_attr_init (pthread_attr_t * attr)
       */
 {
   pthread_attr_t attr_result;
-  cpu_set_t cpuset;
 
   if (attr == NULL)
     {
@@ -114,8 +113,7 @@ pthread_attr_init (pthread_attr_t * attr)
   attr_result->param.sched_priority = THREAD_PRIORITY_NORMAL;
   attr_result->inheritsched = PTHREAD_EXPLICIT_SCHED;
   attr_result->contentionscope = PTHREAD_SCOPE_SYSTEM;
-  CPU_ZERO(&cpuset);
-  attr_result->cpuset = ((_sched_cpu_set_vector_*)&cpuset)->_cpuset;
+  CPU_ZERO(&attr_result->cpuset);
   attr_result->thrname = NULL;
 
   attr_result->valid = PTW32_ATTR_VALID;
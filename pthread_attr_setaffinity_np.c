@@ -51,7 +51,16 @@ pthread_attr_setaffinity_np (pthread_attr_t * attr, size_t cpusetsize, const cpu
       return EINVAL;
     }
 
-  (*attr)->cpuset = ((_sched_cpu_set_vector_*)cpuset)->_cpuset;
+  if (cpusetsize > sizeof (cpu_set_t)
+      && CPU_COUNT_S (cpusetsize, cpuset) != CPU_COUNT_S (sizeof (cpu_set_t), cpuset))
+    {
+      /* The attribute only holds CPU_SETSIZE CPUs. */
+      return EINVAL;
+    }
+
+  memset (&(*attr)->cpuset, 0, sizeof (cpu_set_t));
+  memcpy (&(*attr)->cpuset, cpuset,
+          (cpusetsize < sizeof (cpu_set_t)) ? cpusetsize : sizeof (cpu_set_t));
 
   return 0;
 }
@@ -61,13 +61,10 @@ pthread_barrier_init (pthread_barrier_t * barrier,
 
       b->nCurrentBarrierHeight = b->nInitialBarrierHeight = count;
       b->lock = 0;
+      b->generation = 0;
 
-      if (0 == sem_init (&(b->semBarrierBreeched), b->pshared, 0))
-	    {
-	      *barrier = b;
-	      return 0;
-	    }
-      (void) free (b);
+      *barrier = b;
+      return 0;
     }
 
   return ENOMEM;
@@ -46,8 +46,9 @@
 int
 pthread_barrier_wait (pthread_barrier_t * barrier)
 {
-  int result;
+  int result = 0;
   pthread_barrier_t b;
+  LONG generation;
 
   ptw32_mcs_local_node_t node;
 
@@ -69,27 +70,40 @@ pthread_barrier_wait (pthread_barrier_t * barrier)
       ptw32_mcs_node_transfer(&b->proxynode, &node);
 
       /*
-       * Any threads that have not quite entered sem_wait below when the
-       * multiple_post has completed will nevertheless continue through
-       * the semaphore (barrier).
+       * Any threads that have not quite started waiting below when the
+       * generation changes will see the change and not wait at all.
        */
-      result = (b->nInitialBarrierHeight > 1
-                ? sem_post_multiple (&(b->semBarrierBreeched),
-				     b->nInitialBarrierHeight - 1) : 0);
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR)&b->generation);
+
+      if (b->nInitialBarrierHeight > 1)
+        {
+          (void) ptw32_wake_address (&b->generation, (int) b->nInitialBarrierHeight - 1);
+        }
     }
   else
     {
+      generation = b->generation;
       ptw32_mcs_lock_release(&node);
       /*
-       * Use the non-cancelable version of sem_wait().
+       * Not a cancellation point.
        *
-       * It is possible that all nInitialBarrierHeight-1 threads are
-       * at this point when the last thread enters the barrier, resets
-       * nCurrentBarrierHeight = nInitialBarrierHeight and leaves.
-       * If pthread_barrier_destroy is called at that moment then the
-       * barrier will be destroyed along with the semas.
+       * The barrier can't be destroyed until we've left and
+       * incremented nCurrentBarrierHeight below, so it's safe to
+       * keep reading b->generation. See ptw32_park.c.
        */
-      result = ptw32_semwait (&(b->semBarrierBreeched));
+      while (generation == (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG(
+                                     (PTW32_INTERLOCKED_LONGPTR)&b->generation,
+                                     (PTW32_INTERLOCKED_LONG)0))
+        {
+          if (ENOSPC == ptw32_wait_on_address (&b->generation, generation, INFINITE, PTW32_FALSE))
+            {
+              /*
+               * No park event. Our arrival has already been counted,
+               * so we can't back out; poll until we're released.
+               */
+              Sleep (0);
+            }
+        }
     }
 
   if ((PTW32_INTERLOCKED_LONG)PTW32_INTERLOCKED_INCREMENT_LONG((PTW32_INTERLOCKED_LONGPTR)&b->nCurrentBarrierHeight)
@@ -177,9 +177,16 @@ pthread_cancel (pthread_t thread)
       if (tp->state < PThreadStateCancelPending)
 	{
 	  tp->state = PThreadStateCancelPending;
-	  if (!SetEvent (tp->cancelEvent))
+	  /*
+	   * Raise the flag before looking for a park event: a thread
+	   * that creates its event after this still sees the flag
+	   * before it waits (see ptw32_park.c).
+	   */
+	  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &tp->cancelRequested,
+						  (PTW32_INTERLOCKED_LONG) 1);
+	  if (tp->parkEvent != NULL)
 	    {
-	      result = ESRCH;
+	      ptw32_unpark (tp);
 	    }
 	}
       else if (tp->state >= PThreadStateCanceling)
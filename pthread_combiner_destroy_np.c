@@ -0,0 +1,95 @@
+/*
+ * pthread_combiner_destroy_np.c
+ *
+ * Description:
+ * This translation unit implements flat combining primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_combiner_destroy_np (pthread_combiner_t * combiner)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Destroys a combiner.
+      *
+      * PARAMETERS
+      *      combiner
+      *              pointer to an instance of pthread_combiner_t
+      *
+      * DESCRIPTION
+      *      The combiner must not be in use.
+      *
+      * RESULTS
+      *              0               successfully destroyed,
+      *              EINVAL          'combiner' is invalid,
+      *              EBUSY           operations are pending or
+      *                              being run
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_combiner_t c;
+  ptw32_mcs_local_node_t node;
+
+  if (combiner == NULL || *combiner == NULL)
+    {
+      return EINVAL;
+    }
+
+  c = *combiner;
+
+  if (0 != ptw32_mcs_lock_try_acquire (&c->lock, &node))
+    {
+      return EBUSY;
+    }
+
+  if (c->pending != NULL)
+    {
+      ptw32_mcs_lock_release (&node);
+      return EBUSY;
+    }
+
+  *combiner = NULL;
+  ptw32_mcs_lock_release (&node);
+  (void) free (c);
+
+  return 0;
+}
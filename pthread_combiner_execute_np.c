@@ -0,0 +1,222 @@
+/*
+ * pthread_combiner_execute_np.c
+ *
+ * Description:
+ * This translation unit implements flat combining primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Notes on flat combining.
+ * ------------------------
+ *
+ * A thread publishes its operation by pushing a request node (on its own
+ * stack) onto the combiner's pending list, then tries to take the
+ * combiner lock (an MCS lock). The thread that gets the lock becomes the
+ * combiner: it detaches the whole pending list with one Interlocked
+ * exchange, runs the requests in arrival order, and marks each one done.
+ * The other threads just wait for their own 'done' flag, which lives in
+ * their own stack and cache, instead of queueing for the lock and pulling
+ * the shared data's cache lines across in turn.
+ *
+ * The combiner makes at most PTW32_COMBINER_PASSES sweeps of the pending
+ * list before releasing the lock so that no thread is kept combining for
+ * others indefinitely. A waiting thread only reads its own 'done' flag
+ * and the lock word, and tries to take the lock (an Interlocked
+ * operation that would pull the lock's cache line away from the
+ * combiner) only when it sees it free. After PTW32_COMBINER_SPIN
+ * checks a waiter blocks on the MCS lock rather than continuing to
+ * spin; when it gets the lock its request has either been run or it
+ * runs it itself.
+ */
+
+#define PTW32_COMBINER_PASSES   4
+#define PTW32_COMBINER_SPIN     1000
+
+
+static void
+ptw32_combiner_run (pthread_combiner_t c)
+{
+  ptw32_combiner_request_t * list;
+  ptw32_combiner_request_t * prev;
+  ptw32_combiner_request_t * next;
+  int pass;
+
+  for (pass = 0; pass < PTW32_COMBINER_PASSES; pass++)
+    {
+      list = (ptw32_combiner_request_t *)
+        PTW32_INTERLOCKED_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &c->pending,
+                                        (PTW32_INTERLOCKED_PVOID) NULL);
+      if (list == NULL)
+        {
+          break;
+        }
+
+      /*
+       * The list is newest first; reverse it into arrival order.
+       */
+      for (prev = NULL; list != NULL; list = next)
+        {
+          next = list->next;
+          list->next = prev;
+          prev = list;
+        }
+
+      for (list = prev; list != NULL; list = next)
+        {
+          /*
+           * The request belongs to its thread again once 'done' is set.
+           */
+          next = list->next;
+          list->result = (*list->op) (list->arg);
+          (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &list->done,
+                                                  (PTW32_INTERLOCKED_LONG) 1);
+        }
+    }
+}
+
+
+int
+pthread_combiner_execute_np (pthread_combiner_t * combiner,
+                             void *(PTW32_CDECL *op) (void *),
+                             void * arg,
+                             void ** result)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Runs an operation under the combiner's mutual
+      *      exclusion, possibly on another thread.
+      *
+      * PARAMETERS
+      *      combiner
+      *              pointer to an instance of pthread_combiner_t
+      *
+      *      op
+      *              the operation
+      *
+      *      arg
+      *              passed to 'op'
+      *
+      *      result
+      *              if not NULL, receives the value returned
+      *              by 'op'
+      *
+      * DESCRIPTION
+      *      No two operations executed through the same
+      *      combiner run concurrently, and each caller's
+      *      operations run in the order it submits them.
+      *      Because 'op' may run on a thread other than the
+      *      caller it must not depend on the identity of the
+      *      calling thread (e.g. pthread_self(), thread
+      *      specific data or mutexes held by the caller), must
+      *      not block for long, and must not call
+      *      pthread_combiner_execute_np() on the same combiner.
+      *
+      *      This function returns when 'op' has completed. It is
+      *      not a cancellation point.
+      *
+      * RESULTS
+      *              0               'op' was run,
+      *              EINVAL          'combiner' or 'op' is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_combiner_t c;
+  ptw32_combiner_request_t request;
+  ptw32_mcs_local_node_t node;
+  int spin = 0;
+
+  if (combiner == NULL || *combiner == NULL || op == NULL)
+    {
+      return EINVAL;
+    }
+
+  c = *combiner;
+
+  request.op = op;
+  request.arg = arg;
+  request.result = NULL;
+  request.done = 0;
+
+  /*
+   * Publish.
+   */
+  do
+    {
+      request.next = c->pending;
+    }
+  while (request.next != (ptw32_combiner_request_t *)
+           PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &c->pending,
+                                                   (PTW32_INTERLOCKED_PVOID) &request,
+                                                   (PTW32_INTERLOCKED_PVOID) request.next));
+
+  while (!request.done)
+    {
+      if (spin < PTW32_COMBINER_SPIN)
+        {
+          if (NULL == *(ptw32_mcs_lock_t volatile *) &c->lock
+              && 0 == ptw32_mcs_lock_try_acquire (&c->lock, &node))
+            {
+              ptw32_combiner_run (c);
+              ptw32_mcs_lock_release (&node);
+            }
+          else
+            {
+              spin++;
+              YieldProcessor ();
+            }
+        }
+      else
+        {
+          ptw32_mcs_lock_acquire (&c->lock, &node);
+          ptw32_combiner_run (c);
+          ptw32_mcs_lock_release (&node);
+        }
+    }
+
+  PTW32_COMPILER_BARRIER ();
+
+  if (result != NULL)
+    {
+      *result = request.result;
+    }
+
+  return 0;
+}
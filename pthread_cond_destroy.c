@@ -131,9 +131,6 @@ pthread_cond_destroy (pthread_cond_t * cond)
 
   if (*cond != PTHREAD_COND_INITIALIZER)
     {
-      ptw32_mcs_local_node_t node;
-      ptw32_mcs_lock_acquire(&ptw32_cond_list_lock, &node);
-
       cv = *cond;
 
       /*
@@ -160,7 +157,6 @@ pthread_cond_destroy (pthread_cond_t * cond)
 	
       if (result != 0)
         {
-          ptw32_mcs_lock_release(&node);
           return result;
         }
 
@@ -196,30 +192,8 @@ pthread_cond_destroy (pthread_cond_t * cond)
 	      result2 = pthread_mutex_destroy (&(cv->mtxUnblockLock));
 	    }
 
-	  /* Unlink the CV from the list */
-
-	  if (ptw32_cond_list_head == cv)
-	    {
-	      ptw32_cond_list_head = cv->next;
-	    }
-	  else
-	    {
-	      cv->prev->next = cv->next;
-	    }
-
-	  if (ptw32_cond_list_tail == cv)
-	    {
-	      ptw32_cond_list_tail = cv->prev;
-	    }
-	  else
-	    {
-	      cv->next->prev = cv->prev;
-	    }
-
 	  (void) free (cv);
 	}
-
-      ptw32_mcs_lock_release(&node);
     }
   else
     {
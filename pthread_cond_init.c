@@ -74,6 +74,7 @@ pthread_cond_init (pthread_cond_t * cond, const pthread_condattr_t * attr)
       */
 {
   int result;
+  int cpus = 0;
   pthread_cond_t cv = NULL;
 
   if (cond == NULL)
@@ -103,6 +104,17 @@ pthread_cond_init (pthread_cond_t * cond, const pthread_condattr_t * attr)
   cv->nWaitersBlocked = 0;
   cv->nWaitersToUnblock = 0;
   cv->nWaitersGone = 0;
+  cv->generation = 0;
+  cv->nTimedWaiters = 0;
+
+  if (0 != ptw32_getprocessors (&cpus) || cpus < 2)
+    {
+      cv->spin = 0;
+    }
+  else
+    {
+      cv->spin = PTW32_COND_SPIN;
+    }
 
   if (sem_init (&(cv->semBlockLock), 0, 1) != 0)
     {
@@ -141,30 +153,6 @@ FAIL0:
   cv = NULL;
 
 DONE:
-  if (0 == result)
-    {
-      ptw32_mcs_local_node_t node;
-
-      ptw32_mcs_lock_acquire(&ptw32_cond_list_lock, &node);
-
-      cv->next = NULL;
-      cv->prev = ptw32_cond_list_tail;
-
-      if (ptw32_cond_list_tail != NULL)
-	{
-	  ptw32_cond_list_tail->next = cv;
-	}
-
-      ptw32_cond_list_tail = cv;
-
-      if (ptw32_cond_list_head == NULL)
-	{
-	  ptw32_cond_list_head = cv;
-	}
-
-      ptw32_mcs_lock_release(&node);
-    }
-
   *cond = cv;
 
   return result;
@@ -67,6 +67,7 @@ ptw32_cond_unblock (pthread_cond_t * cond, int unblockAll)
       *   mtxUnblockLock
       *   semBlockLock
       *   semBlockQueue
+      *   generation
       */
 {
   int result;
@@ -148,6 +149,13 @@ ptw32_cond_unblock (pthread_cond_t * cond, int unblockAll)
 	{
 	  result = PTW32_GET_ERRNO();
 	}
+      else
+	{
+	  /*
+	   * Tell any spinning waiters. See ptw32_cond_spin().
+	   */
+	  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &cv->generation);
+	}
     }
 
   return result;
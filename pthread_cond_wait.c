@@ -255,6 +255,28 @@
  *   sem_post( semBlockQueue,nSignalsToIssue );
  *   return result;
  * }
+ *
+ * Spinning:
+ * On a multiprocessor a signal often arrives within microseconds of
+ * the waiter releasing mtxExternal. Before blocking on semBlockQueue
+ * the waiter therefore polls cv->generation, which signal/broadcast
+ * increment after posting semBlockQueue, up to cv->spin times. When
+ * it changes the waiter tries to take semBlockQueue without waiting.
+ * The counter is only a hint; the semaphore decides who is woken.
+ * A waiter that succeeds has not blocked and has passed no
+ * cancellation point since releasing mtxExternal, so it runs the
+ * cleanup routine directly and never pushes a cleanup handler.
+ * Entering the wait likewise tries semBlockLock before falling back
+ * to the cancelable sem_wait().
+ *
+ * Timed waits:
+ * While a CV has timed waiters it is kept in one of the shard lists
+ * that pthread_timechange_handler_np() walks. A timed waiter joins
+ * after registering in nWaitersBlocked and leaves first thing in the
+ * cleanup routine, before adjusting any counts, so a listed CV is
+ * always busy and can't be destroyed. Neither step is taken while
+ * holding semBlockLock or mtxUnblockLock, since the handler holds a
+ * shard lock while it broadcasts.
  * -------------------------------------------------------------
  */
 
@@ -274,8 +296,63 @@ typedef struct
   pthread_mutex_t *mutexPtr;
   pthread_cond_t cv;
   int *resultPtr;
+  int timed;
 } ptw32_cond_wait_cleanup_args_t;
 
+static INLINE void
+ptw32_cond_timed_enter (pthread_cond_t cv)
+{
+  ptw32_cond_shard_t * shard = PTW32_COND_SHARD (cv);
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&shard->lock, &node);
+
+  if (0 == cv->nTimedWaiters++)
+    {
+      cv->prev = NULL;
+      cv->next = shard->head;
+
+      if (shard->head != NULL)
+	{
+	  shard->head->prev = cv;
+	}
+
+      shard->head = cv;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+}				/* ptw32_cond_timed_enter */
+
+static INLINE void
+ptw32_cond_timed_leave (pthread_cond_t cv)
+{
+  ptw32_cond_shard_t * shard = PTW32_COND_SHARD (cv);
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&shard->lock, &node);
+
+  if (0 == --cv->nTimedWaiters)
+    {
+      if (cv->prev != NULL)
+	{
+	  cv->prev->next = cv->next;
+	}
+      else
+	{
+	  shard->head = cv->next;
+	}
+
+      if (cv->next != NULL)
+	{
+	  cv->next->prev = cv->prev;
+	}
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+}				/* ptw32_cond_timed_leave */
+
 static void PTW32_CDECL
 ptw32_cond_wait_cleanup (void *args)
 {
@@ -286,6 +363,11 @@ ptw32_cond_wait_cleanup (void *args)
   int nSignalsWasLeft;
   int result;
 
+  if (cleanup_args->timed)
+    {
+      ptw32_cond_timed_leave (cv);
+    }
+
   /*
    * Whether we got here as a result of signal/broadcast or because of
    * timeout on wait or thread cancellation we indicate that we are no
@@ -354,12 +436,35 @@ ptw32_cond_wait_cleanup (void *args)
     }
 }				/* ptw32_cond_wait_cleanup */
 
+static INLINE int
+ptw32_cond_spin (pthread_cond_t cv, LONG generation)
+{
+  int spin;
+
+  for (spin = cv->spin; spin > 0; spin--)
+    {
+      if (cv->generation != generation)
+	{
+	  if (sem_trywait (&(cv->semBlockQueue)) == 0)
+	    {
+	      return PTW32_TRUE;
+	    }
+
+	  generation = cv->generation;
+	}
+    }
+
+  return PTW32_FALSE;
+
+}				/* ptw32_cond_spin */
+
 static INLINE int
 ptw32_cond_timedwait (pthread_cond_t * cond,
 		      pthread_mutex_t * mutex, const struct timespec *abstime)
 {
   int result = 0;
   pthread_cond_t cv;
+  LONG generation;
   ptw32_cond_wait_cleanup_args_t cleanup_args;
 
   if (cond == NULL || *cond == NULL)
@@ -385,13 +490,19 @@ ptw32_cond_timedwait (pthread_cond_t * cond,
 
   cv = *cond;
 
-  /* Thread can be cancelled in sem_wait() but this is OK */
-  if (sem_wait (&(cv->semBlockLock)) != 0)
+  pthread_testcancel ();
+
+  if (sem_trywait (&(cv->semBlockLock)) != 0)
     {
-      return PTW32_GET_ERRNO();
+      /* Thread can be cancelled in sem_wait() but this is OK */
+      if (sem_wait (&(cv->semBlockLock)) != 0)
+	{
+	  return PTW32_GET_ERRNO();
+	}
     }
 
   ++(cv->nWaitersBlocked);
+  generation = cv->generation;
 
   if (sem_post (&(cv->semBlockLock)) != 0)
     {
@@ -404,6 +515,24 @@ ptw32_cond_timedwait (pthread_cond_t * cond,
   cleanup_args.mutexPtr = mutex;
   cleanup_args.cv = cv;
   cleanup_args.resultPtr = &result;
+  cleanup_args.timed = (abstime != NULL);
+
+  if (cleanup_args.timed)
+    {
+      ptw32_cond_timed_enter (cv);
+    }
+
+  /*
+   * Now we can release 'mutex' and spin briefly for a signal. If the
+   * unlock fails, or we are signalled while spinning, nothing can have
+   * cancelled us yet and we clean up directly.
+   */
+  if ((result = pthread_mutex_unlock (mutex)) != 0
+      || ptw32_cond_spin (cv, generation))
+    {
+      ptw32_cond_wait_cleanup ((void *) &cleanup_args);
+      return result;
+    }
 
 #if defined(PTW32_CONFIG_MSVC7)
 #pragma inline_depth(0)
@@ -411,31 +540,24 @@ ptw32_cond_timedwait (pthread_cond_t * cond,
   pthread_cleanup_push (ptw32_cond_wait_cleanup, (void *) &cleanup_args);
 
   /*
-   * Now we can release 'mutex' and...
+   * ...wait to be awakened by
+   *              pthread_cond_signal, or
+   *              pthread_cond_broadcast, or
+   *              timeout, or
+   *              thread cancellation
+   *
+   * Note:
+   *
+   *      sem_timedwait is a cancellation point,
+   *      hence providing the mechanism for making
+   *      pthread_cond_wait a cancellation point.
+   *      We use the cleanup mechanism to ensure we
+   *      re-lock the mutex and adjust (to)unblock(ed) waiters
+   *      counts if we are cancelled, timed out or signalled.
    */
-  if ((result = pthread_mutex_unlock (mutex)) == 0)
+  if (sem_timedwait (&(cv->semBlockQueue), abstime) != 0)
     {
-
-      /*
-       * ...wait to be awakened by
-       *              pthread_cond_signal, or
-       *              pthread_cond_broadcast, or
-       *              timeout, or
-       *              thread cancellation
-       *
-       * Note:
-       *
-       *      sem_timedwait is a cancellation point,
-       *      hence providing the mechanism for making
-       *      pthread_cond_wait a cancellation point.
-       *      We use the cleanup mechanism to ensure we
-       *      re-lock the mutex and adjust (to)unblock(ed) waiters
-       *      counts if we are cancelled, timed out or signalled.
-       */
-      if (sem_timedwait (&(cv->semBlockQueue), abstime) != 0)
-	{
-	  result = PTW32_GET_ERRNO();
-	}
+      result = PTW32_GET_ERRNO();
     }
 
   /*
@@ -53,6 +53,10 @@
  *       arbitrary amount of time after the period has gone by. This can be due to
  *       system load, thread priorities, and system timer granularity. 
  *
+ *       The thread sleeps on a high resolution waitable timer where Windows has
+ *       one. In PTHREAD_DELAY_PRECISE_NP mode (see pthread_setdelaymode_np) it
+ *       wakes early and spins until the period ends.
+ *
  *       Specifying an interval of zero (0) seconds and zero (0) nanoseconds is
  *       allowed and can be used to force the thread to give up the processor or to
  *       deliver a pending cancellation request. 
@@ -86,14 +90,7 @@
 int
 pthread_delay_np (struct timespec *interval)
 {
-  DWORD wait_time;
-  DWORD secs_in_millisecs;
-  DWORD millisecs;
-  DWORD status;
-  pthread_t self;
-  ptw32_thread_t * sp;
-
-  if (interval == NULL)
+  if (interval == NULL || interval->tv_sec < 0 || interval->tv_nsec < 0)
     {
       return EINVAL;
     }
@@ -106,72 +103,9 @@ pthread_delay_np (struct timespec *interval)
       return (0);
     }
 
-  /* convert secs to millisecs */
-  secs_in_millisecs = (DWORD)interval->tv_sec * 1000L;
-
-  /* convert nanosecs to millisecs (rounding up) */
-  millisecs = (interval->tv_nsec + 999999L) / 1000000L;
-
-#if defined(__WATCOMC__)
-#pragma disable_message (124)
-#endif
-
   /*
-   * Most compilers will issue a warning 'comparison always 0'
-   * because the variable type is unsigned, but we need to keep this
-   * for some reason I can't recall now.
+   * See ptw32_delay.c.
    */
-  if (0 > (wait_time = secs_in_millisecs + millisecs))
-    {
-      return EINVAL;
-    }
-
-#if defined(__WATCOMC__)
-#pragma enable_message (124)
-#endif
-
-  if (NULL == (self = pthread_self ()).p)
-    {
-      return ENOMEM;
-    }
-
-  sp = (ptw32_thread_t *) self.p;
-
-  if (sp->cancelState == PTHREAD_CANCEL_ENABLE)
-    {
-      /*
-       * Async cancellation won't catch us until wait_time is up.
-       * Deferred cancellation will cancel us immediately.
-       */
-      if (WAIT_OBJECT_0 ==
-	  (status = WaitForSingleObject (sp->cancelEvent, wait_time)))
-	{
-          ptw32_mcs_local_node_t stateLock;
-	  /*
-	   * Canceling!
-	   */
-	  ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
-	  if (sp->state < PThreadStateCanceling)
-	    {
-	      sp->state = PThreadStateCanceling;
-	      sp->cancelState = PTHREAD_CANCEL_DISABLE;
-	      ptw32_mcs_lock_release (&stateLock);
-
-	      ptw32_throw (PTW32_EPS_CANCEL);
-	    }
-
-	  ptw32_mcs_lock_release (&stateLock);
-	  return ESRCH;
-	}
-      else if (status != WAIT_TIMEOUT)
-	{
-	  return EINVAL;
-	}
-    }
-  else
-    {
-      Sleep (wait_time);
-    }
-
-  return (0);
+  return ptw32_delay (ptw32_clock_ns (CLOCK_MONOTONIC) + ptw32_timespec_to_ns (interval),
+                      ptw32_delay_mode == PTHREAD_DELAY_PRECISE_NP);
 }
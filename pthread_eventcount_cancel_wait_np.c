@@ -0,0 +1,77 @@
+/*
+ * pthread_eventcount_cancel_wait_np.c
+ *
+ * Description:
+ * This translation unit implements event count primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_eventcount_cancel_wait_np (pthread_eventcount_t * eventcount)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Abandons a wait announced by
+      *      pthread_eventcount_prepare_wait_np().
+      *
+      * PARAMETERS
+      *      eventcount
+      *              pointer to an instance of pthread_eventcount_t
+      *
+      * DESCRIPTION
+      *      Used when the recheck after prepare found the
+      *      condition true, so there is no need to sleep.
+      *
+      * RESULTS
+      *              0               successfully cancelled,
+      *              EINVAL          'eventcount' is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (eventcount == NULL || *eventcount == NULL)
+    {
+      return EINVAL;
+    }
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &(*eventcount)->waiters);
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * pthread_eventcount_commit_wait_np.c
+ *
+ * Description:
+ * This translation unit implements event count primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_eventcount_commit_wait_np (pthread_eventcount_t * eventcount,
+                                   unsigned int key,
+                                   const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits on an event count.
+      *
+      * PARAMETERS
+      *      eventcount
+      *              pointer to an instance of pthread_eventcount_t
+      *
+      *      key
+      *              the value from
+      *              pthread_eventcount_prepare_wait_np()
+      *
+      *      abstime
+      *              absolute time at which to stop waiting,
+      *              or NULL to wait until notified
+      *
+      * DESCRIPTION
+      *      Blocks until pthread_eventcount_notify_np() is
+      *      called after the prepare that produced 'key'. If one
+      *      already has been, this returns at once. Either way
+      *      the wait announced by the prepare is over.
+      *
+      *      This routine is a cancellation point. A cancelled
+      *      thread doesn't consume the notification: every
+      *      thread waiting when it was made is woken.
+      *
+      * RESULTS
+      *              0               notified,
+      *              ETIMEDOUT       abstime passed,
+      *              EINVAL          'eventcount' is invalid,
+      *              ENOSPC          the thread's wait event could
+      *                              not be created.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+
+  if (eventcount == NULL || *eventcount == NULL)
+    {
+      return EINVAL;
+    }
+
+  result = ptw32_eventcount_wait (*eventcount, key,
+                                  (abstime == NULL) ? INFINITE : ptw32_relmillisecs (abstime),
+                                  PTW32_TRUE);
+
+  if (result == EINTR)
+    {
+      pthread_testcancel ();
+    }
+
+  return result;
+}
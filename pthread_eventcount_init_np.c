@@ -0,0 +1,92 @@
+/*
+ * pthread_eventcount_init_np.c
+ *
+ * Description:
+ * This translation unit implements event count primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_eventcount_init_np (pthread_eventcount_t * eventcount)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Initialises an event count.
+      *
+      * PARAMETERS
+      *      eventcount
+      *              pointer to an instance of pthread_eventcount_t
+      *
+      * DESCRIPTION
+      *      An event count lets threads sleep until some
+      *      condition on data managed without locks (e.g. a
+      *      lock-free queue becoming non-empty) may have become
+      *      true, without the threads that make it true having to
+      *      take a lock. See pthread_eventcount_prepare_wait_np().
+      *
+      * RESULTS
+      *              0               successfully initialised,
+      *              EINVAL          'eventcount' is NULL,
+      *              ENOMEM          insufficient memory
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_eventcount_t ec;
+
+  if (eventcount == NULL)
+    {
+      return EINVAL;
+    }
+
+  ec = (pthread_eventcount_t) calloc (1, sizeof (*ec));
+
+  if (ec == NULL)
+    {
+      return ENOMEM;
+    }
+
+  ec->epoch = 0;
+  ec->waiters = 0;
+
+  *eventcount = ec;
+
+  return 0;
+}
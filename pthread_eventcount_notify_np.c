@@ -0,0 +1,82 @@
+/*
+ * pthread_eventcount_notify_np.c
+ *
+ * Description:
+ * This translation unit implements event count primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_eventcount_notify_np (pthread_eventcount_t * eventcount)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Wakes the threads waiting on an event count.
+      *
+      * PARAMETERS
+      *      eventcount
+      *              pointer to an instance of pthread_eventcount_t
+      *
+      * DESCRIPTION
+      *      Call after making a change that waiters may be
+      *      interested in (e.g. after enqueueing). Every thread
+      *      that has called pthread_eventcount_prepare_wait_np()
+      *      and not yet cancelled is made to return from
+      *      pthread_eventcount_commit_wait_np().
+      *
+      *      When no thread is waiting this is a memory fence and
+      *      a single load; no shared memory is written.
+      *
+      * RESULTS
+      *              0               successfully notified,
+      *              EINVAL          'eventcount' is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (eventcount == NULL || *eventcount == NULL)
+    {
+      return EINVAL;
+    }
+
+  (void) ptw32_eventcount_notify (*eventcount, INT_MAX);
+
+  return 0;
+}
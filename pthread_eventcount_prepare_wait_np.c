@@ -0,0 +1,108 @@
+/*
+ * pthread_eventcount_prepare_wait_np.c
+ *
+ * Description:
+ * This translation unit implements event count primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_eventcount_prepare_wait_np (pthread_eventcount_t * eventcount,
+                                    unsigned int * key)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Announces that the calling thread is about to wait
+      *      on an event count.
+      *
+      * PARAMETERS
+      *      eventcount
+      *              pointer to an instance of pthread_eventcount_t
+      *
+      *      key
+      *              receives the value to pass to
+      *              pthread_eventcount_commit_wait_np()
+      *
+      * DESCRIPTION
+      *      The consumer side of an event count is used as:
+      *
+      *      while (!try_dequeue (&q, &item))
+      *        {
+      *          pthread_eventcount_prepare_wait_np (&ec, &key);
+      *          if (try_dequeue (&q, &item))
+      *            {
+      *              pthread_eventcount_cancel_wait_np (&ec);
+      *              break;
+      *            }
+      *          pthread_eventcount_commit_wait_np (&ec, key, NULL);
+      *        }
+      *
+      *      Any pthread_eventcount_notify_np() that follows this
+      *      call makes the commit return, so a change the second
+      *      check missed can't be slept through. Every call must
+      *      be matched by exactly one commit or cancel.
+      *
+      * RESULTS
+      *              0               successfully prepared,
+      *              EINVAL          'eventcount' or 'key' is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_eventcount_t ec;
+
+  if (eventcount == NULL || *eventcount == NULL || key == NULL)
+    {
+      return EINVAL;
+    }
+
+  ec = *eventcount;
+
+  /*
+   * The Interlocked increment is a full fence: notifiers that read
+   * 'waiters' after their change to the caller's data see it, and the
+   * caller's recheck of the data follows it.
+   */
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ec->waiters);
+
+  *key = (unsigned int) ec->epoch;
+
+  return 0;
+}
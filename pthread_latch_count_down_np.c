@@ -0,0 +1,108 @@
+/*
+ * pthread_latch_count_down_np.c
+ *
+ * Description:
+ * This translation unit implements countdown latch primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_latch_count_down_np (pthread_latch_t * latch)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Counts down a latch, opening it when the count
+      *      reaches zero.
+      *
+      * PARAMETERS
+      *      latch
+      *              pointer to an instance of pthread_latch_t
+      *
+      * DESCRIPTION
+      *      Never blocks. Only the call that opens the latch
+      *      wakes the threads waiting on it; the others are a
+      *      single Interlocked decrement.
+      *
+      *      Memory writes made by each thread before it counts
+      *      down are visible to every thread that has seen the
+      *      latch open.
+      *
+      * RESULTS
+      *              0               successfully counted down,
+      *              EINVAL          'latch' is invalid or already
+      *                              open
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_latch_t l;
+  LONG count;
+
+  if (latch == NULL || *latch == NULL)
+    {
+      return EINVAL;
+    }
+
+  l = *latch;
+
+  count = (LONG) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->count);
+
+  if (count > 0)
+    {
+      return 0;
+    }
+
+  if (count < 0)
+    {
+      /*
+       * Too many count downs. Put it back so the latch stays open.
+       */
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->count);
+      return EINVAL;
+    }
+
+  /*
+   * Cheap if nobody waits: ptw32_wake_address() finds the bucket empty
+   * without taking its lock.
+   */
+  (void) ptw32_wake_address (&l->count, INT_MAX);
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * pthread_latch_destroy_np.c
+ *
+ * Description:
+ * This translation unit implements countdown latch primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_latch_destroy_np (pthread_latch_t * latch)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Destroys a countdown latch.
+      *
+      * PARAMETERS
+      *      latch
+      *              pointer to an instance of pthread_latch_t
+      *
+      * DESCRIPTION
+      *      The latch may be destroyed while it is still closed,
+      *      but not while threads are waiting on it.
+      *
+      * RESULTS
+      *              0               successfully destroyed,
+      *              EINVAL          'latch' is invalid,
+      *              EBUSY           threads are waiting
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_latch_t l;
+
+  if (latch == NULL || *latch == NULL)
+    {
+      return EINVAL;
+    }
+
+  l = *latch;
+
+  if (l->waiters > 0)
+    {
+      return EBUSY;
+    }
+
+  *latch = NULL;
+  (void) free (l);
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * pthread_latch_init_np.c
+ *
+ * Description:
+ * This translation unit implements countdown latch primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_latch_init_np (pthread_latch_t * latch, unsigned int count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Initialises a countdown latch.
+      *
+      * PARAMETERS
+      *      latch
+      *              pointer to an instance of pthread_latch_t
+      *
+      *      count
+      *              number of pthread_latch_count_down_np() calls
+      *              needed to open the latch
+      *
+      * DESCRIPTION
+      *      A latch lets any number of threads wait until 'count'
+      *      events have happened, typically until that many
+      *      workers have finished. Unlike a barrier, the threads
+      *      that count down never wait. Once open a latch stays
+      *      open; it can't be reset.
+      *
+      *      A count of 0 gives a latch that is already open.
+      *
+      * RESULTS
+      *              0               successfully initialised,
+      *              EINVAL          'latch' is NULL or 'count' is
+      *                              too large,
+      *              ENOMEM          insufficient memory
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_latch_t l;
+
+  if (latch == NULL || count > (unsigned int) INT_MAX)
+    {
+      return EINVAL;
+    }
+
+  l = (pthread_latch_t) calloc (1, sizeof (*l));
+
+  if (l == NULL)
+    {
+      return ENOMEM;
+    }
+
+  l->count = (LONG) count;
+  l->waiters = 0;
+
+  *latch = l;
+
+  return 0;
+}
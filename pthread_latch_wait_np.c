@@ -0,0 +1,111 @@
+/*
+ * pthread_latch_wait_np.c
+ *
+ * Description:
+ * This translation unit implements countdown latch primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_latch_wait_np (pthread_latch_t * latch)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits for a countdown latch to open.
+      *
+      * PARAMETERS
+      *      latch
+      *              pointer to an instance of pthread_latch_t
+      *
+      * DESCRIPTION
+      *      Returns at once if the latch is already open.
+      *      Otherwise blocks until the final
+      *      pthread_latch_count_down_np(). Any number of threads
+      *      may wait.
+      *
+      *      Like pthread_barrier_wait(), this routine is not a
+      *      cancellation point.
+      *
+      * RESULTS
+      *              0               the latch is open,
+      *              EINVAL          'latch' is invalid,
+      *              ENOSPC          the thread's wait event could
+      *                              not be created.
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_latch_t l;
+  LONG count;
+  int result = 0;
+
+  if (latch == NULL || *latch == NULL)
+    {
+      return EINVAL;
+    }
+
+  l = *latch;
+
+  if (l->count == 0)
+    {
+      PTW32_COMPILER_BARRIER ();
+      return 0;
+    }
+
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->waiters);
+
+  /*
+   * Only the final count down wakes us, so the count read here is
+   * normally the one we sleep on. If another count down slips in
+   * first the wait returns at once and we go round again.
+   */
+  while (result == 0 && (count = l->count) > 0)
+    {
+      result = ptw32_wait_on_address (&l->count, count, INFINITE, PTW32_FALSE);
+    }
+
+  /*
+   * The Interlocked decrement also orders the caller's reads of the
+   * counted down data after our read of the count.
+   */
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &l->waiters);
+
+  return result;
+}
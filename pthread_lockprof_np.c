@@ -0,0 +1,197 @@
+/*
+ * pthread_lockprof_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable lock profiling functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_lockprof_enable_np (int sampleInterval)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Turns lock contention profiling on or off for
+      *      mutexes created from now on.
+      *
+      * PARAMETERS
+      *      sampleInterval
+      *              0 turns profiling off. Mutexes that are
+      *              already profiled continue to be profiled.
+      *              A positive value turns profiling on and
+      *              records the call site of one in every
+      *              'sampleInterval' contended acquires.
+      *
+      * DESCRIPTION
+      *      Profiled mutexes are kept in a process-wide
+      *      registry and report acquisition counts, contention
+      *      counts and wait and hold time histograms through
+      *      pthread_lockprof_dump_np(). Turning profiling on
+      *      also turns off, for the life of the process, the
+      *      PTW32_INLINE_FASTPATH inline lock paths.
+      *
+      * RESULTS
+      *              0               successfully changed,
+      *              EINVAL          'sampleInterval' is negative,
+      *              ENOSYS          no high resolution counter
+      *
+      * ------------------------------------------------------
+      */
+{
+  LARGE_INTEGER freq;
+
+  if (sampleInterval < 0)
+    {
+      return EINVAL;
+    }
+
+  if (sampleInterval == 0)
+    {
+      ptw32_lockprof_enabled = PTW32_FALSE;
+      return 0;
+    }
+
+  if (!QueryPerformanceFrequency (&freq) || freq.QuadPart <= 0)
+    {
+      return ENOSYS;
+    }
+
+  ptw32_lockprof_frequency = freq.QuadPart;
+  ptw32_lockprof_sample = sampleInterval;
+  ptw32_lockprof_enabled = PTW32_TRUE;
+
+  /*
+   * Profiled mutexes must see every acquire and release.
+   */
+  ptw32_fastpath_v1 = PTW32_FALSE;
+
+  return 0;
+}
+
+
+int
+pthread_lockprof_dump_np (const char * path, int top)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Writes a report of the most contended profiled
+      *      objects.
+      *
+      * PARAMETERS
+      *      path
+      *              file to append the report to, or NULL
+      *              for stderr.
+      *
+      *      top
+      *              maximum number of objects to report, or
+      *              zero to report them all.
+      *
+      * DESCRIPTION
+      *      Objects are ranked by total time spent waiting
+      *      to acquire them. The report can be requested at
+      *      any time; it does not stop the profiled objects.
+      *
+      * RESULTS
+      *              0               report written,
+      *              EINVAL          'top' is negative or profiling
+      *                              has never been turned on,
+      *              ENOMEM          insufficient memory,
+      *              EACCES          the file could not be opened
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (top < 0 || ptw32_lockprof_frequency == 0)
+    {
+      return EINVAL;
+    }
+
+  return ptw32_lockprof_dump (path, top);
+}
+
+
+int
+pthread_lockprof_reset_np (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Clears the statistics of all profiled objects.
+      *
+      * DESCRIPTION
+      *      Call this only while no other thread is using a
+      *      profiled object. Each record is updated without a
+      *      lock by the thread holding the object, and a reset
+      *      racing with an update can leave it inconsistent.
+      *
+      *      Objects that are held at the time of the reset
+      *      don't contribute a hold time for the current
+      *      ownership.
+      *
+      * RESULTS
+      *              0               always
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_lockprof_t * p;
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&ptw32_lockprof_list_lock, &node);
+
+  for (p = ptw32_lockprof_list_head; p != NULL; p = p->next)
+    {
+      p->acquireTime = 0;
+      p->nAcquired = 0;
+      p->nContended = 0;
+      p->nBusy = 0;
+      p->waitTotal = 0;
+      p->waitMax = 0;
+      p->holdTotal = 0;
+      p->holdMax = 0;
+      memset (p->waitHist, 0, sizeof (p->waitHist));
+      memset (p->holdHist, 0, sizeof (p->holdHist));
+      memset (p->sites, 0, sizeof (p->sites));
+      p->nOtherSites = 0;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return 0;
+}
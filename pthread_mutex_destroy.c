@@ -87,13 +87,17 @@ pthread_mutex_destroy (pthread_mutex_t * mutex)
                     {
                       free(mx->robustNode);
                     }
-		  if (!CloseHandle (mx->event))
+		  if (mx->event != NULL && !CloseHandle (mx->event))
 		    {
 		      *mutex = mx;
 		      result = EINVAL;
 		    }
 		  else
 		    {
+		      if (mx->prof != NULL)
+			{
+			  ptw32_lockprof_detach (mx->prof);
+			}
 		      free (mx);
 		    }
 		}
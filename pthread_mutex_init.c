@@ -76,6 +76,16 @@ pthread_mutex_init (pthread_mutex_t * mutex, const pthread_mutexattr_t * attr)
 
 #endif /* _POSIX_THREAD_PROCESS_SHARED */
         }
+
+      if (((*attr)->kind == PTHREAD_MUTEX_FAIR_NP
+           || (*attr)->kind == PTHREAD_MUTEX_BIASED_NP)
+          && (*attr)->robustness == PTHREAD_MUTEX_ROBUST)
+        {
+          /*
+           * Robust mutexes use the barging lock paths.
+           */
+          return EINVAL;
+        }
     }
 
   mx = (pthread_mutex_t) calloc (1, sizeof (*mx));
@@ -89,6 +99,12 @@ pthread_mutex_init (pthread_mutex_t * mutex, const pthread_mutexattr_t * attr)
       mx->lock_idx = 0;
       mx->recursive_count = 0;
       mx->robustNode = NULL;
+      mx->prof = NULL;
+      mx->queueLock = NULL;
+      mx->queueHead = NULL;
+      mx->queueTail = NULL;
+      mx->biasHeld = 0;
+      mx->biasRevoked = 0;
       if (attr == NULL || *attr == NULL)
         {
           mx->kind = PTHREAD_MUTEX_DEFAULT;
@@ -117,15 +133,19 @@ pthread_mutex_init (pthread_mutex_t * mutex, const pthread_mutexattr_t * attr)
 
       mx->ownerThread.p = NULL;
 
-      mx->event = CreateEvent (NULL, PTW32_FALSE,    /* manual reset = No */
-                              PTW32_FALSE,           /* initial state = not signaled */
-                              NULL);                 /* event name */
+      /*
+       * Only robust mutexes use this, and it's created by the first
+       * thread to block. See ptw32_lazy_handle.c.
+       */
+      mx->event = NULL;
 
-      if (0 == mx->event)
+      if (ptw32_lockprof_enabled)
         {
-          result = ENOSPC;
-          free (mx);
-          mx = NULL;
+          /*
+           * Failure to allocate a profile isn't fatal; the mutex
+           * just isn't profiled.
+           */
+          (void) ptw32_lockprof_attach (mx, PTW32_LOCKPROF_MUTEX, mx->kind, &mx->prof);
         }
     }
 
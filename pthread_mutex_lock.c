@@ -51,6 +51,7 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
   int kind;
   pthread_mutex_t mx;
   int result = 0;
+  LONGLONG waitStart = 0;
 
   /*
    * Let the system deal with invalid pointers.
@@ -86,18 +87,81 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
 		       (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 		       (PTW32_INTERLOCKED_LONG) 1) != 0)
 	    {
+	      if (mx->prof != NULL)
+		{
+		  waitStart = ptw32_lockprof_now ();
+		}
 	      while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
                               (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			      (PTW32_INTERLOCKED_LONG) -1) != 0)
 	        {
-	          if (WAIT_OBJECT_0 != WaitForSingleObject (mx->event, INFINITE))
+	          if (0 != (result = ptw32_wait_on_address (&mx->lock_idx, -1, INFINITE, PTW32_FALSE)))
 	            {
-	              result = EINVAL;
 		      break;
 	            }
 	        }
 	    }
         }
+      else if (PTHREAD_MUTEX_BIASED_NP == kind)
+        {
+          pthread_t self = pthread_self();
+          int biased = PTW32_FALSE;
+
+          if (mx->ownerThread.p == self.p)
+            {
+              /*
+               * Biased towards us. See ptw32_mutex_bias.c.
+               */
+              mx->biasHeld = 1;
+              PTW32_COMPILER_BARRIER ();
+              biased = (0 == mx->biasRevoked);
+              if (!biased)
+                {
+                  mx->biasHeld = 0;
+                }
+            }
+
+          if (!biased)
+            {
+              if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                           (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                           (PTW32_INTERLOCKED_LONG) 1) != 0)
+                {
+                  if (mx->prof != NULL)
+                    {
+                      waitStart = ptw32_lockprof_now ();
+                    }
+                  while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                                  (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                  (PTW32_INTERLOCKED_LONG) -1) != 0)
+                    {
+                      if (0 != (result = ptw32_wait_on_address (&mx->lock_idx, -1, INFINITE, PTW32_FALSE)))
+                        {
+                          break;
+                        }
+                    }
+                }
+
+              if (0 == result)
+                {
+                  result = ptw32_mutex_bias_acquired (mx, self, PTW32_TRUE);
+                }
+            }
+        }
+      else if (PTHREAD_MUTEX_FAIR_NP == kind)
+        {
+          if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                       (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+		       (PTW32_INTERLOCKED_LONG) 1,
+		       (PTW32_INTERLOCKED_LONG) 0) != 0)
+	    {
+	      if (mx->prof != NULL)
+		{
+		  waitStart = ptw32_lockprof_now ();
+		}
+	      result = ptw32_mutex_fair_wait (mx, NULL);
+	    }
+        }
       else
         {
           pthread_t self = pthread_self();
@@ -125,13 +189,16 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
 	        }
 	      else
 	        {
+		  if (mx->prof != NULL)
+		    {
+		      waitStart = ptw32_lockprof_now ();
+		    }
 	          while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
                                   (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			          (PTW32_INTERLOCKED_LONG) -1) != 0)
 		    {
-	              if (WAIT_OBJECT_0 != WaitForSingleObject (mx->event, INFINITE))
+	              if (0 != (result = ptw32_wait_on_address (&mx->lock_idx, -1, INFINITE, PTW32_FALSE)))
 		        {
-	                  result = EINVAL;
 		          break;
 		        }
 		    }
@@ -172,7 +239,15 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
                            (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
                            (PTW32_INTERLOCKED_LONG) 1) != 0)
                 {
-                  while (0 == (result = ptw32_robust_mutex_inherit(mutex))
+                  if (mx->prof != NULL)
+                    {
+                      waitStart = ptw32_lockprof_now ();
+                    }
+                  if (mx->event == NULL && ptw32_lazy_event (&mx->event) == NULL)
+                    {
+                      result = ENOSPC;
+                    }
+                  while (0 == result && 0 == (result = ptw32_robust_mutex_inherit(mutex))
                            && (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
                                        (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
                                        (PTW32_INTERLOCKED_LONG) -1) != 0)
@@ -232,7 +307,15 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
                     }
                   else
                     {
-                      while (0 == (result = ptw32_robust_mutex_inherit(mutex))
+                      if (mx->prof != NULL)
+                        {
+                          waitStart = ptw32_lockprof_now ();
+                        }
+                      if (mx->event == NULL && ptw32_lazy_event (&mx->event) == NULL)
+                        {
+                          result = ENOSPC;
+                        }
+                      while (0 == result && 0 == (result = ptw32_robust_mutex_inherit(mutex))
                                && (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
                                            (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
                                            (PTW32_INTERLOCKED_LONG) -1) != 0)
@@ -269,6 +352,11 @@ pthread_mutex_lock (pthread_mutex_t * mutex)
         }
     }
 
+  if (mx->prof != NULL && (0 == result || EOWNERDEAD == result))
+    {
+      ptw32_lockprof_acquired (mx, waitStart, PTW32_RETURN_ADDRESS());
+    }
+
   return (result);
 }
 
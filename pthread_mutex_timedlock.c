@@ -49,7 +49,7 @@ ptw32_timed_eventwait (HANDLE event, const struct timespec *abstime)
       * ------------------------------------------------------
       * DESCRIPTION
       *      This function waits on an event until signaled or until
-      *      abstime passes.
+      *      abstime passes. Used by the robust kinds.
       *      If abstime has passed when this routine is called then
       *      it returns a result to indicate this.
       *
@@ -109,6 +109,32 @@ ptw32_timed_eventwait (HANDLE event, const struct timespec *abstime)
 }				/* ptw32_timed_semwait */
 
 
+static INLINE int
+ptw32_timed_addresswait (pthread_mutex_t mx, const struct timespec *abstime)
+     /*
+      * ------------------------------------------------------
+      * DESCRIPTION
+      *      This function waits for lock_idx to change from -1
+      *      or until abstime passes. Used by the non-robust
+      *      kinds (see ptw32_park.c). It may return 0 without
+      *      lock_idx having changed.
+      *
+      *      This routine is not a cancellation point.
+      *
+      * RESULTS
+      *              0               woken,
+      *              ETIMEDOUT       abstime passed
+      *              ENOSPC          no park event
+      *
+      * ------------------------------------------------------
+      */
+{
+  return ptw32_wait_on_address (&mx->lock_idx, -1,
+                                (abstime == NULL) ? INFINITE : ptw32_relmillisecs (abstime),
+                                PTW32_FALSE);
+}				/* ptw32_timed_addresswait */
+
+
 int
 pthread_mutex_timedlock (pthread_mutex_t * mutex,
 			 const struct timespec *abstime)
@@ -116,6 +142,7 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
   pthread_mutex_t mx;
   int kind;
   int result = 0;
+  LONGLONG waitStart = 0;
 
   /*
    * Let the system deal with invalid pointers.
@@ -146,17 +173,84 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
 		       (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 		       (PTW32_INTERLOCKED_LONG) 1) != 0)
 	    {
+              if (mx->prof != NULL)
+                {
+                  waitStart = ptw32_lockprof_now ();
+                }
               while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
                               (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			      (PTW32_INTERLOCKED_LONG) -1) != 0)
                 {
-	          if (0 != (result = ptw32_timed_eventwait (mx->event, abstime)))
+	          if (0 != (result = ptw32_timed_addresswait (mx, abstime)))
 		    {
 		      return result;
 		    }
 	        }
 	    }
         }
+      else if (mx->kind == PTHREAD_MUTEX_BIASED_NP)
+        {
+          pthread_t self = pthread_self();
+          int biased = PTW32_FALSE;
+
+          if (mx->ownerThread.p == self.p)
+            {
+              /*
+               * Biased towards us. See ptw32_mutex_bias.c.
+               */
+              mx->biasHeld = 1;
+              PTW32_COMPILER_BARRIER ();
+              biased = (0 == mx->biasRevoked);
+              if (!biased)
+                {
+                  mx->biasHeld = 0;
+                }
+            }
+
+          if (!biased)
+            {
+              if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                           (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                           (PTW32_INTERLOCKED_LONG) 1) != 0)
+                {
+                  if (mx->prof != NULL)
+                    {
+                      waitStart = ptw32_lockprof_now ();
+                    }
+                  while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
+                                  (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                  (PTW32_INTERLOCKED_LONG) -1) != 0)
+                    {
+                      if (0 != (result = ptw32_timed_addresswait (mx, abstime)))
+                        {
+                          return result;
+                        }
+                    }
+                }
+
+              if (0 != (result = ptw32_mutex_bias_acquired (mx, self, PTW32_TRUE)))
+                {
+                  return result;
+                }
+            }
+        }
+      else if (mx->kind == PTHREAD_MUTEX_FAIR_NP)
+        {
+          if ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG(
+                       (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+		       (PTW32_INTERLOCKED_LONG) 1,
+		       (PTW32_INTERLOCKED_LONG) 0) != 0)
+	    {
+              if (mx->prof != NULL)
+                {
+                  waitStart = ptw32_lockprof_now ();
+                }
+	      if (0 != (result = ptw32_mutex_fair_wait (mx, abstime)))
+		{
+		  return result;
+		}
+	    }
+        }
       else
         {
           pthread_t self = pthread_self();
@@ -184,11 +278,15 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
 	        }
 	      else
 	        {
+                  if (mx->prof != NULL)
+                    {
+                      waitStart = ptw32_lockprof_now ();
+                    }
                   while ((PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
                                   (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 			          (PTW32_INTERLOCKED_LONG) -1) != 0)
                     {
-		      if (0 != (result = ptw32_timed_eventwait (mx->event, abstime)))
+		      if (0 != (result = ptw32_timed_addresswait (mx, abstime)))
 		        {
 		          return result;
 		        }
@@ -227,6 +325,14 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
 		           (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
 		           (PTW32_INTERLOCKED_LONG) 1) != 0)
 	        {
+                  if (mx->prof != NULL)
+                    {
+                      waitStart = ptw32_lockprof_now ();
+                    }
+                  if (mx->event == NULL && ptw32_lazy_event (&mx->event) == NULL)
+                    {
+                      return ENOSPC;
+                    }
                   while (0 == (result = ptw32_robust_mutex_inherit(mutex))
                            && (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
                                   (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
@@ -289,6 +395,14 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
 	            }
 	          else
 	            {
+                      if (mx->prof != NULL)
+                        {
+                          waitStart = ptw32_lockprof_now ();
+                        }
+                      if (mx->event == NULL && ptw32_lazy_event (&mx->event) == NULL)
+                        {
+                          return ENOSPC;
+                        }
                       while (0 == (result = ptw32_robust_mutex_inherit(mutex))
                                && (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_EXCHANGE_LONG(
                                           (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
@@ -324,5 +438,10 @@ pthread_mutex_timedlock (pthread_mutex_t * mutex,
         }
     }
 
+  if (mx->prof != NULL && (0 == result || EOWNERDEAD == result))
+    {
+      ptw32_lockprof_acquired (mx, waitStart, PTW32_RETURN_ADDRESS());
+    }
+
   return result;
 }
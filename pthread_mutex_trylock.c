@@ -71,7 +71,46 @@ pthread_mutex_trylock (pthread_mutex_t * mutex)
   mx = *mutex;
   kind = mx->kind;
 
-  if (kind >= 0)
+  if (kind == PTHREAD_MUTEX_BIASED_NP)
+    {
+      pthread_t self = pthread_self();
+      int biased = PTW32_FALSE;
+
+      if (mx->ownerThread.p == self.p)
+        {
+          if (mx->biasHeld)
+            {
+              return EBUSY;
+            }
+
+          /*
+           * Biased towards us. See ptw32_mutex_bias.c.
+           */
+          mx->biasHeld = 1;
+          PTW32_COMPILER_BARRIER ();
+          biased = (0 == mx->biasRevoked);
+          if (!biased)
+            {
+              mx->biasHeld = 0;
+            }
+        }
+
+      if (!biased)
+        {
+          if (0 == (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG (
+                             (PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                             (PTW32_INTERLOCKED_LONG) 1,
+                             (PTW32_INTERLOCKED_LONG) 0))
+            {
+              result = ptw32_mutex_bias_acquired (mx, self, PTW32_FALSE);
+            }
+          else
+            {
+              result = EBUSY;
+            }
+        }
+    }
+  else if (kind >= 0)
     {
       /* Non-robust */
       if (0 == (PTW32_INTERLOCKED_LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG (
@@ -79,7 +118,7 @@ pthread_mutex_trylock (pthread_mutex_t * mutex)
 		         (PTW32_INTERLOCKED_LONG) 1,
 		         (PTW32_INTERLOCKED_LONG) 0))
         {
-          if (kind != PTHREAD_MUTEX_NORMAL)
+          if (kind != PTHREAD_MUTEX_NORMAL && kind != PTHREAD_MUTEX_FAIR_NP)
 	    {
 	      mx->recursive_count = 1;
 	      mx->ownerThread = pthread_self ();
@@ -155,5 +194,17 @@ pthread_mutex_trylock (pthread_mutex_t * mutex)
         }
     }
 
+  if (mx->prof != NULL)
+    {
+      if (0 == result || EOWNERDEAD == result)
+        {
+          ptw32_lockprof_acquired (mx, 0, PTW32_RETURN_ADDRESS());
+        }
+      else if (EBUSY == result)
+        {
+          ptw32_lockprof_busy (mx);
+        }
+    }
+
   return (result);
 }
@@ -71,8 +71,18 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
 	    {
 	      LONG idx;
 
-	      idx = (LONG) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR)&mx->lock_idx,
-							    (PTW32_INTERLOCKED_LONG)0);
+	      if (mx->prof != NULL)
+		{
+		  ptw32_lockprof_released (mx);
+		}
+
+	      /*
+	       * Release ordering is enough here: whether to wake depends
+	       * only on the value swapped out, and ptw32_wake_address
+	       * fences before it looks for waiters.
+	       */
+	      idx = (LONG) PTW32_ATOMIC_EXCHANGE_RELEASE ((PTW32_INTERLOCKED_LONGPTR)&mx->lock_idx,
+							  (PTW32_INTERLOCKED_LONG)0);
 	      if (idx != 0)
 	        {
 	          if (idx < 0)
@@ -80,13 +90,51 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
 		      /*
 		       * Someone may be waiting on that mutex.
 		       */
-		      if (SetEvent (mx->event) == 0)
-		        {
-		          result = EINVAL;
-		        }
+		      (void) ptw32_wake_address (&mx->lock_idx, 1);
 		    }
 	        }
 	    }
+          else if (kind == PTHREAD_MUTEX_BIASED_NP)
+	    {
+	      pthread_t self = pthread_self();
+
+	      if (mx->prof != NULL)
+		{
+		  ptw32_lockprof_released (mx);
+		}
+
+	      if (mx->ownerThread.p == self.p && mx->biasHeld)
+	        {
+		  /*
+		   * Held through the bias. See ptw32_mutex_bias.c.
+		   */
+		  PTW32_COMPILER_BARRIER ();
+		  mx->biasHeld = 0;
+	        }
+	      else if ((LONG) PTW32_ATOMIC_EXCHANGE_RELEASE ((PTW32_INTERLOCKED_LONGPTR)&mx->lock_idx,
+							     (PTW32_INTERLOCKED_LONG)0) < 0)
+	        {
+		  (void) ptw32_wake_address (&mx->lock_idx, 1);
+	        }
+	    }
+          else if (kind == PTHREAD_MUTEX_FAIR_NP)
+	    {
+	      if (mx->prof != NULL)
+		{
+		  ptw32_lockprof_released (mx);
+		}
+
+	      /*
+	       * With waiters queued, ownership passes straight to the
+	       * longest waiter and the mutex is never free.
+	       */
+	      if ((LONG) PTW32_ATOMIC_COMPARE_EXCHANGE_RELEASE ((PTW32_INTERLOCKED_LONGPTR)&mx->lock_idx,
+								(PTW32_INTERLOCKED_LONG)0,
+								(PTW32_INTERLOCKED_LONG)1) != 1)
+	        {
+		  result = ptw32_mutex_fair_release (mx);
+	        }
+	    }
           else
 	    {
 	      if (pthread_equal (mx->ownerThread, pthread_self()))
@@ -94,16 +142,18 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
 	          if (kind != PTHREAD_MUTEX_RECURSIVE
 		      || 0 == --mx->recursive_count)
 		    {
+		      if (mx->prof != NULL)
+			{
+			  ptw32_lockprof_released (mx);
+			}
+
 		      mx->ownerThread.p = NULL;
 
-		      if ((LONG) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR)&mx->lock_idx,
-							          (PTW32_INTERLOCKED_LONG)0) < 0L)
+		      if ((LONG) PTW32_ATOMIC_EXCHANGE_RELEASE ((PTW32_INTERLOCKED_LONGPTR)&mx->lock_idx,
+							        (PTW32_INTERLOCKED_LONG)0) < 0L)
 		        {
 		          /* Someone may be waiting on that mutex */
-		          if (SetEvent (mx->event) == 0)
-			    {
-			      result = EINVAL;
-			    }
+		          (void) ptw32_wake_address (&mx->lock_idx, 1);
 		        }
 		    }
 	        }
@@ -130,6 +180,11 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
                                                       (PTW32_INTERLOCKED_LONG)PTW32_ROBUST_INCONSISTENT);
               if (PTHREAD_MUTEX_NORMAL == kind)
                 {
+                  if (mx->prof != NULL)
+                    {
+                      ptw32_lockprof_released (mx);
+                    }
+
                   ptw32_robust_mutex_remove(mutex, NULL);
 
                   if ((LONG) PTW32_INTERLOCKED_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
@@ -149,6 +204,11 @@ pthread_mutex_unlock (pthread_mutex_t * mutex)
                   if (kind != PTHREAD_MUTEX_RECURSIVE
                       || 0 == --mx->recursive_count)
                     {
+                      if (mx->prof != NULL)
+                        {
+                          ptw32_lockprof_released (mx);
+                        }
+
                       ptw32_robust_mutex_remove(mutex, NULL);
 
                       if ((LONG) PTW32_INTERLOCKED_EXCHANGE_LONG((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
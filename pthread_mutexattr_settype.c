@@ -69,6 +69,10 @@ pthread_mutexattr_settype (pthread_mutexattr_t * attr, int kind)
       *
       *                      PTHREAD_MUTEX_RECURSIVE
       *
+      *                      PTHREAD_MUTEX_FAIR_NP
+      *
+      *                      PTHREAD_MUTEX_BIASED_NP
+      *
       * DESCRIPTION
       * The pthread_mutexattr_settype() and
       * pthread_mutexattr_gettype() functions  respectively set and
@@ -116,6 +120,25 @@ pthread_mutexattr_settype (pthread_mutexattr_t * attr, int kind)
       *          process        shared         attribute         is
       *          PTHREAD_PROCESS_PRIVATE.
       *
+      * PTHREAD_MUTEX_FAIR_NP
+      *          Non-portable. Behaves as PTHREAD_MUTEX_NORMAL except
+      *          that the mutex is handed directly to the thread that
+      *          has waited longest when it is unlocked, instead of
+      *          being made free for any thread to take. This bounds
+      *          the time a thread can wait at the cost of throughput
+      *          under contention. Can't be combined with
+      *          PTHREAD_MUTEX_ROBUST.
+      *
+      * PTHREAD_MUTEX_BIASED_NP
+      *          Non-portable. Behaves as PTHREAD_MUTEX_NORMAL but is
+      *          optimised for mutexes locked almost exclusively by
+      *          one thread. The first thread to lock the mutex can
+      *          then lock and unlock it without Interlocked
+      *          operations. The first time another thread locks it
+      *          the bias is revoked, which is expensive, and the
+      *          mutex behaves as PTHREAD_MUTEX_NORMAL from then on.
+      *          Can't be combined with PTHREAD_MUTEX_ROBUST.
+      *
       * RESULTS
       *              0               successfully set attribute,
       *              EINVAL          'attr' or 'type' is invalid,
@@ -132,6 +155,8 @@ pthread_mutexattr_settype (pthread_mutexattr_t * attr, int kind)
 	case PTHREAD_MUTEX_FAST_NP:
 	case PTHREAD_MUTEX_RECURSIVE_NP:
 	case PTHREAD_MUTEX_ERRORCHECK_NP:
+	case PTHREAD_MUTEX_FAIR_NP:
+	case PTHREAD_MUTEX_BIASED_NP:
 	  (*attr)->kind = kind;
 	  break;
 	default:
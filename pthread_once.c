@@ -50,9 +50,12 @@ pthread_once (pthread_once_t * once_control, void (PTW32_CDECL *init_routine) (v
       return EINVAL;
     }
   
+  /*
+   * Acquire pairs with the release store of 'done' below, so that a
+   * caller who sees it set also sees everything init_routine wrote.
+   */
   if ((PTW32_INTERLOCKED_LONG)PTW32_FALSE ==
-      (PTW32_INTERLOCKED_LONG)PTW32_INTERLOCKED_EXCHANGE_ADD_LONG((PTW32_INTERLOCKED_LONGPTR)&once_control->done,
-                                                                  (PTW32_INTERLOCKED_LONG)0)) /* MBR fence */
+      (PTW32_INTERLOCKED_LONG)PTW32_ATOMIC_LOAD_ACQUIRE((PTW32_INTERLOCKED_LONGPTR)&once_control->done))
     {
       ptw32_mcs_local_node_t node;
 
@@ -73,7 +76,8 @@ pthread_once (pthread_once_t * once_control, void (PTW32_CDECL *init_routine) (v
 #pragma inline_depth()
 #endif
 
-	  once_control->done = PTW32_TRUE;
+	  PTW32_ATOMIC_STORE_RELEASE((PTW32_INTERLOCKED_LONGPTR)&once_control->done,
+				     (PTW32_INTERLOCKED_LONG)PTW32_TRUE);
 	}
 
       ptw32_mcs_lock_release(&node);
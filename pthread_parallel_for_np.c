@@ -0,0 +1,239 @@
+/*
+ * pthread_parallel_for_np.c
+ *
+ * Description:
+ * This translation unit implements parallel loop primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_parallel_for_np (long begin,
+                         long end,
+                         long grain,
+                         void (PTW32_CDECL *routine) (long, long, void *),
+                         void * arg,
+                         int policy)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Runs a loop over a range of indices on several
+      *      threads.
+      *
+      * PARAMETERS
+      *      begin, end
+      *              the range [begin, end)
+      *
+      *      grain
+      *              chunk size, or 0 to let the library choose
+      *
+      *      routine
+      *              called as routine (first, last, arg) for
+      *              disjoint subranges [first, last) that together
+      *              cover the range
+      *
+      *      arg
+      *              passed to 'routine'
+      *
+      *      policy
+      *              PTHREAD_PARALLEL_STATIC_NP,
+      *              PTHREAD_PARALLEL_DYNAMIC_NP or
+      *              PTHREAD_PARALLEL_GUIDED_NP
+      *
+      * DESCRIPTION
+      *      The calling thread and the workers of a pool shared
+      *      by the whole process run 'routine' on pieces of the
+      *      range. Returns when every piece has finished.
+      *
+      *      With PTHREAD_PARALLEL_STATIC_NP each thread gets one
+      *      equal share of the range, or if 'grain' is given
+      *      every nth chunk of 'grain' iterations. With
+      *      PTHREAD_PARALLEL_DYNAMIC_NP threads take chunks of
+      *      'grain' iterations in turn as they finish the last.
+      *      With PTHREAD_PARALLEL_GUIDED_NP the chunks start
+      *      large and shrink as the range runs out, down to
+      *      'grain'.
+      *
+      *      A loop started from inside 'routine', or when the
+      *      range is no more than one chunk, runs on the calling
+      *      thread as a single call of 'routine' for the whole
+      *      range.
+      *
+      *      If the calling thread is cancelled or exits while in
+      *      'routine', no further pieces are started and the
+      *      thread waits for those already running on other
+      *      threads before it unwinds.
+      *
+      * RESULTS
+      *              0               successfully completed,
+      *              EINVAL          'routine', 'grain' or 'policy'
+      *                              is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_parallel_job_t job;
+  ptw32_pool_task_t tasks[PTW32_PARALLEL_SUBMIT_BATCH];
+  ptw32_thread_t * sp;
+  pthread_pool_t team = NULL;
+  unsigned long count;
+  int teamSize;
+  int helpers;
+  int queued;
+  int n;
+
+  if (routine == NULL
+      || grain < 0
+      || (policy != PTHREAD_PARALLEL_STATIC_NP
+          && policy != PTHREAD_PARALLEL_DYNAMIC_NP
+          && policy != PTHREAD_PARALLEL_GUIDED_NP))
+    {
+      return EINVAL;
+    }
+
+  if (begin >= end)
+    {
+      return 0;
+    }
+
+  count = (unsigned long) end - (unsigned long) begin;
+  sp = (ptw32_thread_t *) pthread_self ().p;
+
+  if (sp != NULL && sp->parallelLevel == 0)
+    {
+      team = ptw32_parallel_get_team (&teamSize);
+    }
+
+  if (team == NULL)
+    {
+      (*routine) (begin, end, arg);
+      return 0;
+    }
+
+  job.grain = (unsigned long) grain;
+
+  if (policy == PTHREAD_PARALLEL_DYNAMIC_NP && job.grain == 0)
+    {
+      job.grain = count / (PTW32_PARALLEL_DYNAMIC_CHUNKS * (unsigned long) (teamSize + 1));
+    }
+
+  if (policy != PTHREAD_PARALLEL_STATIC_NP && job.grain == 0)
+    {
+      job.grain = 1;
+    }
+
+  /*
+   * Dynamic chunk numbers must stay clear of the top of the cursor.
+   */
+  if (policy == PTHREAD_PARALLEL_DYNAMIC_NP && (count - 1) / job.grain >= LONG_MAX)
+    {
+      job.grain = count / LONG_MAX + 1;
+    }
+
+  job.begin = begin;
+  job.count = count;
+  job.chunks = (job.grain == 0) ? count : (count - 1) / job.grain + 1;
+  job.routine = routine;
+  job.arg = arg;
+  job.policy = policy;
+  job.nThreads = (job.chunks < (unsigned long) teamSize + 1) ? (int) job.chunks : teamSize + 1;
+  job.nextId = 0;
+  job.cursor = 0;
+
+  if (job.nThreads == 1)
+    {
+      (*routine) (begin, end, arg);
+      return 0;
+    }
+
+  helpers = job.nThreads - 1;
+  job.helpers = (LONG) helpers;
+
+  for (n = 0; n < PTW32_PARALLEL_SUBMIT_BATCH; n++)
+    {
+      tasks[n].routine = ptw32_parallel_helper;
+      tasks[n].arg = &job;
+    }
+
+  sp->parallelLevel++;
+
+  pthread_cleanup_push (ptw32_parallel_finish, (void *) &job);
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &team->pending,
+                                              (PTW32_INTERLOCKED_LONG) helpers);
+
+  for (queued = 0; queued < helpers; queued += n)
+    {
+      n = helpers - queued;
+      n = (n < PTW32_PARALLEL_SUBMIT_BATCH) ? n : PTW32_PARALLEL_SUBMIT_BATCH;
+
+      if (0 != ptw32_pool_inject (team, tasks, n))
+        {
+          break;
+        }
+    }
+
+  if (queued < helpers)
+    {
+      /*
+       * Out of memory for the queue: the threads taking part do the
+       * missing helpers' work between them.
+       */
+      n = helpers - queued;
+
+      if (n == PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &team->pending,
+                                                    (PTW32_INTERLOCKED_LONG) -n))
+        {
+          (void) ptw32_eventcount_notify (team->idle, INT_MAX);
+        }
+      (void) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &job.helpers,
+                                                  (PTW32_INTERLOCKED_LONG) -n);
+    }
+
+  if (queued > 0)
+    {
+      ptw32_pool_wake (team, queued);
+    }
+
+  ptw32_parallel_run (&job);
+
+  pthread_cleanup_pop (1);
+
+  return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * pthread_pool_init_np.c
+ *
+ * Description:
+ * This translation unit implements thread pool primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+#include "sched.h"
+
+
+int
+pthread_pool_init_np (pthread_pool_t * pool, const pthread_attr_t * attr,
+                      int minThreads, int maxThreads)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates a thread pool.
+      *
+      * PARAMETERS
+      *      pool
+      *              pointer to an instance of pthread_pool_t
+      *
+      *      attr
+      *              attributes for the worker threads, or NULL
+      *
+      *      minThreads
+      *              number of workers started now and kept
+      *              running
+      *
+      *      maxThreads
+      *              most workers the pool may run at once, or 0
+      *              for the number of processors available to
+      *              the process
+      *
+      * DESCRIPTION
+      *      A pool runs submitted tasks on a set of worker
+      *      threads. If maxThreads is greater than minThreads
+      *      the pool is elastic: it starts workers as tasks
+      *      arrive while all workers are busy, and workers
+      *      beyond minThreads exit after a period with no work.
+      *
+      *      Workers are created with pthread_create() and the
+      *      stack size, scheduling and CPU affinity (see
+      *      pthread_attr_setaffinity_np()) of 'attr'. Its detach
+      *      state and stack address are ignored. Without an
+      *      affinity in 'attr' workers may run on any processor
+      *      available to the process, whichever thread happens to
+      *      start them.
+      *
+      * RESULTS
+      *              0               successfully created,
+      *              EINVAL          an argument is invalid,
+      *              ENOMEM          insufficient memory,
+      *              EAGAIN          a worker could not be started
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_pool_t p;
+  int result;
+  int i;
+
+  if (pool == NULL
+      || minThreads < 0
+      || maxThreads < 0
+      || (attr != NULL && ptw32_is_attr (attr) != 0))
+    {
+      return EINVAL;
+    }
+
+  if (maxThreads == 0)
+    {
+      maxThreads = pthread_num_processors_np ();
+      if (maxThreads < minThreads)
+        {
+          maxThreads = minThreads;
+        }
+      if (maxThreads < 1)
+        {
+          maxThreads = 1;
+        }
+    }
+
+  if (maxThreads < minThreads)
+    {
+      return EINVAL;
+    }
+
+  p = (pthread_pool_t) calloc (1, sizeof (*p));
+
+  if (p == NULL)
+    {
+      return ENOMEM;
+    }
+
+  p->minThreads = minThreads;
+  p->maxThreads = maxThreads;
+
+  if (0 != (result = pthread_attr_init (&p->attr)))
+    {
+      free (p);
+      return result;
+    }
+
+  if (attr != NULL)
+    {
+      p->attr->stacksize = (*attr)->stacksize;
+      p->attr->param = (*attr)->param;
+      p->attr->inheritsched = (*attr)->inheritsched;
+      p->attr->contentionscope = (*attr)->contentionscope;
+      p->attr->cpuset = (*attr)->cpuset;
+    }
+
+#if defined(HAVE_CPU_AFFINITY)
+  {
+    /*
+     * Workers would otherwise inherit the affinity of whichever
+     * thread starts them, which in an elastic pool is a submitter.
+     * Given the process's CPUs they are spread over its processor
+     * groups (see ptw32_cpugroups.c).
+     */
+    cpu_set_t cpus;
+
+    if (CPU_COUNT(&p->attr->cpuset) == 0
+        && 0 == sched_getaffinity (0, sizeof (cpus), &cpus))
+      {
+        p->attr->cpuset = cpus;
+      }
+  }
+#endif
+
+  if (NULL == (p->workers = (ptw32_pool_worker_t *) calloc (maxThreads, sizeof (ptw32_pool_worker_t)))
+      || 0 != pthread_eventcount_init_np (&p->wakeup)
+      || 0 != pthread_eventcount_init_np (&p->idle))
+    {
+      result = ENOMEM;
+      goto FAIL0;
+    }
+
+  for (i = 0; i < maxThreads; i++)
+    {
+      p->workers[i].pool = p;
+      p->workers[i].seed = (unsigned int) i;
+    }
+
+  for (i = 0; i < minThreads; i++)
+    {
+      if (0 != (result = ptw32_pool_spawn (p)))
+        {
+          result = EAGAIN;
+          goto FAIL0;
+        }
+    }
+
+  *pool = p;
+
+  return 0;
+
+FAIL0:
+  ptw32_pool_free (p);
+
+  return result;
+}
@@ -0,0 +1,154 @@
+/*
+ * pthread_pool_submit_batch_np.c
+ *
+ * Description:
+ * This translation unit implements thread pool primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_pool_submit_batch_np (pthread_pool_t * pool,
+                              void (PTW32_CDECL *routine) (void *),
+                              void ** args,
+                              int count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Submits several tasks to a thread pool at once.
+      *
+      * PARAMETERS
+      *      pool
+      *              pointer to an instance of pthread_pool_t
+      *
+      *      routine
+      *              the task
+      *
+      *      args
+      *              array of 'count' arguments; 'routine' is
+      *              called once with each
+      *
+      *      count
+      *              number of tasks
+      *
+      * DESCRIPTION
+      *      As 'count' calls of pthread_pool_submit_np(), but
+      *      the shared queue is locked once and sleeping workers
+      *      are woken together.
+      *
+      *      If the result is ENOMEM none of the tasks were
+      *      submitted.
+      *
+      * RESULTS
+      *              0               successfully submitted,
+      *              EINVAL          an argument is invalid,
+      *              ENOMEM          insufficient memory
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_pool_t p;
+  ptw32_pool_worker_t * w;
+  ptw32_pool_task_t * tasks;
+  ptw32_pool_task_t task;
+  int result = 0;
+  int i;
+
+  if (pool == NULL || *pool == NULL || routine == NULL
+      || count < 0 || (count > 0 && args == NULL))
+    {
+      return EINVAL;
+    }
+
+  if (count == 0)
+    {
+      return 0;
+    }
+
+  p = *pool;
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &p->pending,
+                                              (PTW32_INTERLOCKED_LONG) count);
+
+  if (NULL != (w = ptw32_pool_self (p)))
+    {
+      /*
+       * Once there is room for all of them the pushes can't fail.
+       */
+      if (0 == (result = ptw32_pool_reserve (w, (LONG) count)))
+        {
+          task.routine = routine;
+
+          for (i = 0; i < count; i++)
+            {
+              task.arg = args[i];
+              (void) ptw32_pool_push (w, &task);
+            }
+        }
+    }
+  else if (NULL != (tasks = (ptw32_pool_task_t *) malloc (count * sizeof (ptw32_pool_task_t))))
+    {
+      for (i = 0; i < count; i++)
+        {
+          tasks[i].routine = routine;
+          tasks[i].arg = args[i];
+        }
+
+      result = ptw32_pool_inject (p, tasks, count);
+      free (tasks);
+    }
+  else
+    {
+      result = ENOMEM;
+    }
+
+  if (result != 0)
+    {
+      if (count == PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &p->pending,
+                                                        (PTW32_INTERLOCKED_LONG) -count))
+        {
+          (void) ptw32_eventcount_notify (p->idle, INT_MAX);
+        }
+      return result;
+    }
+
+  ptw32_pool_wake (p, count);
+
+  return 0;
+}
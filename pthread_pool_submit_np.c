@@ -0,0 +1,111 @@
+/*
+ * pthread_pool_submit_np.c
+ *
+ * Description:
+ * This translation unit implements thread pool primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_pool_submit_np (pthread_pool_t * pool,
+                        void (PTW32_CDECL *routine) (void *),
+                        void * arg)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Submits a task to a thread pool.
+      *
+      * PARAMETERS
+      *      pool
+      *              pointer to an instance of pthread_pool_t
+      *
+      *      routine
+      *              the task
+      *
+      *      arg
+      *              passed to 'routine'
+      *
+      * DESCRIPTION
+      *      'routine' will be called with 'arg' by one of the
+      *      pool's workers. Tasks submitted by a task of the same
+      *      pool are kept on that worker's own queue, from which
+      *      idle workers steal; those submitted from any other
+      *      thread go on a shared queue.
+      *
+      * RESULTS
+      *              0               successfully submitted,
+      *              EINVAL          an argument is invalid,
+      *              ENOMEM          insufficient memory
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_pool_t p;
+  ptw32_pool_worker_t * w;
+  ptw32_pool_task_t task;
+  int result;
+
+  if (pool == NULL || *pool == NULL || routine == NULL)
+    {
+      return EINVAL;
+    }
+
+  p = *pool;
+  task.routine = routine;
+  task.arg = arg;
+
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &p->pending);
+
+  w = ptw32_pool_self (p);
+  result = (w != NULL) ? ptw32_pool_push (w, &task) : ptw32_pool_inject (p, &task, 1);
+
+  if (result != 0)
+    {
+      if (0 == PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &p->pending))
+        {
+          (void) ptw32_eventcount_notify (p->idle, INT_MAX);
+        }
+      return result;
+    }
+
+  ptw32_pool_wake (p, 1);
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * pthread_pool_wait_idle_np.c
+ *
+ * Description:
+ * This translation unit implements thread pool primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_pool_wait_idle_np (pthread_pool_t * pool)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Waits until a thread pool has run every task
+      *      submitted to it.
+      *
+      * PARAMETERS
+      *      pool
+      *              pointer to an instance of pthread_pool_t
+      *
+      * DESCRIPTION
+      *      Returns once no task is queued or running, including
+      *      tasks submitted by other tasks while waiting.
+      *
+      *      This routine is a cancellation point.
+      *
+      * RESULTS
+      *              0               the pool is idle,
+      *              EINVAL          'pool' is invalid,
+      *              EDEADLK         called from one of the pool's
+      *                              own tasks
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_pool_t p;
+  unsigned int key;
+  int result = 0;
+
+  if (pool == NULL || *pool == NULL)
+    {
+      return EINVAL;
+    }
+
+  p = *pool;
+
+  if (ptw32_pool_self (p) != NULL)
+    {
+      return EDEADLK;
+    }
+
+  while (result == 0 && p->pending != 0)
+    {
+      (void) pthread_eventcount_prepare_wait_np (&p->idle, &key);
+
+      if (p->pending == 0)
+        {
+          (void) pthread_eventcount_cancel_wait_np (&p->idle);
+          break;
+        }
+
+      result = pthread_eventcount_commit_wait_np (&p->idle, key, NULL);
+    }
+
+  return result;
+}
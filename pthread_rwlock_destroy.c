@@ -81,7 +81,11 @@ pthread_rwlock_destroy (pthread_rwlock_t * rwlock)
        * report "BUSY" if so.
        */
       if (rwl->nExclusiveAccessCount > 0
-	  || rwl->nSharedAccessCount > rwl->nCompletedSharedAccessCount)
+	  || rwl->nSharedAccessCount > rwl->nCompletedSharedAccessCount
+	  || (rwl->kind == PTHREAD_RWLOCK_BIGREADER_NP
+	      && ptw32_rwlock_bigreader_busy (rwl))
+	  || (rwl->kind >= PTHREAD_RWLOCK_PREFER_READER_NP
+	      && ptw32_rwlock_prefer_busy (rwl)))
 	{
 	  result = pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
 	  result1 = pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
@@ -108,6 +112,14 @@ pthread_rwlock_destroy (pthread_rwlock_t * rwlock)
 	  result = pthread_cond_destroy (&(rwl->cndSharedAccessCompleted));
 	  result1 = pthread_mutex_destroy (&(rwl->mtxSharedAccessCompleted));
 	  result2 = pthread_mutex_destroy (&(rwl->mtxExclusiveAccess));
+	  if (rwl->kind == PTHREAD_RWLOCK_BIGREADER_NP)
+	    {
+	      ptw32_rwlock_bigreader_destroy (rwl);
+	    }
+	  else if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+	    {
+	      ptw32_rwlock_prefer_destroy (rwl);
+	    }
 	  (void) free (rwl);
 	}
     }
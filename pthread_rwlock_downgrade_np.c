@@ -0,0 +1,116 @@
+/*
+ * pthread_rwlock_downgrade_np.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <limits.h>
+
+#include "pthread.h"
+#include "implement.h"
+
+int
+pthread_rwlock_downgrade_np (pthread_rwlock_t * rwlock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Convert the write lock held by the calling thread
+      *      into a read lock without unlocking in between.
+      *
+      * PARAMETERS
+      *      rwlock
+      *              pointer to an instance of pthread_rwlock_t
+      *
+      *
+      * DESCRIPTION
+      *      Other readers may join the caller as soon as this
+      *      returns, as the lock's kind allows, but no writer
+      *      can get in until the caller unlocks. The caller
+      *      releases the lock with pthread_rwlock_unlock() as
+      *      for any read lock.
+      *
+      * RESULTS
+      *              0               the caller holds a read lock,
+      *              EPERM           the lock isn't write locked,
+      *              EINVAL          'rwlock' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result, result1;
+  pthread_rwlock_t rwl;
+
+  if (rwlock == NULL || *rwlock == NULL
+      || *rwlock == PTHREAD_RWLOCK_INITIALIZER)
+    {
+      return EINVAL;
+    }
+
+  rwl = *rwlock;
+
+  if (rwl->nMagic != PTW32_RWLOCK_MAGIC)
+    {
+      return EINVAL;
+    }
+
+  if (rwl->kind == PTHREAD_RWLOCK_BIGREADER_NP)
+    {
+      return ptw32_rwlock_bigreader_downgrade (rwl);
+    }
+  else if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      return ptw32_rwlock_prefer_downgrade (rwl);
+    }
+
+  if (rwl->nExclusiveAccessCount == 0)
+    {
+      return EPERM;
+    }
+
+  /*
+   * The writer holds both mutexes and every earlier reader has
+   * completed. Become the only reader, then let others in.
+   */
+  rwl->nExclusiveAccessCount--;
+  rwl->nSharedAccessCount++;
+
+  result = pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
+  result1 = pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+
+  return ((result != 0) ? result : result1);
+}
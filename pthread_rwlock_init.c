@@ -56,12 +56,6 @@ pthread_rwlock_init (pthread_rwlock_t * rwlock,
       return EINVAL;
     }
 
-  if (attr != NULL && *attr != NULL)
-    {
-      result = EINVAL;		/* Not supported */
-      goto DONE;
-    }
-
   rwl = (pthread_rwlock_t) calloc (1, sizeof (*rwl));
 
   if (rwl == NULL)
@@ -73,6 +67,8 @@ pthread_rwlock_init (pthread_rwlock_t * rwlock,
   rwl->nSharedAccessCount = 0;
   rwl->nExclusiveAccessCount = 0;
   rwl->nCompletedSharedAccessCount = 0;
+  rwl->kind = (attr != NULL && *attr != NULL)
+              ? (*attr)->kind : PTHREAD_RWLOCK_DEFAULT_NP;
 
   result = pthread_mutex_init (&rwl->mtxExclusiveAccess, NULL);
   if (result != 0)
@@ -92,11 +88,27 @@ pthread_rwlock_init (pthread_rwlock_t * rwlock,
       goto FAIL2;
     }
 
+  if (rwl->kind == PTHREAD_RWLOCK_BIGREADER_NP)
+    {
+      result = ptw32_rwlock_bigreader_init (rwl);
+    }
+  else if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      result = ptw32_rwlock_prefer_init (rwl);
+    }
+  if (result != 0)
+    {
+      goto FAIL3;
+    }
+
   rwl->nMagic = PTW32_RWLOCK_MAGIC;
 
   result = 0;
   goto DONE;
 
+FAIL3:
+  (void) pthread_cond_destroy (&(rwl->cndSharedAccessCompleted));
+
 FAIL2:
   (void) pthread_mutex_destroy (&(rwl->mtxSharedAccessCompleted));
 
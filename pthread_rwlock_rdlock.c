@@ -78,6 +78,15 @@ pthread_rwlock_rdlock (pthread_rwlock_t * rwlock)
       return EINVAL;
     }
 
+  if (rwl->kind == PTHREAD_RWLOCK_BIGREADER_NP)
+    {
+      return ptw32_rwlock_bigreader_rdlock (rwl, NULL, PTW32_FALSE);
+    }
+  else if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      return ptw32_rwlock_prefer_rdlock (rwl, NULL, PTW32_FALSE);
+    }
+
   if ((result = pthread_mutex_lock (&(rwl->mtxExclusiveAccess))) != 0)
     {
       return result;
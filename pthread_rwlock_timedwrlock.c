@@ -79,6 +79,15 @@ pthread_rwlock_timedwrlock (pthread_rwlock_t * rwlock,
       return EINVAL;
     }
 
+  if (rwl->kind == PTHREAD_RWLOCK_BIGREADER_NP)
+    {
+      return ptw32_rwlock_bigreader_wrlock (rwl, abstime, PTW32_FALSE);
+    }
+  else if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      return ptw32_rwlock_prefer_wrlock (rwl, abstime, PTW32_FALSE);
+    }
+
   if ((result =
        pthread_mutex_timedlock (&(rwl->mtxExclusiveAccess), abstime)) != 0)
     {
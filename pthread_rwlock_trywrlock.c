@@ -78,6 +78,15 @@ pthread_rwlock_trywrlock (pthread_rwlock_t * rwlock)
       return EINVAL;
     }
 
+  if (rwl->kind == PTHREAD_RWLOCK_BIGREADER_NP)
+    {
+      return ptw32_rwlock_bigreader_wrlock (rwl, NULL, PTW32_TRUE);
+    }
+  else if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      return ptw32_rwlock_prefer_wrlock (rwl, NULL, PTW32_TRUE);
+    }
+
   if ((result = pthread_mutex_trylock (&(rwl->mtxExclusiveAccess))) != 0)
     {
       return result;
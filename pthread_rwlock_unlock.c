@@ -70,6 +70,15 @@ pthread_rwlock_unlock (pthread_rwlock_t * rwlock)
       return EINVAL;
     }
 
+  if (rwl->kind == PTHREAD_RWLOCK_BIGREADER_NP)
+    {
+      return ptw32_rwlock_bigreader_unlock (rwl);
+    }
+  else if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      return ptw32_rwlock_prefer_unlock (rwl);
+    }
+
   if (rwl->nExclusiveAccessCount == 0)
     {
       if ((result =
@@ -0,0 +1,214 @@
+/*
+ * pthread_rwlock_upgrade_np.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <limits.h>
+
+#include "pthread.h"
+#include "implement.h"
+
+int
+pthread_rwlock_upgrade_np (pthread_rwlock_t * rwlock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Convert a read lock held by the calling thread into
+      *      the write lock without unlocking in between.
+      *
+      * PARAMETERS
+      *      rwlock
+      *              pointer to an instance of pthread_rwlock_t
+      *
+      *
+      * DESCRIPTION
+      *      Waits until every other reader has unlocked, then
+      *      returns with the caller holding the write lock. No
+      *      writer can get in first, so data read under the
+      *      read lock is still valid.
+      *
+      *      Only one reader at a time can be upgrading: a
+      *      second would wait forever for the first to release
+      *      its read lock. It fails with EDEADLK instead, still
+      *      holding its read lock, and must unlock and take the
+      *      write lock the ordinary way. With the
+      *      PTHREAD_RWLOCK_DEFAULT_NP and
+      *      PTHREAD_RWLOCK_BIGREADER_NP kinds the same happens if
+      *      a writer is already waiting for the caller's read
+      *      lock; the PREFER kinds give the upgrading reader
+      *      priority over waiting writers.
+      *
+      *      This function is not a cancellation point.
+      *
+      * RESULTS
+      *              0               the caller holds the write lock,
+      *              EDEADLK         another thread is upgrading, or
+      *                              a writer is waiting (see above),
+      *              EPERM           the lock isn't read locked,
+      *              EINVAL          'rwlock' is invalid.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result, oldstate, pending;
+  pthread_rwlock_t rwl;
+
+  if (rwlock == NULL || *rwlock == NULL
+      || *rwlock == PTHREAD_RWLOCK_INITIALIZER)
+    {
+      return EINVAL;
+    }
+
+  rwl = *rwlock;
+
+  if (rwl->nMagic != PTW32_RWLOCK_MAGIC)
+    {
+      return EINVAL;
+    }
+
+  if (rwl->kind == PTHREAD_RWLOCK_BIGREADER_NP)
+    {
+      return ptw32_rwlock_bigreader_upgrade (rwl);
+    }
+  else if (rwl->kind != PTHREAD_RWLOCK_DEFAULT_NP)
+    {
+      return ptw32_rwlock_prefer_upgrade (rwl);
+    }
+
+  if (rwl->nExclusiveAccessCount > 0)
+    {
+      return EPERM;
+    }
+
+  /*
+   * Readers hold mtxExclusiveAccess only briefly; a writer or another
+   * upgrade holds it while waiting for the remaining readers, which
+   * include us, and has set nCompletedSharedAccessCount negative.
+   */
+  for (;;)
+    {
+      result = pthread_mutex_trylock (&(rwl->mtxExclusiveAccess));
+
+      if (result != EBUSY)
+	{
+	  break;
+	}
+
+      if ((result =
+	   pthread_mutex_lock (&(rwl->mtxSharedAccessCompleted))) != 0)
+	{
+	  return result;
+	}
+
+      pending = (rwl->nCompletedSharedAccessCount < 0);
+
+      if ((result =
+	   pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted))) != 0)
+	{
+	  return result;
+	}
+
+      if (pending)
+	{
+	  return EDEADLK;
+	}
+
+      Sleep (0);
+    }
+
+  if (result != 0)
+    {
+      return result;
+    }
+
+  if ((result = pthread_mutex_lock (&(rwl->mtxSharedAccessCompleted))) != 0)
+    {
+      (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+      return result;
+    }
+
+  if (rwl->nSharedAccessCount <= rwl->nCompletedSharedAccessCount)
+    {
+      (void) pthread_mutex_unlock (&(rwl->mtxSharedAccessCompleted));
+      (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+      return EPERM;
+    }
+
+  /*
+   * Nobody else can lock now. Complete our own read access and then
+   * wait for the others as pthread_rwlock_wrlock() does. Being
+   * cancelled here would lose the caller's read lock without it
+   * knowing, so this wait is not a cancellation point.
+   */
+  rwl->nCompletedSharedAccessCount++;
+
+  if (rwl->nCompletedSharedAccessCount > 0)
+    {
+      rwl->nSharedAccessCount -= rwl->nCompletedSharedAccessCount;
+      rwl->nCompletedSharedAccessCount = 0;
+    }
+
+  if (rwl->nSharedAccessCount > 0)
+    {
+      rwl->nCompletedSharedAccessCount = -rwl->nSharedAccessCount;
+
+      (void) pthread_setcancelstate (PTHREAD_CANCEL_DISABLE, &oldstate);
+
+      do
+	{
+	  result = pthread_cond_wait (&(rwl->cndSharedAccessCompleted),
+				      &(rwl->mtxSharedAccessCompleted));
+	}
+      while (result == 0 && rwl->nCompletedSharedAccessCount < 0);
+
+      (void) pthread_setcancelstate (oldstate, NULL);
+
+      if (result != 0)
+	{
+	  ptw32_rwlock_cancelwrwait ((void *) rwl);
+	  return result;
+	}
+
+      rwl->nSharedAccessCount = 0;
+    }
+
+  rwl->nExclusiveAccessCount++;
+
+  return 0;
+}
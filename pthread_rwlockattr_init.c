@@ -80,6 +80,7 @@ pthread_rwlockattr_init (pthread_rwlockattr_t * attr)
   else
     {
       rwa->pshared = PTHREAD_PROCESS_PRIVATE;
+      rwa->kind = PTHREAD_RWLOCK_DEFAULT_NP;
     }
 
   *attr = rwa;
@@ -0,0 +1,110 @@
+/*
+ * pthread_rwlockattr_setkind_np.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+int
+pthread_rwlockattr_setkind_np (pthread_rwlockattr_t * attr, int kind)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Select the implementation used by rwlocks created
+      *      with 'attr'.
+      *
+      * PARAMETERS
+      *      attr
+      *              pointer to an instance of pthread_rwlockattr_t
+      *
+      *      kind
+      *              must be one of:
+      *
+      *                      PTHREAD_RWLOCK_DEFAULT_NP
+      *                              Writers are favoured over readers.
+      *
+      *                      PTHREAD_RWLOCK_BIGREADER_NP
+      *                              Readers only touch a per-CPU
+      *                              counter; writers are expensive.
+      *
+      *                      PTHREAD_RWLOCK_PREFER_READER_NP
+      *                              Readers may pass waiting writers.
+      *
+      *                      PTHREAD_RWLOCK_PREFER_WRITER_NP
+      *                              New readers wait behind waiting
+      *                              writers unless they already hold
+      *                              a read lock.
+      *
+      *                      PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP
+      *                              New readers always wait behind
+      *                              waiting writers.
+      *
+      *
+      * DESCRIPTION
+      *      See README.NONPORTABLE for when each kind is
+      *      appropriate.
+      *
+      * RESULTS
+      *              0               successfully set attribute,
+      *              EINVAL          'attr' or 'kind' is invalid,
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+
+  if ((attr != NULL && *attr != NULL) &&
+      (kind == PTHREAD_RWLOCK_DEFAULT_NP ||
+       kind == PTHREAD_RWLOCK_BIGREADER_NP ||
+       kind == PTHREAD_RWLOCK_PREFER_READER_NP ||
+       kind == PTHREAD_RWLOCK_PREFER_WRITER_NP ||
+       kind == PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP))
+    {
+      (*attr)->kind = kind;
+      result = 0;
+    }
+  else
+    {
+      result = EINVAL;
+    }
+
+  return (result);
+
+}				/* pthread_rwlockattr_setkind_np */
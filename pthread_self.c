@@ -65,7 +65,10 @@ pthread_self (void)
       */
 {
   pthread_t self;
-  DWORD_PTR vThreadMask, vProcessMask, vSystemMask;
+#if defined(HAVE_CPU_AFFINITY)
+  DWORD_PTR vThreadMask;
+  int group;
+#endif
   pthread_t nil = {NULL, 0};
   ptw32_thread_t * sp;
 
@@ -130,22 +133,12 @@ pthread_self (void)
 #if defined(HAVE_CPU_AFFINITY)
 
     	      /*
-    	       * Get this threads CPU affinity by temporarily setting the threads
-    	       * affinity to that of the process to get the old thread affinity,
-    	       * then reset to the old affinity.
+    	       * Get this threads processor group and CPU affinity.
     	       */
-    	      if (GetProcessAffinityMask(GetCurrentProcess(), &vProcessMask, &vSystemMask))
+    	      if (0 == ptw32_get_thread_affinity (sp->threadH, &group, &vThreadMask))
     	        {
-    	          vThreadMask = SetThreadAffinityMask(sp->threadH, vProcessMask);
-    	          if (vThreadMask)
-    	            {
-    	              if (SetThreadAffinityMask(sp->threadH, vThreadMask))
-    	                {
-    	                  sp->cpuset = (size_t) vThreadMask;
-    	                }
-    	              else fail = PTW32_TRUE;
-    	            }
-    	          else fail = PTW32_TRUE;
+    	          sp->cpuGroup = group;
+    	          sp->cpuset = (size_t) vThreadMask;
     	        }
     	      else fail = PTW32_TRUE;
 
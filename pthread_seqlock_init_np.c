@@ -0,0 +1,98 @@
+/*
+ * pthread_seqlock_init_np.c
+ *
+ * Description:
+ * This translation unit implements sequence lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_seqlock_init_np (pthread_seqlock_t * lock)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Initialises a sequence lock.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_seqlock_t
+      *
+      * DESCRIPTION
+      *      A sequence lock protects small, read-mostly data.
+      *      Readers never write to shared memory; instead they
+      *      copy the data and then check whether a writer was
+      *      active meanwhile, retrying if so. Writers are
+      *      serialised by an internal mutex.
+      *
+      * RESULTS
+      *              0               successfully initialised,
+      *              EINVAL          'lock' is NULL,
+      *              ENOMEM          insufficient memory
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_seqlock_t sl;
+  int result;
+
+  if (lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  sl = (pthread_seqlock_t) calloc (1, sizeof (*sl));
+
+  if (sl == NULL)
+    {
+      return ENOMEM;
+    }
+
+  sl->sequence = 0;
+
+  if (0 != (result = pthread_mutex_init (&sl->writer, NULL)))
+    {
+      (void) free (sl);
+      return result;
+    }
+
+  *lock = sl;
+
+  return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * pthread_seqlock_read_begin_np.c
+ *
+ * Description:
+ * This translation unit implements sequence lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "sched.h"
+#include "implement.h"
+
+
+int
+pthread_seqlock_read_begin_np (pthread_seqlock_t * lock, unsigned int * seq)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Starts a read of the data protected by a sequence
+      *      lock.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_seqlock_t
+      *
+      *      seq
+      *              receives the sequence number to pass to
+      *              pthread_seqlock_read_retry_np()
+      *
+      * DESCRIPTION
+      *      Waits while a writer is active, then returns the
+      *      current sequence number. The caller copies the data
+      *      it needs and then calls
+      *      pthread_seqlock_read_retry_np(). The copied data
+      *      must not be acted upon until that call has said the
+      *      copy is consistent.
+      *
+      *      This routine does not write to shared memory.
+      *
+      * RESULTS
+      *              0               successfully started,
+      *              EINVAL          'lock' or 'seq' is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  pthread_seqlock_t sl;
+  LONG s;
+  int spin = 0;
+
+  if (lock == NULL || *lock == NULL || seq == NULL)
+    {
+      return EINVAL;
+    }
+
+  sl = *lock;
+
+  /*
+   * An odd sequence number means a writer is active.
+   */
+  while ((s = sl->sequence) & 1)
+    {
+      if (++spin >= PTW32_SEQLOCK_SPIN)
+        {
+          sched_yield ();
+          spin = 0;
+        }
+    }
+
+  /*
+   * The caller's reads of the data must follow the read of the
+   * sequence number.
+   */
+  PTW32_COMPILER_BARRIER ();
+
+  *seq = (unsigned int) s;
+
+  return 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * pthread_seqlock_read_retry_np.c
+ *
+ * Description:
+ * This translation unit implements sequence lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_seqlock_read_retry_np (pthread_seqlock_t * lock, unsigned int seq)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Ends a read of the data protected by a sequence
+      *      lock.
+      *
+      * PARAMETERS
+      *      lock
+      *              pointer to an instance of pthread_seqlock_t
+      *
+      *      seq
+      *              the value from pthread_seqlock_read_begin_np()
+      *
+      * DESCRIPTION
+      *      Reports whether a writer may have changed the data
+      *      since the matching pthread_seqlock_read_begin_np(),
+      *      in which case the copy may be inconsistent and the
+      *      read must be repeated:
+      *
+      *      do
+      *        {
+      *          pthread_seqlock_read_begin_np (&lock, &seq);
+      *          copy = shared;
+      *        }
+      *      while (pthread_seqlock_read_retry_np (&lock, seq));
+      *
+      *      This routine does not write to shared memory.
+      *
+      * RESULTS
+      *              0               the copy is consistent,
+      *              EAGAIN          a writer intervened; retry,
+      *              EINVAL          'lock' is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (lock == NULL || *lock == NULL)
+    {
+      return EINVAL;
+    }
+
+  /*
+   * The caller's reads of the data must precede the second read of
+   * the sequence number.
+   */
+  PTW32_COMPILER_BARRIER ();
+
+  return ((unsigned int) (*lock)->sequence == seq) ? 0 : EAGAIN;
+}
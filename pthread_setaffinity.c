@@ -58,7 +58,7 @@ pthread_setaffinity_np (pthread_t thread, size_t cpusetsize,
       *					The target thread
       *
       *		cpusetsize
-      *					Ignored in pthreads4w.
+      *					The size of the set in bytes.
       *					Usually set to sizeof(cpu_set_t)
       *
       *		cpuset
@@ -67,7 +67,10 @@ pthread_setaffinity_np (pthread_t thread, size_t cpusetsize,
       *   				The set of CPUs on which the thread will actually run
       *   				is the intersection of the set specified in the cpuset
       *   				argument and the set of CPUs actually present for
-      *   				the process.
+      *   				the process. A thread runs in one
+      *   				processor group, so if that spans groups
+      *   				the thread is confined to the group with
+      *   				the most of its CPUs (the lowest on a tie).
       *
       * DESCRIPTION
       *   The pthread_setaffinity_np() function sets the CPU affinity mask
@@ -79,6 +82,8 @@ pthread_setaffinity_np (pthread_t thread, size_t cpusetsize,
       * 				0		Success
       * 				ESRCH	Thread does not exist
       * 				EFAULT	pcuset is NULL
+      * 				EINVAL	cpuset holds no CPU available
+      * 						to the process
       * 				EAGAIN	The thread affinity could not be set
       * 				ENOSYS  The platform does not support this function
       *
@@ -94,7 +99,6 @@ pthread_setaffinity_np (pthread_t thread, size_t cpusetsize,
   int result = 0;
   ptw32_thread_t * tp;
   ptw32_mcs_local_node_t node;
-  cpu_set_t processCpuset;
 
   ptw32_mcs_lock_acquire (&ptw32_thread_reuse_lock, &node);
 
@@ -108,22 +112,36 @@ pthread_setaffinity_np (pthread_t thread, size_t cpusetsize,
 	{
 	  if (cpuset)
 		{
-		  if (sched_getaffinity(0, sizeof(cpu_set_t), &processCpuset))
-		    {
-			  result = PTW32_GET_ERRNO();
-		    }
-		  else
+		  DWORD_PTR newMask = 0;
+		  int group = 0;
+		  int g;
+
+		  /*
+		   * Result is the intersection of available CPUs and the mask,
+		   * in the group where that has the most CPUs.
+		   */
+		  for (g = 0; g < ptw32_cpu_groups && 0 == result; g++)
 			{
-			  /*
-			   * Result is the intersection of available CPUs and the mask.
-			   */
-			  cpu_set_t newMask;
+			  DWORD_PTR processMask;
 
-			  CPU_AND(&newMask, &processCpuset, cpuset);
+			  result = ptw32_process_group_affinity (GetCurrentProcess (), g, &processMask);
+			  if (0 == result)
+				{
+				  DWORD_PTR m = processMask & ptw32_cpuset_get_group (cpusetsize, cpuset, g);
 
-			  if (((_sched_cpu_set_vector_*)&newMask)->_cpuset)
+				  if (ptw32_popcount ((size_t) m) > ptw32_popcount ((size_t) newMask))
+					{
+					  group = g;
+					  newMask = m;
+					}
+				}
+			}
+
+		  if (0 == result)
+			{
+			  if (newMask)
 				{
-				  if (SetThreadAffinityMask (tp->threadH, ((_sched_cpu_set_vector_*)&newMask)->_cpuset))
+				  if (0 == (result = ptw32_set_thread_affinity (tp->threadH, group, newMask)))
 					{
 					  /*
 					   * We record the intersection of the process affinity
@@ -131,11 +149,8 @@ pthread_setaffinity_np (pthread_t thread, size_t cpusetsize,
 					   * pthread_getaffinity_np() returns the actual thread
 					   * CPU set.
 					   */
-					  tp->cpuset = ((_sched_cpu_set_vector_*)&newMask)->_cpuset;
-					}
-				  else
-					{
-					  result = EAGAIN;
+					  tp->cpuGroup = group;
+					  tp->cpuset = newMask;
 					}
 				}
 			  else
@@ -170,7 +185,7 @@ pthread_getaffinity_np (pthread_t thread, size_t cpusetsize, cpu_set_t *cpuset)
       *					The target thread
       *
       *		cpusetsize
-      *					Ignored in pthreads4w.
+      *					The size of the set in bytes.
       *					Usually set to sizeof(cpu_set_t)
       *
       *		cpuset
@@ -186,6 +201,8 @@ pthread_getaffinity_np (pthread_t thread, size_t cpusetsize, cpu_set_t *cpuset)
       * 				0		Success
       * 				ESRCH	thread does not exist
       * 				EFAULT	cpuset is NULL
+      * 				EINVAL	cpusetsize is too small for
+      * 						the thread's CPUs
       *                                 ENOSYS  The platform does not support this function
       *
       * ------------------------------------------------------
@@ -213,21 +230,22 @@ pthread_getaffinity_np (pthread_t thread, size_t cpusetsize, cpu_set_t *cpuset)
     {
 	  if (cpuset)
 	    {
-		  if (tp->cpuset)
+		  int group;
+		  DWORD_PTR vThreadMask;
+
+		  /*
+		   * The application may have set thread affinity independently
+		   * via SetThreadAffinityMask() or SetThreadGroupAffinity(). If so,
+		   * we adjust our record of the threads affinity.
+		   */
+		  if (0 == ptw32_get_thread_affinity (tp->threadH, &group, &vThreadMask)
+		      && vThreadMask != 0)
 		    {
-			  /*
-			   * The application may have set thread affinity independently
-			   * via SetThreadAffinityMask(). If so, we adjust our record of the threads
-			   * affinity and try to do so in a reasonable way.
-			   */
-			  DWORD_PTR vThreadMask = SetThreadAffinityMask(tp->threadH, tp->cpuset);
-			  if (vThreadMask && vThreadMask != tp->cpuset)
-			    {
-				  (void) SetThreadAffinityMask(tp->threadH, vThreadMask);
-				  tp->cpuset = vThreadMask;
-			    }
+			  tp->cpuGroup = group;
+			  tp->cpuset = vThreadMask;
 		    }
-		  ((_sched_cpu_set_vector_*)cpuset)->_cpuset = tp->cpuset;
+		  memset (cpuset, 0, cpusetsize);
+		  result = ptw32_cpuset_put_group (cpusetsize, cpuset, tp->cpuGroup, (DWORD_PTR) tp->cpuset);
 		}
 	  else
 	    {
@@ -112,11 +112,11 @@ pthread_setcancelstate (int state, int *oldstate)
    */
   if (state == PTHREAD_CANCEL_ENABLE
       && sp->cancelType == PTHREAD_CANCEL_ASYNCHRONOUS
-      && WaitForSingleObject (sp->cancelEvent, 0) == WAIT_OBJECT_0)
+      && sp->cancelRequested)
     {
       sp->state = PThreadStateCanceling;
       sp->cancelState = PTHREAD_CANCEL_DISABLE;
-      ResetEvent (sp->cancelEvent);
+      sp->cancelRequested = 0;
       ptw32_mcs_lock_release (&stateLock);
       ptw32_throw (PTW32_EPS_CANCEL);
 
@@ -0,0 +1,85 @@
+/*
+ * pthread_setdelaymode_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable thread functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+pthread_setdelaymode_np (int mode)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Sets how pthread_delay_np(), nanosleep() and
+      *      clock_nanosleep() wait.
+      *
+      * PARAMETERS
+      *      mode
+      *              PTHREAD_DELAY_COARSE_NP or
+      *              PTHREAD_DELAY_PRECISE_NP
+      *
+      * DESCRIPTION
+      *      In PTHREAD_DELAY_COARSE_NP mode, the default, delays
+      *      sleep until they are due and wake as promptly as the
+      *      system timer allows. In PTHREAD_DELAY_PRECISE_NP mode
+      *      they stop sleeping shortly before they are due, by an
+      *      amount calibrated from how late recent sleeps woke,
+      *      and spin for the rest, so they end within a few
+      *      microseconds of the time asked for at the cost of
+      *      some processor time. The mode applies to the whole
+      *      process.
+      *
+      * RESULTS
+      *              0               successfully set,
+      *              EINVAL          'mode' is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (mode != PTHREAD_DELAY_COARSE_NP && mode != PTHREAD_DELAY_PRECISE_NP)
+    {
+      return EINVAL;
+    }
+
+  ptw32_delay_mode = mode;
+
+  return 0;
+}
@@ -61,7 +61,7 @@ pthread_spin_unlock (pthread_spinlock_t * lock)
     }
 
   switch ((long)
-	  PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
+	  PTW32_ATOMIC_COMPARE_EXCHANGE_RELEASE ((PTW32_INTERLOCKED_LONGPTR) &s->interlock,
 					      (PTW32_INTERLOCKED_LONG) PTW32_SPIN_UNLOCKED,
 					      (PTW32_INTERLOCKED_LONG) PTW32_SPIN_LOCKED))
     {
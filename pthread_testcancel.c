@@ -84,8 +84,8 @@ pthread_testcancel (void)
 
   /*
    * Pthread_cancel() will have set sp->state to PThreadStateCancelPending
-   * and set an event, so no need to enter kernel space if
-   * sp->state != PThreadStateCancelPending - that only slows us down.
+   * and sp->cancelRequested, so there's nothing to do unless
+   * sp->state == PThreadStateCancelPending.
    */
   if (sp->state != PThreadStateCancelPending)
     {
@@ -96,7 +96,7 @@ pthread_testcancel (void)
 
   if (sp->cancelState != PTHREAD_CANCEL_DISABLE)
     {
-      ResetEvent(sp->cancelEvent);
+      sp->cancelRequested = 0;
       sp->state = PThreadStateCanceling;
       sp->cancelState = PTHREAD_CANCEL_DISABLE;
       ptw32_mcs_lock_release (&stateLock);
@@ -56,9 +56,13 @@
  *    order to make use of the underlying Win32, and so waiting threads may
  *    awake before their proper abstimes.
  *
- * 2) We aren't able to distinquish between threads on timed or untimed waits,
- *    so we wake them all at the time of the adjustment so that they can
- *    re-evaluate their conditions and re-compute their timeouts.
+ * 2) Only CVs that currently have timed waiters are broadcast. They are
+ *    found in the lists of ptw32_cond_shards, which timed waiters join
+ *    and leave (see pthread_cond_wait.c). We aren't able to wake only the
+ *    timed waiters on such a CV, so any untimed waiters on it are woken
+ *    too. They can then re-evaluate their conditions and the timed
+ *    waiters re-compute their timeouts. CVs with no timed waiters are
+ *    left alone.
  *
  * 3) We rely on correctly written applications for this to work. Specifically,
  *    they must be able to deal properly with spurious wakeups. That is,
@@ -71,43 +75,54 @@ pthread_timechange_handler_np (void *arg)
      /*
       * ------------------------------------------------------
       * DOCPUBLIC
-      *      Broadcasts all CVs to force re-evaluation and
-      *      new timeouts if required.
+      *      Broadcasts all CVs with timed waiters to force
+      *      re-evaluation and new timeouts.
       *
       * PARAMETERS
       *      NONE
       *
       *
       * DESCRIPTION
-      *      Broadcasts all CVs to force re-evaluation and
-      *      new timeouts if required.
+      *      Broadcasts all CVs with timed waiters to force
+      *      re-evaluation and new timeouts.
       *
       *      This routine may be passed directly to pthread_create()
       *      as a new thread in order to run asynchronously.
       *
       *
       * RESULTS
-      *              0               successfully broadcast all CVs
+      *              0               successfully broadcast all such CVs
       *              EAGAIN          Not all CVs were broadcast
       *
       * ------------------------------------------------------
       */
 {
   int result = 0;
+  int i;
   pthread_cond_t cv;
   ptw32_mcs_local_node_t node;
 
-  ptw32_mcs_lock_acquire(&ptw32_cond_list_lock, &node);
+  for (i = 0; i < PTW32_COND_SHARDS && 0 == result; i++)
+    {
+      ptw32_cond_shard_t * shard = &ptw32_cond_shards[i];
 
-  cv = ptw32_cond_list_head;
+      if (shard->head == NULL)
+	{
+	  continue;
+	}
 
-  while (cv != NULL && 0 == result)
-    {
-      result = pthread_cond_broadcast (&cv);
-      cv = cv->next;
-    }
+      ptw32_mcs_lock_acquire(&shard->lock, &node);
 
-  ptw32_mcs_lock_release(&node);
+      cv = shard->head;
+
+      while (cv != NULL && 0 == result)
+	{
+	  result = pthread_cond_broadcast (&cv);
+	  cv = cv->next;
+	}
+
+      ptw32_mcs_lock_release(&node);
+    }
 
   return (void *) (size_t) (result != 0 ? EAGAIN : 0);
 }
@@ -0,0 +1,104 @@
+/*
+ * pthread_wait_on_address_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable address wait functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+int
+pthread_wait_on_address_np (volatile int * address, int expected,
+                            const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Block while the int at 'address' equals 'expected'.
+      *
+      * PARAMETERS
+      *      address
+      *              the word to wait on
+      *
+      *      expected
+      *              the value that means "keep waiting"
+      *
+      *      abstime
+      *              absolute time at which to stop waiting,
+      *              or NULL to wait until woken
+      *
+      *
+      * DESCRIPTION
+      *      If *address doesn't equal 'expected' this returns
+      *      at once. Otherwise the calling thread blocks until
+      *      another thread calls pthread_wake_address_np() on
+      *      the same address or 'abstime' passes. The test and
+      *      the block are atomic with respect to wakers, so a
+      *      thread that changes *address and then wakes it can't
+      *      be missed.
+      *
+      *      The call may return 0 without *address having
+      *      changed; callers recheck it in a loop. The object
+      *      at 'address' needs no initialisation and the
+      *      library allocates nothing for it.
+      *
+      *      The word is an int, which is 32 bits wide on every
+      *      platform the library builds for, so that all of it
+      *      takes part in the compare.
+      *
+      *      This routine is not a cancellation point.
+      *
+      * RESULTS
+      *              0               woken, the value differed, or
+      *                              a spurious wakeup,
+      *              ETIMEDOUT       abstime passed,
+      *              EINVAL          'address' is NULL,
+      *              ENOSPC          the thread's wait event could
+      *                              not be created.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (address == NULL)
+    {
+      return EINVAL;
+    }
+
+  return ptw32_wait_on_address ((volatile LONG *) address, (LONG) expected,
+                                (abstime == NULL) ? INFINITE : ptw32_relmillisecs (abstime),
+                                PTW32_FALSE);
+}
@@ -0,0 +1,81 @@
+/*
+ * pthread_wake_address_np.c
+ *
+ * Description:
+ * This translation unit implements non-portable address wait functions.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+int
+pthread_wake_address_np (volatile int * address, int count)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Wake threads blocked in pthread_wait_on_address_np()
+      *      on 'address'.
+      *
+      * PARAMETERS
+      *      address
+      *              the word waited on
+      *
+      *      count
+      *              the most threads to wake; INT_MAX for all
+      *
+      *
+      * DESCRIPTION
+      *      Wakes up to 'count' of the threads waiting on
+      *      'address', longest waiting first. The caller stores
+      *      the new value at 'address' before calling this.
+      *
+      *      When no thread is waiting on any address that shares
+      *      a wait queue with 'address' this takes no lock.
+      *
+      * RESULTS
+      *              The number of threads woken.
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (address == NULL)
+    {
+      return 0;
+    }
+
+  return ptw32_wake_address ((volatile LONG *) address, count);
+}
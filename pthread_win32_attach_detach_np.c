@@ -142,6 +142,23 @@ pthread_win32_process_attach_np ()
       ptw32_features |= PTW32_ALERTABLE_ASYNC_CANCEL;
     }
 
+  /*
+   * Used to pick a per-CPU slot in big-reader rwlocks. Without it
+   * they hash the thread id instead.
+   */
+#if ! defined(WINCE)
+  ptw32_get_processor_number = (DWORD (WINAPI *)(VOID))
+#if defined(NEED_UNICODE_CONSTS)
+    GetProcAddress (GetModuleHandle (TEXT ("KERNEL32.DLL")),
+		    (const TCHAR *) TEXT ("GetCurrentProcessorNumber"));
+#else
+    GetProcAddress (GetModuleHandle (TEXT ("KERNEL32.DLL")),
+		    (LPCSTR) "GetCurrentProcessorNumber");
+#endif
+#endif
+
+  ptw32_cpu_groups_init ();
+
   return result;
 }
 
@@ -241,9 +258,13 @@ pthread_win32_thread_detach_np ()
               /*
                * If there are no waiters then the next thread to block will
                * sleep, wake up immediately and then go back to sleep.
-               * See pthread_mutex_lock.c.
+               * See pthread_mutex_lock.c. Without an event no thread
+               * has blocked yet.
                */
-              SetEvent(mx->event);
+              if (mx->event != NULL)
+                {
+                  SetEvent(mx->event);
+                }
             }
 
 
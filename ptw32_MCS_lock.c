@@ -101,16 +101,15 @@
 /*
  * ptw32_mcs_flag_set -- notify another thread about an event.
  * 
- * Set event if an event handle has been stored in the flag, and
- * set flag to -1 otherwise. Note that -1 cannot be a valid handle value.
+ * Set flag to -1 and set the event if an event handle had been stored
+ * in the flag. Note that -1 cannot be a valid handle value.
  */
 INLINE void 
 ptw32_mcs_flag_set (HANDLE * flag)
 {
-  HANDLE e = (HANDLE)(PTW32_INTERLOCKED_SIZE)PTW32_INTERLOCKED_COMPARE_EXCHANGE_SIZE(
+  HANDLE e = (HANDLE)(PTW32_INTERLOCKED_SIZE)PTW32_INTERLOCKED_EXCHANGE_SIZE(
 						(PTW32_INTERLOCKED_SIZEPTR)flag,
-						(PTW32_INTERLOCKED_SIZE)-1,
-						(PTW32_INTERLOCKED_SIZE)0);
+						(PTW32_INTERLOCKED_SIZE)-1);
   if ((HANDLE)0 != e)
     {
       /* another thread has already stored an event handle in the flag */
@@ -122,18 +121,29 @@ ptw32_mcs_flag_set (HANDLE * flag)
  * ptw32_mcs_flag_wait -- wait for notification from another.
  * 
  * Store an event handle in the flag and wait on it if the flag has not been
- * set, and proceed without creating an event otherwise.
+ * set, and proceed without waiting otherwise.
+ *
+ * The event is the thread's park event (see ptw32_park.c) if it has or
+ * can get one. That event can be set for other reasons, so we wait until
+ * the flag is set. Otherwise a temporary event is used, which is only set
+ * by ptw32_mcs_flag_set(). We can't call pthread_self() here because it
+ * may itself need an MCS lock.
  */
 INLINE void 
 ptw32_mcs_flag_wait (HANDLE * flag)
 {
-  if ((PTW32_INTERLOCKED_SIZE)0 ==
-        PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE((PTW32_INTERLOCKED_SIZEPTR)flag,
-                                            (PTW32_INTERLOCKED_SIZE)0)) /* MBR fence */
+  if ((PTW32_INTERLOCKED_PVOID)0 == PTW32_ATOMIC_LOAD_ACQUIRE_PTR(flag))
     {
-      /* the flag is not set. create event. */
+      /* the flag is not set. find or create an event. */
+
+      ptw32_thread_t * sp = (ptw32_thread_t *) pthread_getspecific (ptw32_selfThreadKey);
+      HANDLE e = (sp != NULL) ? ptw32_lazy_event (&sp->parkEvent) : NULL;
+      int temporary = (e == NULL);
 
-      HANDLE e = CreateEvent(NULL, PTW32_FALSE, PTW32_FALSE, NULL);
+      if (temporary)
+        {
+          e = CreateEvent(NULL, PTW32_FALSE, PTW32_FALSE, NULL);
+        }
 
       if ((PTW32_INTERLOCKED_SIZE)0 == PTW32_INTERLOCKED_COMPARE_EXCHANGE_SIZE(
 			                  (PTW32_INTERLOCKED_SIZEPTR)flag,
@@ -141,10 +151,25 @@ ptw32_mcs_flag_wait (HANDLE * flag)
 			                  (PTW32_INTERLOCKED_SIZE)0))
 	{
 	  /* stored handle in the flag. wait on it now. */
-	  WaitForSingleObject(e, INFINITE);
+	  if (temporary)
+	    {
+	      WaitForSingleObject(e, INFINITE);
+	    }
+	  else
+	    {
+	      while ((PTW32_INTERLOCKED_SIZE)-1 !=
+		       PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE((PTW32_INTERLOCKED_SIZEPTR)flag,
+							   (PTW32_INTERLOCKED_SIZE)0))
+		{
+		  WaitForSingleObject(e, INFINITE);
+		}
+	    }
 	}
 
-      CloseHandle(e);
+      if (temporary)
+        {
+          CloseHandle(e);
+        }
     }
 }
 
@@ -198,17 +223,20 @@ ptw32_mcs_lock_release (ptw32_mcs_local_node_t * node)
 {
   ptw32_mcs_lock_t *lock = node->lock;
   ptw32_mcs_local_node_t *next =
-    (ptw32_mcs_local_node_t *)
-      PTW32_INTERLOCKED_EXCHANGE_ADD_SIZE((PTW32_INTERLOCKED_SIZEPTR)&node->next, (PTW32_INTERLOCKED_SIZE)0); /* MBR fence */
+    (ptw32_mcs_local_node_t *) PTW32_ATOMIC_LOAD_ACQUIRE_PTR(&node->next);
 
   if (0 == next)
     {
       /* no known successor */
 
+      /*
+       * Release ordering publishes the critical section to the next
+       * acquirer, whose exchange on the lock is a full barrier.
+       */
       if (node == (ptw32_mcs_local_node_t *)
-	  PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR((PTW32_INTERLOCKED_PVOID_PTR)lock,
-						 (PTW32_INTERLOCKED_PVOID)0,
-						 (PTW32_INTERLOCKED_PVOID)node))
+	  PTW32_ATOMIC_COMPARE_EXCHANGE_RELEASE_PTR((PTW32_INTERLOCKED_PVOID_PTR)lock,
+						    (PTW32_INTERLOCKED_PVOID)0,
+						    (PTW32_INTERLOCKED_PVOID)node))
 	{
 	  /* no successor, lock is free now */
 	  return;
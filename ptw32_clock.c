@@ -0,0 +1,168 @@
+/*
+ * ptw32_clock.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+#if !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+
+/*
+ * ptw32_clock_ns()
+ *
+ * Read a clock in nanoseconds. CLOCK_MONOTONIC counts from an
+ * arbitrary point with the performance counter; CLOCK_REALTIME counts
+ * from Jan 1, 1970 with the system time.
+ */
+LONGLONG
+ptw32_clock_ns (clockid_t clock_id)
+{
+  LARGE_INTEGER t;
+  LONGLONG f;
+#if defined(NEED_FTIME)
+  SYSTEMTIME st;
+#endif
+  FILETIME ft;
+
+  if (clock_id == CLOCK_MONOTONIC)
+    {
+      if ((f = ptw32_clock_frequency) == 0)
+        {
+          /*
+           * The frequency is fixed at boot, so racing to set it is
+           * harmless.
+           */
+          (void) QueryPerformanceFrequency (&t);
+          ptw32_clock_frequency = f = t.QuadPart;
+        }
+
+      (void) QueryPerformanceCounter (&t);
+
+      /*
+       * Split the conversion so that the product can't overflow.
+       */
+      return (t.QuadPart / f) * 1000000000
+             + ((t.QuadPart % f) * 1000000000) / f;
+    }
+
+#if defined(NEED_FTIME)
+  GetSystemTime (&st);
+  SystemTimeToFileTime (&st, &ft);
+#else
+  GetSystemTimeAsFileTime (&ft);
+#endif
+
+  t.LowPart = ft.dwLowDateTime;
+  t.HighPart = (LONG) ft.dwHighDateTime;
+
+  return (t.QuadPart - (LONGLONG) PTW32_TIMESPEC_TO_FILETIME_OFFSET) * 100;
+}
+
+/*
+ * ptw32_timespec_to_ns()
+ *
+ * Convert a valid, non-negative timespec to nanoseconds. Times beyond
+ * about 136 years are cut short so that sums of them can't overflow.
+ */
+LONGLONG
+ptw32_timespec_to_ns (const struct timespec * ts)
+{
+  LONGLONG sec = (LONGLONG) ts->tv_sec;
+
+  if (sec > (LONGLONG) 0xFFFFFFFF)
+    {
+      sec = (LONGLONG) 0xFFFFFFFF;
+    }
+
+  return sec * 1000000000 + ts->tv_nsec;
+}
+
+/*
+ * ptw32_ns_to_timespec()
+ */
+void
+ptw32_ns_to_timespec (LONGLONG ns, struct timespec * ts)
+{
+  ts->tv_sec = (time_t) (ns / 1000000000);
+  ts->tv_nsec = (long) (ns % 1000000000);
+}
+
+/*
+ * ptw32_clock_timer()
+ *
+ * Create an auto-reset waitable timer, with high resolution where
+ * Windows supports it (Windows 10 1803 on). Returns NULL if no timer
+ * can be created.
+ */
+HANDLE
+ptw32_clock_timer (void)
+{
+#if defined(WINCE)
+  return NULL;
+#else
+  HANDLE (WINAPI * createTimerEx) (LPSECURITY_ATTRIBUTES, LPCWSTR, DWORD, DWORD);
+  HANDLE h = NULL;
+
+  createTimerEx = (HANDLE (WINAPI *) (LPSECURITY_ATTRIBUTES, LPCWSTR, DWORD, DWORD))
+#if defined(NEED_UNICODE_CONSTS)
+    GetProcAddress (GetModuleHandle (TEXT ("KERNEL32.DLL")),
+		    (const TCHAR *) TEXT ("CreateWaitableTimerExW"));
+#else
+    GetProcAddress (GetModuleHandle (TEXT ("KERNEL32.DLL")),
+		    (LPCSTR) "CreateWaitableTimerExW");
+#endif
+
+  if (createTimerEx != NULL)
+    {
+      h = createTimerEx (NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    }
+
+  if (h == NULL)
+    {
+      h = CreateWaitableTimer (NULL, PTW32_FALSE, NULL);
+    }
+
+  return h;
+#endif
+}
@@ -0,0 +1,431 @@
+/*
+ * ptw32_cpugroups.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Notes on processor groups.
+ *
+ * Windows 7 and later put the logical processors of a system with more
+ * than 64 of them into processor groups of up to 64. An affinity mask
+ * (and so SetThreadAffinityMask(), GetProcessAffinityMask() and
+ * SetProcessAffinityMask()) only covers one group. A thread runs in
+ * one group at a time, which SetThreadGroupAffinity() can change.
+ *
+ * A cpu_set_t numbers CPUs consecutively through the groups, as
+ * Windows' own tools do: group g's processor n is CPU
+ * ptw32_cpu_group_first[g] + n. The table is filled in once, by
+ * ptw32_cpu_groups_init() at process attach. Where the group functions
+ * don't exist there is one group, as wide as a mask.
+ *
+ * The CPUs a process can use are its affinity mask if it is confined
+ * to its primary group by SetProcessAffinityMask(); otherwise they are
+ * every active processor in every group, since a thread can be moved
+ * to any group.
+ *
+ * pthread_setaffinity_np() puts a thread in the group holding most of
+ * the CPUs it asks for. pthread_create() takes the groups an attribute
+ * set spans in turn, so that, for example, a thread pool's workers
+ * spread over all of the process's groups.
+ */
+
+static LONG ptw32_cpu_group_next = 0;
+
+
+static FARPROC
+ptw32_kernel32_proc (const char * name)
+{
+#if defined(WINCE)
+  return NULL;
+#else
+  return GetProcAddress (GetModuleHandle (TEXT ("KERNEL32.DLL")), (LPCSTR) name);
+#endif
+}
+
+
+/*
+ * ptw32_cpu_groups_init()
+ *
+ * Find the processor group functions and record the layout of the
+ * active groups.
+ */
+void
+ptw32_cpu_groups_init (void)
+{
+  WORD (WINAPI * getGroupCount) (VOID);
+  DWORD (WINAPI * getMaximumCount) (WORD);
+  DWORD (WINAPI * getActiveCount) (WORD);
+  int groups;
+  int g;
+
+  ptw32_cpu_groups = 1;
+  ptw32_cpu_group_first[0] = 0;
+  ptw32_cpu_group_first[1] = (int) (8 * sizeof (DWORD_PTR));
+  ptw32_cpu_group_active[0] = ~(DWORD_PTR) 0;
+  ptw32_get_process_group_affinity = NULL;
+  ptw32_get_thread_group_affinity = NULL;
+  ptw32_set_thread_group_affinity = NULL;
+
+  getGroupCount = (WORD (WINAPI *) (VOID))
+    ptw32_kernel32_proc ("GetActiveProcessorGroupCount");
+  getMaximumCount = (DWORD (WINAPI *) (WORD))
+    ptw32_kernel32_proc ("GetMaximumProcessorCount");
+  getActiveCount = (DWORD (WINAPI *) (WORD))
+    ptw32_kernel32_proc ("GetActiveProcessorCount");
+  ptw32_get_process_group_affinity = (BOOL (WINAPI *) (HANDLE, WORD *, WORD *))
+    ptw32_kernel32_proc ("GetProcessGroupAffinity");
+  ptw32_get_thread_group_affinity = (BOOL (WINAPI *) (HANDLE, ptw32_group_affinity_t *))
+    ptw32_kernel32_proc ("GetThreadGroupAffinity");
+  ptw32_set_thread_group_affinity = (BOOL (WINAPI *) (HANDLE, const ptw32_group_affinity_t *, ptw32_group_affinity_t *))
+    ptw32_kernel32_proc ("SetThreadGroupAffinity");
+
+  if (getGroupCount == NULL || getMaximumCount == NULL || getActiveCount == NULL
+      || ptw32_get_process_group_affinity == NULL
+      || ptw32_get_thread_group_affinity == NULL
+      || ptw32_set_thread_group_affinity == NULL)
+    {
+      ptw32_get_process_group_affinity = NULL;
+      ptw32_get_thread_group_affinity = NULL;
+      ptw32_set_thread_group_affinity = NULL;
+      return;
+    }
+
+  groups = (int) getGroupCount ();
+  if (groups < 1)
+    {
+      groups = 1;
+    }
+  else if (groups > PTW32_MAX_CPU_GROUPS)
+    {
+      groups = PTW32_MAX_CPU_GROUPS;
+    }
+
+  for (g = 0; g < groups; g++)
+    {
+      DWORD width = getMaximumCount ((WORD) g);
+      DWORD active = getActiveCount ((WORD) g);
+
+      if (width > 8 * sizeof (DWORD_PTR))
+	{
+	  width = 8 * sizeof (DWORD_PTR);
+	}
+      if (active > width)
+	{
+	  active = width;
+	}
+
+      ptw32_cpu_group_first[g + 1] = ptw32_cpu_group_first[g] + (int) width;
+      ptw32_cpu_group_active[g] = (active == 8 * sizeof (DWORD_PTR))
+				   ? ~(DWORD_PTR) 0
+				   : (((DWORD_PTR) 1 << active) - 1);
+    }
+
+  ptw32_cpu_groups = groups;
+}
+
+
+/*
+ * ptw32_popcount()
+ *
+ * The number of bits set in 'word'.
+ */
+int
+ptw32_popcount (size_t word)
+{
+#if defined(__GNUC__) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4))
+  return __builtin_popcountll ((unsigned long long) word);
+#else
+  const size_t m1 = ~(size_t) 0 / 3;
+  const size_t m2 = ~(size_t) 0 / 5;
+  const size_t m4 = ~(size_t) 0 / 17;
+  const size_t h01 = ~(size_t) 0 / 255;
+
+  word -= (word >> 1) & m1;
+  word = (word & m2) + ((word >> 2) & m2);
+  word = (word + (word >> 4)) & m4;
+  return (int) ((word * h01) >> (8 * (sizeof (size_t) - 1)));
+#endif
+}
+
+
+/*
+ * ptw32_cpuset_get_group()
+ *
+ * The CPUs of 'group' that are in the set, as a mask for the group.
+ */
+DWORD_PTR
+ptw32_cpuset_get_group (size_t setsize, const cpu_set_t * set, int group)
+{
+  const unsigned char * bits = (const unsigned char *) set;
+  DWORD_PTR mask = 0;
+  int first;
+  int n;
+
+  if (group < 0 || group >= ptw32_cpu_groups)
+    {
+      return 0;
+    }
+
+  first = ptw32_cpu_group_first[group];
+
+  for (n = 0; n < ptw32_cpu_group_first[group + 1] - first; n++)
+    {
+      size_t cpu = (size_t) (first + n);
+
+      if (cpu / 8 >= setsize)
+	{
+	  break;
+	}
+      if (bits[cpu / 8] & (1 << (cpu % 8)))
+	{
+	  mask |= (DWORD_PTR) 1 << n;
+	}
+    }
+
+  return mask;
+}
+
+
+/*
+ * ptw32_cpuset_put_group()
+ *
+ * Add the CPUs of 'group' in 'mask' to the set. Returns EINVAL if one
+ * of them is past the end of the set.
+ */
+int
+ptw32_cpuset_put_group (size_t setsize, cpu_set_t * set, int group, DWORD_PTR mask)
+{
+  unsigned char * bits = (unsigned char *) set;
+  int n;
+
+  if (group < 0 || group >= ptw32_cpu_groups)
+    {
+      return (mask == 0) ? 0 : EINVAL;
+    }
+
+  for (n = 0; mask != 0; n++, mask >>= 1)
+    {
+      size_t cpu = (size_t) (ptw32_cpu_group_first[group] + n);
+
+      if (mask & 1)
+	{
+	  if (cpu / 8 >= setsize
+	      || cpu >= (size_t) ptw32_cpu_group_first[group + 1])
+	    {
+	      return EINVAL;
+	    }
+	  bits[cpu / 8] |= (unsigned char) (1 << (cpu % 8));
+	}
+    }
+
+  return 0;
+}
+
+
+/*
+ * ptw32_cpuset_next_group()
+ *
+ * The next of the groups holding CPUs of the set, taking each in turn,
+ * and the set's CPUs there as a mask; or -1 if the set holds none.
+ */
+int
+ptw32_cpuset_next_group (size_t setsize, const cpu_set_t * set, DWORD_PTR * mask)
+{
+  int start;
+  int n;
+
+  if (ptw32_cpu_groups > 1)
+    {
+      start = (int) ((unsigned long) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_cpu_group_next)
+		     % (unsigned long) ptw32_cpu_groups);
+
+      for (n = 0; n < ptw32_cpu_groups; n++)
+	{
+	  int g = (start + n) % ptw32_cpu_groups;
+
+	  if ((*mask = ptw32_cpuset_get_group (setsize, set, g)) != 0)
+	    {
+	      return g;
+	    }
+	}
+      return -1;
+    }
+
+  *mask = ptw32_cpuset_get_group (setsize, set, 0);
+  return (*mask != 0) ? 0 : -1;
+}
+
+
+/*
+ * ptw32_process_group_affinity()
+ *
+ * The CPUs of 'group' that 'process' can use, as a mask for the group.
+ */
+int
+ptw32_process_group_affinity (HANDLE process, int group, DWORD_PTR * mask)
+{
+  DWORD_PTR vProcessMask;
+  DWORD_PTR vSystemMask;
+
+  *mask = 0;
+
+  if (group < 0 || group >= ptw32_cpu_groups)
+    {
+      return 0;
+    }
+
+#if defined(NEED_PROCESS_AFFINITY_MASK)
+  *mask = 1;
+  return 0;
+#else
+  if (ptw32_get_process_group_affinity == NULL)
+    {
+      if (!GetProcessAffinityMask (process, &vProcessMask, &vSystemMask))
+	{
+	  return EAGAIN;
+	}
+      *mask = vProcessMask;
+      return 0;
+    }
+  else
+    {
+      WORD groups[PTW32_MAX_CPU_GROUPS];
+      WORD count = PTW32_MAX_CPU_GROUPS;
+
+      /*
+       * GetProcessAffinityMask() returns empty masks for a process with
+       * threads in more than one group, which isn't confined anyway.
+       */
+      if (ptw32_get_process_group_affinity (process, &count, groups)
+	  && count == 1
+	  && GetProcessAffinityMask (process, &vProcessMask, &vSystemMask)
+	  && vProcessMask != vSystemMask)
+	{
+	  if (group == (int) groups[0])
+	    {
+	      *mask = vProcessMask;
+	    }
+	  return 0;
+	}
+
+      *mask = ptw32_cpu_group_active[group];
+      return 0;
+    }
+#endif
+}
+
+
+#if defined(HAVE_CPU_AFFINITY)
+
+
+/*
+ * ptw32_get_thread_affinity()
+ *
+ * The thread's group and its affinity mask in that group.
+ */
+int
+ptw32_get_thread_affinity (HANDLE threadH, int * group, DWORD_PTR * mask)
+{
+  DWORD_PTR vProcessMask;
+  DWORD_PTR vSystemMask;
+  DWORD_PTR vThreadMask;
+
+  if (ptw32_get_thread_group_affinity != NULL)
+    {
+      ptw32_group_affinity_t ga;
+
+      if (!ptw32_get_thread_group_affinity (threadH, &ga))
+	{
+	  return EAGAIN;
+	}
+      *group = (int) ga.Group;
+      *mask = ga.Mask;
+      return 0;
+    }
+
+  /*
+   * Without GetThreadGroupAffinity() the only way to read a thread's
+   * mask is to replace it, so briefly set it to the process mask.
+   */
+  if (!GetProcessAffinityMask (GetCurrentProcess (), &vProcessMask, &vSystemMask)
+      || 0 == (vThreadMask = SetThreadAffinityMask (threadH, vProcessMask))
+      || !SetThreadAffinityMask (threadH, vThreadMask))
+    {
+      return EAGAIN;
+    }
+
+  *group = 0;
+  *mask = vThreadMask;
+  return 0;
+}
+
+
+/*
+ * ptw32_set_thread_affinity()
+ *
+ * Move the thread to 'group' and set its affinity mask there.
+ */
+int
+ptw32_set_thread_affinity (HANDLE threadH, int group, DWORD_PTR mask)
+{
+  if (ptw32_set_thread_group_affinity != NULL)
+    {
+      ptw32_group_affinity_t ga;
+
+      memset (&ga, 0, sizeof (ga));
+      ga.Mask = mask;
+      ga.Group = (WORD) group;
+
+      return ptw32_set_thread_group_affinity (threadH, &ga, NULL) ? 0 : EAGAIN;
+    }
+
+  if (group != 0)
+    {
+      return EINVAL;
+    }
+
+  return SetThreadAffinityMask (threadH, mask) ? 0 : EAGAIN;
+}
+
+#endif /* HAVE_CPU_AFFINITY */
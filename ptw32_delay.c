@@ -0,0 +1,238 @@
+/*
+ * ptw32_delay.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Notes on delays.
+ * ----------------
+ *
+ * pthread_delay_np(), nanosleep() and clock_nanosleep() sleep on the
+ * calling thread's own waitable timer, sp->delayTimer, created on first
+ * use with ptw32_clock_timer() so that it has high resolution where
+ * Windows allows. The thread's park event is waited on with it, and
+ * sp->cancelRequested checked around each wait, so the sleep is a
+ * cancellation point as before (see ptw32_park.c). A stale unpark just
+ * sends the thread round the loop again.
+ *
+ * Even a high resolution timer wakes late by up to the system timer
+ * period. In PTHREAD_DELAY_PRECISE_NP mode the thread sleeps until
+ * ptw32_delay_slack ns before it is due and spins on the performance
+ * counter for the rest. The slack is calibrated by every precise sleep:
+ * it rises quickly towards a late wake and falls slowly after prompt
+ * ones, so it tracks the worst recent lateness. Delays shorter than the
+ * slack only spin.
+ */
+
+/*
+ * ptw32_delay_cancel()
+ *
+ * Act on a cancellation request seen while delaying.
+ */
+static int
+ptw32_delay_cancel (ptw32_thread_t * sp)
+{
+  ptw32_mcs_local_node_t stateLock;
+
+  ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
+  sp->cancelRequested = 0;
+  if (sp->state < PThreadStateCanceling)
+    {
+      sp->state = PThreadStateCanceling;
+      sp->cancelState = PTHREAD_CANCEL_DISABLE;
+      ptw32_mcs_lock_release (&stateLock);
+
+      ptw32_throw (PTW32_EPS_CANCEL);
+    }
+
+  ptw32_mcs_lock_release (&stateLock);
+
+  return ESRCH;
+}
+
+/*
+ * ptw32_delay_calibrate()
+ *
+ * Fold how late a sleep woke into ptw32_delay_slack. Racing updates
+ * only lose a sample.
+ */
+static void
+ptw32_delay_calibrate (LONGLONG late)
+{
+  LONGLONG slack = ptw32_delay_slack;
+
+  if (late > slack)
+    {
+      slack += (late - slack) / 2;
+    }
+  else
+    {
+      slack -= (slack - late) / 16;
+    }
+
+  if (slack < PTW32_DELAY_SLACK_MIN)
+    {
+      slack = PTW32_DELAY_SLACK_MIN;
+    }
+  else if (slack > PTW32_DELAY_SLACK_MAX)
+    {
+      slack = PTW32_DELAY_SLACK_MAX;
+    }
+
+  ptw32_delay_slack = (LONG) slack;
+}
+
+/*
+ * ptw32_delay()
+ *
+ * Delay the calling thread until 'deadline' on CLOCK_MONOTONIC,
+ * spinning at the end if 'precise'. A cancellation point.
+ *
+ * Returns 0, or ENOMEM, EINVAL or ESRCH as pthread_delay_np() does.
+ */
+int
+ptw32_delay (LONGLONG deadline, int precise)
+{
+  pthread_t self;
+  ptw32_thread_t * sp;
+  HANDLE handles[2];
+  DWORD nHandles = 0;
+  DWORD status;
+  LARGE_INTEGER due;
+  LONGLONG target;
+  LONGLONG now;
+  int spins;
+
+  if (NULL == (self = pthread_self ()).p)
+    {
+      return ENOMEM;
+    }
+
+  sp = (ptw32_thread_t *) self.p;
+
+  if (sp->cancelState == PTHREAD_CANCEL_ENABLE
+      && (sp->parkEvent != NULL || ptw32_lazy_event (&sp->parkEvent) != NULL))
+    {
+      /*
+       * Async cancellation won't catch us until the delay is up.
+       * Deferred cancellation will cancel us immediately.
+       */
+      handles[nHandles++] = sp->parkEvent;
+    }
+
+  if (sp->delayTimer == NULL)
+    {
+      sp->delayTimer = ptw32_clock_timer ();
+    }
+
+  for (;;)
+    {
+      if (nHandles > 0 && sp->cancelRequested)
+        {
+          return ptw32_delay_cancel (sp);
+        }
+
+      target = deadline - (precise ? (LONGLONG) ptw32_delay_slack : 0);
+      now = ptw32_clock_ns (CLOCK_MONOTONIC);
+
+      if (target <= now)
+        {
+          break;
+        }
+
+      /*
+       * Negative due times are relative, in 100 ns units.
+       */
+      due.QuadPart = -((target - now + 99) / 100);
+
+      if (sp->delayTimer != NULL
+          && SetWaitableTimer (sp->delayTimer, &due, 0, NULL, NULL, PTW32_FALSE))
+        {
+          handles[nHandles] = sp->delayTimer;
+          status = WaitForMultipleObjects (nHandles + 1, handles, PTW32_FALSE, INFINITE);
+        }
+      else if (nHandles > 0)
+        {
+          status = WaitForSingleObject (handles[0], (DWORD) ((target - now + 999999) / 1000000));
+        }
+      else
+        {
+          Sleep ((DWORD) ((target - now + 999999) / 1000000));
+          status = WAIT_TIMEOUT;
+        }
+
+      if (nHandles > 0 && status == WAIT_OBJECT_0)
+        {
+          /*
+           * Cancelled, or a stale unpark: the flag tells which at the
+           * top of the loop.
+           */
+          continue;
+        }
+      else if (status == WAIT_FAILED)
+        {
+          return EINVAL;
+        }
+
+      if (precise)
+        {
+          ptw32_delay_calibrate (ptw32_clock_ns (CLOCK_MONOTONIC) - target);
+        }
+    }
+
+  if (precise)
+    {
+      for (spins = 0; ptw32_clock_ns (CLOCK_MONOTONIC) < deadline; spins++)
+        {
+          if (nHandles > 0
+              && (spins & 63) == 0
+              && sp->cancelRequested)
+            {
+              return ptw32_delay_cancel (sp);
+            }
+        }
+    }
+
+  return 0;
+}
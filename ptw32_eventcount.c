@@ -0,0 +1,139 @@
+/*
+ * ptw32_eventcount.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * ptw32_eventcount_wait()
+ *
+ * Wait for the epoch of 'ec' to move on from 'key', for up to
+ * 'milliseconds', and end the wait announced by the matching prepare.
+ * Returns 0, ETIMEDOUT, ENOSPC or, if 'cancelable', EINTR
+ * (cancellation pending, act on it with pthread_testcancel()).
+ */
+int
+ptw32_eventcount_wait (pthread_eventcount_t ec, unsigned int key,
+                       DWORD milliseconds, int cancelable)
+{
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER now;
+  LONGLONG deadline = 0;
+  LONGLONG remaining;
+  DWORD timeout = milliseconds;
+  int result = 0;
+
+  /*
+   * Time the wait with the performance counter, which unlike
+   * GetTickCount() is precise and doesn't wrap. The products are split
+   * so that they can't overflow.
+   */
+  if (milliseconds != INFINITE)
+    {
+      (void) QueryPerformanceFrequency (&frequency);
+      (void) QueryPerformanceCounter (&now);
+      deadline = now.QuadPart
+                 + (LONGLONG) (milliseconds / 1000) * frequency.QuadPart
+                 + (LONGLONG) (milliseconds % 1000) * frequency.QuadPart / 1000;
+    }
+
+  /*
+   * ptw32_wait_on_address() can return early, so wait until the epoch
+   * has actually moved on.
+   */
+  while ((unsigned int) ec->epoch == key)
+    {
+      if (milliseconds != INFINITE)
+        {
+          (void) QueryPerformanceCounter (&now);
+          remaining = deadline - now.QuadPart;
+          if (remaining <= 0)
+            {
+              result = ETIMEDOUT;
+              break;
+            }
+          /* Round up to a whole millisecond. */
+          timeout = (DWORD) ((remaining / frequency.QuadPart) * 1000
+                             + ((remaining % frequency.QuadPart) * 1000
+                                + frequency.QuadPart - 1) / frequency.QuadPart);
+        }
+
+      if (0 != (result = ptw32_wait_on_address (&ec->epoch, (LONG) key,
+                                                timeout, cancelable)))
+        {
+          break;
+        }
+    }
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ec->waiters);
+
+  return result;
+}
+
+/*
+ * ptw32_eventcount_notify()
+ *
+ * Notify 'ec', waking up to 'count' of the threads blocked in a
+ * commit. The others see the new epoch when they next wake or reach
+ * the commit. Returns the number of threads woken.
+ */
+int
+ptw32_eventcount_notify (pthread_eventcount_t ec, int count)
+{
+  /*
+   * The caller's change to its data must be visible before we look
+   * for waiters, or a waiter rechecking the data could miss the change
+   * while we miss the waiter. A compiler barrier is not enough here:
+   * even x86 lets a load pass an earlier store.
+   */
+  MemoryBarrier ();
+
+  if (ec->waiters == 0)
+    {
+      return 0;
+    }
+
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &ec->epoch);
+
+  return ptw32_wake_address (&ec->epoch, count);
+}
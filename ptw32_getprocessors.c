@@ -47,7 +47,8 @@
 /*
  * ptw32_getprocessors()
  *
- * Get the number of CPUs available to the process.
+ * Get the number of CPUs available to the process, in all processor
+ * groups.
  *
  * If the available number of CPUs is 1 then pthread_spin_lock()
  * will block rather than spin if the lock is already owned.
@@ -60,8 +61,6 @@
 int
 ptw32_getprocessors (int *count)
 {
-  DWORD_PTR vProcessCPUs;
-  DWORD_PTR vSystemCPUs;
   int result = 0;
 
 #if defined(NEED_PROCESS_AFFINITY_MASK)
@@ -70,26 +69,21 @@ ptw32_getprocessors (int *count)
 
 #else
 
-  if (GetProcessAffinityMask (GetCurrentProcess (),
-			      &vProcessCPUs, &vSystemCPUs))
-    {
-      DWORD_PTR bit;
-      int CPUs = 0;
+  DWORD_PTR vProcessCPUs;
+  int CPUs = 0;
+  int g;
 
-      for (bit = 1; bit != 0; bit <<= 1)
+  for (g = 0; g < ptw32_cpu_groups; g++)
+    {
+      if ((result = ptw32_process_group_affinity (GetCurrentProcess (), g, &vProcessCPUs)) != 0)
 	{
-	  if (vProcessCPUs & bit)
-	    {
-	      CPUs++;
-	    }
+	  return result;
 	}
-      *count = CPUs;
-    }
-  else
-    {
-      result = EAGAIN;
+      CPUs += ptw32_popcount ((size_t) vProcessCPUs);
     }
 
+  *count = CPUs;
+
 #endif
 
   return (result);
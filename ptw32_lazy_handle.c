@@ -0,0 +1,130 @@
+/*
+ * ptw32_lazy_handle.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "semaphore.h"
+#include "implement.h"
+
+
+/*
+ * Notes on lazily created wait objects.
+ *
+ * Robust mutexes and the rwlock kinds that have their own wait
+ * objects don't create them until a thread first has to block. Most
+ * sync objects are never contended, so most never own a kernel handle,
+ * and init and destroy don't enter the kernel. (Other mutexes,
+ * semaphores and barriers block on the waiting thread's own park
+ * event, which is created the same way. See ptw32_park.c.)
+ *
+ * The handle starts as NULL. The first thread that needs it creates
+ * one and installs it with a compare-and-swap; a thread that loses the
+ * race closes its own and uses the winner's. Once installed the handle
+ * is never changed until the object is destroyed.
+ *
+ * Every object using this follows the same rule: a thread creates the
+ * handle before it makes itself visible as a waiter (sets the waiting
+ * state, increments a waiter count, etc.). A thread that sees
+ * a waiter and must wake it therefore always finds the handle in
+ * place, since the handle was installed by an Interlocked operation
+ * that precedes the one that published the waiter.
+ *
+ * Failure to create the handle is reported as ENOSPC by the waiting
+ * call, as it was previously by init.
+ */
+
+/*
+ * ptw32_lazy_event()
+ *
+ * Return the auto-reset event in *handle, creating it unsignalled
+ * if it doesn't exist yet. Returns NULL if it can't be created.
+ */
+HANDLE
+ptw32_lazy_event (HANDLE * handle)
+{
+  HANDLE h = *handle;
+
+  if (h == NULL)
+    {
+      if ((h = CreateEvent (NULL, PTW32_FALSE, PTW32_FALSE, NULL)) != NULL)
+	{
+	  HANDLE prev = (HANDLE) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) handle,
+									 (PTW32_INTERLOCKED_PVOID) h,
+									 (PTW32_INTERLOCKED_PVOID) NULL);
+	  if (prev != NULL)
+	    {
+	      (void) CloseHandle (h);
+	      h = prev;
+	    }
+	}
+    }
+
+  return h;
+}
+
+/*
+ * ptw32_lazy_semaphore()
+ *
+ * Return the semaphore in *handle, creating it with a count of zero
+ * if it doesn't exist yet. Returns NULL if it can't be created.
+ */
+HANDLE
+ptw32_lazy_semaphore (HANDLE * handle, LONG maximum)
+{
+  HANDLE h = *handle;
+
+  if (h == NULL)
+    {
+      if ((h = CreateSemaphore (NULL, 0, maximum, NULL)) != NULL)
+	{
+	  HANDLE prev = (HANDLE) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) handle,
+									 (PTW32_INTERLOCKED_PVOID) h,
+									 (PTW32_INTERLOCKED_PVOID) NULL);
+	  if (prev != NULL)
+	    {
+	      (void) CloseHandle (h);
+	      h = prev;
+	    }
+	}
+    }
+
+  return h;
+}
@@ -0,0 +1,561 @@
+/*
+ * ptw32_lockprof.c
+ *
+ * Description:
+ * This translation unit implements the lock contention profiler.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Notes on the lock profiler.
+ * ---------------------------
+ *
+ * When profiling is on, every mutex created gets a ptw32_lockprof_t record
+ * which is linked into a process-wide registry (cf. the condition variable
+ * list used by pthread_timechange_handler_np). Mutexes created while
+ * profiling is off carry a NULL record and pay only a NULL test in the
+ * lock and unlock paths.
+ *
+ * Only mutexes are attached. Read-write locks, condition variables and
+ * spin locks that lock a mutex internally are seen only through that
+ * mutex, and only as far as they use it; other objects aren't seen. The
+ * 'type' field leaves room for them.
+ *
+ * All statistics except the failed trylock count are updated by the
+ * thread that owns the mutex at the time, i.e. the mutex serialises
+ * updates to its own record. Reports read the records without stopping
+ * the world and so may see a slightly inconsistent snapshot. Resets
+ * write them the same way, and could leave a record inconsistent, so
+ * pthread_lockprof_reset_np() may only be called while no other thread
+ * is using a profiled mutex.
+ *
+ * Call sites are sampled rather than recorded on every contended acquire:
+ * one in every ptw32_lockprof_sample contended acquires stores the return
+ * address of the caller of pthread_mutex_lock().
+ *
+ * Profiling can be turned on from the start of the process by setting
+ * these environment variables:
+ *
+ *   PTW32_LOCKPROF=<file>     Enable profiling and write the report to
+ *                             <file> when the library is detached from
+ *                             the process.
+ *   PTW32_LOCKPROF_TOP=<n>    Number of objects in the report (default 20).
+ *   PTW32_LOCKPROF_SAMPLE=<n> Call site sampling interval (default 16).
+ */
+
+#define PTW32_LOCKPROF_DEFAULT_TOP       20
+#define PTW32_LOCKPROF_DEFAULT_SAMPLE    16
+
+#if defined(PTW32_HOST)
+#define PTW32_LOCKPROF_U64               "%llu"
+#else
+#define PTW32_LOCKPROF_U64               "%I64u"
+#endif
+
+static char ptw32_lockprof_path[MAX_PATH];
+static int ptw32_lockprof_top = PTW32_LOCKPROF_DEFAULT_TOP;
+
+
+LONGLONG
+ptw32_lockprof_now (void)
+{
+  LARGE_INTEGER t;
+
+  (void) QueryPerformanceCounter (&t);
+
+  return t.QuadPart;
+}
+
+
+static INLINE int
+ptw32_lockprof_bucket (unsigned __int64 ticks)
+{
+  unsigned __int64 usecs = (ticks * 1000000) / (unsigned __int64) ptw32_lockprof_frequency;
+  int bucket = 0;
+
+  while (usecs != 0 && bucket < PTW32_LOCKPROF_BUCKETS - 1)
+    {
+      usecs >>= 1;
+      bucket++;
+    }
+
+  return bucket;
+}
+
+
+int
+ptw32_lockprof_attach (void * object, int type, int kind, ptw32_lockprof_t ** prof)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Allocates a profile record for 'object' and adds it
+      *      to the registry. The record is returned through
+      *      'prof'.
+      *
+      * RESULTS
+      *              0               successfully attached,
+      *              ENOMEM          insufficient memory
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_lockprof_t * p;
+  ptw32_mcs_local_node_t node;
+
+  p = (ptw32_lockprof_t *) calloc (1, sizeof (*p));
+
+  if (p == NULL)
+    {
+      *prof = NULL;
+      return ENOMEM;
+    }
+
+  p->object = object;
+  p->type = type;
+  p->kind = kind;
+
+  ptw32_mcs_lock_acquire (&ptw32_lockprof_list_lock, &node);
+
+  p->prev = NULL;
+  p->next = ptw32_lockprof_list_head;
+
+  if (ptw32_lockprof_list_head != NULL)
+    {
+      ptw32_lockprof_list_head->prev = p;
+    }
+
+  ptw32_lockprof_list_head = p;
+
+  ptw32_mcs_lock_release (&node);
+
+  *prof = p;
+
+  return 0;
+}
+
+
+void
+ptw32_lockprof_detach (ptw32_lockprof_t * p)
+{
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&ptw32_lockprof_list_lock, &node);
+
+  if (ptw32_lockprof_list_head == p)
+    {
+      ptw32_lockprof_list_head = p->next;
+    }
+  else
+    {
+      p->prev->next = p->next;
+    }
+
+  if (p->next != NULL)
+    {
+      p->next->prev = p->prev;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  free (p);
+}
+
+
+void
+ptw32_lockprof_acquired (pthread_mutex_t mx, LONGLONG waitStart, void * caller)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Called by the new owner of 'mx' immediately after
+      *      acquiring it. 'waitStart' is the time at which the
+      *      caller began to wait, or zero if it didn't.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_lockprof_t * p = mx->prof;
+  LONGLONG now;
+
+  if (mx->recursive_count > 1)
+    {
+      /* A recursive relock doesn't transfer ownership. */
+      return;
+    }
+
+  now = ptw32_lockprof_now ();
+
+  p->nAcquired++;
+  p->acquireTime = now;
+
+  if (waitStart != 0)
+    {
+      unsigned __int64 wait = (unsigned __int64) (now - waitStart);
+
+      p->nContended++;
+      p->waitTotal += wait;
+
+      if (wait > p->waitMax)
+        {
+          p->waitMax = wait;
+        }
+
+      p->waitHist[ptw32_lockprof_bucket (wait)]++;
+
+      if (ptw32_lockprof_sample > 0
+          && (p->nContended % (unsigned __int64) ptw32_lockprof_sample) == 0)
+        {
+          int i;
+
+          for (i = 0; i < PTW32_LOCKPROF_SITES; i++)
+            {
+              if (p->sites[i].addr == caller || p->sites[i].addr == NULL)
+                {
+                  p->sites[i].addr = caller;
+                  p->sites[i].count++;
+                  break;
+                }
+            }
+
+          if (i == PTW32_LOCKPROF_SITES)
+            {
+              p->nOtherSites++;
+            }
+        }
+    }
+}
+
+
+void
+ptw32_lockprof_released (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Called by the owner of 'mx' immediately before it
+      *      gives up ownership.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_lockprof_t * p = mx->prof;
+  unsigned __int64 hold;
+
+  if (p->acquireTime == 0)
+    {
+      /* Acquired before the last reset or not at all. */
+      return;
+    }
+
+  hold = (unsigned __int64) (ptw32_lockprof_now () - p->acquireTime);
+  p->acquireTime = 0;
+
+  p->holdTotal += hold;
+
+  if (hold > p->holdMax)
+    {
+      p->holdMax = hold;
+    }
+
+  p->holdHist[ptw32_lockprof_bucket (hold)]++;
+}
+
+
+void
+ptw32_lockprof_busy (pthread_mutex_t mx)
+{
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->prof->nBusy);
+}
+
+
+static int
+ptw32_lockprof_compare (const void * a, const void * b)
+{
+  const ptw32_lockprof_t * pa = (const ptw32_lockprof_t *) a;
+  const ptw32_lockprof_t * pb = (const ptw32_lockprof_t *) b;
+
+  /* Descending total wait time, then descending contended count. */
+  if (pa->waitTotal != pb->waitTotal)
+    {
+      return (pa->waitTotal < pb->waitTotal) ? 1 : -1;
+    }
+  if (pa->nContended != pb->nContended)
+    {
+      return (pa->nContended < pb->nContended) ? 1 : -1;
+    }
+  return 0;
+}
+
+
+static double
+ptw32_lockprof_usecs (unsigned __int64 ticks)
+{
+  return (double) (__int64) ticks * 1.0e6 / (double) ptw32_lockprof_frequency;
+}
+
+
+static void
+ptw32_lockprof_print_histogram (FILE * fp, const char * title, const unsigned long * hist)
+{
+  int i;
+
+  fprintf (fp, "    %s (usec):", title);
+
+  for (i = 0; i < PTW32_LOCKPROF_BUCKETS; i++)
+    {
+      if (hist[i] == 0)
+        {
+          continue;
+        }
+      if (i == 0)
+        {
+          fprintf (fp, " <1:%lu", hist[i]);
+        }
+      else if (i == PTW32_LOCKPROF_BUCKETS - 1)
+        {
+          fprintf (fp, " >=%lu:%lu", 1UL << (i - 1), hist[i]);
+        }
+      else
+        {
+          fprintf (fp, " %lu-%lu:%lu", 1UL << (i - 1), 1UL << i, hist[i]);
+        }
+    }
+
+  fprintf (fp, "\n");
+}
+
+
+int
+ptw32_lockprof_dump (const char * path, int top)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Writes a report of the 'top' most contended objects
+      *      to the file 'path', or to stderr if 'path' is NULL.
+      *
+      * RESULTS
+      *              0               report written,
+      *              ENOMEM          insufficient memory,
+      *              EACCES          the file could not be opened
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_lockprof_t * p;
+  ptw32_lockprof_t * snapshot;
+  ptw32_mcs_local_node_t node;
+  FILE * fp;
+  int count = 0;
+  int n = 0;
+  int i, j;
+
+  ptw32_mcs_lock_acquire (&ptw32_lockprof_list_lock, &node);
+
+  for (p = ptw32_lockprof_list_head; p != NULL; p = p->next)
+    {
+      count++;
+    }
+
+  snapshot = (ptw32_lockprof_t *) malloc ((count > 0 ? count : 1) * sizeof (*snapshot));
+
+  if (snapshot == NULL)
+    {
+      ptw32_mcs_lock_release (&node);
+      return ENOMEM;
+    }
+
+  for (p = ptw32_lockprof_list_head; p != NULL; p = p->next)
+    {
+      snapshot[n++] = *p;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  qsort (snapshot, n, sizeof (*snapshot), ptw32_lockprof_compare);
+
+  if (path == NULL)
+    {
+      fp = stderr;
+    }
+  else if ((fp = fopen (path, "a")) == NULL)
+    {
+      free (snapshot);
+      return EACCES;
+    }
+
+  if (top <= 0 || top > n)
+    {
+      top = n;
+    }
+
+  fprintf (fp, "Lock profile: %d objects profiled, top %d by total wait time\n", n, top);
+
+  for (i = 0; i < top; i++)
+    {
+      p = &snapshot[i];
+
+      fprintf (fp, "#%d mutex %p kind %d\n", i + 1, p->object, p->kind);
+      fprintf (fp, "    acquired " PTW32_LOCKPROF_U64 " contended " PTW32_LOCKPROF_U64
+               " trylock-busy %ld\n",
+               p->nAcquired, p->nContended, (long) p->nBusy);
+      fprintf (fp, "    wait total %.1f max %.1f usec; hold total %.1f max %.1f usec\n",
+               ptw32_lockprof_usecs (p->waitTotal), ptw32_lockprof_usecs (p->waitMax),
+               ptw32_lockprof_usecs (p->holdTotal), ptw32_lockprof_usecs (p->holdMax));
+      ptw32_lockprof_print_histogram (fp, "wait", p->waitHist);
+      ptw32_lockprof_print_histogram (fp, "hold", p->holdHist);
+
+      for (j = 0; j < PTW32_LOCKPROF_SITES && p->sites[j].addr != NULL; j++)
+        {
+          fprintf (fp, "    site %p sampled %lu\n", p->sites[j].addr, p->sites[j].count);
+        }
+      if (p->nOtherSites != 0)
+        {
+          fprintf (fp, "    other sites sampled %lu\n", p->nOtherSites);
+        }
+    }
+
+  if (fp != stderr)
+    {
+      fclose (fp);
+    }
+  else
+    {
+      fflush (fp);
+    }
+
+  free (snapshot);
+
+  return 0;
+}
+
+
+#if ! defined(WINCE)
+static int
+ptw32_lockprof_getenv_int (const char * name, int defaultValue)
+{
+  char buf[32];
+  DWORD len = GetEnvironmentVariableA (name, buf, sizeof (buf));
+
+  if (len == 0 || len >= sizeof (buf))
+    {
+      return defaultValue;
+    }
+
+  return atoi (buf);
+}
+#endif
+
+
+void
+ptw32_lockprof_initialize (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Turns profiling on at process start if requested
+      *      through the environment.
+      *
+      * ------------------------------------------------------
+      */
+{
+#if ! defined(WINCE)
+  DWORD len;
+  LARGE_INTEGER freq;
+
+  len = GetEnvironmentVariableA ("PTW32_LOCKPROF", ptw32_lockprof_path,
+                                 sizeof (ptw32_lockprof_path));
+
+  if (len == 0 || len >= sizeof (ptw32_lockprof_path))
+    {
+      ptw32_lockprof_path[0] = '\0';
+      return;
+    }
+
+  ptw32_lockprof_top = ptw32_lockprof_getenv_int ("PTW32_LOCKPROF_TOP",
+                                                  PTW32_LOCKPROF_DEFAULT_TOP);
+  ptw32_lockprof_sample = ptw32_lockprof_getenv_int ("PTW32_LOCKPROF_SAMPLE",
+                                                     PTW32_LOCKPROF_DEFAULT_SAMPLE);
+
+  if (QueryPerformanceFrequency (&freq) && freq.QuadPart > 0)
+    {
+      ptw32_lockprof_frequency = freq.QuadPart;
+      ptw32_lockprof_enabled = PTW32_TRUE;
+      ptw32_fastpath_v1 = PTW32_FALSE;
+    }
+#endif
+}
+
+
+void
+ptw32_lockprof_terminate (void)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Writes the at-exit report if one was requested
+      *      through the environment, then detaches all
+      *      remaining records from their objects.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_lockprof_t * p;
+  ptw32_mcs_local_node_t node;
+
+  if (ptw32_lockprof_path[0] != '\0')
+    {
+      (void) ptw32_lockprof_dump (ptw32_lockprof_path, ptw32_lockprof_top);
+      ptw32_lockprof_path[0] = '\0';
+    }
+
+  ptw32_lockprof_enabled = PTW32_FALSE;
+
+  ptw32_mcs_lock_acquire (&ptw32_lockprof_list_lock, &node);
+
+  while ((p = ptw32_lockprof_list_head) != NULL)
+    {
+      ptw32_lockprof_list_head = p->next;
+
+      if (p->type == PTW32_LOCKPROF_MUTEX)
+        {
+          ((pthread_mutex_t) p->object)->prof = NULL;
+        }
+
+      free (p);
+    }
+
+  ptw32_mcs_lock_release (&node);
+}
@@ -0,0 +1,181 @@
+/*
+ * ptw32_mutex_bias.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Notes on PTHREAD_MUTEX_BIASED_NP.
+ * ---------------------------------
+ *
+ * The first thread to lock a biased mutex becomes its bias owner and is
+ * recorded in ownerThread. From then on the bias owner locks and unlocks
+ * with plain stores to biasHeld instead of Interlocked operations on
+ * lock_idx:
+ *
+ *   lock:    biasHeld = 1; if (!biasRevoked) done; else biasHeld = 0 and
+ *            take the normal path.
+ *   unlock:  biasHeld = 0.
+ *
+ * Any other thread first acquires lock_idx in the normal way and then,
+ * while the bias is still in place, revokes it:
+ *
+ *   biasRevoked = 1 (Interlocked);
+ *   suspend and resume the bias owner;
+ *   wait for biasHeld == 0;
+ *   ownerThread = NULL.
+ *
+ * The plain store to biasHeld by the owner may still be sitting in its
+ * processor's store buffer when it reads biasRevoked, so without more the
+ * two threads could each see the other's flag as zero. Suspending the
+ * owner thread (SuspendThread plus GetThreadContext, which waits until
+ * the thread has actually stopped) forces all of its earlier stores to
+ * become visible. So either the owner set biasHeld before the suspension
+ * and the revoker sees it, or it sets it afterwards and then must see
+ * biasRevoked. This handshake happens once per mutex.
+ *
+ * Holding lock_idx throughout the revocation serialises revokers and
+ * makes the revoker the owner of the mutex as soon as biasHeld is clear.
+ *
+ * The bias isn't re-established once revoked; the mutex behaves as
+ * PTHREAD_MUTEX_NORMAL from then on. A mutex that migrates between
+ * threads therefore pays for one revocation and nothing after that.
+ */
+
+
+static void
+ptw32_mutex_bias_handshake (pthread_t owner)
+{
+  ptw32_thread_t * tp = (ptw32_thread_t *) owner.p;
+  CONTEXT context;
+
+  if (tp != NULL
+      && tp->threadH != 0
+      && SuspendThread (tp->threadH) != (DWORD) -1)
+    {
+      /*
+       * SuspendThread is asynchronous; GetThreadContext doesn't return
+       * until the thread is stopped.
+       */
+      context.ContextFlags = CONTEXT_CONTROL;
+      (void) GetThreadContext (tp->threadH, &context);
+      (void) ResumeThread (tp->threadH);
+    }
+  else
+    {
+      /*
+       * The owner has gone, so it isn't storing anything.
+       */
+      MemoryBarrier ();
+    }
+}
+
+
+int
+ptw32_mutex_bias_acquired (pthread_mutex_t mx, pthread_t self, int wait)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Called by a thread that has just acquired lock_idx
+      *      of a PTHREAD_MUTEX_BIASED_NP mutex. Takes the bias
+      *      if nobody has it yet, or revokes another thread's
+      *      bias.
+      *
+      * PARAMETERS
+      *      mx
+      *              the mutex, with lock_idx held by the caller
+      *
+      *      self
+      *              the calling thread
+      *
+      *      wait
+      *              if PTW32_FALSE and the bias owner holds the
+      *              mutex, release lock_idx and return EBUSY
+      *              (for trylock) rather than wait.
+      *
+      * RESULTS
+      *              0               the caller owns the mutex,
+      *              EBUSY           the bias owner holds the mutex
+      *                              (only if 'wait' is false)
+      *
+      * ------------------------------------------------------
+      */
+{
+  if (mx->ownerThread.p == NULL)
+    {
+      if (0 == mx->biasRevoked)
+        {
+          mx->ownerThread = self;
+        }
+    }
+  else if (mx->ownerThread.p != self.p)
+    {
+      if (0 == mx->biasRevoked)
+        {
+          (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->biasRevoked,
+                                                  (PTW32_INTERLOCKED_LONG) 1);
+          ptw32_mutex_bias_handshake (mx->ownerThread);
+        }
+
+      while (mx->biasHeld)
+        {
+          if (!wait)
+            {
+              /*
+               * The revocation stands; the next thread to get lock_idx
+               * finishes it.
+               */
+              if ((LONG) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                                          (PTW32_INTERLOCKED_LONG) 0) < 0)
+                {
+                  (void) ptw32_wake_address (&mx->lock_idx, 1);
+                }
+              return EBUSY;
+            }
+          Sleep (0);
+        }
+
+      PTW32_COMPILER_BARRIER ();
+      mx->ownerThread.p = NULL;
+    }
+
+  return 0;
+}
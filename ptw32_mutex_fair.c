@@ -0,0 +1,281 @@
+/*
+ * ptw32_mutex_fair.c
+ *
+ * Description:
+ * This translation unit implements mutual exclusion (mutex) primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Notes on PTHREAD_MUTEX_FAIR_NP.
+ * -------------------------------
+ *
+ * The other mutex kinds let a running thread take the mutex ahead of a
+ * thread that has just been woken (barging). This maximises throughput
+ * but can starve a blocked thread for a long time under load.
+ *
+ * A fair mutex uses lock_idx exactly as the normal kind does:
+ *    0: unlocked/free.
+ *    1: locked - no waiters.
+ *   -1: locked - with waiters queued.
+ *
+ * The uncontended lock and unlock are a single Interlocked operation each.
+ * A thread that can't get the mutex joins a FIFO of waiters (guarded by
+ * queueLock) and parks (see ptw32_park.c). Unlock with waiters never
+ * makes the mutex free: it dequeues the head waiter and transfers
+ * ownership to it directly, so no other thread can get in first. Because
+ * lock_idx stays non-zero while anybody is queued, new arrivals always
+ * queue behind existing waiters.
+ *
+ * The cost is that every contended handoff includes a full context switch
+ * to the waiter, where the normal kind would often let the releasing
+ * thread (or another running thread) re-acquire immediately.
+ */
+
+
+int
+ptw32_mutex_fair_wait (pthread_mutex_t mx, const struct timespec * abstime)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Slow path of pthread_mutex_[timed]lock() for
+      *      PTHREAD_MUTEX_FAIR_NP mutexes. Called after the
+      *      fast path failed to change lock_idx from 0 to 1.
+      *
+      * PARAMETERS
+      *      mx
+      *              the mutex
+      *
+      *      abstime
+      *              absolute timeout or NULL to wait forever
+      *
+      * RESULTS
+      *              0               the calling thread owns the mutex,
+      *              ETIMEDOUT       abstime passed,
+      *              ENOSPC          unable to create the park event,
+      *              EINVAL          the wait failed
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_waiter_t self;
+  ptw32_mutex_waiter_t * w;
+  ptw32_mutex_waiter_t * prev;
+  ptw32_mcs_local_node_t node;
+  LONG idx;
+  int result = 0;
+
+  /*
+   * Make sure we can park before queueing.
+   */
+  self.next = NULL;
+  self.granted = 0;
+  self.thread = ptw32_park_self ();
+
+  if (self.thread == NULL)
+    {
+      return ENOSPC;
+    }
+
+  ptw32_mcs_lock_acquire (&mx->queueLock, &node);
+
+  for (;;)
+    {
+      idx = (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                                        (PTW32_INTERLOCKED_LONG) 0);
+      if (0 == idx)
+        {
+          /*
+           * Released before we got the queue lock and nobody is queued.
+           */
+          if (0 == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                                                   (PTW32_INTERLOCKED_LONG) 1,
+                                                                   (PTW32_INTERLOCKED_LONG) 0))
+            {
+              ptw32_mcs_lock_release (&node);
+              return 0;
+            }
+        }
+      else if (idx == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                                                      (PTW32_INTERLOCKED_LONG) -1,
+                                                                      (PTW32_INTERLOCKED_LONG) idx))
+        {
+          /*
+           * The owner must now take the slow path in unlock, which needs
+           * the queue lock, so it can't miss us.
+           */
+          break;
+        }
+    }
+
+  if (mx->queueTail == NULL)
+    {
+      mx->queueHead = &self;
+    }
+  else
+    {
+      mx->queueTail->next = &self;
+    }
+  mx->queueTail = &self;
+
+  ptw32_mcs_lock_release (&node);
+
+  /*
+   * The park event may have been set by an earlier, stale, unpark,
+   * so wait until we've been granted the mutex.
+   */
+  while (0 == result && !self.granted)
+    {
+      result = ptw32_park (self.thread,
+                           (abstime == NULL) ? INFINITE : ptw32_relmillisecs (abstime),
+                           PTW32_FALSE);
+    }
+
+  if (result != 0)
+    {
+      ptw32_mcs_lock_acquire (&mx->queueLock, &node);
+
+      if (self.granted)
+        {
+          /*
+           * Ownership was handed to us as we timed out.
+           */
+          result = 0;
+        }
+      else
+        {
+          for (prev = NULL, w = mx->queueHead; w != &self; prev = w, w = w->next)
+            {
+            }
+
+          if (prev == NULL)
+            {
+              mx->queueHead = self.next;
+            }
+          else
+            {
+              prev->next = self.next;
+            }
+          if (mx->queueTail == &self)
+            {
+              mx->queueTail = prev;
+            }
+
+          if (mx->queueHead == NULL)
+            {
+              /*
+               * Still owned by someone but no longer with waiters.
+               */
+              (void) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                                              (PTW32_INTERLOCKED_LONG) 1,
+                                                              (PTW32_INTERLOCKED_LONG) -1);
+            }
+        }
+
+      ptw32_mcs_lock_release (&node);
+    }
+
+  return result;
+}
+
+
+int
+ptw32_mutex_fair_release (pthread_mutex_t mx)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Slow path of pthread_mutex_unlock() for
+      *      PTHREAD_MUTEX_FAIR_NP mutexes. Called after the
+      *      fast path failed to change lock_idx from 1 to 0,
+      *      i.e. there may be waiters. Hands ownership to the
+      *      longest waiting thread.
+      *
+      * PARAMETERS
+      *      mx
+      *              the mutex
+      *
+      * RESULTS
+      *              0               the mutex was released
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mutex_waiter_t * w;
+  ptw32_thread_t * sp;
+  ptw32_mcs_local_node_t node;
+  int result = 0;
+
+  ptw32_mcs_lock_acquire (&mx->queueLock, &node);
+
+  w = mx->queueHead;
+
+  if (w == NULL)
+    {
+      /*
+       * The waiters timed out after we saw lock_idx == -1.
+       */
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                              (PTW32_INTERLOCKED_LONG) 0);
+    }
+  else
+    {
+      mx->queueHead = w->next;
+
+      if (mx->queueHead == NULL)
+        {
+          mx->queueTail = NULL;
+          (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &mx->lock_idx,
+                                                  (PTW32_INTERLOCKED_LONG) 1);
+        }
+
+      /*
+       * The waiter returns (and its node goes away) as soon as it sees
+       * 'granted' set or, if it timed out, after it gets the queue lock,
+       * so read 'w' first.
+       */
+      sp = w->thread;
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &w->granted,
+                                              (PTW32_INTERLOCKED_LONG) 1);
+      ptw32_unpark (sp);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
@@ -84,20 +84,14 @@ ptw32_new (void)
   tp->threadLock = 0;
   tp->robustMxListLock = 0;
   tp->robustMxList = NULL;
+  tp->cleanupStack = NULL;
+  tp->cancelRequested = 0;
   tp->name = NULL;
+  tp->rwlockReadHolds = 0;
 #if defined(HAVE_CPU_AFFINITY)
-  CPU_ZERO((cpu_set_t*)&tp->cpuset);
+  tp->cpuset = 0;
+  tp->cpuGroup = 0;
 #endif
-  tp->cancelEvent = CreateEvent (0, (int) PTW32_TRUE,	/* manualReset  */
-				 (int) PTW32_FALSE,	/* setSignaled  */
-				 NULL);
-
-  if (tp->cancelEvent == NULL)
-    {
-      ptw32_threadReusePush (tp->ptHandle);
-      return nil;
-    }
-
   return t;
 
 }
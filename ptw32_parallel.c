@@ -0,0 +1,300 @@
+/*
+ * ptw32_parallel.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Notes on parallel loops.
+ * ------------------------
+ *
+ * pthread_parallel_for_np() runs on a single thread pool shared by the
+ * whole process, with one worker fewer than there are processors: the
+ * calling thread makes up the last. The pool is created by the first
+ * loop and its workers then sleep between loops, so a loop costs a few
+ * wakeups rather than a pthread_create() and pthread_join() per thread.
+ *
+ * A loop is described by a ptw32_parallel_job_t on the caller's stack.
+ * The caller queues one helper task per extra thread it wants, each
+ * pointing at the job, then works on the loop itself. Every thread
+ * taking part, the caller included, runs ptw32_parallel_run():
+ *
+ *   static   - the range is cut into nThreads shares, or into chunks
+ *              of 'grain' dealt round robin to nThreads shares. Each
+ *              thread claims whole shares with an Interlocked increment
+ *              of 'nextId' until none are left, so if a helper is slow
+ *              to start another thread runs its share instead.
+ *   dynamic  - each thread claims the next chunk of 'grain' iterations
+ *              with an Interlocked increment of 'cursor'.
+ *   guided   - each thread claims a chunk of the remaining iterations
+ *              divided by PTW32_PARALLEL_GUIDED_DIVISOR * nThreads, but
+ *              not less than 'grain', with a compare-and-swap on
+ *              'cursor', so chunks start large and shrink.
+ *
+ * The caller can't return while a helper may still look at the job, so
+ * each helper counts 'helpers' down when it is done and the last one
+ * wakes the caller through ptw32_wake_address(), which only uses the
+ * address to find the waiter and never reads through it.
+ *
+ * A loop started from inside another loop, by the caller or a helper,
+ * runs serially on the calling thread. The thread's 'parallelLevel'
+ * counts the loops it is running.
+ *
+ * All offsets and chunk numbers are unsigned and relative to 'begin',
+ * so any range of longs can be used.
+ */
+
+#define PTW32_PARALLEL_INDEX(job, offset) ((long) ((unsigned long) (job)->begin + (offset)))
+
+
+/*
+ * ptw32_parallel_get_team()
+ *
+ * Return the team pool, creating it if need be, and set '*size' to its
+ * number of workers. Returns NULL with a size of 0 if there is only
+ * one processor or the pool can't be created; loops then run serially.
+ */
+pthread_pool_t
+ptw32_parallel_get_team (int * size)
+{
+  ptw32_mcs_local_node_t node;
+  pthread_pool_t team = NULL;
+  int n;
+
+  if (ptw32_parallel_team_size < 0)
+    {
+      ptw32_mcs_lock_acquire (&ptw32_parallel_team_lock, &node);
+
+      if (ptw32_parallel_team_size < 0)
+        {
+          n = pthread_num_processors_np () - 1;
+
+          /*
+           * A failure isn't remembered, so a later loop tries again.
+           */
+          if (n > 0 && 0 == pthread_pool_init_np (&team, NULL, n, n))
+            {
+              ptw32_parallel_team = team;
+              (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_parallel_team_size,
+                                                      (PTW32_INTERLOCKED_LONG) n);
+            }
+          else if (n <= 0)
+            {
+              (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &ptw32_parallel_team_size,
+                                                      (PTW32_INTERLOCKED_LONG) 0);
+            }
+        }
+
+      ptw32_mcs_lock_release (&node);
+    }
+
+  n = (int) ptw32_parallel_team_size;
+
+  PTW32_COMPILER_BARRIER ();
+
+  if (n <= 0)
+    {
+      *size = 0;
+      return NULL;
+    }
+
+  *size = n;
+
+  return ptw32_parallel_team;
+}
+
+/*
+ * ptw32_parallel_run()
+ *
+ * Take part in a loop: claim and run work until there is none left.
+ */
+void
+ptw32_parallel_run (ptw32_parallel_job_t * job)
+{
+  unsigned long nThreads = (unsigned long) job->nThreads;
+  unsigned long first;
+  unsigned long size;
+  unsigned long left;
+  unsigned long k;
+  ULONG old;
+
+  switch (job->policy)
+    {
+    case PTHREAD_PARALLEL_STATIC_NP:
+      while ((k = (ULONG) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &job->nextId) - 1)
+             < nThreads)
+        {
+          if (job->grain == 0)
+            {
+              /*
+               * Share k of nThreads nearly equal contiguous shares.
+               */
+              size = job->count / nThreads;
+              left = job->count % nThreads;
+              first = k * size + (k < left ? k : left);
+              size += (k < left);
+
+              (*job->routine) (PTW32_PARALLEL_INDEX (job, first),
+                               PTW32_PARALLEL_INDEX (job, first + size),
+                               job->arg);
+              continue;
+            }
+
+          /*
+           * Chunks k, k + nThreads, k + 2 * nThreads, ...
+           */
+          for (;;)
+            {
+              first = k * job->grain;
+              size = job->count - first;
+              size = (size < job->grain) ? size : job->grain;
+
+              (*job->routine) (PTW32_PARALLEL_INDEX (job, first),
+                               PTW32_PARALLEL_INDEX (job, first + size),
+                               job->arg);
+
+              if (job->chunks - k <= nThreads)
+                {
+                  break;
+                }
+              k += nThreads;
+            }
+        }
+      break;
+
+    case PTHREAD_PARALLEL_DYNAMIC_NP:
+      while ((k = (ULONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &job->cursor,
+                                                               (PTW32_INTERLOCKED_LONG) 1))
+             < job->chunks)
+        {
+          first = k * job->grain;
+          size = job->count - first;
+          size = (size < job->grain) ? size : job->grain;
+
+          (*job->routine) (PTW32_PARALLEL_INDEX (job, first),
+                           PTW32_PARALLEL_INDEX (job, first + size),
+                           job->arg);
+        }
+      break;
+
+    case PTHREAD_PARALLEL_GUIDED_NP:
+      while ((first = (ULONG) job->cursor) < job->count)
+        {
+          left = job->count - first;
+          size = left / (PTW32_PARALLEL_GUIDED_DIVISOR * nThreads);
+          size = (size > job->grain) ? size : job->grain;
+          size = (size < left) ? size : left;
+
+          old = (ULONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &job->cursor,
+                                                                 (PTW32_INTERLOCKED_LONG) (first + size),
+                                                                 (PTW32_INTERLOCKED_LONG) first);
+          if (old == first)
+            {
+              (*job->routine) (PTW32_PARALLEL_INDEX (job, first),
+                               PTW32_PARALLEL_INDEX (job, first + size),
+                               job->arg);
+            }
+        }
+      break;
+    }
+}
+
+/*
+ * ptw32_parallel_helper()
+ *
+ * The pool task queued for each extra thread in a loop.
+ */
+void PTW32_CDECL
+ptw32_parallel_helper (void * arg)
+{
+  ptw32_parallel_job_t * job = (ptw32_parallel_job_t *) arg;
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+
+  sp->parallelLevel++;
+  ptw32_parallel_run (job);
+  sp->parallelLevel--;
+
+  /*
+   * The job may be gone as soon as the count reaches zero.
+   */
+  if (0 == PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &job->helpers))
+    {
+      (void) ptw32_wake_address (&job->helpers, 1);
+    }
+}
+
+/*
+ * ptw32_parallel_finish()
+ *
+ * Run by the calling thread when it has done what it can, and as a
+ * cleanup handler if it is cancelled or exits from inside the loop.
+ * Stops any more work being handed out, then waits until the helpers
+ * have finished with the job.
+ */
+void PTW32_CDECL
+ptw32_parallel_finish (void * arg)
+{
+  ptw32_parallel_job_t * job = (ptw32_parallel_job_t *) arg;
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+  LONG n;
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &job->nextId,
+                                          (PTW32_INTERLOCKED_LONG) job->nThreads);
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &job->cursor,
+                                          (PTW32_INTERLOCKED_LONG) (job->policy == PTHREAD_PARALLEL_GUIDED_NP
+                                                                    ? job->count : job->chunks));
+
+  while ((n = job->helpers) != 0)
+    {
+      if (ENOSPC == ptw32_wait_on_address (&job->helpers, n, INFINITE, PTW32_FALSE))
+        {
+          /*
+           * No park event; the helpers touch the job only briefly
+           * once their work is done, so just poll.
+           */
+          Sleep (0);
+        }
+    }
+
+  sp->parallelLevel--;
+}
@@ -0,0 +1,331 @@
+/*
+ * ptw32_park.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Notes on parking.
+ *
+ * Every thread owns one auto-reset event, sp->parkEvent, created the
+ * first time the thread has to block and kept for as long as the
+ * ptw32_thread_t exists (including while it sits on the reuse stack).
+ * Mutexes, semaphores, barriers and MCS locks don't own kernel objects
+ * of their own for blocking: a thread parks on its own event and the
+ * thread that wakes it sets that event.
+ *
+ * Because the event belongs to the thread and outlives any one wait, a
+ * thread may be unparked after it has already stopped waiting (e.g. it
+ * timed out just as it was woken). The next park then returns early.
+ * Every caller must therefore treat a return from ptw32_park() as a
+ * hint and recheck its own condition.
+ *
+ * The address-keyed wait table lets a thread wait until the LONG at
+ * some address no longer holds an expected value, without the object
+ * at that address having to keep a list of waiters:
+ *
+ *   waiter                               waker
+ *   ------                               -----
+ *   while (*addr == expected)            *addr = new value;
+ *     ptw32_wait_on_address (addr,       ptw32_wake_address (addr, n);
+ *                            expected,
+ *                            ...);
+ *
+ * The waiter queues itself in the bucket for 'addr' and only then reads
+ * *addr again; the waker changes *addr and only then looks at the
+ * bucket. Both use Interlocked operations for the second step, so
+ * either the waiter sees the new value and doesn't sleep, or the waker
+ * sees the waiter and wakes it. The waker can skip the bucket lock
+ * entirely when the bucket is empty, which is the common case.
+ *
+ * Waits on addresses that hash to the same bucket share its lock and
+ * list, but the table is large enough that this is rare and the lock is
+ * only held to link or unlink a node.
+ *
+ * Deferred cancellation uses the same event. pthread_cancel() raises
+ * sp->cancelRequested and then unparks the thread if it has a park
+ * event; a cancelable park checks the flag before it waits. Both steps
+ * on each side are ordered by Interlocked operations (the event is
+ * published with one), so either the canceller sees the event and sets
+ * it or the thread sees the flag. A cancelable wait is therefore a
+ * single-handle wait, and a thread that never blocks never creates an
+ * event at all. Waits on other handles (pthreadCancelableWait(),
+ * delays) add the park event as their second handle.
+ */
+
+
+/*
+ * ptw32_park_self()
+ *
+ * Return the calling thread's ptw32_thread_t, creating its park event
+ * if it doesn't have one yet. Returns NULL if the event can't be
+ * created.
+ */
+ptw32_thread_t *
+ptw32_park_self (void)
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+
+  if (sp != NULL
+      && sp->parkEvent == NULL
+      && ptw32_lazy_event (&sp->parkEvent) == NULL)
+    {
+      sp = NULL;
+    }
+
+  return sp;
+}
+
+/*
+ * ptw32_park()
+ *
+ * Block the calling thread 'sp' until it is unparked, the timeout
+ * expires or, if 'cancelable', a cancellation request is pending.
+ * Returns 0, ETIMEDOUT, EINTR (cancellation pending, act on it
+ * with pthread_testcancel()) or EINVAL.
+ */
+int
+ptw32_park (ptw32_thread_t * sp, DWORD milliseconds, int cancelable)
+{
+  DWORD status;
+
+  /*
+   * A request that arrives while we wait sets the event, and the
+   * caller's recheck brings us back here to see the flag. Leave the
+   * flag for pthread_testcancel(), which clears it.
+   */
+  if (cancelable
+      && sp->cancelState == PTHREAD_CANCEL_ENABLE
+      && sp->cancelRequested)
+    {
+      return EINTR;
+    }
+
+  status = WaitForSingleObject (sp->parkEvent, milliseconds);
+
+  if (status == WAIT_OBJECT_0)
+    {
+      return 0;
+    }
+
+  return (status == WAIT_TIMEOUT) ? ETIMEDOUT : EINVAL;
+}
+
+/*
+ * ptw32_unpark()
+ *
+ * Wake thread 'sp' if it is parked, or make its next park return
+ * immediately if it isn't.
+ */
+void
+ptw32_unpark (ptw32_thread_t * sp)
+{
+  (void) SetEvent (sp->parkEvent);
+}
+
+/*
+ * Remove 'w' from bucket 'b'. The bucket lock must be held.
+ */
+static INLINE void
+ptw32_wait_unlink (ptw32_wait_bucket_t * b, ptw32_wait_node_t * w)
+{
+  if (w->prev == NULL)
+    {
+      b->head = w->next;
+    }
+  else
+    {
+      w->prev->next = w->next;
+    }
+
+  if (w->next == NULL)
+    {
+      b->tail = w->prev;
+    }
+  else
+    {
+      w->next->prev = w->prev;
+    }
+}
+
+/*
+ * ptw32_wait_on_address()
+ *
+ * If the LONG at 'address' equals 'expected', block until woken by
+ * ptw32_wake_address() on the same address, the timeout expires or,
+ * if 'cancelable', a cancellation request is pending. May return 0
+ * without having been woken; callers recheck the value.
+ *
+ * Returns 0, ETIMEDOUT, EINTR (cancellation pending, act on it with
+ * pthread_testcancel()), ENOSPC (no park event) or EINVAL.
+ * A thread that is woken as it times out or sees a cancellation
+ * request returns 0 so that the wakeup isn't lost.
+ */
+int
+ptw32_wait_on_address (volatile LONG * address, LONG expected,
+                       DWORD milliseconds, int cancelable)
+{
+  ptw32_wait_bucket_t * b = PTW32_WAIT_BUCKET (address);
+  ptw32_wait_node_t self;
+  ptw32_mcs_local_node_t node;
+  int result;
+
+  if ((self.thread = ptw32_park_self ()) == NULL)
+    {
+      return ENOSPC;
+    }
+
+  self.address = address;
+  self.woken = 0;
+  self.next = NULL;
+
+  ptw32_mcs_lock_acquire (&b->lock, &node);
+
+  self.prev = b->tail;
+  if (b->tail == NULL)
+    {
+      b->head = &self;
+    }
+  else
+    {
+      b->tail->next = &self;
+    }
+  b->tail = &self;
+
+  /*
+   * Read the value only after queueing (see the notes above).
+   */
+  if ((LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) address,
+                                                  (PTW32_INTERLOCKED_LONG) 0) != expected)
+    {
+      ptw32_wait_unlink (b, &self);
+      ptw32_mcs_lock_release (&node);
+      return 0;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  result = ptw32_park (self.thread, milliseconds, cancelable);
+
+  if (0 == (LONG) PTW32_INTERLOCKED_EXCHANGE_ADD_LONG ((PTW32_INTERLOCKED_LONGPTR) &self.woken,
+                                                       (PTW32_INTERLOCKED_LONG) 0))
+    {
+      ptw32_mcs_lock_acquire (&b->lock, &node);
+
+      if (self.woken)
+        {
+          /* Woken as we gave up */
+          result = 0;
+        }
+      else
+        {
+          ptw32_wait_unlink (b, &self);
+        }
+
+      ptw32_mcs_lock_release (&node);
+    }
+  else
+    {
+      result = 0;
+    }
+
+  return result;
+}
+
+/*
+ * ptw32_wake_address()
+ *
+ * Wake up to 'count' threads waiting in ptw32_wait_on_address() on
+ * 'address', longest waiting first. The caller changes the value at
+ * 'address' before calling this. Returns the number woken.
+ */
+int
+ptw32_wake_address (volatile LONG * address, int count)
+{
+  ptw32_wait_bucket_t * b = PTW32_WAIT_BUCKET (address);
+  ptw32_wait_node_t * w;
+  ptw32_wait_node_t * next;
+  ptw32_thread_t * sp;
+  ptw32_mcs_local_node_t node;
+  int woken = 0;
+
+  /*
+   * The caller's change to *address may have been only a release, which
+   * a later load can pass. A waiter links itself in and then reads
+   * *address, so both sides must be ordered or each can miss the other.
+   */
+  PTW32_ATOMIC_THREAD_FENCE ();
+
+  if (count <= 0
+      || NULL == (ptw32_wait_node_t *) PTW32_INTERLOCKED_COMPARE_EXCHANGE_PTR ((PTW32_INTERLOCKED_PVOID_PTR) &b->head,
+                                                                                 (PTW32_INTERLOCKED_PVOID) NULL,
+                                                                                 (PTW32_INTERLOCKED_PVOID) NULL))
+    {
+      return 0;
+    }
+
+  ptw32_mcs_lock_acquire (&b->lock, &node);
+
+  for (w = b->head; w != NULL && woken < count; w = next)
+    {
+      next = w->next;
+
+      if (w->address == address)
+        {
+          ptw32_wait_unlink (b, w);
+          sp = w->thread;
+          /*
+           * The waiter may return, and 'w' go with it, as soon as
+           * 'woken' is set.
+           */
+          (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &w->woken,
+                                                  (PTW32_INTERLOCKED_LONG) 1);
+          ptw32_unpark (sp);
+          woken++;
+        }
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return woken;
+}
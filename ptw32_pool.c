@@ -0,0 +1,736 @@
+/*
+ * ptw32_pool.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Notes on thread pools.
+ * ----------------------
+ *
+ * Each worker owns a Chase-Lev deque: an array of tasks indexed by two
+ * counters, 'top' and 'bottom'. Only the owner pushes and pops, at the
+ * bottom, without any Interlocked operation except when it takes the
+ * last task. Other workers steal from the top with one Interlocked
+ * compare-and-swap. A task submitted by a worker goes on its own deque,
+ * so a task that spawns subtasks keeps them local until some other
+ * worker runs out of work and steals.
+ *
+ * Tasks submitted from threads outside the pool go on a shared ring
+ * guarded by an MCS lock. A worker that finds its deque empty takes up
+ * to PTW32_POOL_INJECT_BATCH tasks from the ring at once, runs one and
+ * pushes the rest onto its deque, where others can steal them.
+ *
+ * When a deque fills, its owner copies it into an array twice the size.
+ * A thief may still be reading the old array, so old arrays are kept,
+ * linked from the new one, until the pool is destroyed.
+ *
+ * A worker with nothing to do sleeps on the pool's event count, after
+ * announcing the wait and looking for work once more. Each submit
+ * notifies it, waking one sleeping worker per task; while all workers
+ * are busy this is a fence and a load. If nobody was asleep and the
+ * pool is below maxThreads, the submitting thread starts a new worker.
+ * Workers above minThreads exit after PTW32_POOL_IDLE_MSECS without
+ * work.
+ *
+ * Workers are ordinary threads, created with pthread_create() and the
+ * pool's attributes. They are stopped with pthread_cancel(): waiting
+ * for work is a cancellation point, and once the pool is shutting down
+ * so is the gap between tasks. A task may call pthread_testcancel()
+ * (or any other cancellation point) to stop early during shutdown.
+ *
+ * The counters wrap around; they are only ever compared by difference.
+ */
+
+#define PTW32_POOL_DIFF(a, b) ((LONG) ((ULONG) (a) - (ULONG) (b)))
+#define PTW32_POOL_NEXT(a) ((LONG) ((ULONG) (a) + 1))
+#define PTW32_POOL_SLOT(array, i) (&(array)->tasks[(ULONG) (i) & (ULONG) (array)->mask])
+
+
+/*
+ * ptw32_pool_self()
+ *
+ * Return the calling thread's worker if it is a worker of 'pool',
+ * otherwise NULL.
+ */
+ptw32_pool_worker_t *
+ptw32_pool_self (pthread_pool_t pool)
+{
+  ptw32_thread_t * sp = (ptw32_thread_t *) pthread_getspecific (ptw32_selfThreadKey);
+
+  if (sp != NULL && sp->poolWorker != NULL && sp->poolWorker->pool == pool)
+    {
+      return sp->poolWorker;
+    }
+
+  return NULL;
+}
+
+/*
+ * ptw32_pool_grow()
+ *
+ * Replace the deque's array with one twice the size (or the initial
+ * size if it has none) holding the tasks from 't' to 'b'. Called by
+ * the owner only.
+ */
+static ptw32_pool_array_t *
+ptw32_pool_grow (ptw32_pool_worker_t * w, LONG b, LONG t)
+{
+  ptw32_pool_array_t * old = w->array;
+  ptw32_pool_array_t * a;
+  LONG size = (old == NULL) ? PTW32_POOL_DEQUE_SIZE : 2 * (old->mask + 1);
+  LONG i;
+
+  a = (ptw32_pool_array_t *) malloc (sizeof (*a) + (size - 1) * sizeof (ptw32_pool_task_t));
+
+  if (a == NULL)
+    {
+      return NULL;
+    }
+
+  a->mask = size - 1;
+  a->retired = old;
+
+  for (i = t; i != b; i = PTW32_POOL_NEXT (i))
+    {
+      *PTW32_POOL_SLOT (a, i) = *PTW32_POOL_SLOT (old, i);
+    }
+
+  /*
+   * Thieves must see the copied tasks before the new array.
+   */
+  PTW32_COMPILER_BARRIER ();
+  w->array = a;
+
+  return a;
+}
+
+/*
+ * ptw32_pool_reserve()
+ *
+ * Make room in the calling worker's own deque for 'count' more tasks,
+ * so that that many pushes can't fail. Returns 0 or ENOMEM.
+ */
+int
+ptw32_pool_reserve (ptw32_pool_worker_t * w, LONG count)
+{
+  LONG b = w->bottom;
+  LONG t;
+
+  /*
+   * Thieves only ever make more room.
+   */
+  for (;;)
+    {
+      t = w->top;
+
+      if (w->array != NULL && PTW32_POOL_DIFF (b, t) + count <= w->array->mask)
+        {
+          return 0;
+        }
+
+      if (NULL == ptw32_pool_grow (w, b, t))
+        {
+          return ENOMEM;
+        }
+    }
+}
+
+/*
+ * ptw32_pool_push()
+ *
+ * Push a task onto the bottom of the calling worker's own deque.
+ * Returns 0 or ENOMEM.
+ */
+int
+ptw32_pool_push (ptw32_pool_worker_t * w, const ptw32_pool_task_t * task)
+{
+  LONG b = w->bottom;
+
+  if (0 != ptw32_pool_reserve (w, 1))
+    {
+      return ENOMEM;
+    }
+
+  *PTW32_POOL_SLOT (w->array, b) = *task;
+
+  /*
+   * Thieves must see the task before the new bottom.
+   */
+  PTW32_COMPILER_BARRIER ();
+  w->bottom = PTW32_POOL_NEXT (b);
+
+  return 0;
+}
+
+/*
+ * ptw32_pool_pop()
+ *
+ * Pop a task from the bottom of the calling worker's own deque.
+ * Returns 1 if it got one.
+ */
+static int
+ptw32_pool_pop (ptw32_pool_worker_t * w, ptw32_pool_task_t * task)
+{
+  LONG b = (LONG) ((ULONG) w->bottom - 1);
+  LONG t;
+  LONG n;
+  int result;
+
+  /*
+   * Claim the bottom task before looking at 'top'. The exchange is a
+   * full fence so that a thief reading 'bottom' after this sees the
+   * claim, or we see its steal.
+   */
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &w->bottom,
+                                          (PTW32_INTERLOCKED_LONG) b);
+  t = w->top;
+  n = PTW32_POOL_DIFF (b, t);
+
+  if (n < 0)
+    {
+      w->bottom = t;
+      return 0;
+    }
+
+  *task = *PTW32_POOL_SLOT (w->array, b);
+
+  if (n > 0)
+    {
+      return 1;
+    }
+
+  /*
+   * The last task: a thief may be taking it too.
+   */
+  result = (t == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &w->top,
+                                                                 (PTW32_INTERLOCKED_LONG) PTW32_POOL_NEXT (t),
+                                                                 (PTW32_INTERLOCKED_LONG) t));
+  w->bottom = PTW32_POOL_NEXT (t);
+
+  return result;
+}
+
+/*
+ * ptw32_pool_steal()
+ *
+ * Take a task from the top of another worker's deque. Returns 1 if it
+ * got one, 0 if the deque was empty and -1 if another thread took the
+ * task first.
+ */
+static int
+ptw32_pool_steal (ptw32_pool_worker_t * v, ptw32_pool_task_t * task)
+{
+  LONG t = v->top;
+  LONG b;
+
+  PTW32_COMPILER_BARRIER ();
+  b = v->bottom;
+
+  if (PTW32_POOL_DIFF (b, t) <= 0)
+    {
+      return 0;
+    }
+
+  /*
+   * The array must be read after 'bottom' so that it holds every task
+   * below it.
+   */
+  PTW32_COMPILER_BARRIER ();
+  *task = *PTW32_POOL_SLOT (v->array, t);
+
+  if (t != (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &v->top,
+                                                           (PTW32_INTERLOCKED_LONG) PTW32_POOL_NEXT (t),
+                                                           (PTW32_INTERLOCKED_LONG) t))
+    {
+      return -1;
+    }
+
+  return 1;
+}
+
+/*
+ * ptw32_pool_inject()
+ *
+ * Append tasks to the pool's shared queue. Returns 0 or ENOMEM.
+ */
+int
+ptw32_pool_inject (pthread_pool_t pool, const ptw32_pool_task_t * tasks, int count)
+{
+  ptw32_mcs_local_node_t node;
+  ptw32_pool_task_t * ring;
+  LONG n;
+  LONG size;
+  LONG i;
+  int result = 0;
+
+  ptw32_mcs_lock_acquire (&pool->injectLock, &node);
+
+  n = pool->injected;
+
+  if (n + count > pool->injectSize)
+    {
+      for (size = (pool->injectSize == 0) ? PTW32_POOL_DEQUE_SIZE : pool->injectSize;
+           size < n + count;
+           size *= 2)
+        {
+        }
+
+      if (NULL == (ring = (ptw32_pool_task_t *) malloc (size * sizeof (ptw32_pool_task_t))))
+        {
+          result = ENOMEM;
+          goto FAIL0;
+        }
+
+      for (i = 0; i < n; i++)
+        {
+          ring[i] = pool->inject[(pool->injectHead + i) & (pool->injectSize - 1)];
+        }
+
+      free (pool->inject);
+      pool->inject = ring;
+      pool->injectHead = 0;
+      pool->injectSize = size;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      pool->inject[(pool->injectHead + n + i) & (pool->injectSize - 1)] = tasks[i];
+    }
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &pool->injected,
+                                          (PTW32_INTERLOCKED_LONG) (n + count));
+
+FAIL0:
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+/*
+ * ptw32_pool_take()
+ *
+ * Take a task from the shared queue, moving up to
+ * PTW32_POOL_INJECT_BATCH - 1 more onto the worker's deque. Returns 1
+ * if it got one.
+ */
+static int
+ptw32_pool_take (pthread_pool_t pool, ptw32_pool_worker_t * w, ptw32_pool_task_t * task)
+{
+  ptw32_mcs_local_node_t node;
+  LONG n;
+  int moved;
+  int result = 0;
+
+  if (pool->injected == 0)
+    {
+      return 0;
+    }
+
+  ptw32_mcs_lock_acquire (&pool->injectLock, &node);
+
+  if ((n = pool->injected) > 0)
+    {
+      *task = pool->inject[pool->injectHead];
+      pool->injectHead = (pool->injectHead + 1) & (pool->injectSize - 1);
+      n--;
+
+      for (moved = 1; moved < PTW32_POOL_INJECT_BATCH && n > 0; moved++)
+        {
+          if (0 != ptw32_pool_push (w, &pool->inject[pool->injectHead]))
+            {
+              break;
+            }
+          pool->injectHead = (pool->injectHead + 1) & (pool->injectSize - 1);
+          n--;
+        }
+
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &pool->injected,
+                                              (PTW32_INTERLOCKED_LONG) n);
+      result = 1;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+/*
+ * ptw32_pool_find()
+ *
+ * Find a task for worker 'w': from its own deque, then the shared
+ * queue, then by stealing. Returns 1 if it found one.
+ */
+static int
+ptw32_pool_find (pthread_pool_t pool, ptw32_pool_worker_t * w, ptw32_pool_task_t * task)
+{
+  int n = pool->maxThreads;
+  int start;
+  int i;
+  int result;
+
+  if (ptw32_pool_pop (w, task) || ptw32_pool_take (pool, w, task))
+    {
+      return 1;
+    }
+
+  /*
+   * Start at a pseudo-random victim so that thieves spread out.
+   */
+  w->seed = w->seed * 1103515245 + 12345;
+  start = (int) ((w->seed >> 16) % (unsigned int) n);
+
+  for (i = 0; i < n; i++)
+    {
+      ptw32_pool_worker_t * v = &pool->workers[(start + i) % n];
+
+      if (v == w)
+        {
+          continue;
+        }
+
+      while ((result = ptw32_pool_steal (v, task)) < 0)
+        {
+        }
+
+      if (result > 0)
+        {
+          return 1;
+        }
+    }
+
+  return 0;
+}
+
+/*
+ * ptw32_pool_run()
+ *
+ * Run a task and account for it.
+ */
+static void
+ptw32_pool_run (pthread_pool_t pool, ptw32_pool_task_t * task)
+{
+  (*task->routine) (task->arg);
+
+  if (0 == PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &pool->pending))
+    {
+      (void) ptw32_eventcount_notify (pool->idle, INT_MAX);
+    }
+}
+
+/*
+ * ptw32_pool_worker()
+ *
+ * The thread routine of every worker.
+ */
+static void * PTW32_CDECL
+ptw32_pool_worker (void * arg)
+{
+  ptw32_pool_worker_t * w = (ptw32_pool_worker_t *) arg;
+  pthread_pool_t pool = w->pool;
+  ptw32_pool_task_t task;
+  unsigned int key;
+  LONG n;
+  int stay;
+
+  ((ptw32_thread_t *) pthread_self ().p)->poolWorker = w;
+
+  for (;;)
+    {
+      if (pool->shutdown)
+        {
+          pthread_testcancel ();
+        }
+
+      if (ptw32_pool_find (pool, w, &task))
+        {
+          ptw32_pool_run (pool, &task);
+          continue;
+        }
+
+      (void) pthread_eventcount_prepare_wait_np (&pool->wakeup, &key);
+
+      if (ptw32_pool_find (pool, w, &task))
+        {
+          (void) pthread_eventcount_cancel_wait_np (&pool->wakeup);
+          ptw32_pool_run (pool, &task);
+          continue;
+        }
+
+      switch (ptw32_eventcount_wait (pool->wakeup, key,
+                                     (pool->nThreads > pool->minThreads) ? PTW32_POOL_IDLE_MSECS : INFINITE,
+                                     PTW32_TRUE))
+        {
+        case EINTR:
+          pthread_testcancel ();
+          break;
+
+        case ETIMEDOUT:
+          n = pool->nThreads;
+          if (n > pool->minThreads
+              && n == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &pool->nThreads,
+                                                                     (PTW32_INTERLOCKED_LONG) (n - 1),
+                                                                     (PTW32_INTERLOCKED_LONG) n))
+            {
+              /*
+               * A submitter that saw us waiting, or saw the pool full,
+               * won't start another worker, so look once more now that
+               * we are neither.
+               */
+              if (ptw32_pool_find (pool, w, &task))
+                {
+                  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &pool->nThreads);
+                  ptw32_pool_run (pool, &task);
+                  break;
+                }
+
+              (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &w->state,
+                                                      (PTW32_INTERLOCKED_LONG) PTW32_POOL_WORKER_RETIRED);
+
+              /*
+               * A task submitted since that last look found nobody
+               * waiting and, while our slot was still RUNNING, perhaps
+               * no slot to start a worker in. Unless a submitter has
+               * taken the slot since, and so is starting a worker
+               * that will run the task, take it back and stay.
+               */
+              if (pool->injected != 0
+                  && PTW32_POOL_WORKER_RETIRED == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &w->state,
+                                                                                                (PTW32_INTERLOCKED_LONG) PTW32_POOL_WORKER_RUNNING,
+                                                                                                (PTW32_INTERLOCKED_LONG) PTW32_POOL_WORKER_RETIRED))
+                {
+                  /*
+                   * If pool->shutdown is set after this test then
+                   * ptw32_pool_free() sees us RUNNING and cancels us.
+                   */
+                  stay = PTW32_FALSE;
+                  while (!stay && !pool->shutdown && (n = pool->nThreads) < pool->maxThreads)
+                    {
+                      stay = (n == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &pool->nThreads,
+                                                                                  (PTW32_INTERLOCKED_LONG) (n + 1),
+                                                                                  (PTW32_INTERLOCKED_LONG) n));
+                    }
+
+                  if (stay)
+                    {
+                      break;
+                    }
+
+                  /*
+                   * Shutting down, or the pool has filled up again and
+                   * the other workers will run the task.
+                   */
+                  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &w->state,
+                                                          (PTW32_INTERLOCKED_LONG) PTW32_POOL_WORKER_RETIRED);
+                }
+              return NULL;
+            }
+          break;
+        }
+    }
+
+  return NULL;
+}
+
+/*
+ * ptw32_pool_spawn()
+ *
+ * Start a worker in a free slot if the pool has fewer than maxThreads.
+ * Returns 0, EAGAIN or an error from pthread_create().
+ */
+int
+ptw32_pool_spawn (pthread_pool_t pool)
+{
+  ptw32_pool_worker_t * w;
+  LONG n;
+  LONG state;
+  int i;
+  int result = EAGAIN;
+
+  do
+    {
+      if ((n = pool->nThreads) >= pool->maxThreads)
+        {
+          return EAGAIN;
+        }
+    }
+  while (n != (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &pool->nThreads,
+                                                              (PTW32_INTERLOCKED_LONG) (n + 1),
+                                                              (PTW32_INTERLOCKED_LONG) n));
+
+  if (pool->shutdown)
+    {
+      (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &pool->nThreads);
+      return EAGAIN;
+    }
+
+  for (i = 0; i < pool->maxThreads; i++)
+    {
+      w = &pool->workers[i];
+      state = w->state;
+
+      if ((state == PTW32_POOL_WORKER_FREE || state == PTW32_POOL_WORKER_RETIRED)
+          && state == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &w->state,
+                                                                     (PTW32_INTERLOCKED_LONG) PTW32_POOL_WORKER_STARTING,
+                                                                     (PTW32_INTERLOCKED_LONG) state))
+        {
+          if (state == PTW32_POOL_WORKER_RETIRED)
+            {
+              (void) pthread_join (w->thread, NULL);
+            }
+
+          if (0 == (result = pthread_create (&w->thread, &pool->attr, ptw32_pool_worker, w)))
+            {
+              /*
+               * The worker may already have retired.
+               */
+              (void) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &w->state,
+                                                              (PTW32_INTERLOCKED_LONG) PTW32_POOL_WORKER_RUNNING,
+                                                              (PTW32_INTERLOCKED_LONG) PTW32_POOL_WORKER_STARTING);
+
+              /*
+               * ptw32_pool_free() only cancels RUNNING workers; if it
+               * saw this one STARTING, cancel it here.
+               */
+              if (pool->shutdown)
+                {
+                  (void) pthread_cancel (w->thread);
+                }
+              return 0;
+            }
+
+          (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &w->state,
+                                                  (PTW32_INTERLOCKED_LONG) PTW32_POOL_WORKER_FREE);
+          break;
+        }
+    }
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &pool->nThreads);
+
+  return result;
+}
+
+/*
+ * ptw32_pool_wake()
+ *
+ * Wake up to 'count' sleeping workers for newly submitted tasks. If
+ * fewer were asleep, start new workers while the pool is below
+ * maxThreads.
+ */
+void
+ptw32_pool_wake (pthread_pool_t pool, int count)
+{
+  int woken = ptw32_eventcount_notify (pool->wakeup, count);
+
+  while (woken < count
+         && pool->nThreads < pool->maxThreads
+         && 0 == ptw32_pool_spawn (pool))
+    {
+      woken++;
+    }
+}
+
+/*
+ * ptw32_pool_free()
+ *
+ * Cancel and join any workers, then free the pool. Tasks not yet run
+ * are discarded.
+ */
+void
+ptw32_pool_free (pthread_pool_t pool)
+{
+  ptw32_pool_worker_t * w;
+  ptw32_pool_array_t * a;
+  ptw32_pool_array_t * next;
+  int i;
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &pool->shutdown,
+                                          (PTW32_INTERLOCKED_LONG) 1);
+
+  for (i = 0; i < pool->maxThreads; i++)
+    {
+      if (pool->workers[i].state == PTW32_POOL_WORKER_RUNNING)
+        {
+          (void) pthread_cancel (pool->workers[i].thread);
+        }
+    }
+
+  for (i = 0; i < pool->maxThreads; i++)
+    {
+      w = &pool->workers[i];
+
+      /*
+       * Wait for a worker being started to get its thread handle.
+       */
+      while (w->state == PTW32_POOL_WORKER_STARTING)
+        {
+          Sleep (0);
+        }
+
+      if (w->state != PTW32_POOL_WORKER_FREE)
+        {
+          (void) pthread_join (w->thread, NULL);
+        }
+
+      for (a = w->array; a != NULL; a = next)
+        {
+          next = a->retired;
+          free (a);
+        }
+    }
+
+  if (pool->wakeup != NULL)
+    {
+      (void) pthread_eventcount_destroy_np (&pool->wakeup);
+    }
+
+  if (pool->idle != NULL)
+    {
+      (void) pthread_eventcount_destroy_np (&pool->idle);
+    }
+
+  (void) pthread_attr_destroy (&pool->attr);
+  free (pool->inject);
+  free (pool->workers);
+  free (pool);
+}
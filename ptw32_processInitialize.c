@@ -68,6 +68,8 @@ ptw32_processInitialize (void)
       * ------------------------------------------------------
       */
 {
+  int i;
+
   if (ptw32_processInitialized)
     {
       return PTW32_TRUE;
@@ -79,9 +81,6 @@ ptw32_processInitialize (void)
   ptw32_threadReuseTop = PTW32_THREAD_REUSE_EMPTY;
   ptw32_threadReuseBottom = PTW32_THREAD_REUSE_EMPTY;
   ptw32_selfThreadKey = NULL;
-  ptw32_cleanupKey = NULL;
-  ptw32_cond_list_head = NULL;
-  ptw32_cond_list_tail = NULL;
 
   ptw32_concurrency = 0;
 
@@ -100,6 +99,11 @@ ptw32_processInitialize (void)
    */
   ptw32_register_cancellation = NULL;
 
+  /*
+   * Function pointer to GetCurrentProcessorNumber if the system has it.
+   */
+  ptw32_get_processor_number = NULL;
+
   /*
    * Global lock for managing pthread_t struct reuse.
    */
@@ -129,11 +133,35 @@ ptw32_processInitialize (void)
   ptw32_spinlock_test_init_lock = 0;
 
   /*
-   * Global lock for condition variable linked list. The list exists
+   * Lists of condition variables with timed waiters. They exist
    * to wake up CVs when a WM_TIMECHANGE message arrives. See
-   * w32_TimeChangeHandler.c.
+   * pthread_timechange_handler_np.c.
+   */
+  for (i = 0; i < PTW32_COND_SHARDS; i++)
+    {
+      ptw32_cond_shards[i].lock = 0;
+      ptw32_cond_shards[i].head = NULL;
+    }
+
+  /*
+   * Address-keyed wait table. See ptw32_park.c.
+   */
+  for (i = 0; i < PTW32_WAIT_TABLE_SIZE; i++)
+    {
+      ptw32_wait_table[i].lock = 0;
+      ptw32_wait_table[i].head = NULL;
+      ptw32_wait_table[i].tail = NULL;
+    }
+
+  /*
+   * Lock profiler registry and settings. Profiling may be
+   * requested through the environment.
    */
-  ptw32_cond_list_lock = 0;
+  ptw32_lockprof_enabled = PTW32_FALSE;
+  ptw32_lockprof_sample = 0;
+  ptw32_lockprof_list_head = NULL;
+  ptw32_lockprof_list_lock = 0;
+  ptw32_lockprof_initialize ();
 
   #if defined(_UWIN)
   /*
@@ -147,8 +175,7 @@ ptw32_processInitialize (void)
   /*
    * Initialize Keys
    */
-  if ((pthread_key_create (&ptw32_selfThreadKey, NULL) != 0) ||
-      (pthread_key_create (&ptw32_cleanupKey, NULL) != 0))
+  if (pthread_key_create (&ptw32_selfThreadKey, NULL) != 0)
     {
 
       ptw32_processTerminate ();
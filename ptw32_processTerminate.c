@@ -82,15 +82,18 @@ ptw32_processTerminate (void)
 	  ptw32_selfThreadKey = NULL;
 	}
 
-      if (ptw32_cleanupKey != NULL)
-	{
-	  /*
-	   * Release ptw32_cleanupKey
-	   */
-	  pthread_key_delete (ptw32_cleanupKey);
+      /*
+       * Write any lock profile requested through the environment.
+       */
+      ptw32_lockprof_terminate ();
 
-	  ptw32_cleanupKey = NULL;
-	}
+      /*
+       * The parallel loop team is left asleep rather than destroyed:
+       * joining its workers here could deadlock on the loader lock.
+       * Forget it so that a later attach creates a new one.
+       */
+      ptw32_parallel_team = NULL;
+      ptw32_parallel_team_size = -1;
 
       ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
 
@@ -98,6 +101,14 @@ ptw32_processTerminate (void)
       while (tp != PTW32_THREAD_REUSE_EMPTY)
 	{
 	  tpNext = tp->prevReuse;
+	  if (tp->parkEvent != NULL)
+	    {
+	      CloseHandle (tp->parkEvent);
+	    }
+	  if (tp->delayTimer != NULL)
+	    {
+	      CloseHandle (tp->delayTimer);
+	    }
 	  free (tp);
 	  tp = tpNext;
 	}
@@ -115,23 +115,39 @@ ptw32_threadReusePop (void)
  * Push a clean pthread_t struct onto the reuse stack.
  * Must be re-initialised when reused.
  * All object elements (mutexes, events etc) must have been either
- * destroyed before this, or never initialised.
+ * destroyed before this, or never initialised, except the park event
+ * and delay timer.
  */
 void
 ptw32_threadReusePush (pthread_t thread)
 {
   ptw32_thread_t * tp = (ptw32_thread_t *) thread.p;
   pthread_t t;
+  HANDLE parkEvent;
+  HANDLE delayTimer;
   ptw32_mcs_local_node_t node;
 
   ptw32_mcs_lock_acquire(&ptw32_thread_reuse_lock, &node);
 
   t = tp->ptHandle;
+  parkEvent = tp->parkEvent;
+  delayTimer = tp->delayTimer;
   memset(tp, 0, sizeof(ptw32_thread_t));
 
   /* Must restore the original POSIX handle that we just wiped. */
   tp->ptHandle = t;
 
+  /*
+   * A late unpark may still set the park event, so it stays with
+   * the struct. See ptw32_park.c.
+   */
+  tp->parkEvent = parkEvent;
+
+  /*
+   * The delay timer is kept to save creating another.
+   */
+  tp->delayTimer = delayTimer;
+
   /* Bump the reuse counter now */
 #if defined(PTW32_THREAD_ID_REUSE_INCREMENT)
   tp->ptHandle.x += PTW32_THREAD_ID_REUSE_INCREMENT;
@@ -0,0 +1,541 @@
+/*
+ * ptw32_rwlock_bigreader.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Notes on PTHREAD_RWLOCK_BIGREADER_NP.
+ * -------------------------------------
+ *
+ * With the default kind every reader takes and releases two mutexes, so
+ * all readers write to the same few cache lines and read throughput
+ * stops scaling after a couple of processors.
+ *
+ * A big-reader rwlock gives each processor its own reader count (slot),
+ * each on its own cache line. A reader increments the count for the
+ * processor it is running on and then checks writerActive; if no writer
+ * is about it owns the lock. Unlock just decrements a count. Neither
+ * touches any line that a reader on another processor writes.
+ *
+ * A writer takes mtxExclusiveAccess (which serialises writers), sets
+ * writerActive and then sums all slots until the total is zero. Readers
+ * that see writerActive back out of their slot and block on
+ * mtxExclusiveAccess until the writer has finished, so writers are
+ * favoured exactly as with the default kind. Readers leaving while
+ * writerActive is set signal the 'drained' event so that the writer can
+ * sleep instead of spinning.
+ *
+ * Only the sum over all slots is meaningful: a reader may be moved to
+ * another processor between lock and unlock and decrement a different
+ * slot than it incremented. Once writerActive is set no reader can
+ * enter, so counts only fall (other than the brief increment of a reader
+ * that is about to back out) and a sweep that sums to zero can't be
+ * wrong.
+ *
+ * The slot is chosen with GetCurrentProcessorNumber(). Readers that
+ * can't be attributed to a processor this way - older systems without
+ * the call, or a processor number beyond the slot count because the
+ * process affinity mask is sparse - are folded into the slots by
+ * hashing, which costs only some sharing.
+ *
+ * Writers pay for all this: every write lock sweeps nSlots cache lines
+ * that other processors own.
+ */
+
+
+static ptw32_rwlock_slot_t *
+ptw32_rwlock_bigreader_slot (pthread_rwlock_t rwl)
+{
+  DWORD n;
+
+  if (ptw32_get_processor_number != NULL)
+    {
+      n = ptw32_get_processor_number ();
+    }
+  else
+    {
+      n = GetCurrentThreadId () >> 2;
+    }
+
+  return &rwl->slots[n & (rwl->nSlots - 1)];
+}
+
+
+static LONG
+ptw32_rwlock_bigreader_count (pthread_rwlock_t rwl)
+{
+  LONG readers = 0;
+  int i;
+
+  for (i = 0; i < rwl->nSlots; i++)
+    {
+      readers += rwl->slots[i].readers;
+    }
+
+  return readers;
+}
+
+
+static void
+ptw32_rwlock_bigreader_cancelwrwait (void * arg)
+{
+  pthread_rwlock_t rwl = (pthread_rwlock_t) arg;
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->writerActive,
+                                          (PTW32_INTERLOCKED_LONG) 0);
+  (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+}
+
+
+int
+ptw32_rwlock_bigreader_init (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Allocate the reader slots of a new
+      *      PTHREAD_RWLOCK_BIGREADER_NP rwlock: one per processor
+      *      available to the process, rounded up to a power of 2.
+      *
+      * RESULTS
+      *              0               success,
+      *              ENOMEM          insufficient memory.
+      *
+      * ------------------------------------------------------
+      */
+{
+  int cpus;
+  int n = 1;
+
+  if (ptw32_getprocessors (&cpus) != 0)
+    {
+      cpus = 1;
+    }
+
+  while (n < cpus && n < PTW32_RWLOCK_MAX_SLOTS)
+    {
+      n <<= 1;
+    }
+
+  rwl->slots = (ptw32_rwlock_slot_t *) calloc (n, sizeof (ptw32_rwlock_slot_t));
+
+  if (rwl->slots == NULL)
+    {
+      return ENOMEM;
+    }
+
+  /*
+   * Created by the first writer. See ptw32_lazy_handle.c.
+   */
+  rwl->drained = NULL;
+  rwl->nSlots = n;
+  rwl->writerActive = 0;
+
+  return 0;
+}
+
+
+void
+ptw32_rwlock_bigreader_destroy (pthread_rwlock_t rwl)
+{
+  if (rwl->drained != NULL)
+    {
+      (void) CloseHandle (rwl->drained);
+    }
+  free (rwl->slots);
+  rwl->slots = NULL;
+}
+
+
+int
+ptw32_rwlock_bigreader_busy (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Called by pthread_rwlock_destroy() with
+      *      mtxExclusiveAccess held. Returns non-zero if any
+      *      readers hold the lock. Otherwise leaves writerActive
+      *      set so that no reader can get in before the lock
+      *      is gone.
+      *
+      * ------------------------------------------------------
+      */
+{
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->writerActive,
+                                          (PTW32_INTERLOCKED_LONG) 1);
+
+  if (ptw32_rwlock_bigreader_count (rwl) != 0)
+    {
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->writerActive,
+                                              (PTW32_INTERLOCKED_LONG) 0);
+      return PTW32_TRUE;
+    }
+
+  return PTW32_FALSE;
+}
+
+
+int
+ptw32_rwlock_bigreader_rdlock (pthread_rwlock_t rwl,
+                               const struct timespec * abstime,
+                               int trylock)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      pthread_rwlock_[try|timed]rdlock() for
+      *      PTHREAD_RWLOCK_BIGREADER_NP rwlocks.
+      *
+      * PARAMETERS
+      *      rwl
+      *              the rwlock
+      *
+      *      abstime
+      *              absolute timeout or NULL to wait forever
+      *
+      *      trylock
+      *              non-zero to return EBUSY rather than wait
+      *              for a writer
+      *
+      * RESULTS
+      *              0               the caller holds a read lock,
+      *              EBUSY           trylock and a writer is active,
+      *              ETIMEDOUT       abstime passed,
+      *              other           from pthread_mutex_[timed]lock().
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_rwlock_slot_t * slot;
+  int result;
+
+  for (;;)
+    {
+      slot = ptw32_rwlock_bigreader_slot (rwl);
+
+      /*
+       * The interlocked increment is a full barrier so the writer either
+       * sees our count or we see writerActive.
+       */
+      (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->readers);
+
+      if (0 == rwl->writerActive)
+        {
+          return 0;
+        }
+
+      /*
+       * Back out. The writer may have counted us, so wake it.
+       */
+      (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->readers);
+      (void) SetEvent (rwl->drained);
+
+      if (trylock)
+        {
+          return EBUSY;
+        }
+
+      /*
+       * Wait for the writer to finish. It holds mtxExclusiveAccess for
+       * as long as writerActive is set.
+       */
+      if (abstime == NULL)
+        {
+          result = pthread_mutex_lock (&(rwl->mtxExclusiveAccess));
+        }
+      else
+        {
+          result = pthread_mutex_timedlock (&(rwl->mtxExclusiveAccess), abstime);
+        }
+
+      if (result != 0)
+        {
+          return result;
+        }
+
+      (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+    }
+}
+
+
+int
+ptw32_rwlock_bigreader_wrlock (pthread_rwlock_t rwl,
+                               const struct timespec * abstime,
+                               int trylock)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      pthread_rwlock_[try|timed]wrlock() for
+      *      PTHREAD_RWLOCK_BIGREADER_NP rwlocks.
+      *
+      * PARAMETERS
+      *      rwl
+      *              the rwlock
+      *
+      *      abstime
+      *              absolute timeout or NULL to wait forever
+      *
+      *      trylock
+      *              non-zero to return EBUSY rather than wait
+      *
+      * RESULTS
+      *              0               the caller holds the write lock,
+      *              EBUSY           trylock and the lock is held,
+      *              ETIMEDOUT       abstime passed,
+      *              other           from pthread_mutex_[timed]lock().
+      *
+      * ------------------------------------------------------
+      */
+{
+  int result;
+
+  if (trylock)
+    {
+      result = pthread_mutex_trylock (&(rwl->mtxExclusiveAccess));
+    }
+  else if (abstime != NULL)
+    {
+      result = pthread_mutex_timedlock (&(rwl->mtxExclusiveAccess), abstime);
+    }
+  else
+    {
+      result = pthread_mutex_lock (&(rwl->mtxExclusiveAccess));
+    }
+
+  if (result != 0)
+    {
+      return result;
+    }
+
+  /*
+   * Readers only signal 'drained' once they see writerActive.
+   */
+  if (rwl->drained == NULL && ptw32_lazy_event (&rwl->drained) == NULL)
+    {
+      (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+      return ENOSPC;
+    }
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->writerActive,
+                                          (PTW32_INTERLOCKED_LONG) 1);
+
+  if (ptw32_rwlock_bigreader_count (rwl) != 0)
+    {
+      if (trylock)
+        {
+          ptw32_rwlock_bigreader_cancelwrwait ((void *) rwl);
+          return EBUSY;
+        }
+
+      /*
+       * This routine may be a cancellation point
+       * according to POSIX 1003.1j section 18.1.2.
+       */
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth(0)
+#endif
+      pthread_cleanup_push (ptw32_rwlock_bigreader_cancelwrwait, (void *) rwl);
+
+      do
+        {
+          result = (abstime == NULL)
+                   ? pthreadCancelableWait (rwl->drained)
+                   : pthreadCancelableTimedWait (rwl->drained,
+                                                 ptw32_relmillisecs (abstime));
+        }
+      while (result == 0 && ptw32_rwlock_bigreader_count (rwl) != 0);
+
+      if (result == ETIMEDOUT && ptw32_rwlock_bigreader_count (rwl) == 0)
+        {
+          result = 0;
+        }
+
+      pthread_cleanup_pop ((result != 0) ? 1 : 0);
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth()
+#endif
+    }
+
+  if (result == 0)
+    {
+      rwl->nExclusiveAccessCount = 1;
+    }
+
+  return result;
+}
+
+
+int
+ptw32_rwlock_bigreader_unlock (pthread_rwlock_t rwl)
+{
+  ptw32_rwlock_slot_t * slot;
+
+  /*
+   * A reader can only get here while no writer holds the lock, and a
+   * writer only sets nExclusiveAccessCount after all readers have gone,
+   * so this test is stable for both.
+   */
+  if (rwl->nExclusiveAccessCount > 0)
+    {
+      rwl->nExclusiveAccessCount = 0;
+      (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->writerActive,
+                                              (PTW32_INTERLOCKED_LONG) 0);
+      return pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+    }
+
+  slot = ptw32_rwlock_bigreader_slot (rwl);
+
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->readers);
+
+  if (rwl->writerActive)
+    {
+      if (SetEvent (rwl->drained) == 0)
+        {
+          return EINVAL;
+        }
+    }
+
+  return 0;
+}
+
+
+int
+ptw32_rwlock_bigreader_upgrade (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      pthread_rwlock_upgrade_np() for
+      *      PTHREAD_RWLOCK_BIGREADER_NP rwlocks. Like wrlock
+      *      except that our own read lock is dropped only once
+      *      mtxExclusiveAccess is ours, so no writer can get in
+      *      first.
+      *
+      * RESULTS
+      *              0               the caller holds the write lock,
+      *              EDEADLK         a writer or another upgrade is
+      *                              waiting for our read lock,
+      *              EPERM           no read lock is held.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_rwlock_slot_t * slot;
+  int result;
+
+  for (;;)
+    {
+      result = pthread_mutex_trylock (&(rwl->mtxExclusiveAccess));
+
+      if (result != EBUSY)
+        {
+          break;
+        }
+
+      /*
+       * Readers only hold the mutex for a moment after a writer
+       * leaves. A writer holds it until it has our read lock too.
+       */
+      if (rwl->writerActive)
+        {
+          return EDEADLK;
+        }
+
+      Sleep (0);
+    }
+
+  if (result != 0)
+    {
+      return result;
+    }
+
+  /*
+   * Readers only signal 'drained' once they see writerActive.
+   */
+  if (rwl->drained == NULL && ptw32_lazy_event (&rwl->drained) == NULL)
+    {
+      (void) pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+      return ENOSPC;
+    }
+
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->writerActive,
+                                          (PTW32_INTERLOCKED_LONG) 1);
+
+  if (ptw32_rwlock_bigreader_count (rwl) == 0)
+    {
+      ptw32_rwlock_bigreader_cancelwrwait ((void *) rwl);
+      return EPERM;
+    }
+
+  slot = ptw32_rwlock_bigreader_slot (rwl);
+  (void) PTW32_INTERLOCKED_DECREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->readers);
+
+  while (ptw32_rwlock_bigreader_count (rwl) != 0)
+    {
+      (void) WaitForSingleObject (rwl->drained, INFINITE);
+    }
+
+  rwl->nExclusiveAccessCount = 1;
+
+  return 0;
+}
+
+
+int
+ptw32_rwlock_bigreader_downgrade (pthread_rwlock_t rwl)
+{
+  ptw32_rwlock_slot_t * slot;
+
+  if (rwl->nExclusiveAccessCount == 0)
+    {
+      return EPERM;
+    }
+
+  /*
+   * Count ourselves as a reader before letting anyone else in.
+   */
+  slot = ptw32_rwlock_bigreader_slot (rwl);
+  (void) PTW32_INTERLOCKED_INCREMENT_LONG ((PTW32_INTERLOCKED_LONGPTR) &slot->readers);
+
+  rwl->nExclusiveAccessCount = 0;
+  (void) PTW32_INTERLOCKED_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->writerActive,
+                                          (PTW32_INTERLOCKED_LONG) 0);
+
+  return pthread_mutex_unlock (&(rwl->mtxExclusiveAccess));
+}
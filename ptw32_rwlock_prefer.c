@@ -0,0 +1,817 @@
+/*
+ * ptw32_rwlock_prefer.c
+ *
+ * Description:
+ * This translation unit implements read/write lock primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <limits.h>
+
+#include "pthread.h"
+#include "implement.h"
+
+/*
+ * Notes on PTHREAD_RWLOCK_PREFER_*_NP.
+ * ------------------------------------
+ *
+ * The default kind builds an rwlock from two mutexes and a condition
+ * variable, and a waiting writer blocks new readers simply by holding
+ * mtxExclusiveAccess. The preference kinds instead keep the whole lock
+ * in one word (state):
+ *
+ *   PTW32_RWLOCK_WRITER    a writer holds the lock,
+ *   PTW32_RWLOCK_WAITING   at least one thread is blocked,
+ *   n * PTW32_RWLOCK_READER  n readers hold the lock.
+ *
+ * While nobody waits, rdlock, wrlock and unlock are a single
+ * compare-and-swap on state. Once a thread has to wait it takes
+ * stateLock, counts itself in nReadersWaiting or nWritersWaiting, sets
+ * WAITING and, after checking state once more, sleeps on readerSema or
+ * writerSema. WAITING makes every unlock and every new arrival take
+ * stateLock as well, and the thread that changes state then decides
+ * who to wake (ptw32_rwlock_prefer_wake()):
+ *
+ *   PTHREAD_RWLOCK_PREFER_READER_NP
+ *     Readers only wait while a writer holds the lock; when it unlocks
+ *     all waiting readers are woken together. A writer waits until there
+ *     are no readers at all, holding or waiting, so a steady stream of
+ *     readers can starve writers.
+ *
+ *   PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP
+ *     New readers wait while any writer is waiting, so writers can't be
+ *     starved. Waiting readers are woken only when no writer is left
+ *     waiting. A thread that already holds a read lock and asks for
+ *     another one deadlocks if a writer has arrived in between.
+ *
+ *   PTHREAD_RWLOCK_PREFER_WRITER_NP
+ *     As above, except that a thread that already holds a read lock on
+ *     a rwlock of this kind is let in ahead of waiting writers, so
+ *     recursive read locks are safe. glibc ignores this kind because it
+ *     doesn't track read lock owners; here each thread counts its read
+ *     locks on rwlocks of this kind (rwlockReadHolds) at the cost of a
+ *     pthread_self() per read lock and unlock. The count isn't per lock,
+ *     so a thread holding a read lock on another PREFER_WRITER rwlock is
+ *     also let in.
+ *
+ * pthread_rwlock_upgrade_np() lets one reader at a time (upgrading)
+ * become the writer without unlocking. It counts as a waiting writer,
+ * so new readers are held back except under PREFER_READER, and is woken
+ * through upgradeEvent when its own read lock is the only one left.
+ * pthread_rwlock_downgrade_np() swaps WRITER for one reader in a single
+ * compare-and-swap.
+ *
+ * Semaphore counts are only ever released for threads that are counted
+ * as waiting and not already signalled, and a woken thread re-examines
+ * state under stateLock, so a wakeup that loses a race to a running
+ * thread simply puts the waiter back to sleep.
+ */
+
+
+static void
+ptw32_rwlock_prefer_setwaiting (pthread_rwlock_t rwl)
+{
+  LONG waiting = (rwl->nReadersWaiting + rwl->nWritersWaiting > 0)
+                 ? PTW32_RWLOCK_WAITING : 0;
+  LONG s;
+
+  for (;;)
+    {
+      s = rwl->state;
+
+      if ((s & PTW32_RWLOCK_WAITING) == waiting
+          || s == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->state,
+                                                                  (PTW32_INTERLOCKED_LONG) ((s & ~PTW32_RWLOCK_WAITING) | waiting),
+                                                                  (PTW32_INTERLOCKED_LONG) s))
+        {
+          break;
+        }
+    }
+}
+
+
+static int
+ptw32_rwlock_prefer_canread (pthread_rwlock_t rwl, LONG s, ptw32_thread_t * sp)
+{
+  if (s & PTW32_RWLOCK_WRITER)
+    {
+      return PTW32_FALSE;
+    }
+
+  if (rwl->nWritersWaiting == 0 || rwl->kind == PTHREAD_RWLOCK_PREFER_READER_NP)
+    {
+      return PTW32_TRUE;
+    }
+
+  return (sp != NULL && sp->rwlockReadHolds > 0);
+}
+
+
+static int
+ptw32_rwlock_prefer_canwrite (pthread_rwlock_t rwl, LONG s)
+{
+  if ((s & ~PTW32_RWLOCK_WAITING) != 0)
+    {
+      return PTW32_FALSE;
+    }
+
+  return (rwl->kind != PTHREAD_RWLOCK_PREFER_READER_NP || rwl->nReadersWaiting == 0);
+}
+
+
+static void
+ptw32_rwlock_prefer_wake (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Called with stateLock held after state or the
+      *      waiter counts have changed. Signals the waiters
+      *      that may now be able to proceed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  LONG s = rwl->state;
+  int n;
+
+  if (s & PTW32_RWLOCK_WRITER)
+    {
+      return;
+    }
+
+  if (rwl->upgrading)
+    {
+      /*
+       * Nobody else can get in until the upgrade is done.
+       */
+      if ((s & ~PTW32_RWLOCK_WAITING) == PTW32_RWLOCK_READER)
+        {
+          (void) SetEvent (rwl->upgradeEvent);
+        }
+      return;
+    }
+
+  if (rwl->nWritersWaiting > 0
+      && rwl->kind != PTHREAD_RWLOCK_PREFER_READER_NP)
+    {
+      if (s < PTW32_RWLOCK_READER && rwl->nWritersSignalled == 0)
+        {
+          rwl->nWritersSignalled = 1;
+          (void) ReleaseSemaphore (rwl->writerSema, 1, NULL);
+        }
+      return;
+    }
+
+  n = rwl->nReadersWaiting - rwl->nReadersSignalled;
+
+  if (n > 0)
+    {
+      rwl->nReadersSignalled += n;
+      (void) ReleaseSemaphore (rwl->readerSema, n, NULL);
+    }
+  else if (rwl->nReadersWaiting == 0
+           && rwl->nWritersWaiting > 0
+           && s < PTW32_RWLOCK_READER
+           && rwl->nWritersSignalled == 0)
+    {
+      rwl->nWritersSignalled = 1;
+      (void) ReleaseSemaphore (rwl->writerSema, 1, NULL);
+    }
+}
+
+
+static void
+ptw32_rwlock_prefer_cancelwrwait (void * arg)
+{
+  pthread_rwlock_t rwl = (pthread_rwlock_t) arg;
+  ptw32_mcs_local_node_t node;
+
+  ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+  rwl->nWritersWaiting--;
+  ptw32_rwlock_prefer_setwaiting (rwl);
+  ptw32_rwlock_prefer_wake (rwl);
+  ptw32_mcs_lock_release (&node);
+}
+
+
+int
+ptw32_rwlock_prefer_init (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Initialise a new PTHREAD_RWLOCK_PREFER_*_NP rwlock.
+      *      Its wait objects are created by the first thread to
+      *      block on each. See ptw32_lazy_handle.c.
+      *
+      * RESULTS
+      *              0               success.
+      *
+      * ------------------------------------------------------
+      */
+{
+  rwl->state = 0;
+  rwl->stateLock = 0;
+  rwl->nReadersWaiting = 0;
+  rwl->nWritersWaiting = 0;
+  rwl->nReadersSignalled = 0;
+  rwl->nWritersSignalled = 0;
+  rwl->upgrading = PTW32_FALSE;
+  rwl->readerSema = NULL;
+  rwl->writerSema = NULL;
+  rwl->upgradeEvent = NULL;
+
+  return 0;
+}
+
+
+void
+ptw32_rwlock_prefer_destroy (pthread_rwlock_t rwl)
+{
+  if (rwl->readerSema != NULL)
+    {
+      (void) CloseHandle (rwl->readerSema);
+    }
+  if (rwl->writerSema != NULL)
+    {
+      (void) CloseHandle (rwl->writerSema);
+    }
+  if (rwl->upgradeEvent != NULL)
+    {
+      (void) CloseHandle (rwl->upgradeEvent);
+    }
+  rwl->readerSema = NULL;
+  rwl->writerSema = NULL;
+  rwl->upgradeEvent = NULL;
+}
+
+
+int
+ptw32_rwlock_prefer_busy (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      Called by pthread_rwlock_destroy(). Returns non-zero
+      *      if the lock is held or waited for. Otherwise leaves
+      *      it write locked so that nobody can get in before
+      *      it is gone.
+      *
+      * ------------------------------------------------------
+      */
+{
+  return (0 != (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->state,
+                                                               (PTW32_INTERLOCKED_LONG) PTW32_RWLOCK_WRITER,
+                                                               (PTW32_INTERLOCKED_LONG) 0));
+}
+
+
+int
+ptw32_rwlock_prefer_rdlock (pthread_rwlock_t rwl,
+                            const struct timespec * abstime,
+                            int trylock)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      pthread_rwlock_[try|timed]rdlock() for
+      *      PTHREAD_RWLOCK_PREFER_*_NP rwlocks.
+      *
+      * PARAMETERS
+      *      rwl
+      *              the rwlock
+      *
+      *      abstime
+      *              absolute timeout or NULL to wait forever
+      *
+      *      trylock
+      *              non-zero to return EBUSY rather than wait
+      *
+      * RESULTS
+      *              0               the caller holds a read lock,
+      *              EBUSY           trylock and the lock is busy,
+      *              ETIMEDOUT       abstime passed,
+      *              EAGAIN          too many readers,
+      *              ENOSPC          unable to create the wait object,
+      *              EINVAL          the wait failed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_thread_t * sp = NULL;
+  ptw32_mcs_local_node_t node;
+  int registered = PTW32_FALSE;
+  int result = 0;
+  DWORD status;
+  LONG s;
+
+  if (rwl->kind == PTHREAD_RWLOCK_PREFER_WRITER_NP)
+    {
+      sp = (ptw32_thread_t *) pthread_self ().p;
+    }
+
+  /*
+   * Fast path: nobody holds for writing or waits.
+   */
+  for (;;)
+    {
+      s = rwl->state;
+
+      if (s & (PTW32_RWLOCK_WRITER | PTW32_RWLOCK_WAITING))
+        {
+          break;
+        }
+
+      if (s >= LONG_MAX - PTW32_RWLOCK_READER)
+        {
+          return EAGAIN;
+        }
+
+      if (s == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->state,
+                                                               (PTW32_INTERLOCKED_LONG) (s + PTW32_RWLOCK_READER),
+                                                               (PTW32_INTERLOCKED_LONG) s))
+        {
+          if (sp != NULL)
+            {
+              sp->rwlockReadHolds++;
+            }
+          return 0;
+        }
+    }
+
+  ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+
+  for (;;)
+    {
+      s = rwl->state;
+
+      if (ptw32_rwlock_prefer_canread (rwl, s, sp))
+        {
+          if (s >= LONG_MAX - PTW32_RWLOCK_READER)
+            {
+              result = EAGAIN;
+              break;
+            }
+
+          if (s == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->state,
+                                                                   (PTW32_INTERLOCKED_LONG) (s + PTW32_RWLOCK_READER),
+                                                                   (PTW32_INTERLOCKED_LONG) s))
+            {
+              break;
+            }
+          continue;
+        }
+
+      if (trylock)
+        {
+          result = EBUSY;
+          break;
+        }
+
+      if (!registered)
+        {
+          if (rwl->readerSema == NULL
+              && ptw32_lazy_semaphore (&rwl->readerSema, INT_MAX) == NULL)
+            {
+              result = ENOSPC;
+              break;
+            }
+
+          /*
+           * Look at state again once WAITING is set: an unlock that
+           * got in first won't have woken anybody.
+           */
+          rwl->nReadersWaiting++;
+          ptw32_rwlock_prefer_setwaiting (rwl);
+          registered = PTW32_TRUE;
+          continue;
+        }
+
+      ptw32_mcs_lock_release (&node);
+
+      status = WaitForSingleObject (rwl->readerSema,
+                                    (abstime == NULL) ? INFINITE : ptw32_relmillisecs (abstime));
+
+      ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+
+      if (status != WAIT_OBJECT_0)
+        {
+          result = (status == WAIT_TIMEOUT) ? ETIMEDOUT : EINVAL;
+          break;
+        }
+
+      rwl->nReadersSignalled--;
+    }
+
+  if (registered)
+    {
+      rwl->nReadersWaiting--;
+      ptw32_rwlock_prefer_setwaiting (rwl);
+
+      if (result != 0)
+        {
+          ptw32_rwlock_prefer_wake (rwl);
+        }
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (result == 0 && sp != NULL)
+    {
+      sp->rwlockReadHolds++;
+    }
+
+  return result;
+}
+
+
+int
+ptw32_rwlock_prefer_wrlock (pthread_rwlock_t rwl,
+                            const struct timespec * abstime,
+                            int trylock)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      pthread_rwlock_[try|timed]wrlock() for
+      *      PTHREAD_RWLOCK_PREFER_*_NP rwlocks.
+      *
+      * PARAMETERS
+      *      rwl
+      *              the rwlock
+      *
+      *      abstime
+      *              absolute timeout or NULL to wait forever
+      *
+      *      trylock
+      *              non-zero to return EBUSY rather than wait
+      *
+      * RESULTS
+      *              0               the caller holds the write lock,
+      *              EBUSY           trylock and the lock is busy,
+      *              ETIMEDOUT       abstime passed,
+      *              ENOSPC          unable to create the wait object,
+      *              EINVAL          the wait failed.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int registered = PTW32_FALSE;
+  int result = 0;
+  LONG s;
+
+  if (0 == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->state,
+                                                           (PTW32_INTERLOCKED_LONG) PTW32_RWLOCK_WRITER,
+                                                           (PTW32_INTERLOCKED_LONG) 0))
+    {
+      return 0;
+    }
+
+  ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+
+  for (;;)
+    {
+      s = rwl->state;
+
+      if (ptw32_rwlock_prefer_canwrite (rwl, s))
+        {
+          if (s == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->state,
+                                                                   (PTW32_INTERLOCKED_LONG) (s | PTW32_RWLOCK_WRITER),
+                                                                   (PTW32_INTERLOCKED_LONG) s))
+            {
+              break;
+            }
+          continue;
+        }
+
+      if (trylock)
+        {
+          result = EBUSY;
+          break;
+        }
+
+      if (!registered)
+        {
+          if (rwl->writerSema == NULL
+              && ptw32_lazy_semaphore (&rwl->writerSema, INT_MAX) == NULL)
+            {
+              result = ENOSPC;
+              break;
+            }
+
+          rwl->nWritersWaiting++;
+          ptw32_rwlock_prefer_setwaiting (rwl);
+          registered = PTW32_TRUE;
+          continue;
+        }
+
+      ptw32_mcs_lock_release (&node);
+
+      /*
+       * This routine may be a cancellation point
+       * according to POSIX 1003.1j section 18.1.2.
+       */
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth(0)
+#endif
+      pthread_cleanup_push (ptw32_rwlock_prefer_cancelwrwait, (void *) rwl);
+
+      result = (abstime == NULL)
+               ? pthreadCancelableWait (rwl->writerSema)
+               : pthreadCancelableTimedWait (rwl->writerSema,
+                                             ptw32_relmillisecs (abstime));
+
+      pthread_cleanup_pop (0);
+#if defined(PTW32_CONFIG_MSVC7)
+#pragma inline_depth()
+#endif
+
+      ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+
+      if (result != 0)
+        {
+          break;
+        }
+
+      rwl->nWritersSignalled--;
+    }
+
+  if (registered)
+    {
+      rwl->nWritersWaiting--;
+      ptw32_rwlock_prefer_setwaiting (rwl);
+
+      if (result != 0)
+        {
+          ptw32_rwlock_prefer_wake (rwl);
+        }
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+
+int
+ptw32_rwlock_prefer_unlock (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      pthread_rwlock_unlock() for PTHREAD_RWLOCK_PREFER_*_NP
+      *      rwlocks. The WRITER bit tells us which kind of lock
+      *      the caller holds.
+      *
+      * RESULTS
+      *              0               success,
+      *              EPERM           the lock isn't held.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int locked = PTW32_FALSE;
+  LONG s, n;
+
+  for (;;)
+    {
+      s = rwl->state;
+
+      if (s & PTW32_RWLOCK_WRITER)
+        {
+          n = s & ~PTW32_RWLOCK_WRITER;
+        }
+      else if (s >= PTW32_RWLOCK_READER)
+        {
+          n = s - PTW32_RWLOCK_READER;
+        }
+      else
+        {
+          if (locked)
+            {
+              ptw32_mcs_lock_release (&node);
+            }
+          return EPERM;
+        }
+
+      if ((s & PTW32_RWLOCK_WAITING) && !locked)
+        {
+          /*
+           * Somebody may need waking; we must decide who under stateLock.
+           */
+          ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+          locked = PTW32_TRUE;
+          continue;
+        }
+
+      if (s == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->state,
+                                                               (PTW32_INTERLOCKED_LONG) n,
+                                                               (PTW32_INTERLOCKED_LONG) s))
+        {
+          break;
+        }
+    }
+
+  if (locked)
+    {
+      ptw32_rwlock_prefer_wake (rwl);
+      ptw32_mcs_lock_release (&node);
+    }
+
+  if (!(s & PTW32_RWLOCK_WRITER) && rwl->kind == PTHREAD_RWLOCK_PREFER_WRITER_NP)
+    {
+      ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+
+      if (sp != NULL && sp->rwlockReadHolds > 0)
+        {
+          sp->rwlockReadHolds--;
+        }
+    }
+
+  return 0;
+}
+
+
+int
+ptw32_rwlock_prefer_upgrade (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      pthread_rwlock_upgrade_np() for
+      *      PTHREAD_RWLOCK_PREFER_*_NP rwlocks.
+      *
+      * RESULTS
+      *              0               the caller holds the write lock,
+      *              EDEADLK         another reader is upgrading,
+      *              EPERM           no read lock is held,
+      *              ENOSPC          unable to create the wait object.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int result = 0;
+  LONG s;
+
+  ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+
+  s = rwl->state;
+
+  if ((s & PTW32_RWLOCK_WRITER) || s < PTW32_RWLOCK_READER)
+    {
+      result = EPERM;
+    }
+  else if (rwl->upgrading)
+    {
+      result = EDEADLK;
+    }
+  else if (rwl->upgradeEvent == NULL
+           && ptw32_lazy_event (&rwl->upgradeEvent) == NULL)
+    {
+      result = ENOSPC;
+    }
+  else
+    {
+      rwl->upgrading = PTW32_TRUE;
+      rwl->nWritersWaiting++;
+      ptw32_rwlock_prefer_setwaiting (rwl);
+
+      for (;;)
+        {
+          s = rwl->state;
+
+          if ((s & ~PTW32_RWLOCK_WAITING) == PTW32_RWLOCK_READER)
+            {
+              if (s == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->state,
+                                                                       (PTW32_INTERLOCKED_LONG) ((s - PTW32_RWLOCK_READER) | PTW32_RWLOCK_WRITER),
+                                                                       (PTW32_INTERLOCKED_LONG) s))
+                {
+                  break;
+                }
+              continue;
+            }
+
+          ptw32_mcs_lock_release (&node);
+          (void) WaitForSingleObject (rwl->upgradeEvent, INFINITE);
+          ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+        }
+
+      rwl->upgrading = PTW32_FALSE;
+      rwl->nWritersWaiting--;
+      ptw32_rwlock_prefer_setwaiting (rwl);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  if (result == 0 && rwl->kind == PTHREAD_RWLOCK_PREFER_WRITER_NP)
+    {
+      ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+
+      if (sp != NULL && sp->rwlockReadHolds > 0)
+        {
+          sp->rwlockReadHolds--;
+        }
+    }
+
+  return result;
+}
+
+
+int
+ptw32_rwlock_prefer_downgrade (pthread_rwlock_t rwl)
+     /*
+      * ------------------------------------------------------
+      * DOCPRIVATE
+      *      pthread_rwlock_downgrade_np() for
+      *      PTHREAD_RWLOCK_PREFER_*_NP rwlocks.
+      *
+      * RESULTS
+      *              0               the caller holds a read lock,
+      *              EPERM           the write lock isn't held.
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int locked = PTW32_FALSE;
+  LONG s;
+
+  for (;;)
+    {
+      s = rwl->state;
+
+      if (!(s & PTW32_RWLOCK_WRITER))
+        {
+          if (locked)
+            {
+              ptw32_mcs_lock_release (&node);
+            }
+          return EPERM;
+        }
+
+      if ((s & PTW32_RWLOCK_WAITING) && !locked)
+        {
+          ptw32_mcs_lock_acquire (&rwl->stateLock, &node);
+          locked = PTW32_TRUE;
+          continue;
+        }
+
+      if (s == (LONG) PTW32_INTERLOCKED_COMPARE_EXCHANGE_LONG ((PTW32_INTERLOCKED_LONGPTR) &rwl->state,
+                                                               (PTW32_INTERLOCKED_LONG) ((s & ~PTW32_RWLOCK_WRITER) + PTW32_RWLOCK_READER),
+                                                               (PTW32_INTERLOCKED_LONG) s))
+        {
+          break;
+        }
+    }
+
+  if (locked)
+    {
+      /*
+       * Waiting readers may now be able to join us.
+       */
+      ptw32_rwlock_prefer_wake (rwl);
+      ptw32_mcs_lock_release (&node);
+    }
+
+  if (rwl->kind == PTHREAD_RWLOCK_PREFER_WRITER_NP)
+    {
+      ptw32_thread_t * sp = (ptw32_thread_t *) pthread_self ().p;
+
+      if (sp != NULL)
+        {
+          sp->rwlockReadHolds++;
+        }
+    }
+
+  return 0;
+}
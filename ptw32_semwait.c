@@ -67,6 +67,7 @@ ptw32_semwait (sem_t * sem)
  *              ENOSYS          semaphores are not supported,
  *              EINTR           the function was interrupted by a signal,
  *              EDEADLK         a deadlock condition was detected.
+ *              ENOSPC          a required resource has been exhausted.
  *
  * ------------------------------------------------------
  */
@@ -83,23 +84,7 @@ ptw32_semwait (sem_t * sem)
   if (v < 0)
     {
       /* Must wait */
-      if (WaitForSingleObject (s->sem, INFINITE) == WAIT_OBJECT_0)
-        {
-#if defined(NEED_SEM)
-          ptw32_mcs_lock_acquire(&s->lock, &node);
-          if (s->leftToUnblock > 0)
-            {
-              --s->leftToUnblock;
-              SetEvent(s->sem);
-            }
-          ptw32_mcs_lock_release(&node);
-#endif
-return 0;
-        }
-    }
-  else
-    {
-      return 0;
+      result = ptw32_sem_block (s, NULL, PTW32_FALSE);
     }
 
   if (result != 0)
@@ -111,3 +96,78 @@ return 0;
   return 0;
 
 }				/* ptw32_semwait */
+
+
+int
+ptw32_sem_block (sem_t s, const struct timespec * abstime, int cancelable)
+/*
+ * ------------------------------------------------------
+ * DOCPRIVATE
+ *      Called by a thread that has decremented the value of
+ *      semaphore 's' below zero. Waits for sem_post() or
+ *      sem_post_multiple() to leave a wakeup for it in
+ *      s->wakeups, and takes it.
+ *
+ *      Blocked threads wait on the address of s->wakeups
+ *      (see ptw32_park.c), so the semaphore owns no kernel
+ *      object.
+ *
+ * PARAMETERS
+ *      s
+ *              the semaphore
+ *
+ *      abstime
+ *              absolute timeout or NULL to wait forever
+ *
+ *      cancelable
+ *              return EINTR if a cancellation request is
+ *              pending
+ *
+ * RESULTS
+ *              0               took a wakeup,
+ *              ETIMEDOUT       abstime passed,
+ *              EINTR           cancellation pending,
+ *              ENOSPC          no park event,
+ *              EINVAL          the wait failed
+ *
+ *      On failure the thread is no longer counted in the
+ *      value; the caller just returns the error (after
+ *      acting on EINTR).
+ *
+ * ------------------------------------------------------
+ */
+{
+  ptw32_mcs_local_node_t node;
+  int result = 0;
+
+  for (;;)
+    {
+      ptw32_mcs_lock_acquire(&s->lock, &node);
+
+      if (s->wakeups > 0)
+        {
+          /*
+           * If we timed out or were cancelled, this post arrived
+           * in the meantime. Take it rather than lose it.
+           */
+          s->wakeups--;
+          ptw32_mcs_lock_release(&node);
+          return 0;
+        }
+
+      if (result != 0)
+        {
+          /* Indicate we're no longer waiting */
+          s->value++;
+          ptw32_mcs_lock_release(&node);
+          return result;
+        }
+
+      ptw32_mcs_lock_release(&node);
+
+      result = ptw32_wait_on_address (&s->wakeups, 0,
+                                      (abstime == NULL) ? INFINITE : ptw32_relmillisecs (abstime),
+                                      cancelable);
+    }
+
+}				/* ptw32_sem_block */
@@ -64,11 +64,6 @@ ptw32_threadDestroy (pthread_t thread)
       ptw32_threadReusePush (thread);
 
       /* Now work on the copy. */
-      if (threadCopy.cancelEvent != NULL)
-	{
-	  CloseHandle (threadCopy.cancelEvent);
-	}
-
 #if ! defined(PTW32_CONFIG_MINGW) || defined (__MSVCRT__) || defined (__DMC__)
       /*
        * See documentation for endthread vs endthreadex.
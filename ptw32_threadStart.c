@@ -170,7 +170,14 @@ ptw32_threadStart (void *vthreadParms)
   pthread_setspecific (ptw32_selfThreadKey, sp);
 #endif
 
-  sp->state = PThreadStateRunning;
+  /*
+   * Don't lose a cancel request made before we got here; only
+   * sp->cancelRequested would remember it otherwise.
+   */
+  if (sp->state < PThreadStateRunning)
+    {
+      sp->state = PThreadStateRunning;
+    }
   ptw32_mcs_lock_release (&stateLock);
 
 #if defined(__CLEANUP_SEH)
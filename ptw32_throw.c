@@ -173,8 +173,26 @@ ptw32_throw (DWORD exception)
 void
 ptw32_pop_cleanup_all (int execute)
 {
-  while (NULL != ptw32_pop_cleanup (execute))
+  ptw32_cleanup_t ** stack = ptw32_cleanup_stack ();
+  ptw32_cleanup_t * cleanup;
+
+  if (stack == NULL)
     {
+      return;
+    }
+
+  /*
+   * Unlink each handler before it runs, in case it exits or is
+   * cancelled itself.
+   */
+  while (NULL != (cleanup = *stack))
+    {
+      *stack = cleanup->prev;
+
+      if (execute && cleanup->routine != NULL)
+	{
+	  (*cleanup->routine) (cleanup->arg);
+	}
     }
 }
 
@@ -0,0 +1,642 @@
+/*
+ * ptw32_timer.c
+ *
+ * Description:
+ * This translation unit implements routines which are private to
+ * the implementation and may be used throughout it.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+/*
+ * Notes on timers.
+ * ----------------
+ *
+ * Every armed timer in the process hangs in one hierarchical timer
+ * wheel, ptw32_timer_wheel, run by a single service thread. Time is
+ * measured in ticks of 2^PTW32_TIMER_TICK_SHIFT ns on the monotonic
+ * clock, and a timer is due at the first tick that starts at or after
+ * its expiry, so it never fires early.
+ *
+ * The wheel has PTW32_TIMER_LEVELS levels of PTW32_TIMER_LEVEL_SIZE
+ * slots, each slot a list of timers. A timer due within one level's
+ * span of the wheel's current tick goes in the slot picked by that
+ * level's bits of its due tick. Level 0 slots are single ticks; when
+ * the current tick crosses a level boundary the next slot of each
+ * level above is emptied and its timers put back in lower levels
+ * ("cascading"). Arming and disarming are O(1); each timer cascades
+ * at most PTW32_TIMER_LEVELS - 1 times.
+ *
+ * The service thread runs every tick up to the present, then sleeps
+ * until the next occupied level 0 slot or level boundary, found with
+ * the per-level bitmaps of occupied slots. It sleeps on a waitable
+ * timer, high resolution where available, and an event that
+ * timer_settime() sets when it arms a timer due before the service
+ * thread would otherwise wake.
+ *
+ * SIGEV_THREAD notifications run on a pool rather than a thread each,
+ * unless the timer was created with thread attributes, when a detached
+ * thread is created with them. A timer has at most one notification
+ * queued or running; expirations while it is are counted as overruns,
+ * as are periods missed entirely. A timer deleted while its
+ * notification is pending is freed when the notification finishes.
+ *
+ * One MCS lock guards the wheel and every timer's state.
+ */
+
+#define PTW32_TIMER_SLOT_TICK(tick, level) \
+	((int) (((tick) >> (PTW32_TIMER_LEVEL_SHIFT * (level))) & PTW32_TIMER_LEVEL_MASK))
+
+
+/*
+ * ptw32_timer_due()
+ *
+ * Return the tick at which a timer expiring at 'expires' is due.
+ */
+static LONGLONG
+ptw32_timer_due (ptw32_timer_wheel_t * w, LONGLONG expires)
+{
+  LONGLONG tick = (expires + ((LONGLONG) 1 << PTW32_TIMER_TICK_SHIFT) - 1) >> PTW32_TIMER_TICK_SHIFT;
+
+  return (tick < w->tick) ? w->tick : tick;
+}
+
+/*
+ * ptw32_timer_link()
+ *
+ * Put a timer in the wheel. Called with the wheel locked.
+ */
+static void
+ptw32_timer_link (ptw32_timer_wheel_t * w, ptw32_timer_t * t)
+{
+  LONGLONG tick = ptw32_timer_due (w, t->expires);
+  LONGLONG delta = tick - w->tick;
+  ptw32_timer_t ** head;
+  int level;
+
+  for (level = 0;
+       level < PTW32_TIMER_LEVELS - 1
+         && delta >= ((LONGLONG) 1 << (PTW32_TIMER_LEVEL_SHIFT * (level + 1)));
+       level++)
+    {
+    }
+
+  if (delta >= ((LONGLONG) 1 << (PTW32_TIMER_LEVEL_SHIFT * PTW32_TIMER_LEVELS)))
+    {
+      /*
+       * Beyond the wheel: park it in the furthest slot. It is put
+       * back by its real expiry when that slot cascades.
+       */
+      tick = w->tick + ((LONGLONG) 1 << (PTW32_TIMER_LEVEL_SHIFT * PTW32_TIMER_LEVELS)) - 1;
+    }
+
+  t->level = level;
+  t->slot = PTW32_TIMER_SLOT_TICK (tick, level);
+
+  head = &w->slots[level][t->slot];
+  if (NULL != (t->next = *head))
+    {
+      t->next->prev = &t->next;
+    }
+  *head = t;
+  t->prev = head;
+
+  w->occupied[level] |= (unsigned __int64) 1 << t->slot;
+  w->count++;
+}
+
+/*
+ * ptw32_timer_unlink()
+ *
+ * Take a timer out of the wheel. Called with the wheel locked.
+ */
+static void
+ptw32_timer_unlink (ptw32_timer_wheel_t * w, ptw32_timer_t * t)
+{
+  if (NULL != (*t->prev = t->next))
+    {
+      t->next->prev = t->prev;
+    }
+  t->prev = NULL;
+
+  if (w->slots[t->level][t->slot] == NULL)
+    {
+      w->occupied[t->level] &= ~((unsigned __int64) 1 << t->slot);
+    }
+  w->count--;
+}
+
+/*
+ * ptw32_timer_advance()
+ *
+ * Run the wheel's ticks up to and including 'now'. Returns the timers
+ * that are due, linked through 'next' and out of the wheel.
+ */
+static ptw32_timer_t *
+ptw32_timer_advance (ptw32_timer_wheel_t * w, LONGLONG now)
+{
+  ptw32_timer_t * expired = NULL;
+  ptw32_timer_t * list;
+  ptw32_timer_t * t;
+  LONGLONG next;
+  int index;
+  int level;
+  int slot;
+
+  while (w->tick <= now)
+    {
+      index = PTW32_TIMER_SLOT_TICK (w->tick, 0);
+
+      if (index == 0)
+        {
+          for (level = 1; level < PTW32_TIMER_LEVELS; level++)
+            {
+              slot = PTW32_TIMER_SLOT_TICK (w->tick, level);
+              list = w->slots[level][slot];
+              w->slots[level][slot] = NULL;
+              w->occupied[level] &= ~((unsigned __int64) 1 << slot);
+
+              while ((t = list) != NULL)
+                {
+                  list = t->next;
+                  w->count--;
+                  ptw32_timer_link (w, t);
+                }
+
+              if (slot != 0)
+                {
+                  break;
+                }
+            }
+        }
+
+      while ((t = w->slots[0][index]) != NULL)
+        {
+          ptw32_timer_unlink (w, t);
+          t->next = expired;
+          expired = t;
+        }
+
+      w->tick++;
+
+      /*
+       * Skip to the next level boundary if the rest of level 0 is
+       * empty.
+       */
+      index = PTW32_TIMER_SLOT_TICK (w->tick, 0);
+      if (index != 0 && (w->occupied[0] >> index) == 0)
+        {
+          next = (w->tick | PTW32_TIMER_LEVEL_MASK) + 1;
+          w->tick = (next <= now) ? next : now + 1;
+        }
+    }
+
+  return expired;
+}
+
+/*
+ * ptw32_timer_next()
+ *
+ * Return the next tick the service thread must run, or
+ * PTW32_TIMER_NEVER. Called with the wheel locked.
+ */
+static LONGLONG
+ptw32_timer_next (ptw32_timer_wheel_t * w)
+{
+  unsigned __int64 bits;
+  int index;
+  int n;
+
+  if (w->count == 0)
+    {
+      return PTW32_TIMER_NEVER;
+    }
+
+  index = PTW32_TIMER_SLOT_TICK (w->tick, 0);
+
+  if (index == 0)
+    {
+      /*
+       * Higher levels cascade on this tick.
+       */
+      return w->tick;
+    }
+
+  if (0 != (bits = w->occupied[0] >> index))
+    {
+      for (n = 0; (bits & 1) == 0; n++)
+        {
+          bits >>= 1;
+        }
+      return w->tick + n;
+    }
+
+  return (w->tick | PTW32_TIMER_LEVEL_MASK) + 1;
+}
+
+/*
+ * ptw32_timer_notify()
+ *
+ * Run a SIGEV_THREAD notification, as a pool task or on its own thread.
+ */
+static void PTW32_CDECL
+ptw32_timer_notify (void * arg)
+{
+  ptw32_timer_t * t = (ptw32_timer_t *) arg;
+  ptw32_timer_wheel_t * w = &ptw32_timer_wheel;
+  ptw32_mcs_local_node_t node;
+  int deleted;
+
+  ptw32_mcs_lock_acquire (&w->lock, &node);
+  t->overrun = t->pendingOverrun;
+  t->pendingOverrun = 0;
+  ptw32_mcs_lock_release (&node);
+
+  (*t->function) (t->value);
+
+  ptw32_mcs_lock_acquire (&w->lock, &node);
+  t->notifying = PTW32_FALSE;
+  deleted = t->deleted;
+  ptw32_mcs_lock_release (&node);
+
+  if (deleted)
+    {
+      ptw32_timer_free (t);
+    }
+}
+
+static void * PTW32_CDECL
+ptw32_timer_thread (void * arg)
+{
+  ptw32_timer_notify (arg);
+
+  return NULL;
+}
+
+/*
+ * ptw32_timer_expire()
+ *
+ * Re-arm a timer that is due if it is periodic, and decide whether to
+ * start a notification. Called with the wheel locked. Returns
+ * PTW32_TRUE if the caller should start one.
+ */
+static int
+ptw32_timer_expire (ptw32_timer_wheel_t * w, ptw32_timer_t * t, LONGLONG now)
+{
+  LONGLONG missed = 0;
+
+  if (t->interval > 0)
+    {
+      missed = (now - t->expires) / t->interval;
+      t->expires += (missed + 1) * t->interval;
+      ptw32_timer_link (w, t);
+    }
+
+  if (t->notify != SIGEV_THREAD)
+    {
+      return PTW32_FALSE;
+    }
+
+  if (t->notifying)
+    {
+      missed++;
+    }
+
+  if (missed > (LONGLONG) (DELAYTIMER_MAX - t->pendingOverrun))
+    {
+      t->pendingOverrun = DELAYTIMER_MAX;
+    }
+  else
+    {
+      t->pendingOverrun += (int) missed;
+    }
+
+  if (t->notifying)
+    {
+      return PTW32_FALSE;
+    }
+
+  t->notifying = PTW32_TRUE;
+
+  return PTW32_TRUE;
+}
+
+/*
+ * ptw32_timer_service()
+ *
+ * The service thread.
+ */
+static void * PTW32_CDECL
+ptw32_timer_service (void * arg)
+{
+  ptw32_timer_wheel_t * w = &ptw32_timer_wheel;
+  ptw32_mcs_local_node_t node;
+  ptw32_timer_t * expired;
+  ptw32_timer_t * fire;
+  ptw32_timer_t ** fireTail;
+  ptw32_timer_t * t;
+  pthread_t thread;
+  LARGE_INTEGER due;
+  HANDLE handles[2];
+  LONGLONG now;
+  LONGLONG wait;
+  int result;
+
+  handles[0] = w->wakeEvent;
+  handles[1] = w->waitableTimer;
+
+  for (;;)
+    {
+      fire = NULL;
+      fireTail = &fire;
+
+      ptw32_mcs_lock_acquire (&w->lock, &node);
+
+      now = ptw32_clock_ns (CLOCK_MONOTONIC);
+      expired = ptw32_timer_advance (w, now >> PTW32_TIMER_TICK_SHIFT);
+
+      while ((t = expired) != NULL)
+        {
+          expired = t->next;
+
+          if (ptw32_timer_expire (w, t, now))
+            {
+              t->fireNext = NULL;
+              *fireTail = t;
+              fireTail = &t->fireNext;
+            }
+        }
+
+      w->wakeTick = ptw32_timer_next (w);
+      wait = w->wakeTick;
+
+      ptw32_mcs_lock_release (&node);
+
+      while ((t = fire) != NULL)
+        {
+          fire = t->fireNext;
+
+          if (t->attr == NULL)
+            {
+              result = pthread_pool_submit_np (&w->pool, ptw32_timer_notify, t);
+            }
+          else
+            {
+              result = pthread_create (&thread, &t->attr, ptw32_timer_thread, t);
+            }
+
+          if (result != 0)
+            {
+              /*
+               * Count it as an overrun and try again next time.
+               */
+              ptw32_mcs_lock_acquire (&w->lock, &node);
+              t->notifying = PTW32_FALSE;
+              if (t->pendingOverrun < DELAYTIMER_MAX)
+                {
+                  t->pendingOverrun++;
+                }
+              result = t->deleted;
+              ptw32_mcs_lock_release (&node);
+
+              if (result)
+                {
+                  ptw32_timer_free (t);
+                }
+            }
+        }
+
+      if (wait == PTW32_TIMER_NEVER)
+        {
+          (void) WaitForSingleObject (w->wakeEvent, INFINITE);
+          continue;
+        }
+
+      wait = (wait << PTW32_TIMER_TICK_SHIFT) - ptw32_clock_ns (CLOCK_MONOTONIC);
+
+      if (wait <= 0)
+        {
+          continue;
+        }
+
+      if (w->waitableTimer != NULL)
+        {
+          /*
+           * Negative due times are relative, in 100 ns units.
+           */
+          due.QuadPart = -((wait + 99) / 100);
+          if (SetWaitableTimer (w->waitableTimer, &due, 0, NULL, NULL, PTW32_FALSE))
+            {
+              (void) WaitForMultipleObjects (2, handles, PTW32_FALSE, INFINITE);
+              continue;
+            }
+        }
+
+      (void) WaitForSingleObject (w->wakeEvent, (DWORD) ((wait + 999999) / 1000000));
+    }
+
+  return NULL;
+}
+
+/*
+ * ptw32_timer_start()
+ *
+ * Start the service thread and its pool if that hasn't been done.
+ * Returns 0 or EAGAIN.
+ */
+int
+ptw32_timer_start (void)
+{
+  ptw32_timer_wheel_t * w = &ptw32_timer_wheel;
+  ptw32_mcs_local_node_t node;
+  pthread_attr_t attr;
+  pthread_t thread;
+  int result = 0;
+
+  ptw32_mcs_lock_acquire (&w->lock, &node);
+
+  if (!w->started)
+    {
+      w->tick = ptw32_clock_ns (CLOCK_MONOTONIC) >> PTW32_TIMER_TICK_SHIFT;
+      w->wakeTick = PTW32_TIMER_NEVER;
+
+      if (NULL == (w->wakeEvent = CreateEvent (NULL, PTW32_FALSE, PTW32_FALSE, NULL))
+          || 0 != pthread_pool_init_np (&w->pool, NULL, 1, PTW32_TIMER_NOTIFY_THREADS))
+        {
+          result = EAGAIN;
+          goto FAIL0;
+        }
+
+      w->waitableTimer = ptw32_clock_timer ();
+
+      if (0 != pthread_attr_init (&attr))
+        {
+          result = EAGAIN;
+          goto FAIL1;
+        }
+
+      (void) pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+      result = pthread_create (&thread, &attr, ptw32_timer_service, NULL);
+      (void) pthread_attr_destroy (&attr);
+
+      if (result != 0)
+        {
+          result = EAGAIN;
+          goto FAIL1;
+        }
+
+      w->started = PTW32_TRUE;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return 0;
+
+FAIL1:
+  if (w->waitableTimer != NULL)
+    {
+      (void) CloseHandle (w->waitableTimer);
+      w->waitableTimer = NULL;
+    }
+  (void) pthread_pool_destroy_np (&w->pool);
+
+FAIL0:
+  if (w->wakeEvent != NULL)
+    {
+      (void) CloseHandle (w->wakeEvent);
+      w->wakeEvent = NULL;
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}
+
+/*
+ * ptw32_timer_arm()
+ *
+ * Put a timer whose expiry is set in the wheel, waking the service
+ * thread if it is due before the thread would next wake. Called with
+ * the wheel locked.
+ */
+void
+ptw32_timer_arm (ptw32_timer_t * t)
+{
+  ptw32_timer_wheel_t * w = &ptw32_timer_wheel;
+  LONGLONG now;
+
+  if (w->count == 0)
+    {
+      /*
+       * The service thread doesn't run the wheel while it is empty, so
+       * catch it up first rather than have it step through every tick
+       * since.
+       */
+      now = ptw32_clock_ns (CLOCK_MONOTONIC) >> PTW32_TIMER_TICK_SHIFT;
+      if (w->tick < now)
+        {
+          w->tick = now;
+        }
+    }
+
+  ptw32_timer_link (w, t);
+
+  if (ptw32_timer_due (w, t->expires) < w->wakeTick)
+    {
+      w->wakeTick = ptw32_timer_due (w, t->expires);
+      (void) SetEvent (w->wakeEvent);
+    }
+}
+
+/*
+ * ptw32_timer_disarm()
+ *
+ * Take a timer out of the wheel if it is in it. Called with the wheel
+ * locked.
+ */
+void
+ptw32_timer_disarm (ptw32_timer_t * t)
+{
+  if (t->prev != NULL)
+    {
+      ptw32_timer_unlink (&ptw32_timer_wheel, t);
+    }
+}
+
+/*
+ * ptw32_timer_remaining()
+ *
+ * Fill in 'value' as timer_gettime() reports it. Called with the wheel
+ * locked.
+ */
+void
+ptw32_timer_remaining (ptw32_timer_t * t, LONGLONG now, struct itimerspec * value)
+{
+  LONGLONG left = 0;
+
+  if (t->prev != NULL)
+    {
+      /*
+       * An armed timer that is due but not yet run reads as 1 ns so
+       * that it doesn't look disarmed.
+       */
+      left = t->expires - now;
+      if (left <= 0)
+        {
+          left = 1;
+        }
+    }
+
+  ptw32_ns_to_timespec (left, &value->it_value);
+  ptw32_ns_to_timespec (t->interval, &value->it_interval);
+}
+
+/*
+ * ptw32_timer_free()
+ */
+void
+ptw32_timer_free (ptw32_timer_t * t)
+{
+  if (t->attr != NULL)
+    {
+      (void) pthread_attr_destroy (&t->attr);
+    }
+
+  free (t);
+}
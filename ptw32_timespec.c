@@ -46,12 +46,6 @@
 
 #if defined(NEED_FTIME)
 
-/*
- * time between jan 1, 1601 and jan 1, 1970 in units of 100 nanoseconds
- */
-#define PTW32_TIMESPEC_TO_FILETIME_OFFSET \
-	  ( ((int64_t) 27111902 << 32) + (int64_t) 3577643008 )
-
 INLINE void
 ptw32_timespec_to_filetime (const struct timespec *ts, FILETIME * ft)
      /*
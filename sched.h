@@ -189,27 +189,61 @@ struct sched_param {
  * due to the need for compatibility with GNU systems
  * and sched_setaffinity() et.al. which include the
  * cpusetsize parameter "normally set to sizeof(cpu_set_t)".
+ *
+ * CPUs are numbered consecutively through the system's
+ * processor groups, so a cpu_set_t can name CPUs in any
+ * group. Sets for more than CPU_SETSIZE CPUs can be
+ * allocated with CPU_ALLOC() and used with the CPU_*_S()
+ * macros, which take the size of the set in bytes.
  */
 
-#define CPU_SETSIZE (sizeof(size_t)*8)
+#define CPU_SETSIZE 1024
+
+/* Bits in each word of a set. */
+#define PTW32_NCPUBITS (8 * sizeof(size_t))
+
+#define CPU_ALLOC_SIZE(count) \
+  ((((size_t)(count) + PTW32_NCPUBITS - 1) / PTW32_NCPUBITS) * sizeof(size_t))
+
+#define CPU_ALLOC(count) (_sched_affinitycpualloc(count))
+
+#define CPU_FREE(setptr) (_sched_affinitycpufree(setptr))
+
+#define CPU_COUNT_S(setsize, setptr) (_sched_affinitycpucount_s((setsize),(setptr)))
+
+#define CPU_ZERO_S(setsize, setptr) (_sched_affinitycpuzero_s((setsize),(setptr)))
+
+#define CPU_SET_S(cpu, setsize, setptr) (_sched_affinitycpuset_s((cpu),(setsize),(setptr)))
+
+#define CPU_CLR_S(cpu, setsize, setptr) (_sched_affinitycpuclr_s((cpu),(setsize),(setptr)))
+
+#define CPU_ISSET_S(cpu, setsize, setptr) (_sched_affinitycpuisset_s((cpu),(setsize),(setptr)))
+
+#define CPU_AND_S(setsize, destsetptr, srcset1ptr, srcset2ptr) (_sched_affinitycpuand_s((setsize),(destsetptr),(srcset1ptr),(srcset2ptr)))
+
+#define CPU_OR_S(setsize, destsetptr, srcset1ptr, srcset2ptr) (_sched_affinitycpuor_s((setsize),(destsetptr),(srcset1ptr),(srcset2ptr)))
+
+#define CPU_XOR_S(setsize, destsetptr, srcset1ptr, srcset2ptr) (_sched_affinitycpuxor_s((setsize),(destsetptr),(srcset1ptr),(srcset2ptr)))
+
+#define CPU_EQUAL_S(setsize, set1ptr, set2ptr) (_sched_affinitycpuequal_s((setsize),(set1ptr),(set2ptr)))
 
-#define CPU_COUNT(setptr) (_sched_affinitycpucount(setptr))
+#define CPU_COUNT(setptr) CPU_COUNT_S(sizeof(cpu_set_t), (setptr))
 
-#define CPU_ZERO(setptr) (_sched_affinitycpuzero(setptr))
+#define CPU_ZERO(setptr) CPU_ZERO_S(sizeof(cpu_set_t), (setptr))
 
-#define CPU_SET(cpu, setptr) (_sched_affinitycpuset((cpu),(setptr)))
+#define CPU_SET(cpu, setptr) CPU_SET_S((cpu), sizeof(cpu_set_t), (setptr))
 
-#define CPU_CLR(cpu, setptr) (_sched_affinitycpuclr((cpu),(setptr)))
+#define CPU_CLR(cpu, setptr) CPU_CLR_S((cpu), sizeof(cpu_set_t), (setptr))
 
-#define CPU_ISSET(cpu, setptr) (_sched_affinitycpuisset((cpu),(setptr)))
+#define CPU_ISSET(cpu, setptr) CPU_ISSET_S((cpu), sizeof(cpu_set_t), (setptr))
 
-#define CPU_AND(destsetptr, srcset1ptr, srcset2ptr) (_sched_affinitycpuand((destsetptr),(srcset1ptr),(srcset2ptr)))
+#define CPU_AND(destsetptr, srcset1ptr, srcset2ptr) CPU_AND_S(sizeof(cpu_set_t), (destsetptr), (srcset1ptr), (srcset2ptr))
 
-#define CPU_OR(destsetptr, srcset1ptr, srcset2ptr) (_sched_affinitycpuor((destsetptr),(srcset1ptr),(srcset2ptr)))
+#define CPU_OR(destsetptr, srcset1ptr, srcset2ptr) CPU_OR_S(sizeof(cpu_set_t), (destsetptr), (srcset1ptr), (srcset2ptr))
 
-#define CPU_XOR(destsetptr, srcset1ptr, srcset2ptr) (_sched_affinitycpuxor((destsetptr),(srcset1ptr),(srcset2ptr)))
+#define CPU_XOR(destsetptr, srcset1ptr, srcset2ptr) CPU_XOR_S(sizeof(cpu_set_t), (destsetptr), (srcset1ptr), (srcset2ptr))
 
-#define CPU_EQUAL(set1ptr, set2ptr) (_sched_affinitycpuequal((set1ptr),(set2ptr)))
+#define CPU_EQUAL(set1ptr, set2ptr) CPU_EQUAL_S(sizeof(cpu_set_t), (set1ptr), (set2ptr))
 
 typedef union
 {
@@ -241,6 +275,33 @@ PTW32_DLLPORT int PTW32_CDECL sched_getaffinity (pid_t pid, size_t cpusetsize, c
 /*
  * Support routines and macros for cpu_set_t
  */
+PTW32_DLLPORT cpu_set_t * PTW32_CDECL _sched_affinitycpualloc (size_t count);
+
+PTW32_DLLPORT void PTW32_CDECL _sched_affinitycpufree (cpu_set_t *pset);
+
+PTW32_DLLPORT int PTW32_CDECL _sched_affinitycpucount_s (size_t setsize, const cpu_set_t *pset);
+
+PTW32_DLLPORT void PTW32_CDECL _sched_affinitycpuzero_s (size_t setsize, cpu_set_t *pset);
+
+PTW32_DLLPORT void PTW32_CDECL _sched_affinitycpuset_s (int cpu, size_t setsize, cpu_set_t *pset);
+
+PTW32_DLLPORT void PTW32_CDECL _sched_affinitycpuclr_s (int cpu, size_t setsize, cpu_set_t *pset);
+
+PTW32_DLLPORT int PTW32_CDECL _sched_affinitycpuisset_s (int cpu, size_t setsize, const cpu_set_t *pset);
+
+PTW32_DLLPORT void PTW32_CDECL _sched_affinitycpuand_s (size_t setsize, cpu_set_t *pdestset, const cpu_set_t *psrcset1, const cpu_set_t *psrcset2);
+
+PTW32_DLLPORT void PTW32_CDECL _sched_affinitycpuor_s (size_t setsize, cpu_set_t *pdestset, const cpu_set_t *psrcset1, const cpu_set_t *psrcset2);
+
+PTW32_DLLPORT void PTW32_CDECL _sched_affinitycpuxor_s (size_t setsize, cpu_set_t *pdestset, const cpu_set_t *psrcset1, const cpu_set_t *psrcset2);
+
+PTW32_DLLPORT int PTW32_CDECL _sched_affinitycpuequal_s (size_t setsize, const cpu_set_t *pset1, const cpu_set_t *pset2);
+
+/*
+ * Used by applications built with earlier versions of this header,
+ * when cpu_set_t was a single word. They see only CPUs 0 to 31 or
+ * 63, in the first word of the set.
+ */
 PTW32_DLLPORT int PTW32_CDECL _sched_affinitycpucount (const cpu_set_t *set);
 
 PTW32_DLLPORT void PTW32_CDECL _sched_affinitycpuzero (cpu_set_t *pset);
@@ -63,8 +63,9 @@ sched_setaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *set)
       *      			Process ID
       *
       *      cpusetsize
-      *      			Currently ignored in pthreads4w.
-      *      			Usually set to sizeof(cpu_set_t)
+      *      			The size of the set in bytes.
+      *      			Usually set to sizeof(cpu_set_t), or
+      *      			CPU_ALLOC_SIZE() for an allocated set.
       *
       *      mask
       *      			Pointer to the CPU mask to set (cpu_set_t).
@@ -80,11 +81,17 @@ sched_setaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *set)
       *	     one of the CPUs specified in mask, then that process is
       *	     migrated to one of the CPUs specified in mask.
       *
+      *      Windows can only confine a process to CPUs in its primary
+      *      processor group. A mask that holds every active CPU in
+      *      every group removes the confinement.
+      *
       * RESULTS
       *              0               successfully created semaphore,
       *              EFAULT          'mask' is a NULL pointer.
       *              EINVAL          '*mask' contains no CPUs in the set
-      *                              of available CPUs.
+      *                              of available CPUs, or contains CPUs
+      *                              outside the process's primary group
+      *                              but not all CPUs.
       *              EAGAIN          The system available CPUs could not
       *                              be obtained.
       *              EPERM           The process referred to by 'pid' is
@@ -125,10 +132,46 @@ sched_setaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *set)
 		{
 		  if (GetProcessAffinityMask (h, &vProcessMask, &vSystemMask))
 			{
+			  WORD groups[PTW32_MAX_CPU_GROUPS];
+			  WORD count = PTW32_MAX_CPU_GROUPS;
+			  int primary = 0;
+			  int others = PTW32_FALSE;
+			  int all = PTW32_TRUE;
+			  DWORD_PTR newMask;
+			  int g;
+
+			  if (ptw32_get_process_group_affinity != NULL
+			      && ptw32_get_process_group_affinity (h, &count, groups)
+			      && count == 1)
+				{
+				  primary = (int) groups[0];
+				}
+
+			  for (g = 0; g < ptw32_cpu_groups; g++)
+				{
+				  DWORD_PTR m = ptw32_cpuset_get_group (cpusetsize, set, g);
+
+				  if (g != primary && m != 0)
+				    {
+				      others = PTW32_TRUE;
+				    }
+				  if ((m & ptw32_cpu_group_active[g]) != ptw32_cpu_group_active[g])
+				    {
+				      all = PTW32_FALSE;
+				    }
+				}
+
 			  /*
 			   * Result is the intersection of available CPUs and the mask.
 			   */
-			  DWORD_PTR newMask = vSystemMask & ((_sched_cpu_set_vector_*)set)->_cpuset;
+			  if (! others)
+				{
+				  newMask = vSystemMask & ptw32_cpuset_get_group (cpusetsize, set, primary);
+				}
+			  else
+				{
+				  newMask = all ? vSystemMask : 0;
+				}
 
 			  if (newMask)
 				{
@@ -151,7 +194,8 @@ sched_setaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *set)
 			  else
 				{
 				  /*
-				   * Mask does not contain any CPUs currently available on the system.
+				   * Mask does not contain any CPUs currently available on the system,
+				   * or contains some that the process can't be confined to.
 				   */
 				  result = EINVAL;
 				}
@@ -199,8 +243,9 @@ sched_getaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *set)
       *      			Process ID
       *
       *      cpusetsize
-      *      			Currently ignored in pthreads4w.
-      *      			Usually set to sizeof(cpu_set_t)
+      *      			The size of the set in bytes.
+      *      			Usually set to sizeof(cpu_set_t), or
+      *      			CPU_ALLOC_SIZE() for an allocated set.
       *
       *      mask
       *      			Pointer to the CPU mask to set (cpu_set_t).
@@ -212,9 +257,14 @@ sched_getaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *set)
       *	     length (in bytes) of the data pointed to by mask.  Normally
       *	     this argument would be specified as sizeof(cpu_set_t).
       *
+      *      The mask holds the CPUs of every processor group that
+      *      the process can use.
+      *
       * RESULTS
       *              0               successfully created semaphore,
       *              EFAULT          'mask' is a NULL pointer.
+      *              EINVAL          'cpusetsize' is too small for the
+      *                              CPUs in the mask.
       *              EAGAIN          The system available CPUs could not
       *                              be obtained.
       *              EPERM           The process referred to by 'pid' is
@@ -225,8 +275,6 @@ sched_getaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *set)
       * ------------------------------------------------------
       */
 {
-  DWORD_PTR vProcessMask;
-  DWORD_PTR vSystemMask;
   HANDLE h;
   int targetPid = (int)(size_t) pid;
   int result = 0;
@@ -237,6 +285,7 @@ sched_getaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *set)
     }
   else
     {
+	  memset (set, 0, cpusetsize);
 
 #if ! defined(NEED_PROCESS_AFFINITY_MASK)
 
@@ -253,19 +302,21 @@ sched_getaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *set)
 	    }
 	  else
 	    {
-		  if (GetProcessAffinityMask (h, &vProcessMask, &vSystemMask))
-		    {
-			  ((_sched_cpu_set_vector_*)set)->_cpuset = vProcessMask;
-		    }
-		  else
+		  DWORD_PTR vProcessMask;
+		  int g;
+
+		  for (g = 0; g < ptw32_cpu_groups && 0 == result; g++)
 		    {
-			  result = EAGAIN;
+			  if (0 == (result = ptw32_process_group_affinity (h, g, &vProcessMask)))
+			    {
+				  result = ptw32_cpuset_put_group (cpusetsize, set, g, vProcessMask);
+			    }
 		    }
 	    }
 	  CloseHandle(h);
 
 #else
-	  ((_sched_cpu_set_vector_*)set)->_cpuset = (size_t)0x1;
+	  result = ptw32_cpuset_put_group (cpusetsize, set, 0, (DWORD_PTR) 0x1);
 #endif
 
     }
@@ -283,70 +334,166 @@ sched_getaffinity (pid_t pid, size_t cpusetsize, cpu_set_t *set)
 
 /*
  * Support routines for cpu_set_t
+ *
+ * The sized routines work a word at a time, which compilers can
+ * vectorise, with any bytes left over after the last whole word done
+ * one at a time. CPU n is bit n % 8 of byte n / 8, which on Windows
+ * (always little-endian) is also bit n of the set taken as words.
  */
-int _sched_affinitycpucount (const cpu_set_t *set)
+cpu_set_t * _sched_affinitycpualloc (size_t count)
 {
-  size_t tset;
-  int count;
-
-  /*
-   * Relies on tset being unsigned, otherwise the right-shift will
-   * be arithmetic rather than logical and the 'for' will loop forever.
-   */
-  for (count = 0, tset = ((_sched_cpu_set_vector_*)set)->_cpuset; tset; tset >>= 1)
+  return (cpu_set_t *) calloc (1, CPU_ALLOC_SIZE (count));
+}
+
+void _sched_affinitycpufree (cpu_set_t *pset)
+{
+  free (pset);
+}
+
+int _sched_affinitycpucount_s (size_t setsize, const cpu_set_t *pset)
+{
+  const size_t * words = (const size_t *) pset;
+  const unsigned char * bytes = (const unsigned char *) pset;
+  size_t nwords = setsize / sizeof (size_t);
+  size_t i;
+  int count = 0;
+
+  for (i = 0; i < nwords; i++)
     {
-	  if (tset & (size_t)1)
-	  	{
-		  count++;
-	  	}
+      count += ptw32_popcount (words[i]);
+    }
+  for (i = nwords * sizeof (size_t); i < setsize; i++)
+    {
+      count += ptw32_popcount ((size_t) bytes[i]);
     }
   return count;
 }
 
+void _sched_affinitycpuzero_s (size_t setsize, cpu_set_t *pset)
+{
+  memset (pset, 0, setsize);
+}
+
+void _sched_affinitycpuset_s (int cpu, size_t setsize, cpu_set_t *pset)
+{
+  if (cpu >= 0 && (size_t) cpu / 8 < setsize)
+    {
+      ((unsigned char *) pset)[cpu / 8] |= (unsigned char) (1 << (cpu % 8));
+    }
+}
+
+void _sched_affinitycpuclr_s (int cpu, size_t setsize, cpu_set_t *pset)
+{
+  if (cpu >= 0 && (size_t) cpu / 8 < setsize)
+    {
+      ((unsigned char *) pset)[cpu / 8] &= (unsigned char) ~(1 << (cpu % 8));
+    }
+}
+
+int _sched_affinitycpuisset_s (int cpu, size_t setsize, const cpu_set_t *pset)
+{
+  return (cpu >= 0 && (size_t) cpu / 8 < setsize
+	  && (((const unsigned char *) pset)[cpu / 8] & (1 << (cpu % 8))) != 0);
+}
+
+void _sched_affinitycpuand_s (size_t setsize, cpu_set_t *pdestset, const cpu_set_t *psrcset1, const cpu_set_t *psrcset2)
+{
+  size_t nwords = setsize / sizeof (size_t);
+  size_t i;
+
+  for (i = 0; i < nwords; i++)
+    {
+      ((size_t *) pdestset)[i] = ((const size_t *) psrcset1)[i] & ((const size_t *) psrcset2)[i];
+    }
+  for (i = nwords * sizeof (size_t); i < setsize; i++)
+    {
+      ((unsigned char *) pdestset)[i] = (unsigned char)
+	(((const unsigned char *) psrcset1)[i] & ((const unsigned char *) psrcset2)[i]);
+    }
+}
+
+void _sched_affinitycpuor_s (size_t setsize, cpu_set_t *pdestset, const cpu_set_t *psrcset1, const cpu_set_t *psrcset2)
+{
+  size_t nwords = setsize / sizeof (size_t);
+  size_t i;
+
+  for (i = 0; i < nwords; i++)
+    {
+      ((size_t *) pdestset)[i] = ((const size_t *) psrcset1)[i] | ((const size_t *) psrcset2)[i];
+    }
+  for (i = nwords * sizeof (size_t); i < setsize; i++)
+    {
+      ((unsigned char *) pdestset)[i] = (unsigned char)
+	(((const unsigned char *) psrcset1)[i] | ((const unsigned char *) psrcset2)[i]);
+    }
+}
+
+void _sched_affinitycpuxor_s (size_t setsize, cpu_set_t *pdestset, const cpu_set_t *psrcset1, const cpu_set_t *psrcset2)
+{
+  size_t nwords = setsize / sizeof (size_t);
+  size_t i;
+
+  for (i = 0; i < nwords; i++)
+    {
+      ((size_t *) pdestset)[i] = ((const size_t *) psrcset1)[i] ^ ((const size_t *) psrcset2)[i];
+    }
+  for (i = nwords * sizeof (size_t); i < setsize; i++)
+    {
+      ((unsigned char *) pdestset)[i] = (unsigned char)
+	(((const unsigned char *) psrcset1)[i] ^ ((const unsigned char *) psrcset2)[i]);
+    }
+}
+
+int _sched_affinitycpuequal_s (size_t setsize, const cpu_set_t *pset1, const cpu_set_t *pset2)
+{
+  return memcmp (pset1, pset2, setsize) == 0;
+}
+
+/*
+ * The single word routines used by applications built with earlier
+ * versions of sched.h.
+ */
+int _sched_affinitycpucount (const cpu_set_t *set)
+{
+  return ptw32_popcount (*(const size_t *) set);
+}
+
 void _sched_affinitycpuzero (cpu_set_t *pset)
 {
-	((_sched_cpu_set_vector_*)pset)->_cpuset = (size_t)0;
+	*(size_t *) pset = (size_t)0;
 }
 
 void _sched_affinitycpuset (int cpu, cpu_set_t *pset)
 {
-	((_sched_cpu_set_vector_*)pset)->_cpuset |= ((size_t)1 << cpu);
+	*(size_t *) pset |= ((size_t)1 << cpu);
 }
 
 void _sched_affinitycpuclr (int cpu, cpu_set_t *pset)
 {
-	((_sched_cpu_set_vector_*)pset)->_cpuset &= ~((size_t)1 << cpu);
+	*(size_t *) pset &= ~((size_t)1 << cpu);
 }
 
 int _sched_affinitycpuisset (int cpu, const cpu_set_t *pset)
 {
-	return ((((_sched_cpu_set_vector_*)pset)->_cpuset &
-			((size_t)1 << cpu)) != (size_t)0);
+	return ((*(const size_t *) pset & ((size_t)1 << cpu)) != (size_t)0);
 }
 
 void _sched_affinitycpuand(cpu_set_t *pdestset, const cpu_set_t *psrcset1, const cpu_set_t *psrcset2)
 {
-	((_sched_cpu_set_vector_*)pdestset)->_cpuset =
-			(((_sched_cpu_set_vector_*)psrcset1)->_cpuset &
-					((_sched_cpu_set_vector_*)psrcset2)->_cpuset);
+	*(size_t *) pdestset = (*(const size_t *) psrcset1 & *(const size_t *) psrcset2);
 }
 
 void _sched_affinitycpuor(cpu_set_t *pdestset, const cpu_set_t *psrcset1, const cpu_set_t *psrcset2)
 {
-	((_sched_cpu_set_vector_*)pdestset)->_cpuset =
-			(((_sched_cpu_set_vector_*)psrcset1)->_cpuset |
-					((_sched_cpu_set_vector_*)psrcset2)->_cpuset);
+	*(size_t *) pdestset = (*(const size_t *) psrcset1 | *(const size_t *) psrcset2);
 }
 
 void _sched_affinitycpuxor(cpu_set_t *pdestset, const cpu_set_t *psrcset1, const cpu_set_t *psrcset2)
 {
-	((_sched_cpu_set_vector_*)pdestset)->_cpuset =
-			(((_sched_cpu_set_vector_*)psrcset1)->_cpuset ^
-					((_sched_cpu_set_vector_*)psrcset2)->_cpuset);
+	*(size_t *) pdestset = (*(const size_t *) psrcset1 ^ *(const size_t *) psrcset2);
 }
 
 int _sched_affinitycpuequal (const cpu_set_t *pset1, const cpu_set_t *pset2)
 {
-  return (((_sched_cpu_set_vector_*)pset1)->_cpuset ==
-		  ((_sched_cpu_set_vector_*)pset2)->_cpuset);
+  return (*(const size_t *) pset1 == *(const size_t *) pset2);
 }
@@ -91,22 +91,19 @@ sem_destroy (sem_t * sem)
 
       if ((result = ptw32_mcs_lock_try_acquire(&s->lock, &node)) == 0)
         {
-          if (s->value < 0)
+          /*
+           * Threads that have been posted but haven't taken their
+           * wakeup yet are still inside sem_wait().
+           */
+          if (s->value < 0 || s->wakeups > 0)
             {
               result = EBUSY;
             }
-          else
-            {
-              /*
-               * There are no threads currently blocked on this semaphore
-               * however there could be threads about to wait behind us.
-               * It is up to the application to ensure this is not the case.
-               */
-              if (!CloseHandle (s->sem))
-                {
-                  result = EINVAL;
-                }
-            }
+          /*
+           * Otherwise there are no threads currently blocked on this
+           * semaphore however there could be threads about to wait behind
+           * us. It is up to the application to ensure this is not the case.
+           */
           ptw32_mcs_lock_release(&node);
         }
     }
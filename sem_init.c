@@ -116,39 +116,11 @@ sem_init (sem_t * sem, int pshared, unsigned int value)
           s->value = value;
           s->lock = NULL;
 
-#if defined(NEED_SEM)
-
-          s->sem = CreateEvent (NULL,
-              PTW32_FALSE,	/* auto (not manual) reset */
-              PTW32_FALSE,	/* initial state is unset */
-              NULL);
-
-          if (0 == s->sem)
-            {
-              free (s);
-              result = ENOSPC;
-            }
-          else
-            {
-              s->leftToUnblock = 0;
-            }
-
-#else /* NEED_SEM */
-
-          if ((s->sem = CreateSemaphore (NULL,	/* Always NULL */
-              (long) 0,	/* Force threads to wait */
-              (long) SEM_VALUE_MAX,	/* Maximum value */
-              NULL)) == 0)	/* Name */
-            {
-              result = ENOSPC;
-            }
-
-#endif /* NEED_SEM */
-
-          if (result != 0)
-            {
-              free(s);
-            }
+          /*
+           * Blocked threads wait on this address rather than on a
+           * Win32 semaphore. See ptw32_semwait.c.
+           */
+          s->wakeups = 0;
         }
     }
 
@@ -79,6 +79,7 @@ sem_post (sem_t * sem)
  */
 {
   int result = 0;
+  int wake = 0;
 
   ptw32_mcs_local_node_t node;
   sem_t s = *sem;
@@ -86,21 +87,12 @@ sem_post (sem_t * sem)
   ptw32_mcs_lock_acquire(&s->lock, &node);
   if (s->value < SEM_VALUE_MAX)
     {
-#if defined(NEED_SEM)
-      if (++s->value <= 0
-          && !SetEvent(s->sem))
+      if (++s->value <= 0)
         {
-          s->value--;
-          result = EINVAL;
+          /* Leave a wakeup for one of the waiters */
+          s->wakeups++;
+          wake = 1;
         }
-#else
-      if (++s->value <= 0
-          && !ReleaseSemaphore (s->sem, 1, NULL))
-        {
-          s->value--;
-          result = EINVAL;
-        }
-#endif /* NEED_SEM */
     }
   else
     {
@@ -108,6 +100,11 @@ sem_post (sem_t * sem)
     }
   ptw32_mcs_lock_release(&node);
 
+  if (wake)
+    {
+      (void) ptw32_wake_address (&s->wakeups, 1);
+    }
+
   if (result != 0)
     {
       PTW32_SET_ERRNO(result);
@@ -83,7 +83,7 @@ sem_post_multiple (sem_t * sem, int count)
 {
   ptw32_mcs_local_node_t node;
   int result = 0;
-  long waiters;
+  long waiters = 0;
   sem_t s = *sem;
 
   ptw32_mcs_lock_acquire(&s->lock, &node);
@@ -92,29 +92,14 @@ sem_post_multiple (sem_t * sem, int count)
     {
       waiters = -s->value;
       s->value += count;
+      if (waiters > count)
+        {
+          waiters = count;
+        }
       if (waiters > 0)
         {
-#if defined(NEED_SEM)
-          if (SetEvent(s->sem))
-            {
-              waiters--;
-              s->leftToUnblock += count - 1;
-              if (s->leftToUnblock > waiters)
-                {
-                  s->leftToUnblock = waiters;
-                }
-            }
-#else
-  if (ReleaseSemaphore (s->sem,  (waiters<=count)?waiters:count, 0))
-    {
-      /* No action */
-    }
-#endif
-  else
-    {
-      s->value -= count;
-      result = EINVAL;
-    }
+          /* Leave a wakeup for each waiter that can proceed */
+          s->wakeups += waiters;
         }
     }
   else
@@ -123,6 +108,11 @@ sem_post_multiple (sem_t * sem, int count)
     }
   ptw32_mcs_lock_release(&node);
 
+  if (waiters > 0)
+    {
+      (void) ptw32_wake_address (&s->wakeups, (int) waiters);
+    }
+
   if (result != 0)
     {
       PTW32_SET_ERRNO(result);
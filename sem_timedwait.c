@@ -51,53 +51,6 @@
 #include "implement.h"
 
 
-typedef struct {
-  sem_t sem;
-  int * resultPtr;
-} sem_timedwait_cleanup_args_t;
-
-
-static void PTW32_CDECL
-ptw32_sem_timedwait_cleanup (void * args)
-{
-  ptw32_mcs_local_node_t node;
-  sem_timedwait_cleanup_args_t * a = (sem_timedwait_cleanup_args_t *)args;
-  sem_t s = a->sem;
-
-  ptw32_mcs_lock_acquire(&s->lock, &node);
-  /*
-   * We either timed out or were cancelled.
-   * If someone has posted between then and now we try to take the semaphore.
-   * Otherwise the semaphore count may be wrong after we
-   * return. In the case of a cancellation, it is as if we
-   * were cancelled just before we return (after taking the semaphore)
-   * which is ok.
-   */
-  if (WaitForSingleObject(s->sem, 0) == WAIT_OBJECT_0)
-    {
-      /* We got the semaphore on the second attempt */
-      *(a->resultPtr) = 0;
-    }
-  else
-    {
-      /* Indicate we're no longer waiting */
-      s->value++;
-#if defined(NEED_SEM)
-      if (s->value > 0)
-        {
-          s->leftToUnblock = 0;
-        }
-#else
-      /*
-       * Don't release the W32 sema, it doesn't need adjustment
-       * because it doesn't record the number of waiters.
-       */
-#endif
-    }
-  ptw32_mcs_lock_release(&node);
-}
-
-
 int
 sem_timedwait (sem_t * sem, const struct timespec *abstime)
 /*
@@ -133,74 +86,34 @@ sem_timedwait (sem_t * sem, const struct timespec *abstime)
  *              ENOSYS          semaphores are not supported,
  *              EINTR           the function was interrupted by a signal,
  *              EDEADLK         a deadlock condition was detected.
+ *              ENOSPC          a required resource has been exhausted.
  *              ETIMEDOUT       abstime elapsed before success.
  *
  * ------------------------------------------------------
  */
 {
   ptw32_mcs_local_node_t node;
-  DWORD milliseconds;
   int v;
   int result = 0;
   sem_t s = *sem;
 
   pthread_testcancel();
 
-  if (abstime == NULL)
-    {
-      milliseconds = INFINITE;
-    }
-  else
-    {
-      /*
-       * Calculate timeout as milliseconds from current system time.
-       */
-      milliseconds = ptw32_relmillisecs (abstime);
-    }
-
   ptw32_mcs_lock_acquire(&s->lock, &node);
   v = --s->value;
   ptw32_mcs_lock_release(&node);
 
   if (v < 0)
     {
-#if defined(NEED_SEM)
-      int timedout;
-#endif
-      sem_timedwait_cleanup_args_t cleanup_args;
-
-      cleanup_args.sem = s;
-      cleanup_args.resultPtr = &result;
-
-#if defined(PTW32_CONFIG_MSVC7)
-#pragma inline_depth(0)
-#endif
       /* Must wait */
-      pthread_cleanup_push(ptw32_sem_timedwait_cleanup, (void *) &cleanup_args);
-#if defined(NEED_SEM)
-      timedout =
-#endif
-          result = pthreadCancelableTimedWait (s->sem, milliseconds);
-      pthread_cleanup_pop(result);
-#if defined(PTW32_CONFIG_MSVC7)
-#pragma inline_depth()
-#endif
-
-#if defined(NEED_SEM)
-
-      if (!timedout)
+      if (EINTR == (result = ptw32_sem_block (s, abstime, PTW32_TRUE)))
         {
-          ptw32_mcs_lock_acquire(&s->lock, &node);
-          if (s->leftToUnblock > 0)
-            {
-              --s->leftToUnblock;
-              SetEvent(s->sem);
-            }
-          ptw32_mcs_lock_release(&node);
+          /*
+           * We are no longer counted as a waiter, so the
+           * semaphore needs no cleanup if this doesn't return.
+           */
+          pthread_testcancel();
         }
-
-#endif /* NEED_SEM */
-
     }
 
   if (result != 0)
@@ -51,38 +51,6 @@
 #include "implement.h"
 
 
-static void PTW32_CDECL
-ptw32_sem_wait_cleanup(void * sem)
-{
-  sem_t s = (sem_t) sem;
-  ptw32_mcs_local_node_t node;
-
-  ptw32_mcs_lock_acquire(&s->lock, &node);
-  /*
-   * If sema is destroyed do nothing, otherwise:-
-   * If the sema is posted between us being canceled and us locking
-   * the sema again above then we need to consume that post but cancel
-   * anyway. If we don't get the semaphore we indicate that we're no
-   * longer waiting.
-   */
-  if (*((sem_t *)sem) != NULL && !(WaitForSingleObject(s->sem, 0) == WAIT_OBJECT_0))
-    {
-      ++s->value;
-#if defined(NEED_SEM)
-      if (s->value > 0)
-        {
-          s->leftToUnblock = 0;
-        }
-#else
-      /*
-       * Don't release the W32 sema, it doesn't need adjustment
-       * because it doesn't record the number of waiters.
-       */
-#endif /* NEED_SEM */
-    }
-  ptw32_mcs_lock_release(&node);
-}
-
 int
 sem_wait (sem_t * sem)
 /*
@@ -110,6 +78,7 @@ sem_wait (sem_t * sem)
  *              ENOSYS          semaphores are not supported,
  *              EINTR           the function was interrupted by a signal,
  *              EDEADLK         a deadlock condition was detected.
+ *              ENOSPC          a required resource has been exhausted.
  *
  * ------------------------------------------------------
  */
@@ -127,34 +96,17 @@ sem_wait (sem_t * sem)
 
   if (v < 0)
     {
-#if defined(PTW32_CONFIG_MSVC7)
-#pragma inline_depth(0)
-#endif
       /* Must wait */
-      pthread_cleanup_push(ptw32_sem_wait_cleanup, (void *) s);
-      result = pthreadCancelableWait (s->sem);
-      /* Cleanup if we're canceled or on any other error */
-      pthread_cleanup_pop(result);
-#if defined(PTW32_CONFIG_MSVC7)
-#pragma inline_depth()
-#endif
-    }
-#if defined(NEED_SEM)
-
-  if (!result)
-    {
-      ptw32_mcs_lock_acquire(&s->lock, &node);
-
-      if (s->leftToUnblock > 0)
+      if (EINTR == (result = ptw32_sem_block (s, NULL, PTW32_TRUE)))
         {
-          --s->leftToUnblock;
-          SetEvent(s->sem);
+          /*
+           * We are no longer counted as a waiter, so the
+           * semaphore needs no cleanup if this doesn't return.
+           */
+          pthread_testcancel();
         }
-      ptw32_mcs_lock_release(&node);
     }
 
-#endif /* NEED_SEM */
-
   if (result != 0)
     {
       PTW32_SET_ERRNO(result);
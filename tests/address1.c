@@ -0,0 +1,146 @@
+/* 
+ * address1.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test waiting on and waking an address.
+ *
+ * - a wait on a value that has changed returns at once;
+ * - a wait times out at abstime;
+ * - a wake with no waiters wakes nobody;
+ * - a wake of 1 wakes exactly one of several waiters and a wake
+ *   of INT_MAX wakes the rest;
+ * - waiters on different addresses that share a wait queue are
+ *   woken independently.
+ *
+ * Depends on API functions:
+ *	pthread_wait_on_address_np()
+ *	pthread_wake_address_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+#include <limits.h>
+#include <sys/timeb.h>
+
+enum {
+  NUMTHREADS = 3
+};
+
+/*
+ * 16KB apart, so that they share a wait queue (see PTW32_WAIT_BUCKET
+ * in implement.h).
+ */
+static int words[2 * 16384 / sizeof(int)];
+#define WORD0 (&words[0])
+#define WORD1 (&words[16384 / sizeof(int)])
+
+static long woken = 0;
+
+void *
+waiter(void * arg)
+{
+  volatile int * word = (volatile int *) arg;
+
+  while (*word == 0)
+    {
+      assert(pthread_wait_on_address_np(word, 0, NULL) == 0);
+    }
+  InterlockedIncrement((LPLONG)&woken);
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_t other;
+  PTW32_STRUCT_TIMEB currSysTime;
+  struct timespec abstime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+  long start;
+  long elapsed;
+  int i;
+
+  assert(pthread_wait_on_address_np(NULL, 0, NULL) == EINVAL);
+  assert(pthread_wake_address_np(NULL, 1) == 0);
+
+  /*
+   * Value differs.
+   */
+  *WORD0 = 1;
+  assert(pthread_wait_on_address_np(WORD0, 0, NULL) == 0);
+  *WORD0 = 0;
+
+  /*
+   * Timeout.
+   */
+  PTW32_FTIME(&currSysTime);
+  start = (long)(currSysTime.time * 1000 + currSysTime.millitm);
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+  abstime.tv_sec += 1;
+  while (pthread_wait_on_address_np(WORD0, 0, &abstime) == 0)
+    {
+      /* Spurious returns are allowed */
+    }
+  PTW32_FTIME(&currSysTime);
+  elapsed = (long)(currSysTime.time * 1000 + currSysTime.millitm) - start;
+  assert(elapsed >= 900);
+
+  assert(pthread_wake_address_np(WORD0, INT_MAX) == 0);
+
+  /*
+   * Wake one, then the rest, leaving the waiter on WORD1 alone.
+   */
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, waiter, (void *) WORD0) == 0);
+    }
+  assert(pthread_create(&other, NULL, waiter, (void *) WORD1) == 0);
+
+  Sleep(500);
+  assert(woken == 0);
+
+  InterlockedExchange((LPLONG)WORD0, 1L);
+  assert(pthread_wake_address_np(WORD0, 1) == 1);
+  Sleep(500);
+  assert(woken == 1);
+
+  assert(pthread_wake_address_np(WORD0, INT_MAX) == NUMTHREADS - 1);
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  assert(woken == NUMTHREADS);
+
+  InterlockedExchange((LPLONG)WORD1, 1L);
+  assert(pthread_wake_address_np(WORD1, INT_MAX) == 1);
+  assert(pthread_join(other, NULL) == 0);
+  assert(woken == NUMTHREADS + 1);
+
+  return 0;
+}
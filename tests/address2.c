@@ -0,0 +1,112 @@
+/* 
+ * address2.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Build a lock from pthread_wait_on_address_np() and
+ * pthread_wake_address_np() and check that it excludes.
+ *
+ * The lock word is 0 when free, 1 when held and -1 when held with
+ * possible waiters. Unlock only wakes a waiter if the word was -1.
+ *
+ * Depends on API functions:
+ *	pthread_wait_on_address_np()
+ *	pthread_wake_address_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  NUMTHREADS = 8,
+  ITERATIONS = 50000
+};
+
+static int lockWord = 0;
+static long inside = 0;
+static long counter = 0;
+
+static void
+lock(void)
+{
+  if (InterlockedExchange((LPLONG)&lockWord, 1L) != 0)
+    {
+      while (InterlockedExchange((LPLONG)&lockWord, -1L) != 0)
+        {
+          assert(pthread_wait_on_address_np(&lockWord, -1, NULL) == 0);
+        }
+    }
+}
+
+static void
+unlock(void)
+{
+  if (InterlockedExchange((LPLONG)&lockWord, 0L) < 0)
+    {
+      (void) pthread_wake_address_np(&lockWord, 1);
+    }
+}
+
+void *
+worker(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      lock();
+      assert(InterlockedIncrement((LPLONG)&inside) == 1);
+      counter++;
+      if (i % 1000 == 0)
+        {
+          Sleep(0);
+        }
+      assert(InterlockedDecrement((LPLONG)&inside) == 0);
+      unlock();
+    }
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  int i;
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, NULL) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(counter == (long) NUMTHREADS * ITERATIONS);
+  assert(lockWord == 0);
+
+  return 0;
+}
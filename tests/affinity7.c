@@ -0,0 +1,217 @@
+/*
+ * affinity7.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Test CPU sets wider than one word: CPU_ALLOC() and the CPU_*_S()
+ * macros, cpusetsize in the affinity calls, and the single word
+ * routines kept for applications built with earlier headers.
+ *
+ */
+
+#if ! defined(WINCE)
+
+#include "test.h"
+
+#define BIGSETSIZE 2048
+
+int
+main()
+{
+  int cpu;
+  size_t size;
+  size_t oddSize = 13;
+  cpu_set_t mask;
+  cpu_set_t other;
+  cpu_set_t * big1;
+  cpu_set_t * big2;
+  cpu_set_t * big3;
+  pthread_attr_t attr;
+  pthread_t self = pthread_self();
+
+  /*
+   * CPUs past the first word.
+   */
+  CPU_ZERO(&mask);
+  CPU_SET(100, &mask);
+  CPU_SET(CPU_SETSIZE - 1, &mask);
+  assert(CPU_COUNT(&mask) == 2);
+  assert(CPU_ISSET(100, &mask));
+  assert(!CPU_ISSET(36, &mask));
+  CPU_CLR(100, &mask);
+  assert(!CPU_ISSET(100, &mask));
+  assert(CPU_ISSET(CPU_SETSIZE - 1, &mask));
+
+  /*
+   * Out of range CPUs are ignored.
+   */
+  CPU_SET(CPU_SETSIZE, &mask);
+  CPU_SET(-1, &mask);
+  assert(CPU_COUNT(&mask) == 1);
+  assert(!CPU_ISSET(CPU_SETSIZE, &mask));
+
+  /*
+   * Allocated sets larger than cpu_set_t.
+   */
+  size = CPU_ALLOC_SIZE(BIGSETSIZE);
+  assert(size >= BIGSETSIZE / 8);
+  assert(size % sizeof(size_t) == 0);
+  assert((big1 = CPU_ALLOC(BIGSETSIZE)) != NULL);
+  assert((big2 = CPU_ALLOC(BIGSETSIZE)) != NULL);
+  assert((big3 = CPU_ALLOC(BIGSETSIZE)) != NULL);
+
+  CPU_ZERO_S(size, big1);
+  CPU_ZERO_S(size, big2);
+  assert(CPU_COUNT_S(size, big1) == 0);
+  assert(CPU_EQUAL_S(size, big1, big2));
+
+  for (cpu = 0; cpu < BIGSETSIZE; cpu += 3)
+    {
+      CPU_SET_S(cpu, size, big1);
+    }
+  for (cpu = 0; cpu < BIGSETSIZE; cpu += 2)
+    {
+      CPU_SET_S(cpu, size, big2);
+    }
+  assert(CPU_COUNT_S(size, big1) == (BIGSETSIZE + 2) / 3);
+  assert(CPU_COUNT_S(size, big2) == BIGSETSIZE / 2);
+  assert(CPU_ISSET_S(BIGSETSIZE - 2, size, big2));
+  assert(!CPU_ISSET_S(BIGSETSIZE - 1, size, big2));
+  assert(!CPU_EQUAL_S(size, big1, big2));
+
+  CPU_AND_S(size, big3, big1, big2);
+  assert(CPU_COUNT_S(size, big3) == (BIGSETSIZE + 5) / 6);
+  for (cpu = 0; cpu < BIGSETSIZE; cpu++)
+    {
+      assert((CPU_ISSET_S(cpu, size, big3) != 0) == (cpu % 6 == 0));
+    }
+  CPU_OR_S(size, big3, big1, big2);
+  assert(CPU_COUNT_S(size, big3)
+         == (BIGSETSIZE + 2) / 3 + BIGSETSIZE / 2 - (BIGSETSIZE + 5) / 6);
+  CPU_XOR_S(size, big3, big1, big1);
+  assert(CPU_COUNT_S(size, big3) == 0);
+  CPU_CLR_S(0, size, big1);
+  assert(!CPU_ISSET_S(0, size, big1));
+  assert(CPU_COUNT_S(size, big1) == (BIGSETSIZE + 2) / 3 - 1);
+
+  /*
+   * A size that isn't a whole number of words.
+   */
+  CPU_ZERO_S(size, big1);
+  CPU_ZERO_S(size, big2);
+  CPU_SET_S(oddSize * 8 - 1, oddSize, big1);
+  CPU_SET_S(oddSize * 8, oddSize, big1);
+  CPU_SET_S(3, oddSize, big2);
+  assert(CPU_COUNT_S(oddSize, big1) == 1);
+  assert(CPU_COUNT_S(size, big1) == 1);
+  CPU_OR_S(oddSize, big3, big1, big2);
+  assert(CPU_COUNT_S(oddSize, big3) == 2);
+  assert(CPU_ISSET_S(oddSize * 8 - 1, oddSize, big3));
+  assert(!CPU_EQUAL_S(oddSize, big1, big3));
+  CPU_CLR_S(3, oddSize, big3);
+  assert(CPU_EQUAL_S(oddSize, big1, big3));
+
+  /*
+   * The single word routines.
+   */
+  CPU_ZERO(&mask);
+  CPU_ZERO(&other);
+  _sched_affinitycpuset(5, &mask);
+  _sched_affinitycpuset(40, &mask);
+  assert(_sched_affinitycpucount(&mask) == 2);
+  assert(_sched_affinitycpuisset(5, &mask));
+  assert(CPU_ISSET(5, &mask));
+  _sched_affinitycpuclr(5, &mask);
+  assert(!_sched_affinitycpuisset(5, &mask));
+  _sched_affinitycpuor(&other, &other, &mask);
+  assert(_sched_affinitycpuequal(&other, &mask));
+  _sched_affinitycpuxor(&other, &other, &mask);
+  assert(_sched_affinitycpucount(&other) == 0);
+
+  /*
+   * The process and thread calls fill in, and accept, sets of any
+   * size that holds their CPUs.
+   */
+  CPU_ZERO(&mask);
+  assert(sched_getaffinity(0, sizeof(cpu_set_t), &mask) == 0);
+  assert(CPU_COUNT(&mask) == pthread_num_processors_np());
+  assert(sched_getaffinity(0, size, big1) == 0);
+  assert(CPU_COUNT_S(size, big1) == CPU_COUNT(&mask));
+  assert(sched_getaffinity(0, 0, big1) == -1);
+  assert(errno == EINVAL);
+
+  assert(pthread_setaffinity_np(self, size, big1) == 0);
+  assert(pthread_getaffinity_np(self, size, big2) == 0);
+  assert(CPU_EQUAL_S(size, big1, big2));
+  assert(pthread_getaffinity_np(self, 0, big2) == EINVAL);
+  CPU_ZERO_S(size, big2);
+  CPU_SET_S(BIGSETSIZE - 1, size, big2);
+  assert(pthread_setaffinity_np(self, size, big2) == EINVAL);
+  assert(pthread_setaffinity_np(self, sizeof(cpu_set_t), &mask) == 0);
+
+  /*
+   * Attribute sets keep CPU_SETSIZE CPUs.
+   */
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_setaffinity_np(&attr, size, big1) == 0);
+  assert(pthread_attr_getaffinity_np(&attr, sizeof(cpu_set_t), &other) == 0);
+  assert(CPU_EQUAL(&other, &mask));
+  assert(pthread_attr_setaffinity_np(&attr, size, big2) == EINVAL);
+  CPU_ZERO(&other);
+  CPU_SET(CPU_SETSIZE - 1, &other);
+  assert(pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &other) == 0);
+  assert(pthread_attr_getaffinity_np(&attr, sizeof(size_t), big3) == EINVAL);
+  assert(pthread_attr_getaffinity_np(&attr, size, big3) == 0);
+  assert(CPU_COUNT_S(size, big3) == 1);
+  assert(CPU_ISSET_S(CPU_SETSIZE - 1, size, big3));
+  assert(pthread_attr_destroy(&attr) == 0);
+
+  CPU_FREE(big1);
+  CPU_FREE(big2);
+  CPU_FREE(big3);
+
+  return 0;
+}
+
+#else
+
+#include <stdio.h>
+
+int
+main()
+{
+  fprintf(stderr, "Test N/A for this target environment.\n");
+  return 0;
+}
+
+#endif
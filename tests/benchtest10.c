@@ -0,0 +1,161 @@
+/*
+ * benchtest10.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure read throughput as readers are added.
+ *
+ * - Default versus big-reader rwlock
+ *   1 to all processors run reader threads that each take and release
+ *   a read lock READS times. There is no writer. Run once with a
+ *   PTHREAD_RWLOCK_DEFAULT_NP rwlock and once with a
+ *   PTHREAD_RWLOCK_BIGREADER_NP rwlock.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define READS           1000000L
+#define MAXTHREADS      64
+
+pthread_rwlock_t rwlock;
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+int nThreads;
+volatile long shared = 1;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+void *
+reader (void * arg)
+{
+  long sum = 0;
+  long i;
+
+  for (i = 0; i < READS; i++)
+    {
+      assert(pthread_rwlock_rdlock(&rwlock) == 0);
+      sum += shared;
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) sum;
+}
+
+long
+runTest (int kind)
+{
+  pthread_rwlockattr_t rwa;
+  pthread_t t[MAXTHREADS];
+  int i;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_setkind_np(&rwa, kind) == 0);
+  assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_create(&t[i], NULL, reader, NULL) == 0);
+    }
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  long df, br;
+  int cpus = pthread_num_processors_np();
+
+  if (cpus > MAXTHREADS)
+    {
+      cpus = MAXTHREADS;
+    }
+
+  printf( "=============================================================================\n");
+  printf( "\nRead-only rwlock: %ld reads per thread, %d processors.\n\n",
+          READS, pthread_num_processors_np());
+  printf( "%-10s %15s %15s %15s %15s\n",
+	    "Threads",
+	    "default(msec)",
+	    "reads/usec",
+	    "bigreader(msec)",
+	    "reads/usec");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (nThreads = 1; ; nThreads *= 2)
+    {
+      if (nThreads > cpus)
+        {
+          nThreads = cpus;
+        }
+
+      df = runTest(PTHREAD_RWLOCK_DEFAULT_NP);
+      br = runTest(PTHREAD_RWLOCK_BIGREADER_NP);
+
+      printf( "%-10d %15ld %15.3f %15ld %15.3f\n",
+              nThreads,
+              df, (float) READS * nThreads / 1E3 / (df > 0 ? df : 1),
+              br, (float) READS * nThreads / 1E3 / (br > 0 ? br : 1));
+
+      if (nThreads == cpus)
+        {
+          break;
+        }
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
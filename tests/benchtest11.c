@@ -0,0 +1,167 @@
+/*
+ * benchtest11.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure rwlock throughput under mixed loads for each kind.
+ *
+ * - Default versus PREFER_READER, PREFER_WRITER and
+ *   PREFER_WRITER_NONRECURSIVE rwlocks
+ *   THREADS threads each perform OPERATIONS operations on a shared
+ *   structure, of which a given percentage are writes. Reads take a
+ *   read lock and sum the structure; writes take the write lock and
+ *   update it.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define OPERATIONS      200000L
+#define THREADS         8
+
+pthread_rwlock_t rwlock;
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+int writePercent;
+
+struct {
+  long a;
+  long b;
+  long c;
+  long d;
+} stats;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+void *
+worker (void * arg)
+{
+  unsigned int seed = (unsigned int)(size_t) arg;
+  long sum = 0;
+  long i;
+
+  for (i = 0; i < OPERATIONS; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+
+      if ((int)((seed >> 16) % 100) < writePercent)
+        {
+          assert(pthread_rwlock_wrlock(&rwlock) == 0);
+          stats.a++; stats.b++; stats.c++; stats.d++;
+          assert(pthread_rwlock_unlock(&rwlock) == 0);
+        }
+      else
+        {
+          assert(pthread_rwlock_rdlock(&rwlock) == 0);
+          sum += stats.a + stats.b + stats.c + stats.d;
+          assert(pthread_rwlock_unlock(&rwlock) == 0);
+        }
+    }
+
+  return (void *)(size_t) sum;
+}
+
+long
+runTest (int kind)
+{
+  pthread_rwlockattr_t rwa;
+  pthread_t t[THREADS];
+  int i;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_setkind_np(&rwa, kind) == 0);
+  assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < THREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, (void *)(size_t) (i + 1)) == 0);
+    }
+  for (i = 0; i < THREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  static const int percent[] = { 0, 1, 10, 50 };
+  int i;
+
+  printf( "=============================================================================\n");
+  printf( "\nMixed rwlock load: %d threads, %ld operations per thread.\n",
+          THREADS, OPERATIONS);
+  printf( "Times in msec.\n\n");
+  printf( "%-10s %15s %15s %15s %15s\n",
+	    "Writes(%)",
+	    "default",
+	    "prefer-reader",
+	    "prefer-writer",
+	    "writer-nonrec");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (i = 0; i < (int)(sizeof(percent)/sizeof(percent[0])); i++)
+    {
+      writePercent = percent[i];
+
+      printf( "%-10d %15ld %15ld %15ld %15ld\n",
+              writePercent,
+              runTest(PTHREAD_RWLOCK_DEFAULT_NP),
+              runTest(PTHREAD_RWLOCK_PREFER_READER_NP),
+              runTest(PTHREAD_RWLOCK_PREFER_WRITER_NP),
+              runTest(PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP));
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
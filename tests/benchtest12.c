@@ -0,0 +1,184 @@
+/*
+ * benchtest12.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure a read-mostly cache fill path with and without
+ * pthread_rwlock_upgrade_np().
+ *
+ * - Unlock and relock versus upgrade
+ *   THREADS threads each look up OPERATIONS entries of a small table
+ *   under a read lock. One lookup in MISSRATE finds the entry stale
+ *   and must refill it under the write lock. Either the reader
+ *   unlocks, takes the write lock and checks the entry again, or it
+ *   upgrades its read lock (falling back to relocking if another
+ *   thread is already upgrading). Run for the default and
+ *   PREFER_WRITER_NONRECURSIVE rwlock kinds.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define OPERATIONS      200000L
+#define THREADS         4
+#define ENTRIES         64
+#define MISSRATE        20
+
+pthread_rwlock_t rwlock;
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+int useUpgrade;
+
+struct {
+  long key;
+  long value;
+} table[ENTRIES];
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+static void
+fill (int i, long key)
+{
+  table[i].key = key;
+  table[i].value = key * 2;
+}
+
+void *
+worker (void * arg)
+{
+  unsigned int seed = (unsigned int)(size_t) arg;
+  long sum = 0;
+  long key;
+  long i;
+  int e;
+
+  for (i = 0; i < OPERATIONS; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      e = (int)((seed >> 16) % ENTRIES);
+      key = ((seed >> 8) % MISSRATE == 0) ? (long)(seed >> 4) : table[e].key;
+
+      assert(pthread_rwlock_rdlock(&rwlock) == 0);
+
+      if (table[e].key != key)
+        {
+          if (useUpgrade && pthread_rwlock_upgrade_np(&rwlock) == 0)
+            {
+              fill(e, key);
+            }
+          else
+            {
+              assert(pthread_rwlock_unlock(&rwlock) == 0);
+              assert(pthread_rwlock_wrlock(&rwlock) == 0);
+              if (table[e].key != key)
+                {
+                  fill(e, key);
+                }
+            }
+        }
+
+      sum += table[e].value;
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) sum;
+}
+
+long
+runTest (int kind, int upgrade)
+{
+  pthread_rwlockattr_t rwa;
+  pthread_t t[THREADS];
+  int i;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_setkind_np(&rwa, kind) == 0);
+  assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+  useUpgrade = upgrade;
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < THREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, (void *)(size_t) (i + 1)) == 0);
+    }
+  for (i = 0; i < THREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  printf( "=============================================================================\n");
+  printf( "\nCache fill: %d threads, %ld lookups per thread, 1 in %d misses.\n",
+          THREADS, OPERATIONS, MISSRATE);
+  printf( "Times in msec.\n\n");
+  printf( "%-30s %15s %15s\n",
+	    "Kind",
+	    "relock",
+	    "upgrade");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  printf( "%-30s %15ld %15ld\n",
+          "PTHREAD_RWLOCK_DEFAULT_NP",
+          runTest(PTHREAD_RWLOCK_DEFAULT_NP, 0),
+          runTest(PTHREAD_RWLOCK_DEFAULT_NP, 1));
+  printf( "%-30s %15ld %15ld\n",
+          "PREFER_WRITER_NONRECURSIVE",
+          runTest(PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP, 0),
+          runTest(PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP, 1));
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
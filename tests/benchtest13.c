@@ -0,0 +1,175 @@
+/*
+ * benchtest13.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure condition variable wakeup latency.
+ *
+ * - Ping-pong
+ *   Two threads pass a token back and forth ROUNDS times, each waiting
+ *   on its own condition variable until the token arrives. The threads
+ *   are pinned either to two different processors or both to the same
+ *   one. Waiters spin briefly before blocking on multiprocessors (see
+ *   PTW32_COND_SPIN in implement.h); rebuild the library with
+ *   PTW32_COND_SPIN defined as 0 to compare.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ROUNDS          100000L
+
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t cv[2] = {PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER};
+int turn;
+cpu_set_t pin[2];
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+void *
+player (void * arg)
+{
+  int me = (int)(size_t) arg;
+  long i;
+
+  (void) pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &pin[me]);
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  for (i = 0; i < ROUNDS; i++)
+    {
+      while (turn != me)
+        {
+          assert(pthread_cond_wait(&cv[me], &mutex) == 0);
+        }
+      turn = 1 - me;
+      assert(pthread_cond_signal(&cv[1 - me]) == 0);
+    }
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return NULL;
+}
+
+long
+runTest (void)
+{
+  pthread_t t[2];
+
+  turn = 0;
+
+  PTW32_FTIME(&currSysTimeStart);
+  assert(pthread_create(&t[0], NULL, player, (void *) 0) == 0);
+  assert(pthread_create(&t[1], NULL, player, (void *) 1) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_join(t[1], NULL) == 0);
+  PTW32_FTIME(&currSysTimeStop);
+
+  return GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  cpu_set_t processCpus;
+  int first = -1;
+  int second = -1;
+  int cpu;
+
+  CPU_ZERO(&processCpus);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &processCpus) != 0)
+    {
+      CPU_SET(0, &processCpus);
+    }
+
+  for (cpu = 0; cpu < (int) sizeof(cpu_set_t)*8; cpu++)
+    {
+      if (CPU_ISSET(cpu, &processCpus))
+        {
+          if (first < 0)
+            {
+              first = cpu;
+            }
+          else if (second < 0)
+            {
+              second = cpu;
+            }
+        }
+    }
+
+  printf( "=============================================================================\n");
+  printf( "\nCondition variable ping-pong: %ld round trips.\n", ROUNDS);
+  printf( "Times in msec.\n\n");
+  printf( "%-45s %15s\n",
+	    "Test",
+	    "Total(msec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  if (second >= 0)
+    {
+      CPU_ZERO(&pin[0]);
+      CPU_SET(first, &pin[0]);
+      CPU_ZERO(&pin[1]);
+      CPU_SET(second, &pin[1]);
+      printf( "%-45s %15ld\n",
+              "Threads on two processors",
+              runTest());
+    }
+
+  CPU_ZERO(&pin[0]);
+  CPU_SET(first, &pin[0]);
+  pin[1] = pin[0];
+  printf( "%-45s %15ld\n",
+          "Threads on one processor",
+          runTest());
+
+  printf( "=============================================================================\n");
+
+  assert(pthread_cond_destroy(&cv[0]) == 0);
+  assert(pthread_cond_destroy(&cv[1]) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
@@ -0,0 +1,222 @@
+/*
+ * benchtest14.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure condition variable create/destroy scaling and the cost of
+ * pthread_timechange_handler_np() with many idle condition variables.
+ *
+ * - Create/destroy
+ *   1 to all processors' worth of threads each initialise BATCH
+ *   condition variables and then destroy them, ROUNDS times.
+ *
+ * - Time change
+ *   IDLE condition variables exist but only one has a (timed) waiter
+ *   when pthread_timechange_handler_np() is called.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define BATCH           1000
+#define ROUNDS          100
+#define MAXTHREADS      64
+#define IDLE            10000
+
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+int nThreads;
+
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t idle[IDLE];
+int waiting = 0;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+void *
+churn (void * arg)
+{
+  pthread_cond_t cv[BATCH];
+  int r, i;
+
+  for (r = 0; r < ROUNDS; r++)
+    {
+      for (i = 0; i < BATCH; i++)
+        {
+          assert(pthread_cond_init(&cv[i], NULL) == 0);
+        }
+      for (i = 0; i < BATCH; i++)
+        {
+          assert(pthread_cond_destroy(&cv[i]) == 0);
+        }
+    }
+
+  return NULL;
+}
+
+long
+runTest (void)
+{
+  pthread_t t[MAXTHREADS];
+  int i;
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_create(&t[i], NULL, churn, NULL) == 0);
+    }
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  return GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+}
+
+void *
+timedWaiter (void * arg)
+{
+  struct timespec abstime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+  PTW32_STRUCT_TIMEB currSysTime;
+
+  PTW32_FTIME(&currSysTime);
+  abstime.tv_sec = (long)currSysTime.time + 60;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  waiting = 1;
+  while (waiting)
+    {
+      assert(pthread_cond_timedwait(&idle[0], &mutex, &abstime) == 0);
+    }
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return NULL;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  long ms;
+  int cpus = pthread_num_processors_np();
+  int i;
+  pthread_t t;
+
+  if (cpus > MAXTHREADS)
+    {
+      cpus = MAXTHREADS;
+    }
+
+  printf( "=============================================================================\n");
+  printf( "\nCondition variable create/destroy: %d per batch, %d batches per thread.\n\n",
+          BATCH, ROUNDS);
+  printf( "%-10s %15s %15s\n",
+	    "Threads",
+	    "Total(msec)",
+	    "pairs/msec");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (nThreads = 1; ; nThreads *= 2)
+    {
+      if (nThreads > cpus)
+        {
+          nThreads = cpus;
+        }
+
+      ms = runTest();
+
+      printf( "%-10d %15ld %15.3f\n",
+              nThreads,
+              ms, (float) BATCH * ROUNDS * nThreads / (ms > 0 ? ms : 1));
+
+      if (nThreads == cpus)
+        {
+          break;
+        }
+    }
+
+  for (i = 0; i < IDLE; i++)
+    {
+      assert(pthread_cond_init(&idle[i], NULL) == 0);
+    }
+
+  assert(pthread_create(&t, NULL, timedWaiter, NULL) == 0);
+  do
+    {
+      Sleep(1);
+      assert(pthread_mutex_lock(&mutex) == 0);
+      i = waiting;
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+  while (!i);
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < 1000; i++)
+    {
+      assert(pthread_timechange_handler_np(NULL) == NULL);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  printf( "\n%-45s %15ld\n",
+          "1000 time changes, 1 busy CV (msec)",
+          GetDurationMilliSecs(currSysTimeStart, currSysTimeStop));
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  waiting = 0;
+  assert(pthread_cond_signal(&idle[0]) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  for (i = 0; i < IDLE; i++)
+    {
+      assert(pthread_cond_destroy(&idle[i]) == 0);
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
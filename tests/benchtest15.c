@@ -0,0 +1,210 @@
+/*
+ * benchtest15.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure the cost of creating and destroying sync objects and the
+ * kernel handles they hold while nobody has waited on them.
+ *
+ * - Create/destroy
+ *   Initialise and destroy OBJECTS objects of each type, ROUNDS times,
+ *   and report the process handle count with all OBJECTS in existence.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define OBJECTS         10000
+#define ROUNDS          10
+
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+
+typedef BOOL (WINAPI *handleCount_t) (HANDLE, LPDWORD);
+handleCount_t handleCount;
+
+union {
+  pthread_mutex_t mx[OBJECTS];
+  pthread_cond_t cv[OBJECTS];
+  pthread_rwlock_t rwl[OBJECTS];
+  sem_t sem[OBJECTS];
+} objects;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+enum {
+  MUTEX,
+  COND,
+  RWLOCK,
+  RWLOCK_PREFER,
+  SEMAPHORE
+};
+
+static long
+handles (void)
+{
+  DWORD n = 0;
+
+  if (handleCount == NULL || !handleCount (GetCurrentProcess (), &n))
+    {
+      return -1;
+    }
+
+  return (long) n;
+}
+
+static void
+create (int type)
+{
+  pthread_rwlockattr_t rwa;
+  int i;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_setkind_np(&rwa, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP) == 0);
+
+  for (i = 0; i < OBJECTS; i++)
+    {
+      switch (type)
+        {
+        case MUTEX:
+          assert(pthread_mutex_init(&objects.mx[i], NULL) == 0);
+          break;
+        case COND:
+          assert(pthread_cond_init(&objects.cv[i], NULL) == 0);
+          break;
+        case RWLOCK:
+          assert(pthread_rwlock_init(&objects.rwl[i], NULL) == 0);
+          break;
+        case RWLOCK_PREFER:
+          assert(pthread_rwlock_init(&objects.rwl[i], &rwa) == 0);
+          break;
+        case SEMAPHORE:
+          assert(sem_init(&objects.sem[i], 0, 0) == 0);
+          break;
+        }
+    }
+
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+}
+
+static void
+destroy (int type)
+{
+  int i;
+
+  for (i = 0; i < OBJECTS; i++)
+    {
+      switch (type)
+        {
+        case MUTEX:
+          assert(pthread_mutex_destroy(&objects.mx[i]) == 0);
+          break;
+        case COND:
+          assert(pthread_cond_destroy(&objects.cv[i]) == 0);
+          break;
+        case RWLOCK:
+        case RWLOCK_PREFER:
+          assert(pthread_rwlock_destroy(&objects.rwl[i]) == 0);
+          break;
+        case SEMAPHORE:
+          assert(sem_destroy(&objects.sem[i]) == 0);
+          break;
+        }
+    }
+}
+
+static void
+runTest (char * testNameString, int type)
+{
+  long base, held;
+  int r;
+
+  base = handles();
+  create(type);
+  held = handles();
+  destroy(type);
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (r = 0; r < ROUNDS; r++)
+    {
+      create(type);
+      destroy(type);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  printf( "%-30s %15ld %15.3f %15ld\n",
+          testNameString,
+          GetDurationMilliSecs(currSysTimeStart, currSysTimeStop),
+          (float) GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) * 1E3 / (OBJECTS * ROUNDS),
+          (base < 0) ? -1L : held - base);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  handleCount = (handleCount_t) GetProcAddress(GetModuleHandle(TEXT("KERNEL32.DLL")),
+                                               "GetProcessHandleCount");
+
+  printf( "=============================================================================\n");
+  printf( "\nCreate and destroy %d objects, %d times.\n", OBJECTS, ROUNDS);
+  printf( "Handles is the increase in process handles with %d objects in existence\n", OBJECTS);
+  printf( "(-1 if GetProcessHandleCount() is not available).\n\n");
+  printf( "%-30s %15s %15s %15s\n",
+	    "Object",
+	    "Total(msec)",
+	    "usec/pair",
+	    "Handles");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  runTest("pthread_mutex_t", MUTEX);
+  runTest("pthread_cond_t", COND);
+  runTest("pthread_rwlock_t", RWLOCK);
+  runTest("pthread_rwlock_t (PREFER)", RWLOCK_PREFER);
+  runTest("sem_t", SEMAPHORE);
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
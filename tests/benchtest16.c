@@ -0,0 +1,237 @@
+/*
+ * benchtest16.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ *
+ * Measure wakeup latency of pthread_wait_on_address_np().
+ *
+ * - Ping-pong
+ *   Two threads pass a token back and forth ROUNDS times, each blocking
+ *   until the token arrives. The token is passed by
+ *   - a shared word with pthread_wait_on_address_np() and
+ *     pthread_wake_address_np();
+ *   - a Win32 auto-reset event per thread;
+ *   - a mutex and a condition variable per thread.
+ *   The threads are pinned either to two different processors or both
+ *   to the same one.
+ */
+
+#include "test.h"
+#include <limits.h>
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ROUNDS          100000L
+
+enum {
+  BY_ADDRESS,
+  BY_EVENT,
+  BY_CONDVAR
+};
+
+int method;
+int turn;
+HANDLE event[2];
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t cv[2] = {PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER};
+cpu_set_t pin[2];
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+void *
+player (void * arg)
+{
+  long me = (long)(size_t) arg;
+  long i;
+
+  (void) pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &pin[me]);
+
+  for (i = 0; i < ROUNDS; i++)
+    {
+      switch (method)
+        {
+        case BY_ADDRESS:
+          while (turn != me)
+            {
+              (void) pthread_wait_on_address_np(&turn, (int) (1 - me), NULL);
+            }
+          InterlockedExchange((LPLONG)&turn, 1 - me);
+          (void) pthread_wake_address_np(&turn, 1);
+          break;
+
+        case BY_EVENT:
+          if (i > 0 || me == 1)
+            {
+              assert(WaitForSingleObject(event[me], INFINITE) == WAIT_OBJECT_0);
+            }
+          assert(SetEvent(event[1 - me]));
+          break;
+
+        case BY_CONDVAR:
+          assert(pthread_mutex_lock(&mutex) == 0);
+          while (turn != me)
+            {
+              assert(pthread_cond_wait(&cv[me], &mutex) == 0);
+            }
+          turn = 1 - me;
+          assert(pthread_cond_signal(&cv[1 - me]) == 0);
+          assert(pthread_mutex_unlock(&mutex) == 0);
+          break;
+        }
+    }
+
+  return NULL;
+}
+
+long
+runTest (int m)
+{
+  pthread_t t[2];
+
+  method = m;
+  turn = 0;
+  assert(ResetEvent(event[0]));
+  assert(ResetEvent(event[1]));
+
+  PTW32_FTIME(&currSysTimeStart);
+  assert(pthread_create(&t[0], NULL, player, (void *) 0) == 0);
+  assert(pthread_create(&t[1], NULL, player, (void *) 1) == 0);
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_join(t[1], NULL) == 0);
+  PTW32_FTIME(&currSysTimeStop);
+
+  return GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+}
+
+void
+runTests (const char * where)
+{
+  static const char * names[] = {
+    "wait_on_address/wake_address",
+    "Win32 events",
+    "Mutex + condition variables"
+  };
+  int m;
+  long ms;
+
+  for (m = BY_ADDRESS; m <= BY_CONDVAR; m++)
+    {
+      ms = runTest(m);
+      printf( "%-14s %-30s %15ld %15.3f\n",
+              where,
+              names[m],
+              ms,
+              (double) ms * 1000.0 / ROUNDS);
+    }
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  cpu_set_t processCpus;
+  int first = -1;
+  int second = -1;
+  int cpu;
+
+  assert((event[0] = CreateEvent(NULL, FALSE, FALSE, NULL)) != NULL);
+  assert((event[1] = CreateEvent(NULL, FALSE, FALSE, NULL)) != NULL);
+
+  CPU_ZERO(&processCpus);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &processCpus) != 0)
+    {
+      CPU_SET(0, &processCpus);
+    }
+
+  for (cpu = 0; cpu < (int) sizeof(cpu_set_t)*8; cpu++)
+    {
+      if (CPU_ISSET(cpu, &processCpus))
+        {
+          if (first < 0)
+            {
+              first = cpu;
+            }
+          else if (second < 0)
+            {
+              second = cpu;
+            }
+        }
+    }
+
+  printf( "=============================================================================\n");
+  printf( "\nWakeup ping-pong: %ld round trips.\n", ROUNDS);
+  printf( "Times in msec and usec per round trip.\n\n");
+  printf( "%-14s %-30s %15s %15s\n",
+	    "Processors",
+	    "Token passed by",
+	    "Total(msec)",
+	    "usec/trip");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  if (second >= 0)
+    {
+      CPU_ZERO(&pin[0]);
+      CPU_SET(first, &pin[0]);
+      CPU_ZERO(&pin[1]);
+      CPU_SET(second, &pin[1]);
+      runTests("Two");
+    }
+
+  CPU_ZERO(&pin[0]);
+  CPU_SET(first, &pin[0]);
+  pin[1] = pin[0];
+  runTests("One");
+
+  printf( "=============================================================================\n");
+
+  assert(CloseHandle(event[0]));
+  assert(CloseHandle(event[1]));
+  assert(pthread_cond_destroy(&cv[0]) == 0);
+  assert(pthread_cond_destroy(&cv[1]) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
@@ -0,0 +1,316 @@
+/*
+ * benchtest17.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ *
+ *
+ * Measure the cost of waking the consumers of a lock-free queue.
+ *
+ * - Producer/consumer
+ *   Producers put ITEMS items on a bounded lock-free queue and consumers
+ *   take them off, sleeping when the queue is empty. Consumers sleep on
+ *   - a pthread_eventcount_np that producers notify after each put;
+ *   - a condition variable that producers signal, under its mutex,
+ *     after each put.
+ *   Producers that find the queue full yield and retry.
+ */
+
+#include "test.h"
+#include <sched.h>
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITEMS           1000000L
+#define QUEUE_SIZE      1024            /* Power of 2 */
+#define MAX_THREADS     4
+
+enum {
+  BY_EVENTCOUNT,
+  BY_CONDVAR
+};
+
+/*
+ * A bounded multi-producer/multi-consumer queue. Each cell's sequence
+ * number says whether it is ready to be put to or taken from at a
+ * given position.
+ */
+typedef struct {
+  volatile long sequence;
+  long item;
+} cell_t;
+
+cell_t queue[QUEUE_SIZE];
+volatile long putPos;
+volatile long takePos;
+
+int method;
+int consumers;
+pthread_eventcount_t ec;
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t cv = PTHREAD_COND_INITIALIZER;
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+void
+queueInit (void)
+{
+  long i;
+
+  for (i = 0; i < QUEUE_SIZE; i++)
+    {
+      queue[i].sequence = i;
+    }
+  putPos = 0;
+  takePos = 0;
+}
+
+int
+tryPut (long item)
+{
+  cell_t * cell;
+  long pos = putPos;
+  long d;
+
+  for (;;)
+    {
+      cell = &queue[pos & (QUEUE_SIZE - 1)];
+      d = cell->sequence - pos;
+      if (d == 0)
+        {
+          if (InterlockedCompareExchange((LPLONG)&putPos, pos + 1, pos) == pos)
+            {
+              break;
+            }
+        }
+      else if (d < 0)
+        {
+          return 0;
+        }
+      pos = putPos;
+    }
+
+  cell->item = item;
+  InterlockedExchange((LPLONG)&cell->sequence, pos + 1);
+
+  return 1;
+}
+
+int
+tryTake (long * item)
+{
+  cell_t * cell;
+  long pos = takePos;
+  long d;
+
+  for (;;)
+    {
+      cell = &queue[pos & (QUEUE_SIZE - 1)];
+      d = cell->sequence - (pos + 1);
+      if (d == 0)
+        {
+          if (InterlockedCompareExchange((LPLONG)&takePos, pos + 1, pos) == pos)
+            {
+              break;
+            }
+        }
+      else if (d < 0)
+        {
+          return 0;
+        }
+      pos = takePos;
+    }
+
+  *item = cell->item;
+  InterlockedExchange((LPLONG)&cell->sequence, pos + QUEUE_SIZE);
+
+  return 1;
+}
+
+void *
+producer (void * arg)
+{
+  long n = (long)(size_t) arg;
+  long i;
+
+  for (i = 0; i < n; i++)
+    {
+      while (!tryPut(i))
+        {
+          sched_yield();
+        }
+
+      if (method == BY_EVENTCOUNT)
+        {
+          assert(pthread_eventcount_notify_np(&ec) == 0);
+        }
+      else
+        {
+          assert(pthread_mutex_lock(&mutex) == 0);
+          assert(pthread_cond_signal(&cv) == 0);
+          assert(pthread_mutex_unlock(&mutex) == 0);
+        }
+    }
+
+  return NULL;
+}
+
+void *
+consumer (void * arg)
+{
+  long n = (long)(size_t) arg;
+  long i;
+  long item;
+  unsigned int key;
+
+  for (i = 0; i < n; i++)
+    {
+      if (tryTake(&item))
+        {
+          continue;
+        }
+
+      if (method == BY_EVENTCOUNT)
+        {
+          for (;;)
+            {
+              assert(pthread_eventcount_prepare_wait_np(&ec, &key) == 0);
+              if (tryTake(&item))
+                {
+                  assert(pthread_eventcount_cancel_wait_np(&ec) == 0);
+                  break;
+                }
+              assert(pthread_eventcount_commit_wait_np(&ec, key, NULL) == 0);
+              if (tryTake(&item))
+                {
+                  break;
+                }
+            }
+        }
+      else
+        {
+          assert(pthread_mutex_lock(&mutex) == 0);
+          while (!tryTake(&item))
+            {
+              assert(pthread_cond_wait(&cv, &mutex) == 0);
+            }
+          assert(pthread_mutex_unlock(&mutex) == 0);
+        }
+    }
+
+  return NULL;
+}
+
+long
+runTest (int m, int threads)
+{
+  pthread_t p[MAX_THREADS];
+  pthread_t c[MAX_THREADS];
+  int i;
+
+  method = m;
+  queueInit();
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < threads; i++)
+    {
+      assert(pthread_create(&c[i], NULL, consumer, (void *)(size_t)(ITEMS / threads)) == 0);
+      assert(pthread_create(&p[i], NULL, producer, (void *)(size_t)(ITEMS / threads)) == 0);
+    }
+  for (i = 0; i < threads; i++)
+    {
+      assert(pthread_join(p[i], NULL) == 0);
+      assert(pthread_join(c[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  return GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  static const char * names[] = {
+    "pthread_eventcount_np",
+    "Mutex + condition variable"
+  };
+  int threads;
+  int m;
+  long ms;
+
+  assert(pthread_eventcount_init_np(&ec) == 0);
+
+  printf( "=============================================================================\n");
+  printf( "\nLock-free queue consumer wakeup: %ld items.\n", ITEMS);
+  printf( "Times in msec and nsec per item.\n\n");
+  printf( "%-20s %-30s %12s %12s\n",
+	    "Producers/consumers",
+	    "Consumers wait on",
+	    "Total(msec)",
+	    "nsec/item");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+      for (m = BY_EVENTCOUNT; m <= BY_CONDVAR; m++)
+        {
+          ms = runTest(m, threads);
+          printf( "%9d/%-10d %-30s %12ld %12.1f\n",
+                  threads, threads,
+                  names[m],
+                  ms,
+                  (double) ms * 1000000.0 / ITEMS);
+        }
+    }
+
+  printf( "=============================================================================\n");
+
+  assert(pthread_eventcount_destroy_np(&ec) == 0);
+  assert(pthread_cond_destroy(&cv) == 0);
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
@@ -0,0 +1,195 @@
+/*
+ * benchtest18.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ *
+ *
+ * Measure fan-in: a coordinator waiting for N workers to finish a step.
+ *
+ * - Fan-in
+ *   Each of N workers does a little work and reports it done ROUNDS
+ *   times; the coordinator waits for all N reports of each round. The
+ *   reports are made with
+ *   - pthread_latch_count_down_np() on one latch per round, which the
+ *     coordinator waits on (workers never wait);
+ *   - pthread_barrier_wait() on a barrier for N + 1 threads (workers
+ *     wait for each other and for the coordinator).
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ROUNDS          10000
+#define WORK            200
+#define MAX_WORKERS     8
+
+enum {
+  BY_LATCH,
+  BY_BARRIER
+};
+
+int method;
+pthread_latch_t latch[ROUNDS];
+pthread_barrier_t barrier;
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+void *
+worker (void * arg)
+{
+  int r;
+  int j;
+  int dummy = 0;
+
+  for (r = 0; r < ROUNDS; r++)
+    {
+      for (j = 0; j < WORK; j++)
+        {
+          dummy_call(&dummy);
+        }
+
+      if (method == BY_LATCH)
+        {
+          assert(pthread_latch_count_down_np(&latch[r]) == 0);
+        }
+      else
+        {
+          int result = pthread_barrier_wait(&barrier);
+          assert(result == 0 || result == PTHREAD_BARRIER_SERIAL_THREAD);
+        }
+    }
+
+  return NULL;
+}
+
+long
+runTest (int m, int workers)
+{
+  pthread_t t[MAX_WORKERS];
+  int r;
+  int i;
+  int result;
+
+  method = m;
+
+  for (r = 0; r < ROUNDS; r++)
+    {
+      assert(pthread_latch_init_np(&latch[r], workers) == 0);
+    }
+  assert(pthread_barrier_init(&barrier, NULL, workers + 1) == 0);
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < workers; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, NULL) == 0);
+    }
+  for (r = 0; r < ROUNDS; r++)
+    {
+      if (method == BY_LATCH)
+        {
+          assert(pthread_latch_wait_np(&latch[r]) == 0);
+        }
+      else
+        {
+          result = pthread_barrier_wait(&barrier);
+          assert(result == 0 || result == PTHREAD_BARRIER_SERIAL_THREAD);
+        }
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  for (i = 0; i < workers; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  for (r = 0; r < ROUNDS; r++)
+    {
+      assert(pthread_latch_destroy_np(&latch[r]) == 0);
+    }
+  assert(pthread_barrier_destroy(&barrier) == 0);
+
+  return GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  static const char * names[] = {
+    "pthread_latch_count_down_np",
+    "pthread_barrier_wait"
+  };
+  int workers;
+  int m;
+  long ms;
+
+  printf( "=============================================================================\n");
+  printf( "\nFan-in: coordinator waits for all workers, %d rounds.\n", ROUNDS);
+  printf( "Times in msec and usec per round.\n\n");
+  printf( "%-10s %-30s %15s %15s\n",
+	    "Workers",
+	    "Workers report with",
+	    "Total(msec)",
+	    "usec/round");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (workers = 1; workers <= MAX_WORKERS; workers *= 2)
+    {
+      for (m = BY_LATCH; m <= BY_BARRIER; m++)
+        {
+          ms = runTest(m, workers);
+          printf( "%-10d %-30s %15ld %15.3f\n",
+                  workers,
+                  names[m],
+                  ms,
+                  (double) ms * 1000.0 / ROUNDS);
+        }
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
@@ -0,0 +1,298 @@
+/*
+ * benchtest19.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ *
+ *
+ * Measure thread pool task throughput.
+ *
+ * - Task throughput
+ *   Tasks are run by one worker per processor, and the time from the
+ *   first submit until all have finished is measured. TINY_TASKS tiny
+ *   tasks (an Interlocked increment) or LARGE_TASKS large ones (a few
+ *   tens of microseconds of work) are run by
+ *   - a pthread_pool_np, submitted one at a time from the main thread;
+ *   - a pthread_pool_np, submitted with pthread_pool_submit_batch_np();
+ *   - a pthread_pool_np, as a binary tree of tasks each submitting its
+ *     two children (so workers must steal to share the work);
+ *   - a pool with a single queue protected by a mutex and condition
+ *     variable, like the Queue in threestage.c.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define TINY_TASKS      (1L << 20)
+#define LARGE_TASKS     (1L << 12)
+#define LARGE_WORK      20000
+#define BATCH           1024
+#define MAX_WORKERS     64
+
+enum {
+  BY_SUBMIT,
+  BY_BATCH,
+  BY_TREE,
+  BY_QUEUE
+};
+
+int work;
+long tasks;
+long done;
+pthread_pool_t pool;
+void * args[BATCH];
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+/*
+ * The mutex and condition variable queue.
+ */
+struct {
+  pthread_mutex_t lock;
+  pthread_cond_t notEmpty;
+  pthread_cond_t allDone;
+  long head;
+  long tail;
+  int stop;
+} queue = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, 0};
+
+void
+task (void * arg)
+{
+  int j;
+  int dummy = 0;
+
+  for (j = 0; j < work; j++)
+    {
+      dummy_call(&dummy);
+    }
+  InterlockedIncrement((LPLONG)&done);
+}
+
+void
+tree (void * arg)
+{
+  long n = (long)(size_t) arg;
+
+  /*
+   * A subtree of n tasks: this one plus two halves of the rest.
+   */
+  if (n == 0)
+    {
+      return;
+    }
+  if (n > 1)
+    {
+      assert(pthread_pool_submit_np(&pool, tree, (void *)(size_t)((n - 1) / 2)) == 0);
+      assert(pthread_pool_submit_np(&pool, tree, (void *)(size_t)(n - 1 - (n - 1) / 2)) == 0);
+    }
+  task(NULL);
+}
+
+void *
+queueWorker (void * arg)
+{
+  assert(pthread_mutex_lock(&queue.lock) == 0);
+  for (;;)
+    {
+      while (queue.head == queue.tail && !queue.stop)
+        {
+          assert(pthread_cond_wait(&queue.notEmpty, &queue.lock) == 0);
+        }
+      if (queue.head == queue.tail)
+        {
+          break;
+        }
+      queue.head++;
+      assert(pthread_mutex_unlock(&queue.lock) == 0);
+
+      task(NULL);
+
+      assert(pthread_mutex_lock(&queue.lock) == 0);
+      if (done == tasks)
+        {
+          assert(pthread_cond_signal(&queue.allDone) == 0);
+        }
+    }
+  assert(pthread_mutex_unlock(&queue.lock) == 0);
+
+  return NULL;
+}
+
+long
+runTest (int m, int workers)
+{
+  pthread_t t[MAX_WORKERS];
+  long i;
+
+  done = 0;
+
+  if (m == BY_QUEUE)
+    {
+      queue.head = queue.tail = 0;
+      queue.stop = 0;
+      for (i = 0; i < workers; i++)
+        {
+          assert(pthread_create(&t[i], NULL, queueWorker, NULL) == 0);
+        }
+    }
+  else
+    {
+      assert(pthread_pool_init_np(&pool, NULL, workers, workers) == 0);
+    }
+
+  PTW32_FTIME(&currSysTimeStart);
+  switch (m)
+    {
+    case BY_SUBMIT:
+      for (i = 0; i < tasks; i++)
+        {
+          assert(pthread_pool_submit_np(&pool, task, NULL) == 0);
+        }
+      assert(pthread_pool_wait_idle_np(&pool) == 0);
+      break;
+
+    case BY_BATCH:
+      for (i = 0; i < tasks; i += BATCH)
+        {
+          assert(pthread_pool_submit_batch_np(&pool, task, args, BATCH) == 0);
+        }
+      assert(pthread_pool_wait_idle_np(&pool) == 0);
+      break;
+
+    case BY_TREE:
+      assert(pthread_pool_submit_np(&pool, tree, (void *)(size_t) tasks) == 0);
+      assert(pthread_pool_wait_idle_np(&pool) == 0);
+      break;
+
+    case BY_QUEUE:
+      for (i = 0; i < tasks; i++)
+        {
+          assert(pthread_mutex_lock(&queue.lock) == 0);
+          queue.tail++;
+          assert(pthread_cond_signal(&queue.notEmpty) == 0);
+          assert(pthread_mutex_unlock(&queue.lock) == 0);
+        }
+      assert(pthread_mutex_lock(&queue.lock) == 0);
+      while (done < tasks)
+        {
+          assert(pthread_cond_wait(&queue.allDone, &queue.lock) == 0);
+        }
+      assert(pthread_mutex_unlock(&queue.lock) == 0);
+      break;
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  assert(done == tasks);
+
+  if (m == BY_QUEUE)
+    {
+      assert(pthread_mutex_lock(&queue.lock) == 0);
+      queue.stop = 1;
+      assert(pthread_cond_broadcast(&queue.notEmpty) == 0);
+      assert(pthread_mutex_unlock(&queue.lock) == 0);
+      for (i = 0; i < workers; i++)
+        {
+          assert(pthread_join(t[i], NULL) == 0);
+        }
+    }
+  else
+    {
+      assert(pthread_pool_destroy_np(&pool) == 0);
+    }
+
+  return GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  static const char * names[] = {
+    "pthread_pool_submit_np",
+    "pthread_pool_submit_batch_np",
+    "pthread_pool_np task tree",
+    "Mutex + condvar queue"
+  };
+  int workers = pthread_num_processors_np();
+  int m;
+  long ms;
+
+  if (workers > MAX_WORKERS)
+    {
+      workers = MAX_WORKERS;
+    }
+
+  printf( "=============================================================================\n");
+  printf( "\nTask throughput: %ld tiny or %ld large tasks, %d workers.\n",
+          TINY_TASKS, LARGE_TASKS, workers);
+  printf( "Times in msec and nsec per task.\n\n");
+  printf( "%-8s %-32s %15s %15s\n",
+	    "Tasks",
+	    "Run by",
+	    "Total(msec)",
+	    "nsec/task");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (work = 0; work <= LARGE_WORK; work += LARGE_WORK)
+    {
+      tasks = work ? LARGE_TASKS : TINY_TASKS;
+
+      for (m = BY_SUBMIT; m <= BY_QUEUE; m++)
+        {
+          ms = runTest(m, workers);
+          printf( "%-8s %-32s %15ld %15.1f\n",
+                  work ? "Large" : "Tiny",
+                  names[m],
+                  ms,
+                  (double) ms * 1000000.0 / tasks);
+        }
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
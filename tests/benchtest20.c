@@ -0,0 +1,213 @@
+/*
+ * benchtest20.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ *
+ *
+ *
+ * Measure a parallel loop over a small range (many times) and a large
+ * range (a few times), run
+ * - serially on one thread;
+ * - on one thread per processor created with pthread_create() and
+ *   joined with pthread_join() for every loop, each running an equal
+ *   share of the range;
+ * - with pthread_parallel_for_np() and each scheduling policy.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define SMALL_RANGE     1000
+#define SMALL_LOOPS     2000
+#define LARGE_RANGE     10000000
+#define LARGE_LOOPS     10
+#define MAX_THREADS     64
+
+enum {
+  SERIAL,
+  CREATE_JOIN,
+  PARALLEL_STATIC,
+  PARALLEL_DYNAMIC,
+  PARALLEL_GUIDED
+};
+
+typedef struct {
+  long first;
+  long last;
+} share_t;
+
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+void
+body (long first, long last, void * arg)
+{
+  int dummy = 0;
+
+  for (; first < last; first++)
+    {
+      dummy_call(&dummy);
+    }
+}
+
+void *
+share (void * arg)
+{
+  share_t * s = (share_t *) arg;
+
+  body(s->first, s->last, NULL);
+
+  return NULL;
+}
+
+void
+createJoin (long range, int nThreads)
+{
+  pthread_t t[MAX_THREADS];
+  share_t s[MAX_THREADS];
+  int i;
+
+  for (i = 0; i < nThreads; i++)
+    {
+      s[i].first = range * i / nThreads;
+      s[i].last = range * (i + 1) / nThreads;
+      assert(pthread_create(&t[i], NULL, share, &s[i]) == 0);
+    }
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+}
+
+long
+runTest (int method, long range, int loops, int nThreads)
+{
+  int l;
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (l = 0; l < loops; l++)
+    {
+      switch (method)
+        {
+        case SERIAL:
+          body(0, range, NULL);
+          break;
+        case CREATE_JOIN:
+          createJoin(range, nThreads);
+          break;
+        case PARALLEL_STATIC:
+          assert(pthread_parallel_for_np(0, range, 0, body, NULL, PTHREAD_PARALLEL_STATIC_NP) == 0);
+          break;
+        case PARALLEL_DYNAMIC:
+          assert(pthread_parallel_for_np(0, range, 0, body, NULL, PTHREAD_PARALLEL_DYNAMIC_NP) == 0);
+          break;
+        case PARALLEL_GUIDED:
+          assert(pthread_parallel_for_np(0, range, 0, body, NULL, PTHREAD_PARALLEL_GUIDED_NP) == 0);
+          break;
+        }
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  return GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  static const char * names[] = {
+    "serial",
+    "pthread_create/join",
+    "pthread_parallel_for_np static",
+    "pthread_parallel_for_np dynamic",
+    "pthread_parallel_for_np guided"
+  };
+  int nThreads = pthread_num_processors_np();
+  int m;
+  long ms;
+
+  if (nThreads > MAX_THREADS)
+    {
+      nThreads = MAX_THREADS;
+    }
+
+  /*
+   * Create the loop team before timing.
+   */
+  assert(pthread_parallel_for_np(0, 1, 0, body, NULL, PTHREAD_PARALLEL_STATIC_NP) == 0);
+
+  printf( "=============================================================================\n");
+  printf( "\nParallel loops on %d threads.\n", nThreads);
+  printf( "Small: %d iterations, %d loops. Large: %d iterations, %d loops.\n",
+          SMALL_RANGE, SMALL_LOOPS, LARGE_RANGE, LARGE_LOOPS);
+  printf( "Times in msec and usec per loop.\n\n");
+  printf( "%-35s %12s %12s %12s %12s\n",
+	    "Method",
+	    "Small(msec)",
+	    "usec/loop",
+	    "Large(msec)",
+	    "usec/loop");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (m = SERIAL; m <= PARALLEL_GUIDED; m++)
+    {
+      long large;
+
+      ms = runTest(m, SMALL_RANGE, SMALL_LOOPS, nThreads);
+      large = runTest(m, LARGE_RANGE, LARGE_LOOPS, nThreads);
+      printf( "%-35s %12ld %12.3f %12ld %12.3f\n",
+              names[m],
+              ms,
+              (double) ms * 1000.0 / SMALL_LOOPS,
+              large,
+              (double) large * 1000.0 / LARGE_LOOPS);
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * benchtest21.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure POSIX timers: with 100, 10000 and 100000 periodic timers
+ * armed at once, staggered over their period,
+ * - the CPU time the process uses, as a share of one processor;
+ * - how late notifications run after the time they were due (jitter).
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include <string.h>
+#include "benchtest.h"
+
+#define PERIOD_MS       100
+#define RUN_MS          3000
+#define MAX_TIMERS      100000
+
+static timer_t timers[MAX_TIMERS];
+static LONGLONG due[MAX_TIMERS];
+static LONGLONG frequency;
+static LONGLONG period;
+static LONGLONG lateSum;
+static LONGLONG lateMax;
+static long notified;
+static long missed;
+static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+
+LONGLONG
+now (void)
+{
+  LARGE_INTEGER t;
+
+  QueryPerformanceCounter(&t);
+
+  return t.QuadPart;
+}
+
+LONGLONG
+cpuTime (void)
+{
+  FILETIME created, exited, kernel, user;
+  LARGE_INTEGER k, u;
+
+  GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user);
+  k.LowPart = kernel.dwLowDateTime;
+  k.HighPart = kernel.dwHighDateTime;
+  u.LowPart = user.dwLowDateTime;
+  u.HighPart = user.dwHighDateTime;
+
+  /*
+   * 100 ns units.
+   */
+  return k.QuadPart + u.QuadPart;
+}
+
+void
+notify (union sigval value)
+{
+  long i = (long) value.sival_int;
+  LONGLONG t = now();
+  int overrun = timer_getoverrun(timers[i]);
+  LONGLONG late;
+
+  /*
+   * Only this timer's notification touches due[i].
+   */
+  due[i] += (LONGLONG) overrun * period;
+  late = t - due[i];
+  due[i] += period;
+
+  pthread_mutex_lock(&statsLock);
+  lateSum += late;
+  if (late > lateMax)
+    {
+      lateMax = late;
+    }
+  notified++;
+  missed += overrun;
+  pthread_mutex_unlock(&statsLock);
+}
+
+void
+runTest (long nTimers)
+{
+  struct sigevent ev;
+  struct itimerspec its;
+  LONGLONG start;
+  LONGLONG cpu;
+  LONGLONG offset;
+  long i;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.sigev_notify = SIGEV_THREAD;
+  ev.sigev_notify_function = notify;
+
+  lateSum = lateMax = 0;
+  notified = missed = 0;
+
+  for (i = 0; i < nTimers; i++)
+    {
+      ev.sigev_value.sival_int = (int) i;
+      assert(timer_create(CLOCK_MONOTONIC, &ev, &timers[i]) == 0);
+    }
+
+  start = now();
+  cpu = cpuTime();
+
+  for (i = 0; i < nTimers; i++)
+    {
+      /*
+       * Spread first expirations over the period, in 10 us steps.
+       */
+      offset = 1000000 + (LONGLONG) (i % (PERIOD_MS * 100)) * 10000;
+      its.it_value.tv_sec = 0;
+      its.it_value.tv_nsec = (long) offset;
+      its.it_interval.tv_sec = 0;
+      its.it_interval.tv_nsec = PERIOD_MS * 1000000;
+      due[i] = now() + offset * frequency / 1000000000;
+      assert(timer_settime(timers[i], 0, &its, NULL) == 0);
+    }
+
+  Sleep(RUN_MS);
+
+  cpu = cpuTime() - cpu;
+  start = now() - start;
+
+  for (i = 0; i < nTimers; i++)
+    {
+      assert(timer_delete(timers[i]) == 0);
+    }
+
+  printf( "%-10ld %12ld %12ld %11.1f%% %12.1f %12.1f\n",
+          nTimers,
+          notified,
+          missed,
+          100.0 * (double) cpu / ((double) start * 10000000.0 / (double) frequency),
+          notified ? (double) lateSum * 1000000.0 / (double) frequency / (double) notified : 0.0,
+          (double) lateMax * 1000000.0 / (double) frequency);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  LARGE_INTEGER f;
+
+  QueryPerformanceFrequency(&f);
+  frequency = f.QuadPart;
+  period = frequency * PERIOD_MS / 1000;
+
+  printf( "=============================================================================\n");
+  printf( "\nPeriodic POSIX timers, %d ms period, each run %d ms.\n", PERIOD_MS, RUN_MS);
+  printf( "CPU is process time as a share of one processor;\n");
+  printf( "lateness is in usec after the time the expiration was due.\n\n");
+  printf( "%-10s %12s %12s %12s %12s %12s\n",
+	    "Timers",
+	    "Notified",
+	    "Overruns",
+	    "CPU",
+	    "Mean late",
+	    "Max late");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  runTest(100);
+  runTest(10000);
+  runTest(MAX_TIMERS);
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
@@ -0,0 +1,207 @@
+/*
+ * benchtest22.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure how late sleeps of 10 us to 10 ms end, and the processor
+ * time they use, with
+ * - Sleep() for the interval rounded up to whole milliseconds;
+ * - nanosleep() in PTHREAD_DELAY_COARSE_NP mode;
+ * - nanosleep() in PTHREAD_DELAY_PRECISE_NP mode.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define MAX_SAMPLES     1000
+#define RUN_NS          300000000
+
+enum {
+  WIN32_SLEEP,
+  NANOSLEEP_COARSE,
+  NANOSLEEP_PRECISE
+};
+
+static LONGLONG frequency;
+static LONGLONG late[MAX_SAMPLES];
+
+LONGLONG
+nowNs (void)
+{
+  LARGE_INTEGER t;
+
+  QueryPerformanceCounter(&t);
+
+  return (t.QuadPart / frequency) * 1000000000
+         + ((t.QuadPart % frequency) * 1000000000) / frequency;
+}
+
+LONGLONG
+threadTime (void)
+{
+  FILETIME created, exited, kernel, user;
+  LARGE_INTEGER k, u;
+
+  GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user);
+  k.LowPart = kernel.dwLowDateTime;
+  k.HighPart = kernel.dwHighDateTime;
+  u.LowPart = user.dwLowDateTime;
+  u.HighPart = user.dwHighDateTime;
+
+  /*
+   * 100 ns units.
+   */
+  return k.QuadPart + u.QuadPart;
+}
+
+int
+compare (const void * a, const void * b)
+{
+  LONGLONG x = *(const LONGLONG *) a;
+  LONGLONG y = *(const LONGLONG *) b;
+
+  return (x > y) - (x < y);
+}
+
+void
+runTest (int method, long ns)
+{
+  struct timespec ts;
+  LONGLONG start;
+  LONGLONG cpu;
+  int samples = (int) (RUN_NS / ns);
+  int i;
+
+  if (samples > MAX_SAMPLES)
+    {
+      samples = MAX_SAMPLES;
+    }
+  if (samples < 20)
+    {
+      samples = 20;
+    }
+
+  ts.tv_sec = 0;
+  ts.tv_nsec = ns;
+
+  if (method != WIN32_SLEEP)
+    {
+      assert(pthread_setdelaymode_np(method == NANOSLEEP_PRECISE
+                                     ? PTHREAD_DELAY_PRECISE_NP
+                                     : PTHREAD_DELAY_COARSE_NP) == 0);
+    }
+
+  cpu = threadTime();
+
+  for (i = 0; i < samples; i++)
+    {
+      start = nowNs();
+      if (method == WIN32_SLEEP)
+        {
+          Sleep((DWORD) ((ns + 999999) / 1000000));
+        }
+      else
+        {
+          assert(nanosleep(&ts, NULL) == 0);
+        }
+      late[i] = nowNs() - start - ns;
+    }
+
+  cpu = threadTime() - cpu;
+
+  qsort(late, samples, sizeof(late[0]), compare);
+
+  printf( "%10.0f %12.1f %12.1f %12.1f %12.1f\n",
+          (double) ns / 1000.0,
+          (double) late[samples / 2] / 1000.0,
+          (double) late[samples * 99 / 100] / 1000.0,
+          (double) late[samples - 1] / 1000.0,
+          100.0 * (double) cpu * 100.0 / ((double) samples * (double) ns));
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  static const char * names[] = {
+    "Sleep() rounded up to msec",
+    "nanosleep(), PTHREAD_DELAY_COARSE_NP",
+    "nanosleep(), PTHREAD_DELAY_PRECISE_NP"
+  };
+  static const long intervals[] = {
+    10000, 50000, 100000, 500000, 1000000, 5000000, 10000000
+  };
+  LARGE_INTEGER f;
+  int m;
+  int i;
+
+  QueryPerformanceFrequency(&f);
+  frequency = f.QuadPart;
+
+  printf( "=============================================================================\n");
+  printf( "\nSleep lateness in usec after the interval asked for, and processor time\n");
+  printf( "used as a share of the time asked for.\n");
+
+  for (m = WIN32_SLEEP; m <= NANOSLEEP_PRECISE; m++)
+    {
+      printf( "\n%s\n\n", names[m]);
+      printf( "%10s %12s %12s %12s %12s\n",
+              "usec",
+              "Median",
+              "p99",
+              "Max",
+              "CPU %");
+      printf( "-----------------------------------------------------------------------------\n");
+
+      for (i = 0; i < (int) (sizeof(intervals) / sizeof(intervals[0])); i++)
+        {
+          runTest(m, intervals[i]);
+        }
+    }
+
+  assert(pthread_setdelaymode_np(PTHREAD_DELAY_COARSE_NP) == 0);
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  return 0;
+}
@@ -0,0 +1,219 @@
+/*
+ * benchtest23.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure the cost of lock and unlock on the fast paths.
+ *
+ * - Uncontended: one thread calls each lock and unlock pair ITERATIONS
+ *   times. Reported in nanoseconds per pair.
+ * - Contended: NTHREADS threads share one lock, each performing
+ *   ITERATIONS / NTHREADS pairs around a small critical section.
+ *
+ * The fast paths use release ordering for unlock where the compiler
+ * provides __atomic builtins (see implement.h), so compare results
+ * from builds with and without HAVE_GCC_ATOMIC_BUILTINS.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS      10000000L
+#define NTHREADS        4
+
+enum {
+  OP_MUTEX,
+  OP_SPIN,
+  OP_ONCE,
+  OP_SEM,
+  OP_COUNT
+};
+
+const char * opNames[OP_COUNT] = {
+  "mutex (normal)",
+  "spin lock",
+  "pthread_once",
+  "sem_post/wait"
+};
+
+pthread_mutex_t mx;
+pthread_spinlock_t spin;
+pthread_once_t once = PTHREAD_ONCE_INIT;
+sem_t sema;
+volatile long shared = 0;
+
+static void
+initRoutine (void)
+{
+  shared++;
+}
+
+static LONGLONG
+nowNs (void)
+{
+  LARGE_INTEGER count, freq;
+
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&freq);
+  return (LONGLONG) ((double) count.QuadPart * 1E9 / (double) freq.QuadPart);
+}
+
+static void
+runOp (int op, long n)
+{
+  long i;
+
+  switch (op)
+    {
+    case OP_MUTEX:
+      for (i = 0; i < n; i++)
+        {
+          (void) pthread_mutex_lock(&mx);
+          shared++;
+          (void) pthread_mutex_unlock(&mx);
+        }
+      break;
+    case OP_SPIN:
+      for (i = 0; i < n; i++)
+        {
+          (void) pthread_spin_lock(&spin);
+          shared++;
+          (void) pthread_spin_unlock(&spin);
+        }
+      break;
+    case OP_ONCE:
+      for (i = 0; i < n; i++)
+        {
+          (void) pthread_once(&once, initRoutine);
+        }
+      break;
+    case OP_SEM:
+      for (i = 0; i < n; i++)
+        {
+          (void) sem_post(&sema);
+          (void) sem_wait(&sema);
+        }
+      break;
+    }
+}
+
+void *
+worker (void * arg)
+{
+  runOp((int)(size_t) arg, ITERATIONS / NTHREADS);
+
+  return NULL;
+}
+
+double
+runContended (int op)
+{
+  pthread_t t[NTHREADS];
+  LONGLONG start;
+  int i;
+
+  start = nowNs();
+  for (i = 0; i < NTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, (void *)(size_t) op) == 0);
+    }
+  for (i = 0; i < NTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  return (double) (nowNs() - start) / ITERATIONS;
+}
+
+double
+runUncontended (int op)
+{
+  LONGLONG start;
+
+  start = nowNs();
+  runOp(op, ITERATIONS);
+
+  return (double) (nowNs() - start) / ITERATIONS;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  int op;
+
+  assert(pthread_mutex_init(&mx, NULL) == 0);
+  assert(pthread_spin_init(&spin, PTHREAD_PROCESS_PRIVATE) == 0);
+  assert(sem_init(&sema, 0, 0) == 0);
+
+  /* Warm up: take any lazy initialisation out of the timings. */
+  for (op = 0; op < OP_COUNT; op++)
+    {
+      runOp(op, 1000);
+    }
+
+  printf( "=============================================================================\n");
+  printf( "\nLock and unlock fast paths: %ld operations, %d threads when contended.\n\n",
+          ITERATIONS, NTHREADS);
+  printf( "%-20s %25s %25s\n",
+	    "Operation",
+	    "uncontended(nsec/op)",
+	    "contended(nsec/op)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (op = 0; op < OP_COUNT; op++)
+    {
+      double u = runUncontended(op);
+      double c = runContended(op);
+
+      printf( "%-20s %25.2f %25.2f\n", opNames[op], u, c);
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  assert(sem_destroy(&sema) == 0);
+  assert(pthread_spin_destroy(&spin) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  return 0;
+}
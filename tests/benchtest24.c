@@ -0,0 +1,162 @@
+/*
+ * benchtest24.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure what the PTW32_INLINE_FASTPATH inline paths save over calls
+ * into the library for uncontended lock and unlock.
+ *
+ * Each lock and unlock pair is timed ITERATIONS times, once through the
+ * library's entry points, written (pthread_mutex_lock)(&mx) so that the
+ * inline macros don't apply, and once inline. Loop overhead is measured
+ * and subtracted as in benchtest1.
+ */
+
+#define PTW32_INLINE_FASTPATH
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS      10000000L
+
+pthread_mutex_t mx;
+pthread_spinlock_t spin;
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+long durationMilliSecs;
+long overHeadMilliSecs = 0;
+int two = 2;
+int one = 1;
+int zero = 0;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+/*
+ * Dummy use of j, otherwise the loop may be removed by the optimiser
+ * when doing the overhead timing with an empty loop.
+ */
+#define TESTSTART \
+  { int i, j = 0, k = 0; PTW32_FTIME(&currSysTimeStart); for (i = 0; i < ITERATIONS; i++) { j++;
+
+#define TESTSTOP \
+  }; PTW32_FTIME(&currSysTimeStop); if (j + k == i) j++; }
+
+
+void
+report (char * testNameString)
+{
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
+
+  printf( "%-45s %15ld %15.3f\n",
+	    testNameString,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / ITERATIONS);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  assert(pthread_mutex_init(&mx, NULL) == 0);
+  assert(pthread_spin_init(&spin, PTHREAD_PROCESS_PRIVATE) == 0);
+
+  printf( "=============================================================================\n");
+  printf( "\nLock plus unlock, called and inline (PTW32_INLINE_FASTPATH).\n%ld iterations\n\n",
+          ITERATIONS);
+  printf( "%-45s %15s %15s\n",
+	    "Test",
+	    "Total(msec)",
+	    "average(usec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  /*
+   * Time the loop overhead so we can subtract it from the actual test times.
+   */
+  TESTSTART
+  assert(1 == one);
+  assert(2 == two);
+  TESTSTOP
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
+  overHeadMilliSecs = durationMilliSecs;
+
+
+  TESTSTART
+  assert((pthread_mutex_lock)(&mx) == zero);
+  assert((pthread_mutex_unlock)(&mx) == zero);
+  TESTSTOP
+
+  report("PTHREAD_MUTEX_NORMAL, called");
+
+
+  TESTSTART
+  assert(pthread_mutex_lock(&mx) == zero);
+  assert(pthread_mutex_unlock(&mx) == zero);
+  TESTSTOP
+
+  report("PTHREAD_MUTEX_NORMAL, inline");
+
+
+  TESTSTART
+  assert((pthread_spin_lock)(&spin) == zero);
+  assert((pthread_spin_unlock)(&spin) == zero);
+  TESTSTOP
+
+  report("Spin lock, called");
+
+
+  TESTSTART
+  assert(pthread_spin_lock(&spin) == zero);
+  assert(pthread_spin_unlock(&spin) == zero);
+  TESTSTOP
+
+  report("Spin lock, inline");
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  assert(pthread_spin_destroy(&spin) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  return 0;
+}
@@ -0,0 +1,216 @@
+/*
+ * benchtest25.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure the operations that push and pop cleanup handlers on every
+ * call, and the push/pop pair itself.
+ *
+ * - A pthread_cleanup_push()/pthread_cleanup_pop(0) pair.
+ * - pthread_once() on a fresh control (runs the init routine under a
+ *   cleanup handler) and on one that is already done.
+ * - A pthread_cond_wait() round trip between two threads, each waiting
+ *   for its turn and then signalling the other.
+ *
+ * Reported in nanoseconds per operation (per round trip for the
+ * condition variable).
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS      10000000L
+#define ONCES           1000000L
+#define ROUNDTRIPS      100000L
+
+pthread_once_t * onces;
+pthread_mutex_t pingLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t pingCV = PTHREAD_COND_INITIALIZER;
+long turn = 0;
+volatile long shared = 0;
+
+static LONGLONG
+nowNs (void)
+{
+  LARGE_INTEGER count, freq;
+
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&freq);
+  return (LONGLONG) ((double) count.QuadPart * 1E9 / (double) freq.QuadPart);
+}
+
+static void
+#ifdef __CLEANUP_C
+__cdecl
+#endif
+noop (void * arg)
+{
+  shared++;
+}
+
+static void
+initRoutine (void)
+{
+  shared++;
+}
+
+double
+runPushPop (void)
+{
+  LONGLONG start;
+  long i;
+
+  start = nowNs();
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      pthread_cleanup_push(noop, NULL);
+      shared++;
+      pthread_cleanup_pop(0);
+    }
+
+  return (double) (nowNs() - start) / ITERATIONS;
+}
+
+double
+runOnce (int fresh)
+{
+  pthread_once_t done = PTHREAD_ONCE_INIT;
+  LONGLONG start;
+  long i;
+
+  if (fresh)
+    {
+      start = nowNs();
+      for (i = 0; i < ONCES; i++)
+        {
+          (void) pthread_once(&onces[i], initRoutine);
+        }
+      return (double) (nowNs() - start) / ONCES;
+    }
+
+  (void) pthread_once(&done, initRoutine);
+  start = nowNs();
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      (void) pthread_once(&done, initRoutine);
+    }
+
+  return (double) (nowNs() - start) / ITERATIONS;
+}
+
+/*
+ * Each side waits for its turn, then hands the turn over.
+ */
+static void
+pingPong (long me)
+{
+  long i;
+
+  for (i = 0; i < ROUNDTRIPS; i++)
+    {
+      assert(pthread_mutex_lock(&pingLock) == 0);
+      while (turn != me)
+        {
+          assert(pthread_cond_wait(&pingCV, &pingLock) == 0);
+        }
+      turn = 1 - me;
+      assert(pthread_cond_signal(&pingCV) == 0);
+      assert(pthread_mutex_unlock(&pingLock) == 0);
+    }
+}
+
+void *
+ponger (void * arg)
+{
+  pingPong((long)(size_t) arg);
+
+  return NULL;
+}
+
+double
+runPingPong (void)
+{
+  pthread_t t;
+  LONGLONG start;
+
+  start = nowNs();
+  assert(pthread_create(&t, NULL, ponger, (void *) 1) == 0);
+  pingPong(0);
+  assert(pthread_join(t, NULL) == 0);
+
+  return (double) (nowNs() - start) / ROUNDTRIPS;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  long i;
+
+  onces = (pthread_once_t *) malloc(ONCES * sizeof(pthread_once_t));
+  assert(onces != NULL);
+  for (i = 0; i < ONCES; i++)
+    {
+      pthread_once_t init = PTHREAD_ONCE_INIT;
+
+      onces[i] = init;
+    }
+
+  printf( "=============================================================================\n");
+  printf( "\nCleanup handlers and the calls that use them.\n\n");
+  printf( "%-45s %15s\n",
+	    "Operation",
+	    "nsec/op");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  printf( "%-45s %15.2f\n", "cleanup push/pop(0) pair", runPushPop());
+  printf( "%-45s %15.2f\n", "pthread_once (first call)", runOnce(1));
+  printf( "%-45s %15.2f\n", "pthread_once (done)", runOnce(0));
+  printf( "%-45s %15.2f\n", "cond wait round trip (2 threads)", runPingPong());
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  free(onces);
+
+  return 0;
+}
@@ -0,0 +1,249 @@
+/*
+ * benchtest26.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure the calls whose cost depended on each thread's cancel event:
+ *
+ * - pthread_create() and pthread_join() of a thread that does nothing
+ *   (thread creation no longer creates an event).
+ * - A sem_wait()/sem_post() round trip between two threads.
+ * - pthreadCancelableWait() on a handle that is already signalled.
+ * - pthread_delay_np() with a zero interval.
+ * - pthread_cancel() of a thread blocked in sem_wait(), to its join.
+ *
+ * Reported in nanoseconds per operation.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define CREATES         10000L
+#define ROUNDTRIPS      100000L
+#define ITERATIONS      1000000L
+#define CANCELS         2000L
+
+sem_t sems[2];
+sem_t blockSem;
+HANDLE signalled;
+
+static LONGLONG
+nowNs (void)
+{
+  LARGE_INTEGER count, freq;
+
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&freq);
+  return (LONGLONG) ((double) count.QuadPart * 1E9 / (double) freq.QuadPart);
+}
+
+void *
+nothing (void * arg)
+{
+  return arg;
+}
+
+double
+runCreateJoin (void)
+{
+  pthread_t t;
+  LONGLONG start;
+  long i;
+
+  start = nowNs();
+  for (i = 0; i < CREATES; i++)
+    {
+      assert(pthread_create(&t, NULL, nothing, NULL) == 0);
+      assert(pthread_join(t, NULL) == 0);
+    }
+
+  return (double) (nowNs() - start) / CREATES;
+}
+
+/*
+ * Each side waits on its own semaphore and posts the other's.
+ */
+static void
+pingPong (long me)
+{
+  long i;
+
+  for (i = 0; i < ROUNDTRIPS; i++)
+    {
+      if (me == 0)
+        {
+          assert(sem_post(&sems[1]) == 0);
+        }
+      assert(sem_wait(&sems[me]) == 0);
+      if (me == 1)
+        {
+          assert(sem_post(&sems[0]) == 0);
+        }
+    }
+}
+
+void *
+ponger (void * arg)
+{
+  pingPong((long)(size_t) arg);
+
+  return NULL;
+}
+
+double
+runPingPong (void)
+{
+  pthread_t t;
+  LONGLONG start;
+
+  start = nowNs();
+  assert(pthread_create(&t, NULL, ponger, (void *) 1) == 0);
+  pingPong(0);
+  assert(pthread_join(t, NULL) == 0);
+
+  return (double) (nowNs() - start) / ROUNDTRIPS;
+}
+
+double
+runCancelableWait (void)
+{
+  LONGLONG start;
+  long i;
+
+  start = nowNs();
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthreadCancelableWait(signalled) == 0);
+    }
+
+  return (double) (nowNs() - start) / ITERATIONS;
+}
+
+double
+runDelay (void)
+{
+  struct timespec zero = {0, 0};
+  LONGLONG start;
+  long i;
+
+  start = nowNs();
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_delay_np(&zero) == 0);
+    }
+
+  return (double) (nowNs() - start) / ITERATIONS;
+}
+
+void *
+blocked (void * arg)
+{
+  (void) sem_post((sem_t *) arg);
+  (void) sem_wait(&blockSem);
+
+  return NULL;
+}
+
+/*
+ * Only the time from pthread_cancel() to the end of pthread_join()
+ * is counted.
+ */
+double
+runCancel (void)
+{
+  sem_t ready;
+  pthread_t t;
+  void * result;
+  LONGLONG total = 0;
+  LONGLONG start;
+  long i;
+
+  assert(sem_init(&ready, 0, 0) == 0);
+  for (i = 0; i < CANCELS; i++)
+    {
+      assert(pthread_create(&t, NULL, blocked, &ready) == 0);
+      assert(sem_wait(&ready) == 0);
+      Sleep(0);
+      start = nowNs();
+      assert(pthread_cancel(t) == 0);
+      assert(pthread_join(t, &result) == 0);
+      total += nowNs() - start;
+      assert(result == PTHREAD_CANCELED);
+    }
+  assert(sem_destroy(&ready) == 0);
+
+  return (double) total / CANCELS;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  assert(sem_init(&sems[0], 0, 0) == 0);
+  assert(sem_init(&sems[1], 0, 0) == 0);
+  assert(sem_init(&blockSem, 0, 0) == 0);
+  signalled = CreateEvent(NULL, PTW32_TRUE, PTW32_TRUE, NULL);
+  assert(signalled != NULL);
+
+  printf( "=============================================================================\n");
+  printf( "\nBlocking calls and deferred cancellation.\n\n");
+  printf( "%-45s %15s\n",
+	    "Operation",
+	    "nsec/op");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  printf( "%-45s %15.2f\n", "pthread_create + pthread_join", runCreateJoin());
+  printf( "%-45s %15.2f\n", "sem_wait round trip (2 threads)", runPingPong());
+  printf( "%-45s %15.2f\n", "pthreadCancelableWait (signalled)", runCancelableWait());
+  printf( "%-45s %15.2f\n", "pthread_delay_np (0)", runDelay());
+  printf( "%-45s %15.2f\n", "pthread_cancel to join (in sem_wait)", runCancel());
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  CloseHandle(signalled);
+  assert(sem_destroy(&blockSem) == 0);
+  assert(sem_destroy(&sems[1]) == 0);
+  assert(sem_destroy(&sems[0]) == 0);
+
+  return 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * benchtest27.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ * Measure the CPU set routines on sets of CPU_SETSIZE (1024) and of
+ * 4096 CPUs, and the calls that build a set from the process or
+ * thread affinity:
+ *
+ * - CPU_COUNT_S(), CPU_AND_S() and CPU_EQUAL_S().
+ * - CPU_ISSET_S() of every CPU in the set.
+ * - sched_getaffinity(), pthread_getaffinity_np() and
+ *   pthread_num_processors_np().
+ *
+ * Reported in nanoseconds per operation.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS      1000000L
+#define SCANS           10000L
+#define CALLS           100000L
+#define BIGSETSIZE      4096
+
+cpu_set_t * sets[3];
+volatile int sink;
+
+static LONGLONG
+nowNs (void)
+{
+  LARGE_INTEGER count, freq;
+
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&freq);
+  return (LONGLONG) ((double) count.QuadPart * 1E9 / (double) freq.QuadPart);
+}
+
+double
+runCount (size_t size)
+{
+  LONGLONG start;
+  long i;
+  int n = 0;
+
+  start = nowNs();
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      n += CPU_COUNT_S(size, sets[0]);
+    }
+  sink = n;
+
+  return (double) (nowNs() - start) / ITERATIONS;
+}
+
+double
+runAnd (size_t size)
+{
+  LONGLONG start;
+  long i;
+
+  start = nowNs();
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      CPU_AND_S(size, sets[2], sets[0], sets[1]);
+    }
+
+  return (double) (nowNs() - start) / ITERATIONS;
+}
+
+double
+runEqual (size_t size)
+{
+  LONGLONG start;
+  long i;
+  int n = 0;
+
+  start = nowNs();
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      n += CPU_EQUAL_S(size, sets[0], sets[1]);
+    }
+  sink = n;
+
+  return (double) (nowNs() - start) / ITERATIONS;
+}
+
+double
+runScan (size_t size)
+{
+  LONGLONG start;
+  long i;
+  int cpu;
+  int n = 0;
+
+  start = nowNs();
+  for (i = 0; i < SCANS; i++)
+    {
+      for (cpu = 0; cpu < (int) size * 8; cpu++)
+        {
+          n += CPU_ISSET_S(cpu, size, sets[0]);
+        }
+    }
+  sink = n;
+
+  return (double) (nowNs() - start) / SCANS;
+}
+
+double
+runGetaffinity (void)
+{
+  cpu_set_t mask;
+  LONGLONG start;
+  long i;
+
+  start = nowNs();
+  for (i = 0; i < CALLS; i++)
+    {
+      assert(sched_getaffinity(0, sizeof(cpu_set_t), &mask) == 0);
+    }
+
+  return (double) (nowNs() - start) / CALLS;
+}
+
+double
+runThreadGetaffinity (void)
+{
+  cpu_set_t mask;
+  pthread_t self = pthread_self();
+  LONGLONG start;
+  long i;
+
+  start = nowNs();
+  for (i = 0; i < CALLS; i++)
+    {
+      assert(pthread_getaffinity_np(self, sizeof(cpu_set_t), &mask) == 0);
+    }
+
+  return (double) (nowNs() - start) / CALLS;
+}
+
+double
+runNumProcessors (void)
+{
+  LONGLONG start;
+  long i;
+  int n = 0;
+
+  start = nowNs();
+  for (i = 0; i < CALLS; i++)
+    {
+      n += pthread_num_processors_np();
+    }
+  sink = n;
+
+  return (double) (nowNs() - start) / CALLS;
+}
+
+static void
+report (size_t size)
+{
+  char label[64];
+
+  sprintf(label, "CPU_COUNT_S (%d CPUs)", (int) size * 8);
+  printf( "%-45s %15.2f\n", label, runCount(size));
+  sprintf(label, "CPU_AND_S (%d CPUs)", (int) size * 8);
+  printf( "%-45s %15.2f\n", label, runAnd(size));
+  sprintf(label, "CPU_EQUAL_S (%d CPUs)", (int) size * 8);
+  printf( "%-45s %15.2f\n", label, runEqual(size));
+  sprintf(label, "CPU_ISSET_S, every CPU (%d CPUs)", (int) size * 8);
+  printf( "%-45s %15.2f\n", label, runScan(size));
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  size_t size = CPU_ALLOC_SIZE(BIGSETSIZE);
+  int cpu;
+  int i;
+
+  for (i = 0; i < 3; i++)
+    {
+      assert((sets[i] = CPU_ALLOC(BIGSETSIZE)) != NULL);
+      CPU_ZERO_S(size, sets[i]);
+    }
+  for (cpu = 0; cpu < BIGSETSIZE; cpu += 3)
+    {
+      CPU_SET_S(cpu, size, sets[0]);
+      CPU_SET_S(cpu, size, sets[1]);
+    }
+
+  printf( "=============================================================================\n");
+  printf( "\nCPU sets and affinity.\n\n");
+  printf( "%-45s %15s\n",
+	    "Operation",
+	    "nsec/op");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  report(sizeof(cpu_set_t));
+  report(size);
+  printf( "%-45s %15.2f\n", "sched_getaffinity", runGetaffinity());
+  printf( "%-45s %15.2f\n", "pthread_getaffinity_np (self)", runThreadGetaffinity());
+  printf( "%-45s %15.2f\n", "pthread_num_processors_np", runNumProcessors());
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  for (i = 0; i < 3; i++)
+    {
+      CPU_FREE(sets[i]);
+    }
+
+  return 0;
+}
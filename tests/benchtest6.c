@@ -0,0 +1,195 @@
+/*
+ * benchtest6.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure acquire latency on a contended mutex.
+ *
+ * - Mutex
+ *   Several threads repeatedly lock, hold briefly and unlock one mutex.
+ *   Every acquire is timed and the tail of the latency distribution
+ *   (p99, p99.9, max) is reported alongside the throughput, for the
+ *   normal (barging) kind and for PTHREAD_MUTEX_FAIR_NP (FIFO handoff).
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define THREADS         4
+#define ITERATIONS      50000L
+#define HOLDWORK        200
+#define IDLEWORK        200
+
+pthread_mutex_t mx;
+pthread_mutexattr_t ma;
+LONGLONG samples[THREADS * ITERATIONS];
+LARGE_INTEGER frequency;
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+long durationMilliSecs;
+volatile long sink = 0;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+static void
+work (int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      sink++;
+    }
+}
+
+static int
+compareSamples (const void * a, const void * b)
+{
+  LONGLONG x = *(const LONGLONG *) a;
+  LONGLONG y = *(const LONGLONG *) b;
+
+  return (x < y) ? -1 : (x > y);
+}
+
+static double
+toMicroSecs (LONGLONG ticks)
+{
+  return (double) ticks * 1E6 / (double) frequency.QuadPart;
+}
+
+void *
+locker (void * arg)
+{
+  LONGLONG * mySamples = &samples[(int)(size_t) arg * ITERATIONS];
+  LARGE_INTEGER t0, t1;
+  long i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      QueryPerformanceCounter (&t0);
+      assert(pthread_mutex_lock(&mx) == 0);
+      QueryPerformanceCounter (&t1);
+      mySamples[i] = t1.QuadPart - t0.QuadPart;
+      work (HOLDWORK);
+      assert(pthread_mutex_unlock(&mx) == 0);
+      work (IDLEWORK);
+    }
+
+  return NULL;
+}
+
+void
+runTest (char * testNameString, int mType)
+{
+  pthread_t t[THREADS];
+  const long n = THREADS * ITERATIONS;
+  int i;
+
+  assert(pthread_mutexattr_settype(&ma, mType) == 0);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+
+  /*
+   * Hold the mutex until every thread is running so that they all
+   * start contending together.
+   */
+  assert(pthread_mutex_lock(&mx) == 0);
+  for (i = 0; i < THREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, locker, (void *)(size_t) i) == 0);
+    }
+  Sleep(100);
+  PTW32_FTIME(&currSysTimeStart);
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  for (i = 0; i < THREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+
+  qsort(samples, n, sizeof(samples[0]), compareSamples);
+
+  printf( "%-24s %9ld %10.3f %10.3f %10.3f %10.3f\n",
+	    testNameString,
+          durationMilliSecs,
+          toMicroSecs(samples[n / 2]),
+          toMicroSecs(samples[n - n / 100]),
+          toMicroSecs(samples[n - n / 1000]),
+          toMicroSecs(samples[n - 1]));
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  assert(QueryPerformanceFrequency(&frequency) != 0);
+
+  pthread_mutexattr_init(&ma);
+
+  printf( "=============================================================================\n");
+  printf( "\nContended lock acquire latency.\n%d threads x %ld iterations\n\n",
+          THREADS, ITERATIONS);
+  printf( "%-24s %9s %10s %10s %10s %10s\n",
+	    "Test",
+	    "Total(ms)",
+	    "p50(usec)",
+	    "p99(usec)",
+	    "p99.9(us)",
+	    "max(usec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  runTest("PTHREAD_MUTEX_NORMAL", PTHREAD_MUTEX_NORMAL);
+
+  runTest("PTHREAD_MUTEX_FAIR_NP", PTHREAD_MUTEX_FAIR_NP);
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  pthread_mutexattr_destroy(&ma);
+
+  return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * benchtest7.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure time taken to complete an elementary operation.
+ *
+ * - Mutex
+ *   Lock plus unlock on an unlocked mutex, PTHREAD_MUTEX_NORMAL
+ *   versus PTHREAD_MUTEX_BIASED_NP:
+ *   - single owner: one thread does every iteration;
+ *   - migrating owner: the iterations are split over a sequence of
+ *     threads, so the mutex changes hands between phases.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS      10000000L
+#define PHASES          10
+
+pthread_mutex_t mx;
+pthread_mutexattr_t ma;
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+long durationMilliSecs;
+long overHeadMilliSecs = 0;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+void *
+owner (void * arg)
+{
+  long n = (long)(size_t) arg;
+  long i;
+
+  for (i = 0; i < n; i++)
+    {
+      assert(pthread_mutex_lock(&mx) == 0);
+      assert(pthread_mutex_unlock(&mx) == 0);
+    }
+
+  return NULL;
+}
+
+void
+reportTest (char * testNameString)
+{
+  durationMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop) - overHeadMilliSecs;
+
+  printf( "%-45s %15ld %15.3f\n",
+	    testNameString,
+          durationMilliSecs,
+          (float) durationMilliSecs * 1E3 / ITERATIONS);
+}
+
+void
+runTest (char * testNameString, int mType, int phases)
+{
+  pthread_t t;
+  int i;
+
+  assert(pthread_mutexattr_settype(&ma, mType) == 0);
+  assert(pthread_mutex_init(&mx, &ma) == 0);
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < phases; i++)
+    {
+      assert(pthread_create(&t, NULL, owner, (void *)(size_t)(ITERATIONS / phases)) == 0);
+      assert(pthread_join(t, NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  reportTest(testNameString);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  pthread_t t;
+
+  pthread_mutexattr_init(&ma);
+
+  printf( "=============================================================================\n");
+  printf( "\nLock plus unlock on an unlocked mutex.\n%ld iterations, migrating owner over %d threads\n\n",
+          ITERATIONS, PHASES);
+  printf( "%-45s %15s %15s\n",
+	    "Test",
+	    "Total(msec)",
+	    "average(usec)");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  /*
+   * Time the loop overhead (and thread creation) with a mutex that is
+   * never used so we can subtract it from the actual test times.
+   */
+  PTW32_FTIME(&currSysTimeStart);
+  assert(pthread_create(&t, NULL, owner, (void *) 0) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  PTW32_FTIME(&currSysTimeStop);
+  overHeadMilliSecs = GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+
+  runTest("PTHREAD_MUTEX_NORMAL (single owner)", PTHREAD_MUTEX_NORMAL, 1);
+
+  runTest("PTHREAD_MUTEX_BIASED_NP (single owner)", PTHREAD_MUTEX_BIASED_NP, 1);
+
+  printf( ".............................................................................\n");
+
+  runTest("PTHREAD_MUTEX_NORMAL (migrating owner)", PTHREAD_MUTEX_NORMAL, PHASES);
+
+  runTest("PTHREAD_MUTEX_BIASED_NP (migrating owner)", PTHREAD_MUTEX_BIASED_NP, PHASES);
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  pthread_mutexattr_destroy(&ma);
+
+  return 0;
+}
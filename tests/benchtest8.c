@@ -0,0 +1,201 @@
+/*
+ * benchtest8.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure throughput of operations on shared data.
+ *
+ * - Mutex versus flat combining
+ *   1 to 64 threads update a shared counter, or push and pop a
+ *   shared queue, either by locking a mutex around the update or
+ *   by executing the update through a pthread_combiner_t.
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define ITERATIONS      1000000L
+#define MAXTHREADS      64
+#define QUEUESIZE       256
+
+pthread_mutex_t mx;
+pthread_combiner_t combiner;
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+long durationMilliSecs;
+int nThreads;
+
+/*
+ * The shared data.
+ */
+long counter = 0;
+struct {
+  long head;
+  long tail;
+  void * items[QUEUESIZE];
+} queue;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+static void *
+counterOp (void * arg)
+{
+  return (void *)(size_t) ++counter;
+}
+
+/*
+ * Push arg, or pop if arg is NULL. Each thread pushes then pops, so the
+ * queue never holds more than one item per thread.
+ */
+static void *
+queueOp (void * arg)
+{
+  void * item = NULL;
+
+  if (arg != NULL)
+    {
+      queue.items[queue.tail++ % QUEUESIZE] = arg;
+    }
+  else if (queue.head != queue.tail)
+    {
+      item = queue.items[queue.head++ % QUEUESIZE];
+    }
+
+  return item;
+}
+
+typedef void * (*op_t) (void *);
+
+typedef struct {
+  op_t op;
+  int useCombiner;
+} job_t;
+
+void *
+worker (void * arg)
+{
+  job_t * job = (job_t *) arg;
+  long n = ITERATIONS / nThreads;
+  long i;
+
+  for (i = 0; i < n; i++)
+    {
+      void * a = (job->op == queueOp && (i & 1) == 0) ? (void *) job : NULL;
+
+      if (job->useCombiner)
+        {
+          assert(pthread_combiner_execute_np(&combiner, job->op, a, NULL) == 0);
+        }
+      else
+        {
+          assert(pthread_mutex_lock(&mx) == 0);
+          (void) (*job->op) (a);
+          assert(pthread_mutex_unlock(&mx) == 0);
+        }
+    }
+
+  return NULL;
+}
+
+long
+runTest (op_t op, int useCombiner)
+{
+  pthread_t t[MAXTHREADS];
+  job_t job;
+  int i;
+
+  job.op = op;
+  job.useCombiner = useCombiner;
+  counter = 0;
+  queue.head = queue.tail = 0;
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, &job) == 0);
+    }
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  return GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  assert(pthread_mutex_init(&mx, NULL) == 0);
+  assert(pthread_combiner_init_np(&combiner) == 0);
+
+  printf( "=============================================================================\n");
+  printf( "\nShared counter and shared queue.\n%ld operations in total per test, times in msec\n\n",
+          ITERATIONS);
+  printf( "%-10s %15s %15s %15s %15s\n",
+	    "Threads",
+	    "Counter/mutex",
+	    "Counter/comb",
+	    "Queue/mutex",
+	    "Queue/comb");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (nThreads = 1; nThreads <= MAXTHREADS; nThreads *= 2)
+    {
+      long cm = runTest(counterOp, 0);
+      long cc = runTest(counterOp, 1);
+      long qm = runTest(queueOp, 0);
+      long qc = runTest(queueOp, 1);
+
+      printf( "%-10d %15ld %15ld %15ld %15ld\n", nThreads, cm, cc, qm, qc);
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  assert(pthread_combiner_destroy_np(&combiner) == 0);
+  assert(pthread_mutex_destroy(&mx) == 0);
+
+  return 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * benchtest9.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Measure reader scaling on read-mostly data.
+ *
+ * - Sequence lock versus read-write lock
+ *   1 to MAXTHREADS threads each read a small shared structure
+ *   READS times while one writer updates it every millisecond.
+ *   Readers use either pthread_seqlock_read_begin_np() and
+ *   pthread_seqlock_read_retry_np(), or pthread_rwlock_rdlock()
+ *   and pthread_rwlock_unlock().
+ */
+
+#include "test.h"
+
+#ifdef __GNUC__
+#include <stdlib.h>
+#endif
+
+#include "benchtest.h"
+
+#define READS           1000000L
+#define MAXTHREADS      16
+
+pthread_seqlock_t seqlock;
+pthread_rwlock_t rwlock;
+PTW32_STRUCT_TIMEB currSysTimeStart;
+PTW32_STRUCT_TIMEB currSysTimeStop;
+int nThreads;
+volatile int stop = 0;
+
+struct {
+  long a;
+  long b;
+  long c;
+  long d;
+} stats;
+
+#define GetDurationMilliSecs(_TStart, _TStop) ((long)((_TStop.time*1000+_TStop.millitm) \
+                                               - (_TStart.time*1000+_TStart.millitm)))
+
+void *
+seqReader (void * arg)
+{
+  unsigned int seq;
+  long sum = 0;
+  long i;
+
+  for (i = 0; i < READS; i++)
+    {
+      do
+        {
+          (void) pthread_seqlock_read_begin_np(&seqlock, &seq);
+          sum += stats.a + stats.b + stats.c + stats.d;
+        }
+      while (pthread_seqlock_read_retry_np(&seqlock, seq));
+    }
+
+  return (void *)(size_t) sum;
+}
+
+void *
+rwReader (void * arg)
+{
+  long sum = 0;
+  long i;
+
+  for (i = 0; i < READS; i++)
+    {
+      assert(pthread_rwlock_rdlock(&rwlock) == 0);
+      sum += stats.a + stats.b + stats.c + stats.d;
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) sum;
+}
+
+void *
+writer (void * arg)
+{
+  int useSeqlock = (int)(size_t) arg;
+
+  while (!stop)
+    {
+      if (useSeqlock)
+        {
+          assert(pthread_seqlock_write_lock_np(&seqlock) == 0);
+          stats.a++; stats.b++; stats.c++; stats.d++;
+          assert(pthread_seqlock_write_unlock_np(&seqlock) == 0);
+        }
+      else
+        {
+          assert(pthread_rwlock_wrlock(&rwlock) == 0);
+          stats.a++; stats.b++; stats.c++; stats.d++;
+          assert(pthread_rwlock_unlock(&rwlock) == 0);
+        }
+      Sleep(1);
+    }
+
+  return NULL;
+}
+
+long
+runTest (int useSeqlock)
+{
+  pthread_t t[MAXTHREADS];
+  pthread_t w;
+  int i;
+
+  stop = 0;
+  assert(pthread_create(&w, NULL, writer, (void *)(size_t) useSeqlock) == 0);
+
+  PTW32_FTIME(&currSysTimeStart);
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_create(&t[i], NULL, useSeqlock ? seqReader : rwReader, NULL) == 0);
+    }
+  for (i = 0; i < nThreads; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  PTW32_FTIME(&currSysTimeStop);
+
+  stop = 1;
+  assert(pthread_join(w, NULL) == 0);
+
+  return GetDurationMilliSecs(currSysTimeStart, currSysTimeStop);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  long sl, rw;
+
+  assert(pthread_seqlock_init_np(&seqlock) == 0);
+  assert(pthread_rwlock_init(&rwlock, NULL) == 0);
+
+  printf( "=============================================================================\n");
+  printf( "\nRead-mostly data: %ld reads per thread, one writer per msec.\n\n",
+          READS);
+  printf( "%-10s %15s %15s %15s %15s\n",
+	    "Threads",
+	    "seqlock(msec)",
+	    "reads/usec",
+	    "rwlock(msec)",
+	    "reads/usec");
+  printf( "-----------------------------------------------------------------------------\n");
+
+  for (nThreads = 1; nThreads <= MAXTHREADS; nThreads *= 2)
+    {
+      sl = runTest(1);
+      rw = runTest(0);
+
+      printf( "%-10d %15ld %15.3f %15ld %15.3f\n",
+              nThreads,
+              sl, (float) READS * nThreads / 1E3 / (sl > 0 ? sl : 1),
+              rw, (float) READS * nThreads / 1E3 / (rw > 0 ? rw : 1));
+    }
+
+  printf( "=============================================================================\n");
+
+  /*
+   * End of tests.
+   */
+
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+  assert(pthread_seqlock_destroy_np(&seqlock) == 0);
+
+  return 0;
+}
@@ -0,0 +1,232 @@
+/*
+ * cancel10.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test deferred cancellation of threads blocked in each kind of
+ * cancellation point, now that a request is a flag plus an unpark of
+ * the thread's park event rather than a dedicated event:
+ *
+ * - sem_wait(), pthread_cond_wait(), pthread_delay_np() and
+ *   pthreadCancelableWait() on an event that is never signalled;
+ * - a thread cancelled before it has ever blocked, so has no park
+ *   event yet, then entering sem_wait();
+ * - a request made while cancellation is disabled, acted on only when
+ *   it is enabled again;
+ * - a thread blocked in pthread_mutex_lock(), which isn't a
+ *   cancellation point, keeps waiting through the unpark;
+ * - pthreadCancelableTimedWait() still times out.
+ *
+ * Depends on API functions:
+ *	pthread_create()
+ *	pthread_join()
+ *	pthread_cancel()
+ *	pthread_testcancel()
+ *	pthread_setcancelstate()
+ *	pthreadCancelableWait()
+ *	pthreadCancelableTimedWait()
+ */
+
+#include "test.h"
+
+enum {
+  IN_SEM_WAIT,
+  IN_COND_WAIT,
+  IN_DELAY,
+  IN_CANCELABLE_WAIT,
+  NUMCASES
+};
+
+static sem_t sem;
+static pthread_mutex_t cvLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cv = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t heldLock = PTHREAD_MUTEX_INITIALIZER;
+static HANDLE neverSignalled;
+static volatile long started[NUMCASES];
+static volatile int go = 0;
+static volatile int gotLock = 0;
+static volatile int reenabled = 0;
+
+void *
+blocker(void * arg)
+{
+  int which = (int)(size_t) arg;
+  struct timespec forever = {3600, 0};
+
+  started[which] = 1;
+
+  switch (which)
+    {
+    case IN_SEM_WAIT:
+      (void) sem_wait(&sem);
+      break;
+    case IN_COND_WAIT:
+      assert(pthread_mutex_lock(&cvLock) == 0);
+      pthread_cleanup_push(pthread_mutex_unlock, &cvLock);
+      for (;;)
+        {
+          (void) pthread_cond_wait(&cv, &cvLock);
+        }
+      pthread_cleanup_pop(1);
+      break;
+    case IN_DELAY:
+      (void) pthread_delay_np(&forever);
+      break;
+    case IN_CANCELABLE_WAIT:
+      (void) pthreadCancelableWait(neverSignalled);
+      break;
+    }
+
+  return NULL;
+}
+
+/*
+ * Neither blocks nor sleeps through the library until told to go.
+ */
+void *
+lateBlocker(void * arg)
+{
+  while (!go)
+    {
+      Sleep(1);
+    }
+  (void) sem_wait(&sem);
+
+  return NULL;
+}
+
+void *
+disabled(void * arg)
+{
+  int oldstate;
+
+  assert(pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldstate) == 0);
+  started[0] = 1;
+  while (!go)
+    {
+      Sleep(1);
+    }
+  /* Not a cancellation point while disabled. */
+  assert(pthreadCancelableTimedWait(neverSignalled, 20) == ETIMEDOUT);
+  reenabled = 1;
+  assert(pthread_setcancelstate(oldstate, NULL) == 0);
+  pthread_testcancel();
+  reenabled = 2;
+
+  return NULL;
+}
+
+void *
+locker(void * arg)
+{
+  assert(pthread_mutex_lock(&heldLock) == 0);
+  gotLock = 1;
+  pthread_cleanup_push(pthread_mutex_unlock, &heldLock);
+  pthread_testcancel();
+  pthread_cleanup_pop(1);
+
+  return NULL;
+}
+
+static void
+waitStarted(volatile long * flag)
+{
+  while (!*flag)
+    {
+      Sleep(1);
+    }
+  /* Let it get into the wait. */
+  Sleep(100);
+}
+
+int
+main()
+{
+  pthread_t t[NUMCASES];
+  pthread_t tl;
+  void * result;
+  DWORD start;
+  int i;
+
+  assert(sem_init(&sem, 0, 0) == 0);
+  neverSignalled = CreateEvent(NULL, PTW32_TRUE, PTW32_FALSE, NULL);
+  assert(neverSignalled != NULL);
+
+  for (i = 0; i < NUMCASES; i++)
+    {
+      assert(pthread_create(&t[i], NULL, blocker, (void *)(size_t) i) == 0);
+      waitStarted(&started[i]);
+      assert(pthread_cancel(t[i]) == 0);
+      assert(pthread_join(t[i], &result) == 0);
+      assert(result == PTHREAD_CANCELED);
+    }
+
+  assert(pthread_create(&tl, NULL, lateBlocker, NULL) == 0);
+  assert(pthread_cancel(tl) == 0);
+  go = 1;
+  assert(pthread_join(tl, &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+
+  go = 0;
+  started[0] = 0;
+  assert(pthread_create(&tl, NULL, disabled, NULL) == 0);
+  waitStarted(&started[0]);
+  assert(pthread_cancel(tl) == 0);
+  go = 1;
+  assert(pthread_join(tl, &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+  assert(reenabled == 1);
+
+  assert(pthread_mutex_lock(&heldLock) == 0);
+  assert(pthread_create(&tl, NULL, locker, NULL) == 0);
+  Sleep(100);
+  assert(pthread_cancel(tl) == 0);
+  Sleep(100);
+  assert(gotLock == 0);
+  assert(pthread_mutex_unlock(&heldLock) == 0);
+  assert(pthread_join(tl, &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+  assert(gotLock == 1);
+  assert(pthread_mutex_trylock(&heldLock) == 0);
+  assert(pthread_mutex_unlock(&heldLock) == 0);
+
+  start = GetTickCount();
+  assert(pthreadCancelableTimedWait(neverSignalled, 100) == ETIMEDOUT);
+  assert(GetTickCount() - start >= 90);
+
+  assert(CloseHandle(neverSignalled));
+  assert(sem_destroy(&sem) == 0);
+
+  return 0;
+}
@@ -0,0 +1,231 @@
+/*
+ * cleanup4.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test the cleanup handler stack in every cleanup model, including
+ * the C one: handlers run last pushed first on pthread_exit() and on
+ * deferred cancellation, pthread_cleanup_pop() runs a handler only if
+ * asked to, each thread has its own stack, and a Win32 thread can push
+ * and pop handlers too. In the C model a handler that exits runs only
+ * once, since it is unlinked before it runs (a C++ handler can't exit
+ * from the destructor that runs it).
+ *
+ * Depends on API functions:
+ *	pthread_create()
+ *	pthread_join()
+ *	pthread_cancel()
+ *	pthread_exit()
+ *	pthread_testcancel()
+ *	pthread_cleanup_push()
+ *	pthread_cleanup_pop()
+ */
+
+#include "test.h"
+
+#ifndef _UWIN
+#include <process.h>
+#endif
+
+enum {
+  NUMTHREADS = 4,
+  DEPTH = 3
+};
+
+typedef struct {
+  int trace[DEPTH * 2];
+  int count;
+} record_t;
+
+static record_t records[NUMTHREADS];
+static record_t exitRecord;
+static record_t win32Record;
+static pthread_barrier_t startBarrier;
+#ifdef __CLEANUP_C
+static int exitHandlerRuns = 0;
+#endif
+
+typedef struct {
+  record_t * rec;
+  int id;
+} step_t;
+
+static void
+#ifdef __CLEANUP_C
+__cdecl
+#endif
+note(void * arg)
+{
+  step_t * step = (step_t *) arg;
+
+  step->rec->trace[step->rec->count++] = step->id;
+}
+
+#ifdef __CLEANUP_C
+static void __cdecl
+exitingHandler(void * arg)
+{
+  exitHandlerRuns++;
+  pthread_exit(arg);
+}
+#endif
+
+/*
+ * Push three handlers and block in a cancellation point under them.
+ */
+void *
+canceled(void * arg)
+{
+  record_t * rec = (record_t *) arg;
+  step_t s1 = {rec, 1}, s2 = {rec, 2}, s3 = {rec, 3};
+
+  pthread_cleanup_push(note, &s1);
+  pthread_cleanup_push(note, &s2);
+  pthread_cleanup_push(note, &s3);
+  (void) pthread_barrier_wait(&startBarrier);
+  for (;;)
+    {
+      Sleep(10);
+      pthread_testcancel();
+    }
+  pthread_cleanup_pop(0);
+  pthread_cleanup_pop(0);
+  pthread_cleanup_pop(0);
+
+  return NULL;
+}
+
+/*
+ * Pop one handler without running it, one by running it, then exit
+ * from under the last.
+ */
+void *
+exiting(void * arg)
+{
+  record_t * rec = (record_t *) arg;
+  step_t s1 = {rec, 1}, s2 = {rec, 2}, s3 = {rec, 3};
+
+  pthread_cleanup_push(note, &s1);
+  pthread_cleanup_push(note, &s2);
+  pthread_cleanup_push(note, &s3);
+  pthread_cleanup_pop(0);
+  pthread_cleanup_pop(1);
+  pthread_exit((void *)(size_t) 42);
+  pthread_cleanup_pop(0);
+
+  return NULL;
+}
+
+#ifdef __CLEANUP_C
+void *
+exitFromHandler(void * arg)
+{
+  pthread_cleanup_push(exitingHandler, (void *)(size_t) 7);
+  pthread_cleanup_pop(1);
+
+  return NULL;
+}
+#endif
+
+unsigned __stdcall
+win32Thread(void * arg)
+{
+  record_t * rec = (record_t *) arg;
+  step_t s1 = {rec, 1}, s2 = {rec, 2};
+
+  pthread_cleanup_push(note, &s1);
+  pthread_cleanup_push(note, &s2);
+  pthread_cleanup_pop(1);
+  pthread_cleanup_pop(1);
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  pthread_t te;
+  void * result;
+  HANDLE h;
+  unsigned thrAddr;
+  int i;
+
+  assert(pthread_barrier_init(&startBarrier, NULL, NUMTHREADS + 1) == 0);
+
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, canceled, &records[i]) == 0);
+    }
+  (void) pthread_barrier_wait(&startBarrier);
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_cancel(t[i]) == 0);
+    }
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], &result) == 0);
+      assert(result == PTHREAD_CANCELED);
+      assert(records[i].count == 3);
+      assert(records[i].trace[0] == 3);
+      assert(records[i].trace[1] == 2);
+      assert(records[i].trace[2] == 1);
+    }
+
+  assert(pthread_create(&te, NULL, exiting, &exitRecord) == 0);
+  assert(pthread_join(te, &result) == 0);
+  assert(result == (void *)(size_t) 42);
+  assert(exitRecord.count == 2);
+  assert(exitRecord.trace[0] == 2);
+  assert(exitRecord.trace[1] == 1);
+
+#ifdef __CLEANUP_C
+  assert(pthread_create(&te, NULL, exitFromHandler, NULL) == 0);
+  assert(pthread_join(te, &result) == 0);
+  assert(result == (void *)(size_t) 7);
+  assert(exitHandlerRuns == 1);
+#endif
+
+  h = (HANDLE) _beginthreadex(NULL, 0, win32Thread, &win32Record, 0, &thrAddr);
+  assert(h != 0);
+  assert(WaitForSingleObject(h, INFINITE) == WAIT_OBJECT_0);
+  CloseHandle(h);
+  assert(win32Record.count == 2);
+  assert(win32Record.trace[0] == 2);
+  assert(win32Record.trace[1] == 1);
+
+  assert(pthread_barrier_destroy(&startBarrier) == 0);
+
+  return 0;
+}
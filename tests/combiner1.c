@@ -0,0 +1,101 @@
+/* 
+ * combiner1.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test pthread_combiner_execute_np().
+ * Several threads increment a shared counter through a combiner. Every
+ * increment must be applied exactly once and each caller must get the
+ * result of its own operation.
+ *
+ * Depends on API functions:
+ *	pthread_combiner_init_np()
+ *	pthread_combiner_execute_np()
+ *	pthread_combiner_destroy_np()
+ */
+
+#include "test.h"
+
+#define THREADS         8
+#define ITERATIONS      10000
+
+static pthread_combiner_t combiner;
+static long counter = 0;
+
+static void *
+increment (void * arg)
+{
+  counter += (long)(size_t) arg;
+  return (void *)(size_t) counter;
+}
+
+void * worker(void * arg)
+{
+  void * result;
+  long last = 0;
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_combiner_execute_np(&combiner, increment, (void *) 1, &result) == 0);
+      /*
+       * The counter only increases, so our own results must too.
+       */
+      assert((long)(size_t) result > last);
+      last = (long)(size_t) result;
+    }
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t t[THREADS];
+  void * result;
+  int i;
+
+  assert(pthread_combiner_init_np(&combiner) == 0);
+
+  assert(pthread_combiner_execute_np(&combiner, NULL, NULL, NULL) == EINVAL);
+  assert(pthread_combiner_execute_np(&combiner, increment, (void *) 0, &result) == 0);
+  assert(result == (void *) 0);
+
+  for (i = 0; i < THREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, worker, NULL) == 0);
+    }
+
+  for (i = 0; i < THREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(counter == THREADS * ITERATIONS);
+
+  assert(pthread_combiner_destroy_np(&combiner) == 0);
+  assert(pthread_combiner_destroy_np(&combiner) == EINVAL);
+
+  return 0;
+}
@@ -0,0 +1,145 @@
+/* 
+ * condvar10.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test that pthread_timechange_handler_np() wakes condition variables
+ * that have timed waiters and leaves others alone.
+ *
+ * Depends on API functions:
+ *	pthread_cond_init()
+ *	pthread_cond_destroy()
+ *	pthread_cond_wait()
+ *	pthread_cond_timedwait()
+ *	pthread_cond_broadcast()
+ *	pthread_timechange_handler_np()
+ */
+
+#include "test.h"
+#include <sys/timeb.h>
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t timedCV;
+static pthread_cond_t plainCV;
+static int done = 0;
+static int waiting = 0;
+static int timedWakeups = 0;
+static int plainWakeups = 0;
+
+void * timedWaiter(void * arg)
+{
+  struct timespec abstime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+  PTW32_STRUCT_TIMEB currSysTime;
+
+  PTW32_FTIME(&currSysTime);
+  abstime.tv_sec = (long)currSysTime.time + 60;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  waiting++;
+  while (!done)
+    {
+      assert(pthread_cond_timedwait(&timedCV, &mutex, &abstime) == 0);
+      timedWakeups++;
+    }
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return 0;
+}
+
+void * plainWaiter(void * arg)
+{
+  assert(pthread_mutex_lock(&mutex) == 0);
+  waiting++;
+  while (!done)
+    {
+      assert(pthread_cond_wait(&plainCV, &mutex) == 0);
+      plainWakeups++;
+    }
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t t[2];
+  int n;
+
+  assert(pthread_cond_init(&timedCV, NULL) == 0);
+  assert(pthread_cond_init(&plainCV, NULL) == 0);
+
+  /*
+   * Nothing to wake.
+   */
+  assert(pthread_timechange_handler_np(NULL) == NULL);
+
+  assert(pthread_create(&t[0], NULL, timedWaiter, NULL) == 0);
+  assert(pthread_create(&t[1], NULL, plainWaiter, NULL) == 0);
+
+  do
+    {
+      Sleep(10);
+      assert(pthread_mutex_lock(&mutex) == 0);
+      n = waiting;
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+  while (n < 2);
+
+  assert(pthread_timechange_handler_np(NULL) == NULL);
+
+  do
+    {
+      Sleep(10);
+      assert(pthread_mutex_lock(&mutex) == 0);
+      n = timedWakeups;
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+  while (n == 0);
+
+  Sleep(100);
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(plainWakeups == 0);
+  done = 1;
+  assert(pthread_cond_broadcast(&timedCV) == 0);
+  assert(pthread_cond_broadcast(&plainCV) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_join(t[1], NULL) == 0);
+
+  /*
+   * The timed waiter has gone so timedCV is no longer listed.
+   */
+  assert(pthread_cond_destroy(&timedCV) == 0);
+  assert(pthread_timechange_handler_np(NULL) == NULL);
+  assert(pthread_cond_destroy(&plainCV) == 0);
+
+  return 0;
+}
@@ -101,7 +101,7 @@ main()
 
   do
     {
-      i = (NUM_CV - 1) * rand() / RAND_MAX;
+      i = (int) (NUM_CV * (double) rand() / ((double) RAND_MAX + 1));
       if (cv[i] != NULL)
         {
           j--;
@@ -0,0 +1,191 @@
+/* 
+ * delay3.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test nanosleep(), clock_nanosleep() and the delay modes.
+ *
+ * - argument checking;
+ * - sleeps never end early, in either mode, relative or absolute;
+ * - in precise mode short sleeps end close to when they are due.
+ *
+ * Depends on API functions:
+ *	nanosleep()
+ *	clock_nanosleep()
+ *	pthread_delay_np()
+ *	pthread_setdelaymode_np()
+ *	pthread_getdelaymode_np()
+ */
+
+#include "test.h"
+#include <sys/timeb.h>
+
+static LONGLONG frequency;
+
+LONGLONG
+nowNs(void)
+{
+  LARGE_INTEGER t;
+
+  QueryPerformanceCounter(&t);
+
+  /*
+   * As the library converts, so that times compare exactly.
+   */
+  return (t.QuadPart / frequency) * 1000000000
+         + ((t.QuadPart % frequency) * 1000000000) / frequency;
+}
+
+/*
+ * Sleep for 'ns' with 'how' and return how long it took.
+ */
+LONGLONG
+timed(int how, long ns)
+{
+  struct timespec ts;
+  LONGLONG start;
+
+  ts.tv_sec = ns / 1000000000;
+  ts.tv_nsec = ns % 1000000000;
+  start = nowNs();
+
+  switch (how)
+    {
+    case 0:
+      assert(nanosleep(&ts, NULL) == 0);
+      break;
+    case 1:
+      assert(clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL) == 0);
+      break;
+    case 2:
+      assert(pthread_delay_np(&ts) == 0);
+      break;
+    }
+
+  return nowNs() - start;
+}
+
+int
+main()
+{
+  static const long intervals[] = {10000, 100000, 1000000, 5000000};
+  struct timespec ts;
+  struct _timeb currSysTime;
+  LARGE_INTEGER f;
+  LONGLONG took;
+  LONGLONG worst;
+  int mode;
+  int how;
+  int i;
+  int n;
+
+  QueryPerformanceFrequency(&f);
+  frequency = f.QuadPart;
+
+  assert(pthread_getdelaymode_np() == PTHREAD_DELAY_COARSE_NP);
+  assert(pthread_setdelaymode_np(2) == EINVAL);
+  assert(pthread_setdelaymode_np(-1) == EINVAL);
+
+  ts.tv_sec = 0;
+  ts.tv_nsec = 1000000000;
+  assert(nanosleep(&ts, NULL) == -1);
+  assert(errno == EINVAL);
+  assert(clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL) == EINVAL);
+  ts.tv_nsec = -1;
+  assert(nanosleep(&ts, NULL) == -1);
+  assert(errno == EINVAL);
+  assert(nanosleep(NULL, NULL) == -1);
+  assert(errno == EINVAL);
+  ts.tv_nsec = 0;
+  assert(clock_nanosleep(99, 0, &ts, NULL) == EINVAL);
+  assert(clock_nanosleep(CLOCK_MONOTONIC, 0, NULL, NULL) == EINVAL);
+  assert(nanosleep(&ts, NULL) == 0);
+
+  for (mode = PTHREAD_DELAY_COARSE_NP; mode <= PTHREAD_DELAY_PRECISE_NP; mode++)
+    {
+      assert(pthread_setdelaymode_np(mode) == 0);
+      assert(pthread_getdelaymode_np() == mode);
+
+      for (i = 0; i < (int) (sizeof(intervals) / sizeof(intervals[0])); i++)
+        {
+          for (how = 0; how < 3; how++)
+            {
+              worst = 0;
+              for (n = 0; n < 10; n++)
+                {
+                  took = timed(how, intervals[i]);
+                  assert(took >= intervals[i]);
+                  if (took - intervals[i] > worst)
+                    {
+                      worst = took - intervals[i];
+                    }
+                }
+
+              /*
+               * Allow for preemption on a busy machine, but not for
+               * a whole system timer tick every time.
+               */
+              if (mode == PTHREAD_DELAY_PRECISE_NP)
+                {
+                  assert(worst < 10000000);
+                }
+            }
+        }
+    }
+
+  /*
+   * Precise: most sleeps end within 200 us of when they are due.
+   */
+  worst = 0;
+  for (n = 0; n < 20; n++)
+    {
+      if (timed(0, 500000) - 500000 < 200000)
+        {
+          worst++;
+        }
+    }
+  assert(worst >= 15);
+
+  /*
+   * Absolute, both clocks.
+   */
+  ts.tv_sec = 0;
+  ts.tv_nsec = 0;
+  took = nowNs();
+  assert(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == 0);
+  assert(nowNs() - took < 100000000);
+
+  _ftime(&currSysTime);
+  ts.tv_sec = (time_t) currSysTime.time + 1;
+  ts.tv_nsec = (long) currSysTime.millitm * 1000000;
+  took = nowNs();
+  assert(clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &ts, NULL) == 0);
+  took = nowNs() - took;
+  assert(took >= 1000000000 - 16000000);
+  assert(took < 1500000000);
+
+  assert(pthread_setdelaymode_np(PTHREAD_DELAY_COARSE_NP) == 0);
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+/* 
+ * delay4.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test cancellation of precise delays and of nanosleep(), while the
+ * thread sleeps and while it spins.
+ *
+ * Depends on API functions:
+ *	pthread_setdelaymode_np()
+ *	pthread_delay_np()
+ *	nanosleep()
+ *	clock_nanosleep()
+ *	pthread_cancel()
+ */
+
+#include "test.h"
+
+static long started = 0;
+
+void *
+sleeper(void * arg)
+{
+  struct timespec ts = {5, 0};
+
+  InterlockedIncrement((LPLONG)&started);
+
+  switch ((int) (size_t) arg)
+    {
+    case 0:
+      (void) pthread_delay_np(&ts);
+      break;
+    case 1:
+      (void) nanosleep(&ts, NULL);
+      break;
+    case 2:
+      (void) clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+      break;
+    }
+
+  return NULL;
+}
+
+void *
+spinner(void * arg)
+{
+  /*
+   * Shorter than the slack, so it only spins.
+   */
+  struct timespec ts = {0, 10000};
+  int i;
+
+  InterlockedIncrement((LPLONG)&started);
+
+  for (i = 0; i < 10000000; i++)
+    {
+      (void) nanosleep(&ts, NULL);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t;
+  void * result;
+  DWORD start;
+  int i;
+
+  assert(pthread_setdelaymode_np(PTHREAD_DELAY_PRECISE_NP) == 0);
+
+  for (i = 0; i < 4; i++)
+    {
+      started = 0;
+      assert(pthread_create(&t, NULL, (i < 3) ? sleeper : spinner, (void *) (size_t) i) == 0);
+      while (started == 0)
+        {
+          Sleep(1);
+        }
+      Sleep(100);
+      start = GetTickCount();
+      assert(pthread_cancel(t) == 0);
+      assert(pthread_join(t, &result) == 0);
+      assert(result == PTHREAD_CANCELED);
+      assert(GetTickCount() - start < 1000);
+    }
+
+  assert(pthread_setdelaymode_np(PTHREAD_DELAY_COARSE_NP) == 0);
+
+  return 0;
+}
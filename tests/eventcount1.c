@@ -0,0 +1,143 @@
+/* 
+ * eventcount1.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test the event count API.
+ *
+ * - a notify with no waiters changes nothing;
+ * - a notify between prepare and commit makes the commit return at once;
+ * - a commit times out at abstime;
+ * - a notify wakes every waiting thread.
+ *
+ * Depends on API functions:
+ *	pthread_eventcount_init_np()
+ *	pthread_eventcount_prepare_wait_np()
+ *	pthread_eventcount_commit_wait_np()
+ *	pthread_eventcount_cancel_wait_np()
+ *	pthread_eventcount_notify_np()
+ *	pthread_eventcount_destroy_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+#include <sys/timeb.h>
+
+enum {
+  NUMTHREADS = 4
+};
+
+static pthread_eventcount_t ec;
+static long ready = 0;
+static long woken = 0;
+
+void *
+waiter(void * arg)
+{
+  unsigned int key;
+
+  assert(pthread_eventcount_prepare_wait_np(&ec, &key) == 0);
+  InterlockedIncrement((LPLONG)&ready);
+  assert(pthread_eventcount_commit_wait_np(&ec, key, NULL) == 0);
+  InterlockedIncrement((LPLONG)&woken);
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t t[NUMTHREADS];
+  PTW32_STRUCT_TIMEB currSysTime;
+  struct timespec abstime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+  unsigned int key;
+  unsigned int key2;
+  long start;
+  long elapsed;
+  int i;
+
+  assert(pthread_eventcount_init_np(NULL) == EINVAL);
+  assert(pthread_eventcount_init_np(&ec) == 0);
+  assert(pthread_eventcount_prepare_wait_np(&ec, NULL) == EINVAL);
+
+  /*
+   * With nobody waiting a notify doesn't advance the count.
+   */
+  assert(pthread_eventcount_prepare_wait_np(&ec, &key) == 0);
+  assert(pthread_eventcount_cancel_wait_np(&ec) == 0);
+  assert(pthread_eventcount_notify_np(&ec) == 0);
+  assert(pthread_eventcount_prepare_wait_np(&ec, &key2) == 0);
+  assert(pthread_eventcount_cancel_wait_np(&ec) == 0);
+  assert(key2 == key);
+
+  /*
+   * A notify after prepare is not slept through.
+   */
+  assert(pthread_eventcount_prepare_wait_np(&ec, &key) == 0);
+  assert(pthread_eventcount_destroy_np(&ec) == EBUSY);
+  assert(pthread_eventcount_notify_np(&ec) == 0);
+  assert(pthread_eventcount_commit_wait_np(&ec, key, NULL) == 0);
+
+  /*
+   * Timeout.
+   */
+  PTW32_FTIME(&currSysTime);
+  start = (long)(currSysTime.time * 1000 + currSysTime.millitm);
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+  abstime.tv_sec += 1;
+  assert(pthread_eventcount_prepare_wait_np(&ec, &key) == 0);
+  assert(pthread_eventcount_commit_wait_np(&ec, key, &abstime) == ETIMEDOUT);
+  PTW32_FTIME(&currSysTime);
+  elapsed = (long)(currSysTime.time * 1000 + currSysTime.millitm) - start;
+  assert(elapsed >= 900);
+
+  /*
+   * One notify wakes all waiters.
+   */
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, waiter, NULL) == 0);
+    }
+  while (ready < NUMTHREADS)
+    {
+      Sleep(10);
+    }
+  Sleep(500);
+  assert(woken == 0);
+
+  assert(pthread_eventcount_notify_np(&ec) == 0);
+  for (i = 0; i < NUMTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  assert(woken == NUMTHREADS);
+
+  assert(pthread_eventcount_destroy_np(&ec) == 0);
+  assert(pthread_eventcount_destroy_np(&ec) == EINVAL);
+
+  return 0;
+}
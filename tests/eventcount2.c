@@ -0,0 +1,143 @@
+/* 
+ * eventcount2.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Producers and consumers share a lock-free count of available items.
+ * Consumers sleep on an event count when the count is zero and producers
+ * notify it after each increment. Every consumer must receive its share
+ * of the items; a lost wakeup leaves a consumer asleep and the test
+ * hangs.
+ *
+ * Depends on API functions:
+ *	pthread_eventcount_init_np()
+ *	pthread_eventcount_prepare_wait_np()
+ *	pthread_eventcount_commit_wait_np()
+ *	pthread_eventcount_cancel_wait_np()
+ *	pthread_eventcount_notify_np()
+ *	pthread_eventcount_destroy_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+
+enum {
+  PRODUCERS = 4,
+  CONSUMERS = 4,
+  ITEMS = 100000
+};
+
+static pthread_eventcount_t ec;
+static long available = 0;
+static long consumed = 0;
+
+static int
+tryTake(void)
+{
+  long n;
+
+  while ((n = available) > 0)
+    {
+      if (InterlockedCompareExchange((LPLONG)&available, n - 1, n) == n)
+        {
+          return 1;
+        }
+    }
+
+  return 0;
+}
+
+void *
+producer(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITEMS; i++)
+    {
+      InterlockedIncrement((LPLONG)&available);
+      assert(pthread_eventcount_notify_np(&ec) == 0);
+    }
+
+  return 0;
+}
+
+void *
+consumer(void * arg)
+{
+  unsigned int key;
+  int i;
+
+  for (i = 0; i < PRODUCERS * ITEMS / CONSUMERS; i++)
+    {
+      while (!tryTake())
+        {
+          assert(pthread_eventcount_prepare_wait_np(&ec, &key) == 0);
+          if (tryTake())
+            {
+              assert(pthread_eventcount_cancel_wait_np(&ec) == 0);
+              break;
+            }
+          assert(pthread_eventcount_commit_wait_np(&ec, key, NULL) == 0);
+        }
+      InterlockedIncrement((LPLONG)&consumed);
+    }
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t p[PRODUCERS];
+  pthread_t c[CONSUMERS];
+  int i;
+
+  assert(pthread_eventcount_init_np(&ec) == 0);
+
+  for (i = 0; i < CONSUMERS; i++)
+    {
+      assert(pthread_create(&c[i], NULL, consumer, NULL) == 0);
+    }
+  for (i = 0; i < PRODUCERS; i++)
+    {
+      assert(pthread_create(&p[i], NULL, producer, NULL) == 0);
+    }
+
+  for (i = 0; i < PRODUCERS; i++)
+    {
+      assert(pthread_join(p[i], NULL) == 0);
+    }
+  for (i = 0; i < CONSUMERS; i++)
+    {
+      assert(pthread_join(c[i], NULL) == 0);
+    }
+
+  assert(consumed == PRODUCERS * ITEMS);
+  assert(available == 0);
+
+  assert(pthread_eventcount_destroy_np(&ec) == 0);
+
+  return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * inline1.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test the PTW32_INLINE_FASTPATH inline lock and unlock paths. Normal
+ * mutexes and spin locks are taken inline; static initialisers, other
+ * mutex kinds and errors must still reach the library and give the
+ * same results as the ordinary calls.
+ *
+ * Depends on API functions:
+ *	pthread_mutex_init()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_trylock()
+ *	pthread_mutex_unlock()
+ *	pthread_mutex_destroy()
+ *	pthread_spin_init()
+ *	pthread_spin_lock()
+ *	pthread_spin_trylock()
+ *	pthread_spin_unlock()
+ *	pthread_spin_destroy()
+ */
+
+#define PTW32_INLINE_FASTPATH
+
+#include "test.h"
+
+#if PTW32_FASTPATH_VERSION != 1
+#error "This test was written for inline fast path layout version 1"
+#endif
+
+#define NTHREADS        4
+#define ITERATIONS      100000
+
+static pthread_mutex_t mx;
+static pthread_mutex_t smx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_spinlock_t spin;
+static pthread_spinlock_t sspin = PTHREAD_SPINLOCK_INITIALIZER;
+static long mxCount = 0;
+static long spinCount = 0;
+
+void *
+mutexLocker (void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_mutex_lock(&mx) == 0);
+      mxCount++;
+      assert(pthread_mutex_unlock(&mx) == 0);
+    }
+
+  return NULL;
+}
+
+void *
+spinLocker (void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_spin_lock(&spin) == 0);
+      spinCount++;
+      assert(pthread_spin_unlock(&spin) == 0);
+    }
+
+  return NULL;
+}
+
+int
+main()
+{
+  pthread_t t[NTHREADS];
+  pthread_mutexattr_t ma;
+  int (*lockFn) (pthread_mutex_t *) = pthread_mutex_lock;
+  int i;
+
+  assert(ptw32_fastpath_v1 != 0);
+
+  /*
+   * Normal mutex: both halves inline, and consistent with the library.
+   */
+  assert(pthread_mutex_init(&mx, NULL) == 0);
+  assert(pthread_mutex_lock(&mx) == 0);
+  assert(pthread_mutex_trylock(&mx) == EBUSY);
+  assert(pthread_mutex_unlock(&mx) == 0);
+  assert(pthread_mutex_trylock(&mx) == 0);
+  assert(pthread_mutex_unlock(&mx) == 0);
+
+  /*
+   * The function itself is still the library's entry point.
+   */
+  assert(lockFn(&mx) == 0);
+  assert((pthread_mutex_unlock)(&mx) == 0);
+
+  /*
+   * A statically initialised mutex is set up by the library on first use.
+   */
+  assert(pthread_mutex_lock(&smx) == 0);
+  assert(smx != PTHREAD_MUTEX_INITIALIZER);
+  assert(pthread_mutex_unlock(&smx) == 0);
+  assert(pthread_mutex_lock(&smx) == 0);
+  assert(pthread_mutex_unlock(&smx) == 0);
+  assert(pthread_mutex_destroy(&smx) == 0);
+
+  /*
+   * Other kinds always take the ordinary calls.
+   */
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_RECURSIVE) == 0);
+  assert(pthread_mutex_init(&smx, &ma) == 0);
+  assert(pthread_mutex_lock(&smx) == 0);
+  assert(pthread_mutex_lock(&smx) == 0);
+  assert(pthread_mutex_unlock(&smx) == 0);
+  assert(pthread_mutex_unlock(&smx) == 0);
+  assert(pthread_mutex_unlock(&smx) == EPERM);
+  assert(pthread_mutex_destroy(&smx) == 0);
+
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_ERRORCHECK) == 0);
+  assert(pthread_mutex_init(&smx, &ma) == 0);
+  assert(pthread_mutex_lock(&smx) == 0);
+  assert(pthread_mutex_lock(&smx) == EDEADLK);
+  assert(pthread_mutex_unlock(&smx) == 0);
+  assert(pthread_mutex_unlock(&smx) == EPERM);
+  assert(pthread_mutex_destroy(&smx) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  /*
+   * Contended: the inline unlock must leave waiters to the library.
+   */
+  for (i = 0; i < NTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, mutexLocker, NULL) == 0);
+    }
+  for (i = 0; i < NTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  assert(mxCount == NTHREADS * ITERATIONS);
+  assert(pthread_mutex_destroy(&mx) == 0);
+  assert(pthread_mutex_lock(&mx) == EINVAL);
+
+  /*
+   * Spin locks.
+   */
+  assert(pthread_spin_lock(&sspin) == 0);
+  assert(sspin != PTHREAD_SPINLOCK_INITIALIZER);
+  assert(pthread_spin_trylock(&sspin) == EBUSY);
+  assert(pthread_spin_unlock(&sspin) == 0);
+  assert(pthread_spin_destroy(&sspin) == 0);
+
+  assert(pthread_spin_init(&spin, PTHREAD_PROCESS_PRIVATE) == 0);
+  for (i = 0; i < NTHREADS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, spinLocker, NULL) == 0);
+    }
+  for (i = 0; i < NTHREADS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+  assert(spinCount == NTHREADS * ITERATIONS);
+  assert(pthread_spin_destroy(&spin) == 0);
+  assert(pthread_spin_lock(&spin) == EINVAL);
+
+  return 0;
+}
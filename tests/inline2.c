@@ -0,0 +1,111 @@
+/*
+ * inline2.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test that enabling the lock profiler turns the PTW32_INLINE_FASTPATH
+ * inline paths off, so that a profiled mutex sees every acquire even
+ * when the application was built with them.
+ *
+ * Depends on API functions:
+ *	pthread_lockprof_enable_np()
+ *	pthread_lockprof_dump_np()
+ *	pthread_lockprof_reset_np()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_unlock()
+ */
+
+#define PTW32_INLINE_FASTPATH
+
+#include "test.h"
+
+#define ITERATIONS 1000
+
+static pthread_mutex_t mutex;
+
+int
+main()
+{
+  FILE * fp;
+  const char * report = "inline2.out";
+  char line[256];
+  unsigned long acquired = 0;
+  int result;
+  int i;
+
+  assert(ptw32_fastpath_v1 != 0);
+
+  result = pthread_lockprof_enable_np(1);
+  if (result == ENOSYS)
+    {
+      printf("No high resolution counter - test skipped.\n");
+      return 0;
+    }
+  assert(result == 0);
+  assert(ptw32_fastpath_v1 == 0);
+
+  assert(pthread_mutex_init(&mutex, NULL) == 0);
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_mutex_lock(&mutex) == 0);
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+
+  remove(report);
+  assert(pthread_lockprof_dump_np(report, 10) == 0);
+  assert((fp = fopen(report, "r")) != NULL);
+  while (fgets(line, sizeof(line), fp) != NULL)
+    {
+      if (sscanf(line, " acquired %lu", &acquired) == 1)
+        {
+          break;
+        }
+    }
+  fclose(fp);
+  remove(report);
+  assert(acquired == ITERATIONS);
+
+  /*
+   * Turning profiling off again doesn't bring the inline paths back;
+   * mutexes profiled so far are still profiled.
+   */
+  assert(pthread_lockprof_enable_np(0) == 0);
+  assert(ptw32_fastpath_v1 == 0);
+  assert(pthread_lockprof_reset_np() == 0);
+
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  return 0;
+}
@@ -0,0 +1,76 @@
+/* 
+ * latch1.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test the countdown latch API in a single thread.
+ *
+ * Depends on API functions:
+ *	pthread_latch_init_np()
+ *	pthread_latch_count_down_np()
+ *	pthread_latch_wait_np()
+ *	pthread_latch_try_wait_np()
+ *	pthread_latch_destroy_np()
+ */
+
+#include "test.h"
+
+static pthread_latch_t latch;
+
+int
+main()
+{
+  assert(pthread_latch_init_np(NULL, 1) == EINVAL);
+  assert(pthread_latch_init_np(&latch, 0xFFFFFFFF) == EINVAL);
+
+  /*
+   * A zero count is open from the start.
+   */
+  assert(pthread_latch_init_np(&latch, 0) == 0);
+  assert(pthread_latch_try_wait_np(&latch) == 0);
+  assert(pthread_latch_wait_np(&latch) == 0);
+  assert(pthread_latch_count_down_np(&latch) == EINVAL);
+  assert(pthread_latch_try_wait_np(&latch) == 0);
+  assert(pthread_latch_destroy_np(&latch) == 0);
+
+  assert(pthread_latch_init_np(&latch, 2) == 0);
+  assert(pthread_latch_try_wait_np(&latch) == EBUSY);
+  assert(pthread_latch_count_down_np(&latch) == 0);
+  assert(pthread_latch_try_wait_np(&latch) == EBUSY);
+  assert(pthread_latch_count_down_np(&latch) == 0);
+  assert(pthread_latch_try_wait_np(&latch) == 0);
+  assert(pthread_latch_wait_np(&latch) == 0);
+
+  /*
+   * Once open it stays open.
+   */
+  assert(pthread_latch_count_down_np(&latch) == EINVAL);
+  assert(pthread_latch_try_wait_np(&latch) == 0);
+
+  assert(pthread_latch_destroy_np(&latch) == 0);
+  assert(pthread_latch_destroy_np(&latch) == EINVAL);
+  assert(pthread_latch_try_wait_np(&latch) == EINVAL);
+
+  return 0;
+}
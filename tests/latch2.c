@@ -0,0 +1,117 @@
+/* 
+ * latch2.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Fan-in through a countdown latch. Workers each write their own
+ * result and count down without waiting; several waiters block on the
+ * latch and must see every result once it opens. Repeated with fresh
+ * latches so that count downs race with waiters arriving.
+ *
+ * Depends on API functions:
+ *	pthread_latch_init_np()
+ *	pthread_latch_count_down_np()
+ *	pthread_latch_wait_np()
+ *	pthread_latch_destroy_np()
+ *	pthread_create()
+ *	pthread_join()
+ */
+
+#include "test.h"
+#include <string.h>
+
+enum {
+  WORKERS = 8,
+  WAITERS = 3,
+  ROUNDS = 200
+};
+
+static pthread_latch_t latch;
+static int results[WORKERS];
+
+void *
+worker(void * arg)
+{
+  int me = (int)(size_t) arg;
+
+  results[me] = me + 1;
+  assert(pthread_latch_count_down_np(&latch) == 0);
+
+  return 0;
+}
+
+void *
+waiter(void * arg)
+{
+  int i;
+
+  assert(pthread_latch_wait_np(&latch) == 0);
+  for (i = 0; i < WORKERS; i++)
+    {
+      assert(results[i] == i + 1);
+    }
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t workers[WORKERS];
+  pthread_t waiters[WAITERS];
+  int round;
+  int i;
+
+  for (round = 0; round < ROUNDS; round++)
+    {
+      memset(results, 0, sizeof(results));
+      assert(pthread_latch_init_np(&latch, WORKERS) == 0);
+
+      for (i = 0; i < WAITERS; i++)
+        {
+          assert(pthread_create(&waiters[i], NULL, waiter, NULL) == 0);
+        }
+      for (i = 0; i < WORKERS; i++)
+        {
+          assert(pthread_create(&workers[i], NULL, worker, (void *)(size_t) i) == 0);
+        }
+
+      /*
+       * Workers don't wait for the latch, so all of them can finish
+       * before anyone waits.
+       */
+      for (i = 0; i < WORKERS; i++)
+        {
+          assert(pthread_join(workers[i], NULL) == 0);
+        }
+      for (i = 0; i < WAITERS; i++)
+        {
+          assert(pthread_join(waiters[i], NULL) == 0);
+        }
+
+      assert(pthread_latch_destroy_np(&latch) == 0);
+    }
+
+  return 0;
+}
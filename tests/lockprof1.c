@@ -0,0 +1,109 @@
+/*
+ * lockprof1.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test the lock profiler. Enable profiling, contend a mutex from
+ * two threads and check that a report is written.
+ *
+ * Depends on API functions:
+ *	pthread_lockprof_enable_np()
+ *	pthread_lockprof_dump_np()
+ *	pthread_lockprof_reset_np()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_trylock()
+ *	pthread_mutex_unlock()
+ */
+
+#include "test.h"
+
+#define ITERATIONS 1000
+
+static pthread_mutex_t mutex;
+static int count = 0;
+
+void * locker(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_mutex_lock(&mutex) == 0);
+      count++;
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t t[2];
+  FILE * fp;
+  const char * report = "lockprof1.out";
+  int result;
+
+  assert(pthread_lockprof_enable_np(-1) == EINVAL);
+
+  result = pthread_lockprof_enable_np(1);
+  if (result == ENOSYS)
+    {
+      printf("No high resolution counter - test skipped.\n");
+      return 0;
+    }
+  assert(result == 0);
+
+  assert(pthread_mutex_init(&mutex, NULL) == 0);
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_create(&t[0], NULL, locker, NULL) == 0);
+  assert(pthread_create(&t[1], NULL, locker, NULL) == 0);
+  Sleep(100);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  assert(pthread_join(t[0], NULL) == 0);
+  assert(pthread_join(t[1], NULL) == 0);
+  assert(count == 2 * ITERATIONS);
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_mutex_trylock(&mutex) == EBUSY);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  assert(pthread_lockprof_dump_np(report, -1) == EINVAL);
+
+  remove(report);
+  assert(pthread_lockprof_dump_np(report, 10) == 0);
+  assert((fp = fopen(report, "r")) != NULL);
+  assert(fgetc(fp) != EOF);
+  fclose(fp);
+  remove(report);
+
+  assert(pthread_lockprof_reset_np() == 0);
+  assert(pthread_lockprof_enable_np(0) == 0);
+
+  assert(pthread_mutex_destroy(&mutex) == 0);
+
+  return 0;
+}
@@ -0,0 +1,119 @@
+/* 
+ * mutex10.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test PTHREAD_MUTEX_BIASED_NP.
+ * The first thread to lock the mutex takes the bias. A second thread
+ * that locks the mutex while the bias owner holds it must block until
+ * the owner unlocks, after which both threads use the normal path.
+ *
+ * Depends on API functions:
+ *	pthread_mutexattr_settype()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_trylock()
+ *	pthread_mutex_unlock()
+ */
+
+#include "test.h"
+
+static pthread_mutex_t mutex;
+static int locked = 0;
+
+void * locker(void * arg)
+{
+  assert(pthread_mutex_lock(&mutex) == 0);
+  locked = 1;
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return 0;
+}
+
+void * trylocker(void * arg)
+{
+  assert(pthread_mutex_trylock(&mutex) == EBUSY);
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t t;
+  pthread_mutexattr_t ma;
+  int i;
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_BIASED_NP) == 0);
+
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_ROBUST) == 0);
+  assert(pthread_mutex_init(&mutex, &ma) == EINVAL);
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_STALLED) == 0);
+
+  assert(pthread_mutex_init(&mutex, &ma) == 0);
+
+  /*
+   * Take the bias, then lock and unlock through it.
+   */
+  for (i = 0; i < 1000; i++)
+    {
+      assert(pthread_mutex_lock(&mutex) == 0);
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_mutex_trylock(&mutex) == EBUSY);
+
+  /*
+   * Trylock from another thread revokes the bias but can't wait for us.
+   */
+  assert(pthread_create(&t, NULL, trylocker, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+
+  assert(pthread_create(&t, NULL, locker, NULL) == 0);
+  Sleep(500);
+  assert(locked == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(locked == 1);
+
+  /*
+   * The bias is gone; the original owner now uses the normal path.
+   */
+  for (i = 0; i < 1000; i++)
+    {
+      assert(pthread_mutex_lock(&mutex) == 0);
+      assert(pthread_mutex_unlock(&mutex) == 0);
+    }
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_create(&t, NULL, trylocker, NULL) == 0);
+  assert(pthread_join(t, NULL) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  assert(pthread_mutex_destroy(&mutex) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+/* 
+ * mutex9.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test PTHREAD_MUTEX_FAIR_NP.
+ * Threads that block on a fair mutex acquire it in arrival order, and
+ * a waiter that times out leaves the queue without disturbing the others.
+ *
+ * Depends on API functions:
+ *	pthread_mutexattr_settype()
+ *	pthread_mutex_lock()
+ *	pthread_mutex_timedlock()
+ *	pthread_mutex_trylock()
+ *	pthread_mutex_unlock()
+ */
+
+#include "test.h"
+
+#define WAITERS 4
+
+static pthread_mutex_t mutex;
+static int order[WAITERS];
+static int next = 0;
+
+void * locker(void * arg)
+{
+  assert(pthread_mutex_lock(&mutex) == 0);
+  order[next++] = (int)(size_t) arg;
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  return 0;
+}
+
+void * timedlocker(void * arg)
+{
+  struct timespec abstime = { 0, 0 };
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+
+  PTW32_FTIME(&currSysTime);
+
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+
+  abstime.tv_sec += 1;
+
+  assert(pthread_mutex_timedlock(&mutex, &abstime) == ETIMEDOUT);
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t t[WAITERS];
+  pthread_t tt;
+  pthread_mutexattr_t ma;
+  int i;
+
+  assert(pthread_mutexattr_init(&ma) == 0);
+  assert(pthread_mutexattr_settype(&ma, PTHREAD_MUTEX_FAIR_NP) == 0);
+
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_ROBUST) == 0);
+  assert(pthread_mutex_init(&mutex, &ma) == EINVAL);
+  assert(pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_STALLED) == 0);
+
+  assert(pthread_mutex_init(&mutex, &ma) == 0);
+
+  assert(pthread_mutex_lock(&mutex) == 0);
+  assert(pthread_mutex_trylock(&mutex) == EBUSY);
+
+  /*
+   * Queue a waiter that will give up, then the ordered waiters.
+   */
+  assert(pthread_create(&tt, NULL, timedlocker, NULL) == 0);
+  Sleep(100);
+
+  for (i = 0; i < WAITERS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, locker, (void *)(size_t) i) == 0);
+      Sleep(100);
+    }
+
+  assert(pthread_join(tt, NULL) == 0);
+
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  for (i = 0; i < WAITERS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(next == WAITERS);
+  for (i = 0; i < WAITERS; i++)
+    {
+      assert(order[i] == i);
+    }
+
+  assert(pthread_mutex_trylock(&mutex) == 0);
+  assert(pthread_mutex_unlock(&mutex) == 0);
+
+  assert(pthread_mutex_destroy(&mutex) == 0);
+  assert(pthread_mutexattr_destroy(&ma) == 0);
+
+  return 0;
+}
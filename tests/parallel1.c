@@ -0,0 +1,152 @@
+/* 
+ * parallel1.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Parallel loops: every index of a range is passed to the loop body
+ * exactly once, with each scheduling policy, several grain sizes and
+ * ranges near the ends of a long. Also checks argument errors, empty
+ * ranges and that a range of one chunk runs as a single call.
+ *
+ * Depends on API functions:
+ *	pthread_parallel_for_np()
+ */
+
+#include "test.h"
+#include <string.h>
+#include <limits.h>
+
+enum {
+  SIZE = 100000
+};
+
+static LONG seen[SIZE];
+static long base;
+static LONG calls;
+static LONG largest;
+
+void
+body(long first, long last, void * arg)
+{
+  long i;
+  LONG n = (LONG) (last - first);
+  LONG m;
+
+  assert(arg == (void *) seen);
+  assert(first < last);
+  assert(first >= base && last - base <= SIZE);
+
+  for (i = first; i < last; i++)
+    {
+      assert(InterlockedIncrement(&seen[i - base]) == 1);
+    }
+
+  (void) InterlockedIncrement(&calls);
+
+  while (n > (m = largest)
+         && InterlockedCompareExchange(&largest, n, m) != m)
+    {
+    }
+}
+
+void
+check(long begin, long count, long grain, int policy)
+{
+  long i;
+
+  memset((void *) seen, 0, sizeof(seen));
+  base = begin;
+  calls = 0;
+  largest = 0;
+
+  assert(pthread_parallel_for_np(begin, begin + count, grain, body, (void *) seen, policy) == 0);
+
+  for (i = 0; i < count; i++)
+    {
+      assert(seen[i] == 1);
+    }
+  for (; i < SIZE; i++)
+    {
+      assert(seen[i] == 0);
+    }
+
+  if (count > 0 && count <= grain)
+    {
+      assert(calls == 1);
+    }
+  /*
+   * With one processor the whole range is a single call.
+   */
+  if (grain > 0 && policy == PTHREAD_PARALLEL_DYNAMIC_NP && calls > 1)
+    {
+      assert(largest <= grain);
+    }
+}
+
+int
+main()
+{
+  static const long counts[] = { 0, 1, 2, 3, 7, 64, 1000, SIZE };
+  static const long grains[] = { 0, 1, 3, 64, 1000, SIZE };
+  static const int policies[] = {
+    PTHREAD_PARALLEL_STATIC_NP,
+    PTHREAD_PARALLEL_DYNAMIC_NP,
+    PTHREAD_PARALLEL_GUIDED_NP
+  };
+  int c;
+  int g;
+  int p;
+
+  assert(pthread_parallel_for_np(0, 10, 1, NULL, NULL, PTHREAD_PARALLEL_STATIC_NP) == EINVAL);
+  assert(pthread_parallel_for_np(0, 10, -1, body, seen, PTHREAD_PARALLEL_STATIC_NP) == EINVAL);
+  assert(pthread_parallel_for_np(0, 10, 1, body, seen, -1) == EINVAL);
+  assert(pthread_parallel_for_np(0, 10, 1, body, seen, PTHREAD_PARALLEL_GUIDED_NP + 1) == EINVAL);
+
+  /*
+   * Empty ranges never call the body.
+   */
+  assert(pthread_parallel_for_np(5, 5, 0, NULL, NULL, PTHREAD_PARALLEL_STATIC_NP) == EINVAL);
+  calls = 0;
+  assert(pthread_parallel_for_np(5, 5, 0, body, seen, PTHREAD_PARALLEL_STATIC_NP) == 0);
+  assert(pthread_parallel_for_np(6, 5, 0, body, seen, PTHREAD_PARALLEL_DYNAMIC_NP) == 0);
+  assert(calls == 0);
+
+  for (p = 0; p < (int) (sizeof(policies) / sizeof(policies[0])); p++)
+    {
+      for (c = 0; c < (int) (sizeof(counts) / sizeof(counts[0])); c++)
+        {
+          for (g = 0; g < (int) (sizeof(grains) / sizeof(grains[0])); g++)
+            {
+              check(0, counts[c], grains[g], policies[p]);
+              check(-counts[c] / 2, counts[c], grains[g], policies[p]);
+            }
+        }
+
+      check(LONG_MAX - 1000, 1000, 7, policies[p]);
+      check(LONG_MIN, 1000, 7, policies[p]);
+      check(LONG_MIN, 1000, 0, policies[p]);
+    }
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+/* 
+ * parallel2.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Parallel loops started from several threads at once, nested loops,
+ * and a calling thread cancelled from inside its own loop body. A
+ * nested loop must run on the calling thread as one call, and a
+ * cancelled caller must not unwind until no other thread is still
+ * running its loop body.
+ *
+ * Depends on API functions:
+ *	pthread_parallel_for_np()
+ *	pthread_create()
+ *	pthread_join()
+ *	pthread_cancel()
+ *	pthread_testcancel()
+ *	pthread_self()
+ *	pthread_equal()
+ */
+
+#include "test.h"
+#include <string.h>
+
+enum {
+  CALLERS = 4,
+  SIZE = 20000,
+  OUTER = 64,
+  INNER = 1000
+};
+
+static LONG seen[CALLERS][SIZE];
+static LONG innerCalls;
+static LONG running;
+static pthread_t canceller;
+
+void
+body(long first, long last, void * arg)
+{
+  LONG * s = (LONG *) arg;
+  long i;
+
+  for (i = first; i < last; i++)
+    {
+      assert(InterlockedIncrement(&s[i]) == 1);
+    }
+}
+
+void *
+caller(void * arg)
+{
+  int me = (int)(size_t) arg;
+  int round;
+  int i;
+
+  for (round = 0; round < 20; round++)
+    {
+      memset((void *) seen[me], 0, sizeof(seen[me]));
+      assert(pthread_parallel_for_np(0, SIZE, 0, body, seen[me], round % 3) == 0);
+      for (i = 0; i < SIZE; i++)
+        {
+          assert(seen[me][i] == 1);
+        }
+    }
+
+  return 0;
+}
+
+void
+inner(long first, long last, void * arg)
+{
+  assert(first == 0 && last == INNER);
+  (void) InterlockedIncrement(&innerCalls);
+}
+
+void
+outer(long first, long last, void * arg)
+{
+  long i;
+
+  for (i = first; i < last; i++)
+    {
+      assert(pthread_parallel_for_np(0, INNER, 1, inner, NULL, PTHREAD_PARALLEL_DYNAMIC_NP) == 0);
+    }
+}
+
+void
+leave(void * arg)
+{
+  (void) InterlockedDecrement(&running);
+}
+
+void
+slow(long first, long last, void * arg)
+{
+  (void) InterlockedIncrement(&running);
+
+  if (pthread_equal(pthread_self(), canceller))
+    {
+      assert(pthread_cancel(canceller) == 0);
+      pthread_cleanup_push(leave, NULL);
+      pthread_testcancel();
+      pthread_cleanup_pop(0);
+    }
+  else
+    {
+      Sleep(1);
+    }
+
+  (void) InterlockedDecrement(&running);
+}
+
+void *
+cancelled(void * arg)
+{
+  canceller = pthread_self();
+  (void) pthread_parallel_for_np(0, 1000, 1, slow, NULL, PTHREAD_PARALLEL_DYNAMIC_NP);
+
+  /*
+   * Only reached if the other threads ran every chunk, which is very
+   * unlikely. Give the result the test expects.
+   */
+  return PTHREAD_CANCELED;
+}
+
+int
+main()
+{
+  pthread_t t[CALLERS];
+  void * result;
+  int i;
+
+  for (i = 0; i < CALLERS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, caller, (void *)(size_t) i) == 0);
+    }
+  for (i = 0; i < CALLERS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(pthread_parallel_for_np(0, OUTER, 1, outer, NULL, PTHREAD_PARALLEL_STATIC_NP) == 0);
+  assert(innerCalls == OUTER);
+
+  assert(pthread_create(&t[0], NULL, cancelled, NULL) == 0);
+  assert(pthread_join(t[0], &result) == 0);
+  assert(result == PTHREAD_CANCELED);
+  assert(running == 0);
+
+  return 0;
+}
@@ -0,0 +1,169 @@
+/* 
+ * pool1.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test the thread pool API.
+ *
+ * - argument checking;
+ * - every task submitted from outside the pool, singly and in batches,
+ *   runs exactly once before pthread_pool_wait_idle_np() returns;
+ * - a task can't wait for or destroy its own pool;
+ * - an elastic pool starts workers on demand and lets surplus ones go.
+ *
+ * Depends on API functions:
+ *	pthread_pool_init_np()
+ *	pthread_pool_submit_np()
+ *	pthread_pool_submit_batch_np()
+ *	pthread_pool_wait_idle_np()
+ *	pthread_pool_destroy_np()
+ */
+
+#include "test.h"
+#include <string.h>
+
+enum {
+  NUMTASKS = 100000
+};
+
+static pthread_pool_t pool;
+static unsigned char ran[NUMTASKS];
+static long count = 0;
+static int innerResult[2];
+
+void
+task(void * arg)
+{
+  size_t i = (size_t) arg;
+
+  assert(ran[i] == 0);
+  ran[i] = 1;
+  InterlockedIncrement((LPLONG)&count);
+}
+
+void
+selfwait(void * arg)
+{
+  innerResult[0] = pthread_pool_wait_idle_np(&pool);
+  innerResult[1] = pthread_pool_destroy_np(&pool);
+}
+
+void
+sleeper(void * arg)
+{
+  Sleep(50);
+  InterlockedIncrement((LPLONG)&count);
+}
+
+void
+runAll(void)
+{
+  static void * args[NUMTASKS];
+  size_t i;
+
+  memset(ran, 0, sizeof(ran));
+  count = 0;
+  for (i = 0; i < NUMTASKS / 2; i++)
+    {
+      assert(pthread_pool_submit_np(&pool, task, (void *) i) == 0);
+    }
+  for (; i < NUMTASKS; i++)
+    {
+      args[i] = (void *) i;
+    }
+  assert(pthread_pool_submit_batch_np(&pool, task, &args[NUMTASKS / 2], NUMTASKS / 2) == 0);
+  assert(pthread_pool_wait_idle_np(&pool) == 0);
+
+  assert(count == NUMTASKS);
+  for (i = 0; i < NUMTASKS; i++)
+    {
+      assert(ran[i] == 1);
+    }
+}
+
+int
+main()
+{
+  void * arg = NULL;
+  int i;
+
+  assert(pthread_pool_init_np(NULL, NULL, 1, 1) == EINVAL);
+  assert(pthread_pool_init_np(&pool, NULL, -1, 1) == EINVAL);
+  assert(pthread_pool_init_np(&pool, NULL, 2, 1) == EINVAL);
+  assert(pthread_pool_submit_np(NULL, task, NULL) == EINVAL);
+  assert(pthread_pool_destroy_np(NULL) == EINVAL);
+
+  /*
+   * Fixed size.
+   */
+  assert(pthread_pool_init_np(&pool, NULL, 4, 4) == 0);
+  assert(pthread_pool_submit_np(&pool, NULL, NULL) == EINVAL);
+  assert(pthread_pool_submit_batch_np(&pool, task, NULL, 1) == EINVAL);
+  assert(pthread_pool_submit_batch_np(&pool, task, &arg, 0) == 0);
+  assert(pthread_pool_wait_idle_np(&pool) == 0);
+
+  runAll();
+
+  assert(pthread_pool_submit_np(&pool, selfwait, NULL) == 0);
+  assert(pthread_pool_wait_idle_np(&pool) == 0);
+  assert(innerResult[0] == EDEADLK);
+  assert(innerResult[1] == EDEADLK);
+
+  assert(pthread_pool_destroy_np(&pool) == 0);
+  assert(pool == NULL);
+
+  /*
+   * Elastic, starting with no workers.
+   */
+  assert(pthread_pool_init_np(&pool, NULL, 0, 4) == 0);
+  runAll();
+
+  /*
+   * Four tasks that block run side by side.
+   */
+  count = 0;
+  for (i = 0; i < 4; i++)
+    {
+      assert(pthread_pool_submit_np(&pool, sleeper, NULL) == 0);
+    }
+  assert(pthread_pool_wait_idle_np(&pool) == 0);
+  assert(count == 4);
+
+  /*
+   * Surplus workers have gone; new ones start when needed.
+   */
+  Sleep(2000);
+  runAll();
+
+  assert(pthread_pool_destroy_np(&pool) == 0);
+
+  /*
+   * Default size.
+   */
+  assert(pthread_pool_init_np(&pool, NULL, 1, 0) == 0);
+  runAll();
+  assert(pthread_pool_destroy_np(&pool) == 0);
+
+  return 0;
+}
@@ -0,0 +1,162 @@
+/* 
+ * pool2.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test work stealing and shutdown of a thread pool.
+ *
+ * - tasks that submit tasks: a binary tree of tasks started from one
+ *   root task all run, with the pool's workers stealing from the
+ *   worker that created them;
+ * - workers created with attributes carrying a CPU affinity run on
+ *   those CPUs;
+ * - destroying a pool cancels its workers: queued tasks are discarded
+ *   and a running task that reaches a cancellation point stops.
+ *
+ * Depends on API functions:
+ *	pthread_pool_init_np()
+ *	pthread_pool_submit_np()
+ *	pthread_pool_wait_idle_np()
+ *	pthread_pool_destroy_np()
+ *	pthread_attr_setaffinity_np()
+ *	pthread_getaffinity_np()
+ *	pthread_testcancel()
+ */
+
+#include "test.h"
+
+enum {
+  DEPTH = 16,
+  WORKERS = 4
+};
+
+static pthread_pool_t pool;
+static long count = 0;
+static long started = 0;
+static long finished = 0;
+static cpu_set_t workerCpus;
+static long wrongCpu = 0;
+
+void
+tree(void * arg)
+{
+  long depth = (long)(size_t) arg;
+
+  InterlockedIncrement((LPLONG)&count);
+  if (depth > 0)
+    {
+      assert(pthread_pool_submit_np(&pool, tree, (void *)(size_t)(depth - 1)) == 0);
+      assert(pthread_pool_submit_np(&pool, tree, (void *)(size_t)(depth - 1)) == 0);
+    }
+}
+
+void
+where(void * arg)
+{
+  cpu_set_t cpus;
+
+  assert(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus) == 0);
+  if (!CPU_EQUAL(&cpus, &workerCpus))
+    {
+      InterlockedIncrement((LPLONG)&wrongCpu);
+    }
+}
+
+void
+endless(void * arg)
+{
+  InterlockedIncrement((LPLONG)&started);
+  for (;;)
+    {
+      Sleep(10);
+      pthread_testcancel();
+    }
+  InterlockedIncrement((LPLONG)&finished);
+}
+
+void
+never(void * arg)
+{
+  InterlockedIncrement((LPLONG)&finished);
+}
+
+int
+main()
+{
+  pthread_attr_t attr;
+  cpu_set_t processCpus;
+  int cpu;
+  int i;
+
+  assert(pthread_pool_init_np(&pool, NULL, WORKERS, WORKERS) == 0);
+
+  assert(pthread_pool_submit_np(&pool, tree, (void *)(size_t) DEPTH) == 0);
+  assert(pthread_pool_wait_idle_np(&pool) == 0);
+  assert(count == (2L << DEPTH) - 1);
+
+  /*
+   * Shutdown: WORKERS tasks that only stop when cancelled occupy every
+   * worker, so the rest are never started.
+   */
+  for (i = 0; i < WORKERS; i++)
+    {
+      assert(pthread_pool_submit_np(&pool, endless, NULL) == 0);
+    }
+  while (started < WORKERS)
+    {
+      Sleep(10);
+    }
+  for (i = 0; i < 100; i++)
+    {
+      assert(pthread_pool_submit_np(&pool, never, NULL) == 0);
+    }
+  assert(pthread_pool_destroy_np(&pool) == 0);
+  assert(finished == 0);
+
+  /*
+   * Affinity: pin the workers to the first CPU available.
+   */
+  assert(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &processCpus) == 0);
+  for (cpu = 0; !CPU_ISSET(cpu, &processCpus); cpu++)
+    {
+    }
+  CPU_ZERO(&workerCpus);
+  CPU_SET(cpu, &workerCpus);
+
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &workerCpus) == 0);
+  assert(pthread_pool_init_np(&pool, &attr, WORKERS, WORKERS) == 0);
+  assert(pthread_attr_destroy(&attr) == 0);
+
+  for (i = 0; i < 1000; i++)
+    {
+      assert(pthread_pool_submit_np(&pool, where, NULL) == 0);
+    }
+  assert(pthread_pool_wait_idle_np(&pool) == 0);
+  assert(wrongCpu == 0);
+
+  assert(pthread_pool_destroy_np(&pool) == 0);
+
+  return 0;
+}
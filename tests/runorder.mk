@@ -6,13 +6,36 @@ benchtest2.bench:
 benchtest3.bench:
 benchtest4.bench:
 benchtest5.bench:
+benchtest6.bench:
+benchtest7.bench:
+benchtest8.bench:
+benchtest9.bench:
+benchtest10.bench:
+benchtest11.bench:
+benchtest12.bench:
+benchtest13.bench:
+benchtest14.bench:
+benchtest15.bench:
+benchtest16.bench:
+benchtest17.bench:
+benchtest18.bench:
+benchtest19.bench:
+benchtest20.bench:
+benchtest21.bench:
+benchtest22.bench:
+benchtest23.bench:
+benchtest24.bench:
+benchtest25.bench:
 
+address1.pass: create3.pass join4.pass
+address2.pass: address1.pass
 affinity1.pass: 
 affinity2.pass: affinity1.pass
 affinity3.pass: affinity2.pass self1.pass create3.pass
 affinity4.pass: affinity3.pass
 affinity5.pass: affinity4.pass
 affinity6.pass: affinity5.pass
+affinity7.pass: affinity6.pass
 barrier1.pass: semaphore4.pass
 barrier2.pass: barrier1.pass semaphore4.pass
 barrier3.pass: barrier2.pass semaphore4.pass self1.pass create3.pass join4.pass
@@ -29,10 +52,13 @@ cancel6d.pass: cancel3.pass self1.pass create3.pass join4.pass
 cancel7.pass: self1.pass create3.pass join4.pass kill1.pass
 cancel8.pass: cancel7.pass self1.pass mutex8.pass kill1.pass
 cancel9.pass: cancel8.pass self1.pass create3.pass join4.pass mutex8.pass kill1.pass
+cancel10.pass: cancel8.pass delay4.pass semaphore4.pass condvar7.pass
 cleanup0.pass: self1.pass create3.pass join4.pass mutex8.pass cancel5.pass
 cleanup1.pass: cleanup0.pass
 cleanup2.pass: cleanup1.pass
 cleanup3.pass: cleanup2.pass
+cleanup4.pass: cleanup3.pass barrier1.pass exit4.pass
+combiner1.pass: self1.pass create3.pass join4.pass
 condvar1.pass: self1.pass create3.pass semaphore1.pass mutex8.pass
 condvar1_1.pass: condvar1.pass
 condvar1_2.pass: join2.pass
@@ -48,6 +74,7 @@ condvar6.pass: condvar5.pass
 condvar7.pass: condvar6.pass cleanup1.pass
 condvar8.pass: condvar7.pass
 condvar9.pass: condvar8.pass
+condvar10.pass: condvar9.pass
 context1.pass: cancel1.pass
 count1.pass: join1.pass
 create1.pass: mutex2.pass
@@ -55,9 +82,13 @@ create2.pass: create1.pass
 create3.pass: create2.pass
 delay1.pass: self1.pass create3.pass
 delay2.pass: delay1.pass
+delay3.pass: delay2.pass
+delay4.pass: delay3.pass cancel3.pass
 detach1.pass: join0.pass
 equal1.pass: self1.pass create1.pass
 errno1.pass: mutex3.pass
+eventcount1.pass: create3.pass join4.pass
+eventcount2.pass: eventcount1.pass
 exception1.pass: cancel4.pass
 exception2.pass: exception1.pass
 exception3_0.pass: exception2.pass
@@ -70,12 +101,17 @@ exit5.pass: exit4.pass kill1.pass
 exit6.pass: exit5.pass
 eyal1.pass: self1.pass create3.pass mutex8.pass tsd1.pass
 inherit1.pass: join1.pass priority1.pass
+inline1.pass: mutex8.pass spin1.pass
+inline2.pass: inline1.pass lockprof1.pass
 join0.pass: create1.pass
 join1.pass: create1.pass
 join2.pass: create1.pass
 join3.pass: join2.pass
 join4.pass: join3.pass
 kill1.pass: self1.pass
+latch1.pass:
+latch2.pass: latch1.pass create3.pass join4.pass
+lockprof1.pass: mutex8.pass
 mutex1.pass: mutex5.pass
 mutex1n.pass: mutex1.pass
 mutex1e.pass: mutex1.pass
@@ -103,12 +139,18 @@ mutex8.pass: mutex7.pass
 mutex8n.pass: mutex7n.pass
 mutex8e.pass: mutex7e.pass
 mutex8r.pass: mutex7r.pass
+mutex9.pass: mutex8.pass
+mutex10.pass: mutex8.pass
 name_np1.pass: join4.pass barrier6.pass
 name_np2.pass: name_np1.pass
 once1.pass: create1.pass
 once2.pass: once1.pass
 once3.pass: once2.pass
 once4.pass: once3.pass
+parallel1.pass: create3.pass join4.pass
+parallel2.pass: parallel1.pass cancel3.pass
+pool1.pass: create3.pass join4.pass
+pool2.pass: pool1.pass cancel3.pass affinity1.pass
 priority1.pass: join1.pass
 priority2.pass: priority1.pass barrier3.pass
 reinit1.pass: rwlock7.pass
@@ -127,6 +169,9 @@ rwlock5.pass: rwlock4.pass
 rwlock6.pass: rwlock5.pass
 rwlock7.pass: rwlock6.pass
 rwlock8.pass: rwlock7.pass
+rwlock9.pass: rwlock8.pass
+rwlock10.pass: rwlock9.pass
+rwlock11.pass: rwlock10.pass
 rwlock2_t.pass: rwlock2.pass
 rwlock3_t.pass: rwlock2_t.pass
 rwlock4_t.pass: rwlock3_t.pass
@@ -141,6 +186,9 @@ semaphore3.pass: semaphore2.pass
 semaphore4.pass: semaphore3.pass cancel1.pass
 semaphore4t.pass: semaphore4.pass
 semaphore5.pass: semaphore4.pass
+semaphore6.pass: semaphore5.pass cancel1.pass
+seqlock1.pass: mutex8.pass
+seqlock2.pass: seqlock1.pass create3.pass join4.pass
 sequence1.pass: reuse2.pass
 sizes.pass: 
 spin1.pass: self1.pass create3.pass mutex8.pass
@@ -150,6 +198,8 @@ spin4.pass: spin3.pass
 stress1.pass: create3.pass mutex8.pass barrier6.pass
 threestage.pass: stress1.pass
 timeouts.pass: condvar9.pass
+timer1.pass: pool1.pass
+timer2.pass: timer1.pass
 tsd1.pass: barrier5.pass join1.pass
 tsd2.pass: tsd1.pass
 tsd3.pass: tsd2.pass
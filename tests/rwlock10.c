@@ -0,0 +1,228 @@
+/* 
+ * rwlock10.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test the PTHREAD_RWLOCK_PREFER_*_NP rwlock kinds. Check who may pass
+ * a waiting writer under each policy, that readers queued behind a
+ * writer that times out are released, and that data stays consistent
+ * under a mixed load.
+ *
+ * Depends on API functions:
+ *	pthread_rwlockattr_init()
+ *	pthread_rwlockattr_setkind_np()
+ *	pthread_rwlock_init()
+ *	pthread_rwlock_rdlock()
+ *	pthread_rwlock_tryrdlock()
+ *	pthread_rwlock_wrlock()
+ *	pthread_rwlock_timedwrlock()
+ *	pthread_rwlock_unlock()
+ *	pthread_rwlock_destroy()
+ */
+
+#include "test.h"
+#include <sys/timeb.h>
+
+#define THREADS 8
+#define ITERATIONS 10000
+
+static pthread_rwlock_t rwlock;
+static volatile long a = 0;
+static volatile long b = 0;
+static volatile int done = 0;
+
+void * writer(void * arg)
+{
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  done = 1;
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  return 0;
+}
+
+void * timedWriter(void * arg)
+{
+  struct timespec abstime = { 0, 0 };
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+
+  PTW32_FTIME(&currSysTime);
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+  abstime.tv_sec += 1;
+
+  return (void *)(size_t) pthread_rwlock_timedwrlock(&rwlock, &abstime);
+}
+
+void * tryReader(void * arg)
+{
+  int result = pthread_rwlock_tryrdlock(&rwlock);
+
+  if (result == 0)
+    {
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) result;
+}
+
+void * reader(void * arg)
+{
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  return 0;
+}
+
+void * mixed(void * arg)
+{
+  int id = (int)(size_t) arg;
+  long bad = 0;
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      if ((i + id) % 8 == 0)
+        {
+          assert(pthread_rwlock_wrlock(&rwlock) == 0);
+          a++;
+          b++;
+          assert(pthread_rwlock_unlock(&rwlock) == 0);
+        }
+      else
+        {
+          assert(pthread_rwlock_rdlock(&rwlock) == 0);
+          if (a != b)
+            {
+              bad++;
+            }
+          assert(pthread_rwlock_unlock(&rwlock) == 0);
+        }
+    }
+
+  return (void *)(size_t) bad;
+}
+
+static void
+initLock(int kind)
+{
+  pthread_rwlockattr_t rwa;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_setkind_np(&rwa, kind) == 0);
+  assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+}
+
+/*
+ * Hold a read lock, start a writer and see whether another reader
+ * can get in while the writer waits.
+ */
+static int
+readerPassesWriter(int kind)
+{
+  pthread_t w, r;
+  void * result;
+
+  initLock(kind);
+  done = 0;
+
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(pthread_create(&w, NULL, writer, NULL) == 0);
+  Sleep(200);
+  assert(done == 0);
+
+  if (kind == PTHREAD_RWLOCK_PREFER_WRITER_NP)
+    {
+      /* A recursive read lock passes the writer. */
+      assert(pthread_rwlock_tryrdlock(&rwlock) == 0);
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  assert(pthread_create(&r, NULL, tryReader, NULL) == 0);
+  assert(pthread_join(r, &result) == 0);
+
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_join(w, NULL) == 0);
+  assert(done == 1);
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return (int)(size_t) result;
+}
+
+int
+main()
+{
+  static const int kinds[] = {
+    PTHREAD_RWLOCK_PREFER_READER_NP,
+    PTHREAD_RWLOCK_PREFER_WRITER_NP,
+    PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP
+  };
+  pthread_t t[THREADS];
+  void * result;
+  int k, i;
+
+  assert(readerPassesWriter(PTHREAD_RWLOCK_PREFER_READER_NP) == 0);
+  assert(readerPassesWriter(PTHREAD_RWLOCK_PREFER_WRITER_NP) == EBUSY);
+  assert(readerPassesWriter(PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP) == EBUSY);
+
+  /*
+   * A reader queued behind a writer that gives up must be let in.
+   */
+  initLock(PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+  assert(pthread_rwlock_unlock(&rwlock) == EPERM);
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(pthread_create(&t[0], NULL, timedWriter, NULL) == 0);
+  Sleep(200);
+  assert(pthread_create(&t[1], NULL, reader, NULL) == 0);
+  assert(pthread_join(t[0], &result) == 0);
+  assert((int)(size_t) result == ETIMEDOUT);
+  assert(pthread_join(t[1], NULL) == 0);
+  assert(pthread_rwlock_destroy(&rwlock) == EBUSY);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  for (k = 0; k < (int)(sizeof(kinds)/sizeof(kinds[0])); k++)
+    {
+      initLock(kinds[k]);
+      a = b = 0;
+
+      for (i = 0; i < THREADS; i++)
+        {
+          assert(pthread_create(&t[i], NULL, mixed, (void *)(size_t) i) == 0);
+        }
+      for (i = 0; i < THREADS; i++)
+        {
+          assert(pthread_join(t[i], &result) == 0);
+          assert((int)(size_t) result == 0);
+        }
+
+      assert(a == THREADS * ITERATIONS / 8);
+      assert(pthread_rwlock_destroy(&rwlock) == 0);
+    }
+
+  return 0;
+}
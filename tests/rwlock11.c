@@ -0,0 +1,156 @@
+/* 
+ * rwlock11.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test pthread_rwlock_upgrade_np() and pthread_rwlock_downgrade_np()
+ * with every rwlock kind.
+ *
+ * Depends on API functions:
+ *	pthread_rwlockattr_init()
+ *	pthread_rwlockattr_setkind_np()
+ *	pthread_rwlock_init()
+ *	pthread_rwlock_rdlock()
+ *	pthread_rwlock_tryrdlock()
+ *	pthread_rwlock_wrlock()
+ *	pthread_rwlock_trywrlock()
+ *	pthread_rwlock_upgrade_np()
+ *	pthread_rwlock_downgrade_np()
+ *	pthread_rwlock_unlock()
+ *	pthread_rwlock_destroy()
+ */
+
+#include "test.h"
+
+static pthread_rwlock_t rwlock;
+static volatile int upgraded = 0;
+
+void * tryWriter(void * arg)
+{
+  int result = pthread_rwlock_trywrlock(&rwlock);
+
+  if (result == 0)
+    {
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) result;
+}
+
+void * tryReader(void * arg)
+{
+  int result = pthread_rwlock_tryrdlock(&rwlock);
+
+  if (result == 0)
+    {
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) result;
+}
+
+void * upgrader(void * arg)
+{
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(pthread_rwlock_upgrade_np(&rwlock) == 0);
+  upgraded = 1;
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  return 0;
+}
+
+static int
+tryOther(void * (*func)(void *))
+{
+  pthread_t t;
+  void * result;
+
+  assert(pthread_create(&t, NULL, func, NULL) == 0);
+  assert(pthread_join(t, &result) == 0);
+
+  return (int)(size_t) result;
+}
+
+int
+main()
+{
+  static const int kinds[] = {
+    PTHREAD_RWLOCK_DEFAULT_NP,
+    PTHREAD_RWLOCK_BIGREADER_NP,
+    PTHREAD_RWLOCK_PREFER_READER_NP,
+    PTHREAD_RWLOCK_PREFER_WRITER_NP,
+    PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP
+  };
+  pthread_rwlockattr_t rwa;
+  pthread_t t;
+  int k;
+
+  assert(pthread_rwlock_upgrade_np(NULL) == EINVAL);
+  assert(pthread_rwlock_downgrade_np(NULL) == EINVAL);
+
+  for (k = 0; k < (int)(sizeof(kinds)/sizeof(kinds[0])); k++)
+    {
+      assert(pthread_rwlockattr_init(&rwa) == 0);
+      assert(pthread_rwlockattr_setkind_np(&rwa, kinds[k]) == 0);
+      assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+      assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+      assert(pthread_rwlock_upgrade_np(&rwlock) == EPERM);
+      assert(pthread_rwlock_downgrade_np(&rwlock) == EPERM);
+
+      /*
+       * Read -> write -> read -> unlocked.
+       */
+      assert(pthread_rwlock_rdlock(&rwlock) == 0);
+      assert(tryOther(tryReader) == 0);
+      assert(pthread_rwlock_upgrade_np(&rwlock) == 0);
+      assert(tryOther(tryReader) == EBUSY);
+      assert(tryOther(tryWriter) == EBUSY);
+      assert(pthread_rwlock_downgrade_np(&rwlock) == 0);
+      assert(tryOther(tryReader) == 0);
+      assert(tryOther(tryWriter) == EBUSY);
+      assert(pthread_rwlock_downgrade_np(&rwlock) == EPERM);
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+      assert(tryOther(tryWriter) == 0);
+
+      /*
+       * Only one reader can be upgrading.
+       */
+      upgraded = 0;
+      assert(pthread_rwlock_rdlock(&rwlock) == 0);
+      assert(pthread_create(&t, NULL, upgrader, NULL) == 0);
+      Sleep(200);
+      assert(upgraded == 0);
+      assert(pthread_rwlock_upgrade_np(&rwlock) == EDEADLK);
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+      assert(pthread_join(t, NULL) == 0);
+      assert(upgraded == 1);
+
+      assert(pthread_rwlock_destroy(&rwlock) == 0);
+    }
+
+  return 0;
+}
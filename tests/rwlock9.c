@@ -0,0 +1,186 @@
+/* 
+ * rwlock9.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test PTHREAD_RWLOCK_BIGREADER_NP rwlocks. Check the kind attribute,
+ * that readers share and writers exclude, and that a writer sees
+ * consistent data while readers run on every processor.
+ *
+ * Depends on API functions:
+ *	pthread_rwlockattr_init()
+ *	pthread_rwlockattr_setkind_np()
+ *	pthread_rwlockattr_getkind_np()
+ *	pthread_rwlock_init()
+ *	pthread_rwlock_rdlock()
+ *	pthread_rwlock_tryrdlock()
+ *	pthread_rwlock_wrlock()
+ *	pthread_rwlock_trywrlock()
+ *	pthread_rwlock_timedwrlock()
+ *	pthread_rwlock_unlock()
+ *	pthread_rwlock_destroy()
+ */
+
+#include "test.h"
+#include <sys/timeb.h>
+
+#define ITERATIONS 10000
+#define MAXREADERS 16
+
+static pthread_rwlock_t rwlock;
+static volatile long a = 0;
+static volatile long b = 0;
+static volatile int stop = 0;
+
+void * reader(void * arg)
+{
+  long bad = 0;
+
+  while (!stop)
+    {
+      assert(pthread_rwlock_rdlock(&rwlock) == 0);
+      if (a != b)
+        {
+          bad++;
+        }
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) bad;
+}
+
+void * tryWriter(void * arg)
+{
+  return (void *)(size_t) pthread_rwlock_trywrlock(&rwlock);
+}
+
+void * tryReader(void * arg)
+{
+  int result = pthread_rwlock_tryrdlock(&rwlock);
+
+  if (result == 0)
+    {
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  return (void *)(size_t) result;
+}
+
+int
+main()
+{
+  pthread_rwlockattr_t rwa;
+  pthread_t t[MAXREADERS];
+  void * result;
+  struct timespec abstime = { 0, 0 };
+  PTW32_STRUCT_TIMEB currSysTime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+  int kind = -1;
+  int nReaders;
+  int i;
+
+  assert(pthread_rwlockattr_init(&rwa) == 0);
+  assert(pthread_rwlockattr_getkind_np(&rwa, &kind) == 0);
+  assert(kind == PTHREAD_RWLOCK_DEFAULT_NP);
+  assert(pthread_rwlockattr_setkind_np(&rwa, -1) == EINVAL);
+  assert(pthread_rwlockattr_setkind_np(&rwa, PTHREAD_RWLOCK_BIGREADER_NP) == 0);
+  assert(pthread_rwlockattr_getkind_np(&rwa, &kind) == 0);
+  assert(kind == PTHREAD_RWLOCK_BIGREADER_NP);
+
+  assert(pthread_rwlock_init(&rwlock, &rwa) == 0);
+  assert(pthread_rwlockattr_destroy(&rwa) == 0);
+
+  /*
+   * Readers share; a writer is excluded.
+   */
+  assert(pthread_rwlock_rdlock(&rwlock) == 0);
+  assert(pthread_rwlock_tryrdlock(&rwlock) == 0);
+  assert(pthread_create(&t[0], NULL, tryWriter, NULL) == 0);
+  assert(pthread_join(t[0], &result) == 0);
+  assert((int)(size_t) result == EBUSY);
+  assert(pthread_rwlock_destroy(&rwlock) == EBUSY);
+
+  PTW32_FTIME(&currSysTime);
+  abstime.tv_sec = (long)currSysTime.time;
+  abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm;
+  abstime.tv_sec += 1;
+  assert(pthread_rwlock_timedwrlock(&rwlock, &abstime) == ETIMEDOUT);
+
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  /*
+   * A writer excludes readers.
+   */
+  assert(pthread_rwlock_wrlock(&rwlock) == 0);
+  assert(pthread_create(&t[0], NULL, tryReader, NULL) == 0);
+  assert(pthread_join(t[0], &result) == 0);
+  assert((int)(size_t) result == EBUSY);
+  assert(pthread_rwlock_unlock(&rwlock) == 0);
+
+  assert(pthread_create(&t[0], NULL, tryReader, NULL) == 0);
+  assert(pthread_join(t[0], &result) == 0);
+  assert((int)(size_t) result == 0);
+
+  /*
+   * Writer updates under load from readers on all processors.
+   */
+  nReaders = pthread_num_processors_np();
+  if (nReaders < 2)
+    {
+      nReaders = 2;
+    }
+  else if (nReaders > MAXREADERS)
+    {
+      nReaders = MAXREADERS;
+    }
+
+  for (i = 0; i < nReaders; i++)
+    {
+      assert(pthread_create(&t[i], NULL, reader, NULL) == 0);
+    }
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_rwlock_wrlock(&rwlock) == 0);
+      a++;
+      b++;
+      assert(pthread_rwlock_unlock(&rwlock) == 0);
+    }
+
+  stop = 1;
+
+  for (i = 0; i < nReaders; i++)
+    {
+      assert(pthread_join(t[i], &result) == 0);
+      assert((int)(size_t) result == 0);
+    }
+
+  assert(a == ITERATIONS);
+  assert(pthread_rwlock_destroy(&rwlock) == 0);
+
+  return 0;
+}
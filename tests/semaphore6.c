@@ -0,0 +1,226 @@
+/*
+ * File: semaphore6.c
+ *
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test Synopsis: Verify that no post is lost when timed waits and
+ * cancellations race with sem_post and sem_post_multiple.
+ *
+ * Test Method (Validation or Falsification):
+ * - Validation
+ *
+ * Requirements Tested:
+ * - 
+ *
+ * Features Tested:
+ * - 
+ *
+ * Cases Tested:
+ * - 
+ *
+ * Description:
+ * - Several threads take posts with very short timeouts while others
+ *   post one at a time and several at a time. A post that arrives as a
+ *   wait times out must either be taken by that wait or stay in the
+ *   semaphore's value. Waiters blocked in sem_wait are then cancelled.
+ *   At the end every post has been taken or is still counted and the
+ *   semaphore can be destroyed.
+ *
+ * Environment:
+ * - 
+ *
+ * Input:
+ * - None.
+ *
+ * Output:
+ * - File name, Line number, and failed expression on failure.
+ * - No output on success.
+ *
+ * Assumptions:
+ * - 
+ *
+ * Pass Criteria:
+ * - Process returns zero exit status.
+ *
+ * Fail Criteria:
+ * - Process returns non-zero exit status.
+ */
+
+// #define ASSERT_TRACE
+
+#include "test.h"
+#include <sys/timeb.h>
+
+enum {
+  NUMPOSTERS = 2,
+  NUMTAKERS = 4,
+  NUMBLOCKERS = 4,
+  POSTS = 20000
+};
+
+static sem_t s;
+static long taken = 0;
+static int stop = 0;
+
+void *
+poster(void * arg)
+{
+  int i;
+
+  for (i = 0; i < POSTS; i += 3)
+    {
+      if (i % 2 == 0)
+        {
+          assert(sem_post_multiple(&s, 3) == 0);
+        }
+      else
+        {
+          assert(sem_post(&s) == 0);
+          assert(sem_post(&s) == 0);
+          assert(sem_post(&s) == 0);
+        }
+    }
+
+  return 0;
+}
+
+void *
+taker(void * arg)
+{
+  PTW32_STRUCT_TIMEB currSysTime;
+  struct timespec abstime;
+  const DWORD NANOSEC_PER_MILLISEC = 1000000;
+
+  while (!InterlockedExchangeAdd((LPLONG)&stop, 0L))
+    {
+      PTW32_FTIME(&currSysTime);
+
+      abstime.tv_sec = (long)currSysTime.time;
+      abstime.tv_nsec = NANOSEC_PER_MILLISEC * currSysTime.millitm
+                        + NANOSEC_PER_MILLISEC;
+      if (abstime.tv_nsec >= 1000000000)
+        {
+          abstime.tv_sec++;
+          abstime.tv_nsec -= 1000000000;
+        }
+
+      if (sem_timedwait(&s, &abstime) == 0)
+        {
+          InterlockedIncrement((LPLONG)&taken);
+        }
+      else
+        {
+          assert(errno == ETIMEDOUT);
+        }
+    }
+
+  return 0;
+}
+
+void *
+blocker(void * arg)
+{
+  assert(sem_wait(&s) == 0);
+  InterlockedIncrement((LPLONG)&taken);
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t p[NUMPOSTERS];
+  pthread_t t[NUMTAKERS];
+  pthread_t b[NUMBLOCKERS];
+  void * result;
+  int value;
+  int i;
+
+  assert(sem_init(&s, PTHREAD_PROCESS_PRIVATE, 0) == 0);
+
+  for (i = 0; i < NUMTAKERS; i++)
+    {
+      assert(pthread_create(&t[i], NULL, taker, NULL) == 0);
+    }
+  for (i = 0; i < NUMPOSTERS; i++)
+    {
+      assert(pthread_create(&p[i], NULL, poster, NULL) == 0);
+    }
+  for (i = 0; i < NUMPOSTERS; i++)
+    {
+      assert(pthread_join(p[i], NULL) == 0);
+    }
+
+  InterlockedExchange((LPLONG)&stop, 1L);
+
+  for (i = 0; i < NUMTAKERS; i++)
+    {
+      assert(pthread_join(t[i], NULL) == 0);
+    }
+
+  assert(sem_getvalue(&s, &value) == 0);
+  assert(value >= 0);
+  assert(taken + value == NUMPOSTERS * ((POSTS + 2) / 3) * 3);
+
+  /*
+   * Drain the semaphore, then cancel threads blocked on it.
+   */
+  while (value-- > 0)
+    {
+      assert(sem_wait(&s) == 0);
+    }
+
+  for (i = 0; i < NUMBLOCKERS; i++)
+    {
+      assert(pthread_create(&b[i], NULL, blocker, NULL) == 0);
+    }
+
+  Sleep(500);
+
+  for (i = 0; i < NUMBLOCKERS; i++)
+    {
+      assert(pthread_cancel(b[i]) == 0);
+    }
+  for (i = 0; i < NUMBLOCKERS; i++)
+    {
+      assert(pthread_join(b[i], &result) == 0);
+      assert(result == PTHREAD_CANCELED);
+    }
+
+  assert(sem_getvalue(&s, &value) == 0);
+  assert(value == 0);
+  assert(sem_destroy(&s) == 0);
+
+  return 0;
+}
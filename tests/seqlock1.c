@@ -0,0 +1,80 @@
+/* 
+ * seqlock1.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test the sequence lock API in a single thread.
+ *
+ * Depends on API functions:
+ *	pthread_seqlock_init_np()
+ *	pthread_seqlock_read_begin_np()
+ *	pthread_seqlock_read_retry_np()
+ *	pthread_seqlock_write_lock_np()
+ *	pthread_seqlock_write_unlock_np()
+ *	pthread_seqlock_destroy_np()
+ */
+
+#include "test.h"
+
+static pthread_seqlock_t lock;
+
+int
+main()
+{
+  unsigned int seq;
+  unsigned int seq2;
+
+  assert(pthread_seqlock_init_np(NULL) == EINVAL);
+  assert(pthread_seqlock_init_np(&lock) == 0);
+
+  assert(pthread_seqlock_read_begin_np(&lock, NULL) == EINVAL);
+  assert(pthread_seqlock_write_unlock_np(&lock) == EPERM);
+
+  /*
+   * A read with no writer is consistent.
+   */
+  assert(pthread_seqlock_read_begin_np(&lock, &seq) == 0);
+  assert(pthread_seqlock_read_retry_np(&lock, seq) == 0);
+
+  /*
+   * A read that overlaps a write must be retried.
+   */
+  assert(pthread_seqlock_read_begin_np(&lock, &seq) == 0);
+  assert(pthread_seqlock_write_lock_np(&lock) == 0);
+  assert(pthread_seqlock_write_unlock_np(&lock) == 0);
+  assert(pthread_seqlock_read_retry_np(&lock, seq) == EAGAIN);
+
+  assert(pthread_seqlock_read_begin_np(&lock, &seq2) == 0);
+  assert(seq2 != seq);
+  assert(pthread_seqlock_read_retry_np(&lock, seq2) == 0);
+
+  assert(pthread_seqlock_write_lock_np(&lock) == 0);
+  assert(pthread_seqlock_destroy_np(&lock) == EBUSY);
+  assert(pthread_seqlock_write_unlock_np(&lock) == 0);
+
+  assert(pthread_seqlock_destroy_np(&lock) == 0);
+  assert(pthread_seqlock_destroy_np(&lock) == EINVAL);
+
+  return 0;
+}
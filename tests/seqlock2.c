@@ -0,0 +1,124 @@
+/* 
+ * seqlock2.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test that sequence lock readers only ever accept consistent copies.
+ * Writers keep two fields equal and negated; readers check every copy
+ * they accept.
+ *
+ * Depends on API functions:
+ *	pthread_seqlock_init_np()
+ *	pthread_seqlock_read_begin_np()
+ *	pthread_seqlock_read_retry_np()
+ *	pthread_seqlock_write_lock_np()
+ *	pthread_seqlock_write_unlock_np()
+ *	pthread_seqlock_destroy_np()
+ */
+
+#include "test.h"
+
+#define READERS         4
+#define WRITERS         2
+#define ITERATIONS      100000
+
+static pthread_seqlock_t lock;
+static volatile long a = 0;
+static volatile long b = 0;
+static int retries = 0;
+
+void * writer(void * arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      assert(pthread_seqlock_write_lock_np(&lock) == 0);
+      a++;
+      b--;
+      assert(pthread_seqlock_write_unlock_np(&lock) == 0);
+    }
+
+  return 0;
+}
+
+void * reader(void * arg)
+{
+  unsigned int seq;
+  long ca, cb;
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    {
+      for (;;)
+        {
+          assert(pthread_seqlock_read_begin_np(&lock, &seq) == 0);
+          ca = a;
+          cb = b;
+          if (pthread_seqlock_read_retry_np(&lock, seq) == 0)
+            {
+              break;
+            }
+          InterlockedIncrement((LPLONG)&retries);
+        }
+      assert(ca == -cb);
+    }
+
+  return 0;
+}
+
+int
+main()
+{
+  pthread_t r[READERS];
+  pthread_t w[WRITERS];
+  int i;
+
+  assert(pthread_seqlock_init_np(&lock) == 0);
+
+  for (i = 0; i < READERS; i++)
+    {
+      assert(pthread_create(&r[i], NULL, reader, NULL) == 0);
+    }
+  for (i = 0; i < WRITERS; i++)
+    {
+      assert(pthread_create(&w[i], NULL, writer, NULL) == 0);
+    }
+
+  for (i = 0; i < WRITERS; i++)
+    {
+      assert(pthread_join(w[i], NULL) == 0);
+    }
+  for (i = 0; i < READERS; i++)
+    {
+      assert(pthread_join(r[i], NULL) == 0);
+    }
+
+  assert(a == WRITERS * ITERATIONS);
+  assert(b == -a);
+
+  assert(pthread_seqlock_destroy_np(&lock) == 0);
+
+  return 0;
+}
@@ -279,7 +279,7 @@ void * producer (void * arg)
       /* Periodically produce work units until the goal is satisfied */
       /* messages receive a source and destination address which are */
       /* the same in this case but could, in general, be different. */
-      sleep (rand()/100000000);
+      sleep (0);
       message_fill (&msg, ithread, ithread, parg->work_done);
 
       /* put the message in the queue - Use an infinite timeout to assure
@@ -0,0 +1,196 @@
+/* 
+ * timer1.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test POSIX timers.
+ *
+ * - argument checking;
+ * - a one-shot timer notifies once, not before it is due, and reads
+ *   as disarmed afterwards;
+ * - disarming, and re-arming with an absolute CLOCK_REALTIME time;
+ * - a SIGEV_NONE timer counts down but notifies nothing.
+ *
+ * Depends on API functions:
+ *	timer_create()
+ *	timer_settime()
+ *	timer_gettime()
+ *	timer_getoverrun()
+ *	timer_delete()
+ */
+
+#include "test.h"
+#include <string.h>
+#include <sys/timeb.h>
+
+static long fired = 0;
+static DWORD firedAt;
+
+void
+notify(union sigval value)
+{
+  assert(value.sival_int == 42);
+  firedAt = GetTickCount();
+  InterlockedIncrement((LPLONG)&fired);
+}
+
+void
+setms(struct itimerspec * its, long valueMs, long intervalMs)
+{
+  its->it_value.tv_sec = valueMs / 1000;
+  its->it_value.tv_nsec = (valueMs % 1000) * 1000000;
+  its->it_interval.tv_sec = intervalMs / 1000;
+  its->it_interval.tv_nsec = (intervalMs % 1000) * 1000000;
+}
+
+int
+main()
+{
+  struct sigevent ev;
+  struct itimerspec its;
+  struct itimerspec old;
+  struct _timeb currSysTime;
+  timer_t timer;
+  DWORD start;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.sigev_notify = SIGEV_THREAD;
+  ev.sigev_notify_function = notify;
+  ev.sigev_value.sival_int = 42;
+
+  /*
+   * Argument checking. Signals aren't supported.
+   */
+  assert(timer_create(CLOCK_MONOTONIC, NULL, &timer) == -1);
+  assert(errno == EINVAL);
+  assert(timer_create(CLOCK_MONOTONIC, &ev, NULL) == -1);
+  assert(errno == EINVAL);
+  assert(timer_create(99, &ev, &timer) == -1);
+  assert(errno == EINVAL);
+  ev.sigev_notify = SIGEV_SIGNAL;
+  assert(timer_create(CLOCK_MONOTONIC, &ev, &timer) == -1);
+  assert(errno == EINVAL);
+  ev.sigev_notify = SIGEV_THREAD;
+  ev.sigev_notify_function = NULL;
+  assert(timer_create(CLOCK_MONOTONIC, &ev, &timer) == -1);
+  assert(errno == EINVAL);
+  ev.sigev_notify_function = notify;
+
+  assert(timer_create(CLOCK_MONOTONIC, &ev, &timer) == 0);
+
+  setms(&its, 0, 0);
+  its.it_value.tv_nsec = 1000000000;
+  assert(timer_settime(timer, 0, &its, NULL) == -1);
+  assert(errno == EINVAL);
+  its.it_value.tv_nsec = -1;
+  assert(timer_settime(timer, 0, &its, NULL) == -1);
+  assert(errno == EINVAL);
+  assert(timer_settime(timer, 0, NULL, NULL) == -1);
+  assert(errno == EINVAL);
+  assert(timer_gettime(timer, NULL) == -1);
+  assert(errno == EINVAL);
+
+  /*
+   * Disarmed.
+   */
+  assert(timer_gettime(timer, &its) == 0);
+  assert(its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0);
+  assert(timer_getoverrun(timer) == 0);
+
+  /*
+   * One shot.
+   */
+  setms(&its, 200, 0);
+  start = GetTickCount();
+  assert(timer_settime(timer, 0, &its, &old) == 0);
+  assert(old.it_value.tv_sec == 0 && old.it_value.tv_nsec == 0);
+  assert(timer_gettime(timer, &its) == 0);
+  assert(its.it_value.tv_sec == 0);
+  assert(its.it_value.tv_nsec > 0 && its.it_value.tv_nsec <= 200000000);
+
+  while (fired == 0)
+    {
+      Sleep(10);
+      assert(GetTickCount() - start < 5000);
+    }
+
+  /*
+   * GetTickCount() is coarse, so allow a tick's slack.
+   */
+  assert(firedAt - start >= 200 - 16);
+  Sleep(300);
+  assert(fired == 1);
+  assert(timer_gettime(timer, &its) == 0);
+  assert(its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0);
+
+  /*
+   * Disarm before it fires.
+   */
+  setms(&its, 200, 0);
+  assert(timer_settime(timer, 0, &its, NULL) == 0);
+  setms(&its, 0, 0);
+  assert(timer_settime(timer, 0, &its, &old) == 0);
+  assert(old.it_value.tv_sec == 0 && old.it_value.tv_nsec > 0);
+  Sleep(400);
+  assert(fired == 1);
+
+  /*
+   * Absolute realtime.
+   */
+  assert(timer_delete(timer) == 0);
+  assert(timer_create(CLOCK_REALTIME, &ev, &timer) == 0);
+  _ftime(&currSysTime);
+  its.it_value.tv_sec = (time_t) currSysTime.time + 1;
+  its.it_value.tv_nsec = (long) currSysTime.millitm * 1000000;
+  its.it_interval.tv_sec = 0;
+  its.it_interval.tv_nsec = 0;
+  start = GetTickCount();
+  assert(timer_settime(timer, TIMER_ABSTIME, &its, NULL) == 0);
+  while (fired == 1)
+    {
+      Sleep(10);
+      assert(GetTickCount() - start < 5000);
+    }
+  assert(firedAt - start >= 1000 - 16);
+
+  assert(timer_delete(timer) == 0);
+
+  /*
+   * No notification.
+   */
+  ev.sigev_notify = SIGEV_NONE;
+  assert(timer_create(CLOCK_REALTIME, &ev, &timer) == 0);
+  setms(&its, 300, 0);
+  assert(timer_settime(timer, 0, &its, NULL) == 0);
+  Sleep(100);
+  assert(timer_gettime(timer, &its) == 0);
+  assert(its.it_value.tv_nsec < 300000000);
+  Sleep(400);
+  assert(timer_gettime(timer, &its) == 0);
+  assert(its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0);
+  assert(fired == 2);
+  assert(timer_delete(timer) == 0);
+
+  return 0;
+}
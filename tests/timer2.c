@@ -0,0 +1,170 @@
+/* 
+ * timer2.c
+ *
+ *
+ * Pthreads-win32 - POSIX Threads Library for Win32
+ * Copyright (C) 1998 Ben Elliston and Ross Johnson
+ * Copyright (C) 1999,2000,2001 Ross Johnson
+ *
+ * Contact Email: rpj@ise.canberra.edu.au
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * --------------------------------------------------------------------------
+ *
+ * Test periodic POSIX timers.
+ *
+ * - a periodic timer notifies about once a period;
+ * - expirations while a notification runs are counted as overruns
+ *   and never run notifications side by side;
+ * - notifications run on threads created with the timer's attributes
+ *   when it has them;
+ * - a timer can delete itself from its own notification.
+ *
+ * Depends on API functions:
+ *	timer_create()
+ *	timer_settime()
+ *	timer_getoverrun()
+ *	timer_delete()
+ *	pthread_attr_setstacksize()
+ *	pthread_detach()
+ */
+
+#include "test.h"
+#include <string.h>
+
+static timer_t timer;
+static timer_t other;
+static long count = 0;
+static long running = 0;
+static long overruns = 0;
+static long deleted = 0;
+
+void
+periodic(union sigval value)
+{
+  InterlockedIncrement((LPLONG)&count);
+}
+
+void
+slow(union sigval value)
+{
+  assert(InterlockedIncrement((LPLONG)&running) == 1);
+  InterlockedExchangeAdd((LPLONG)&overruns, timer_getoverrun(timer));
+  InterlockedIncrement((LPLONG)&count);
+  Sleep(100);
+  InterlockedDecrement((LPLONG)&running);
+}
+
+void
+detached(union sigval value)
+{
+  /*
+   * Not a pool worker: those are joinable.
+   */
+  assert(pthread_detach(pthread_self()) == EINVAL);
+  InterlockedIncrement((LPLONG)&count);
+}
+
+void
+selfdelete(union sigval value)
+{
+  assert(timer_delete(other) == 0);
+  InterlockedIncrement((LPLONG)&deleted);
+}
+
+void
+setms(struct itimerspec * its, long valueMs, long intervalMs)
+{
+  its->it_value.tv_sec = valueMs / 1000;
+  its->it_value.tv_nsec = (valueMs % 1000) * 1000000;
+  its->it_interval.tv_sec = intervalMs / 1000;
+  its->it_interval.tv_nsec = (intervalMs % 1000) * 1000000;
+}
+
+int
+main()
+{
+  struct sigevent ev;
+  struct itimerspec its;
+  pthread_attr_t attr;
+  long n;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.sigev_notify = SIGEV_THREAD;
+
+  /*
+   * Every 20 ms for a second.
+   */
+  ev.sigev_notify_function = periodic;
+  assert(timer_create(CLOCK_MONOTONIC, &ev, &timer) == 0);
+  setms(&its, 20, 20);
+  assert(timer_settime(timer, 0, &its, NULL) == 0);
+  Sleep(1000);
+  setms(&its, 0, 0);
+  assert(timer_settime(timer, 0, &its, NULL) == 0);
+  Sleep(100);
+  n = count;
+  assert(n >= 25 && n <= 51);
+  Sleep(100);
+  assert(count == n);
+  assert(timer_delete(timer) == 0);
+
+  /*
+   * A notification that takes 100 ms, every 10 ms. About ten
+   * expirations are missed for each that is notified.
+   */
+  count = 0;
+  ev.sigev_notify_function = slow;
+  assert(timer_create(CLOCK_MONOTONIC, &ev, &timer) == 0);
+  setms(&its, 10, 10);
+  assert(timer_settime(timer, 0, &its, NULL) == 0);
+  Sleep(1000);
+  assert(timer_delete(timer) == 0);
+  Sleep(300);
+  assert(running == 0);
+  assert(count >= 3 && count <= 11);
+  assert(overruns >= count * 5);
+
+  /*
+   * Attributes.
+   */
+  count = 0;
+  ev.sigev_notify_function = detached;
+  assert(pthread_attr_init(&attr) == 0);
+  assert(pthread_attr_setstacksize(&attr, 256 * 1024) == 0);
+  ev.sigev_notify_attributes = &attr;
+  assert(timer_create(CLOCK_MONOTONIC, &ev, &timer) == 0);
+  ev.sigev_notify_attributes = NULL;
+  assert(pthread_attr_destroy(&attr) == 0);
+  setms(&its, 10, 50);
+  assert(timer_settime(timer, 0, &its, NULL) == 0);
+  Sleep(500);
+  assert(timer_delete(timer) == 0);
+  Sleep(100);
+  assert(count >= 3);
+
+  /*
+   * Self deletion.
+   */
+  ev.sigev_notify_function = selfdelete;
+  assert(timer_create(CLOCK_MONOTONIC, &ev, &other) == 0);
+  setms(&its, 10, 10);
+  assert(timer_settime(other, 0, &its, NULL) == 0);
+  Sleep(500);
+  assert(deleted == 1);
+
+  return 0;
+}
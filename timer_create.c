@@ -0,0 +1,153 @@
+/*
+ * timer_create.c
+ *
+ * Description:
+ * This translation unit implements POSIX timer primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+timer_create (clockid_t clock_id, struct sigevent * evp, timer_t * timerid)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Creates a timer.
+      *
+      * PARAMETERS
+      *      clock_id
+      *              CLOCK_REALTIME or CLOCK_MONOTONIC
+      *
+      *      evp
+      *              how expirations are notified
+      *
+      *      timerid
+      *              pointer to an instance of timer_t
+      *
+      * DESCRIPTION
+      *      This function creates a disarmed timer measuring
+      *      'clock_id'. If evp->sigev_notify is SIGEV_THREAD, each
+      *      expiration calls evp->sigev_notify_function with
+      *      evp->sigev_value on another thread: a pool thread if
+      *      evp->sigev_notify_attributes is NULL, otherwise a new
+      *      detached thread created with those attributes. If it
+      *      is SIGEV_NONE expirations aren't notified.
+      *
+      *      Signals are not supported, so SIGEV_SIGNAL and a NULL
+      *      'evp' (which means SIGEV_SIGNAL) fail with EINVAL.
+      *
+      * RESULTS
+      *              0               successfully created,
+      *              -1              failed, error in errno:
+      *
+      *              EINVAL          an argument is invalid,
+      *              EAGAIN          insufficient resources
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_timer_t * t;
+  int result = 0;
+
+  if (timerid == NULL
+      || (clock_id != CLOCK_REALTIME && clock_id != CLOCK_MONOTONIC)
+      || evp == NULL
+      || (evp->sigev_notify != SIGEV_NONE && evp->sigev_notify != SIGEV_THREAD)
+      || (evp->sigev_notify == SIGEV_THREAD
+          && (evp->sigev_notify_function == NULL
+              || (evp->sigev_notify_attributes != NULL
+                  && ptw32_is_attr (evp->sigev_notify_attributes) != 0))))
+    {
+      result = EINVAL;
+      goto FAIL0;
+    }
+
+  if (0 != ptw32_timer_start ())
+    {
+      result = EAGAIN;
+      goto FAIL0;
+    }
+
+  t = (ptw32_timer_t *) calloc (1, sizeof (*t));
+
+  if (t == NULL)
+    {
+      result = EAGAIN;
+      goto FAIL0;
+    }
+
+  t->clock = clock_id;
+  t->notify = evp->sigev_notify;
+  t->function = evp->sigev_notify_function;
+  t->value = evp->sigev_value;
+
+  if (t->notify == SIGEV_THREAD && evp->sigev_notify_attributes != NULL)
+    {
+      pthread_attr_t attr = *evp->sigev_notify_attributes;
+
+      /*
+       * Keep a copy: the caller may destroy theirs. Notification
+       * threads are always detached.
+       */
+      if (0 != pthread_attr_init (&t->attr))
+        {
+          result = EAGAIN;
+          goto FAIL1;
+        }
+
+      t->attr->detachstate = PTHREAD_CREATE_DETACHED;
+      t->attr->stacksize = attr->stacksize;
+      t->attr->param = attr->param;
+      t->attr->inheritsched = attr->inheritsched;
+      t->attr->contentionscope = attr->contentionscope;
+      t->attr->cpuset = attr->cpuset;
+    }
+
+  *timerid = t;
+
+  return 0;
+
+FAIL1:
+  free (t);
+
+FAIL0:
+  PTW32_SET_ERRNO (result);
+
+  return -1;
+}				/* timer_create */
@@ -0,0 +1,92 @@
+/*
+ * timer_delete.c
+ *
+ * Description:
+ * This translation unit implements POSIX timer primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+timer_delete (timer_t timerid)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Deletes a timer.
+      *
+      * PARAMETERS
+      *      timerid
+      *              a timer created by timer_create()
+      *
+      * DESCRIPTION
+      *      This function disarms and deletes 'timerid'. A
+      *      notification that is already running is allowed to
+      *      finish; one that is queued still runs.
+      *
+      * RESULTS
+      *              0               successfully deleted,
+      *              -1              failed, error in errno:
+      *
+      *              EINVAL          'timerid' is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int pending;
+
+  if (timerid == NULL)
+    {
+      PTW32_SET_ERRNO (EINVAL);
+      return -1;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_wheel.lock, &node);
+  ptw32_timer_disarm (timerid);
+  pending = timerid->notifying;
+  timerid->deleted = PTW32_TRUE;
+  ptw32_mcs_lock_release (&node);
+
+  if (!pending)
+    {
+      ptw32_timer_free (timerid);
+    }
+
+  return 0;
+}				/* timer_delete */
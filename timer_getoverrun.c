@@ -0,0 +1,89 @@
+/*
+ * timer_getoverrun.c
+ *
+ * Description:
+ * This translation unit implements POSIX timer primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+timer_getoverrun (timer_t timerid)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Returns a timer's overrun count.
+      *
+      * PARAMETERS
+      *      timerid
+      *              a timer created by timer_create()
+      *
+      * DESCRIPTION
+      *      This function returns the number of expirations of
+      *      'timerid' that were not notified, between the one
+      *      whose notification is running (or ran last) and the
+      *      one before it. Expirations are missed when the timer
+      *      expires again while its notification is still queued
+      *      or running, or when the period is shorter than the
+      *      wheel's tick. The count is at most DELAYTIMER_MAX.
+      *
+      * RESULTS
+      *              >= 0            the overrun count,
+      *              -1              failed, error in errno:
+      *
+      *              EINVAL          'timerid' is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  int result;
+
+  if (timerid == NULL)
+    {
+      PTW32_SET_ERRNO (EINVAL);
+      return -1;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_wheel.lock, &node);
+  result = timerid->overrun;
+  ptw32_mcs_lock_release (&node);
+
+  return result;
+}				/* timer_getoverrun */
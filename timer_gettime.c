@@ -0,0 +1,87 @@
+/*
+ * timer_gettime.c
+ *
+ * Description:
+ * This translation unit implements POSIX timer primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+timer_gettime (timer_t timerid, struct itimerspec * value)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Reads a timer.
+      *
+      * PARAMETERS
+      *      timerid
+      *              a timer created by timer_create()
+      *
+      *      value
+      *              receives the time left and the period
+      *
+      * DESCRIPTION
+      *      This function stores the time until 'timerid' next
+      *      expires in value->it_value, zero if it is disarmed,
+      *      and its period in value->it_interval.
+      *
+      * RESULTS
+      *              0               successfully read,
+      *              -1              failed, error in errno:
+      *
+      *              EINVAL          an argument is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+
+  if (timerid == NULL || value == NULL)
+    {
+      PTW32_SET_ERRNO (EINVAL);
+      return -1;
+    }
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_wheel.lock, &node);
+  ptw32_timer_remaining (timerid, ptw32_clock_ns (CLOCK_MONOTONIC), value);
+  ptw32_mcs_lock_release (&node);
+
+  return 0;
+}				/* timer_gettime */
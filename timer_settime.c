@@ -0,0 +1,137 @@
+/*
+ * timer_settime.c
+ *
+ * Description:
+ * This translation unit implements POSIX timer primitives.
+ *
+ * --------------------------------------------------------------------------
+ *
+ *      Pthreads-win32 - POSIX Threads Library for Win32
+ *      Copyright(C) 1998 John E. Bossom
+ *      Copyright(C) 1999,2012 Pthreads-win32 contributors
+ *
+ *      Homepage1: http://sourceware.org/pthreads-win32/
+ *      Homepage2: http://sourceforge.net/projects/pthreads4w/
+ *
+ *      The current list of contributors is contained
+ *      in the file CONTRIBUTORS included with the source
+ *      code distribution. The list can also be seen at the
+ *      following World Wide Web location:
+ *      http://sources.redhat.com/pthreads-win32/contributors.html
+ * 
+ *      This library is free software; you can redistribute it and/or
+ *      modify it under the terms of the GNU Lesser General Public
+ *      License as published by the Free Software Foundation; either
+ *      version 2 of the License, or (at your option) any later version.
+ * 
+ *      This library is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *      Lesser General Public License for more details.
+ * 
+ *      You should have received a copy of the GNU Lesser General Public
+ *      License along with this library in the file COPYING.LIB;
+ *      if not, write to the Free Software Foundation, Inc.,
+ *      59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "pthread.h"
+#include "implement.h"
+
+
+int
+timer_settime (timer_t timerid, int flags,
+               const struct itimerspec * value, struct itimerspec * ovalue)
+     /*
+      * ------------------------------------------------------
+      * DOCPUBLIC
+      *      Arms or disarms a timer.
+      *
+      * PARAMETERS
+      *      timerid
+      *              a timer created by timer_create()
+      *
+      *      flags
+      *              0 or TIMER_ABSTIME
+      *
+      *      value
+      *              the first expiration and the period
+      *
+      *      ovalue
+      *              if not NULL, receives the time that was left
+      *
+      * DESCRIPTION
+      *      If value->it_value is zero this function disarms
+      *      'timerid'. Otherwise it arms it to expire first after
+      *      value->it_value, or at it if 'flags' is TIMER_ABSTIME,
+      *      and then every value->it_interval if that isn't zero.
+      *      Expirations happen no earlier than asked for, and in
+      *      practice within about a millisecond.
+      *
+      *      An absolute CLOCK_REALTIME time is converted to the
+      *      monotonic clock when the timer is armed, so the timer
+      *      doesn't follow later changes to the system time.
+      *
+      * RESULTS
+      *              0               successfully set,
+      *              -1              failed, error in errno:
+      *
+      *              EINVAL          an argument is invalid
+      *
+      * ------------------------------------------------------
+      */
+{
+  ptw32_mcs_local_node_t node;
+  LONGLONG now;
+  LONGLONG expires;
+
+  if (timerid == NULL || value == NULL
+      || value->it_value.tv_sec < 0
+      || value->it_value.tv_nsec < 0
+      || value->it_value.tv_nsec >= 1000000000
+      || value->it_interval.tv_sec < 0
+      || value->it_interval.tv_nsec < 0
+      || value->it_interval.tv_nsec >= 1000000000)
+    {
+      PTW32_SET_ERRNO (EINVAL);
+      return -1;
+    }
+
+  expires = ptw32_timespec_to_ns (&value->it_value);
+
+  ptw32_mcs_lock_acquire (&ptw32_timer_wheel.lock, &node);
+
+  now = ptw32_clock_ns (CLOCK_MONOTONIC);
+
+  if (ovalue != NULL)
+    {
+      ptw32_timer_remaining (timerid, now, ovalue);
+    }
+
+  ptw32_timer_disarm (timerid);
+  timerid->interval = ptw32_timespec_to_ns (&value->it_interval);
+  timerid->overrun = 0;
+
+  if (expires != 0)
+    {
+      if (!(flags & TIMER_ABSTIME))
+        {
+          expires += now;
+        }
+      else if (timerid->clock == CLOCK_REALTIME)
+        {
+          expires += now - ptw32_clock_ns (CLOCK_REALTIME);
+        }
+
+      timerid->expires = expires;
+      ptw32_timer_arm (timerid);
+    }
+
+  ptw32_mcs_lock_release (&node);
+
+  return 0;
+}				/* timer_settime */
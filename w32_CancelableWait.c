@@ -51,8 +51,9 @@ ptw32_cancelable_wait (HANDLE waitHandle, DWORD timeout)
       * mechanism that will allow you to wait on a Windows handle and make it a
       * cancellation point. This function blocks until the given WIN32 handle is
       * signaled or pthread_cancel has been called. It is implemented using
-      * WaitForMultipleObjects on 'waitHandle' and a manually reset WIN32
-      * event used to implement pthread_cancel.
+      * WaitForMultipleObjects on 'waitHandle' and the thread's park event,
+      * which pthread_cancel sets after raising the thread's cancel flag
+      * (see ptw32_park.c).
       * 
       * Given this hook it would be possible to implement more of the cancellation
       * points.
@@ -60,97 +61,114 @@ ptw32_cancelable_wait (HANDLE waitHandle, DWORD timeout)
       */
 {
   int result;
-  pthread_t self;
   ptw32_thread_t * sp;
   HANDLE handles[2];
   DWORD nHandles = 1;
   DWORD status;
+  LONGLONG deadline = 0;
 
   handles[0] = waitHandle;
 
-  self = pthread_self();
-  sp = (ptw32_thread_t *) self.p;
+  /*
+   * Without a park event the wait can't be cancelled.
+   */
+  sp = (ptw32_thread_t *) pthread_self ().p;
 
-  if (sp != NULL)
+  if (sp != NULL
+      && sp->cancelState == PTHREAD_CANCEL_ENABLE
+      && (sp->parkEvent != NULL || ptw32_lazy_event (&sp->parkEvent) != NULL))
     {
-      /*
-       * Get cancelEvent handle
-       */
-      if (sp->cancelState == PTHREAD_CANCEL_ENABLE)
-	{
-
-	  if ((handles[1] = sp->cancelEvent) != NULL)
-	    {
-	      nHandles++;
-	    }
-	}
+      handles[1] = sp->parkEvent;
+      nHandles++;
     }
-  else
+
+  if (timeout != INFINITE)
     {
-      handles[1] = NULL;
+      deadline = ptw32_clock_ns (CLOCK_MONOTONIC) + (LONGLONG) timeout * 1000000;
     }
 
-  status = WaitForMultipleObjects (nHandles, handles, PTW32_FALSE, timeout);
-
-  switch (status - WAIT_OBJECT_0)
+  for (;;)
     {
-    case 0:
       /*
-       * Got the handle.
-       * In the event that both handles are signalled, the smallest index
-       * value (us) is returned. As it has been arranged, this ensures that
-       * we don't drop a signal that we should act on (i.e. semaphore,
-       * mutex, or condition variable etc).
+       * A request made before the park event existed didn't set it, so
+       * look at the flag too; but let a signalled 'waitHandle' win, as
+       * it would if the event were set.
        */
-      result = 0;
-      break;
-
-    case 1:
-      /*
-       * Got cancel request.
-       * In the event that both handles are signaled, the cancel will
-       * be ignored (see case 0 comment).
-       */
-      ResetEvent (handles[1]);
+      if (nHandles > 1 && sp->cancelRequested)
+	{
+	  status = WaitForMultipleObjects (nHandles, handles, PTW32_FALSE, 0);
+	  if (status == WAIT_TIMEOUT)
+	    {
+	      status = WAIT_OBJECT_0 + 1;
+	    }
+	}
+      else
+	{
+	  status = WaitForMultipleObjects (nHandles, handles, PTW32_FALSE, timeout);
+	}
 
-      if (sp != NULL)
+      switch (status - WAIT_OBJECT_0)
 	{
-          ptw32_mcs_local_node_t stateLock;
+	case 0:
 	  /*
-	   * Should handle POSIX and implicit POSIX threads..
-	   * Make sure we haven't been async-canceled in the meantime.
+	   * Got the handle.
+	   * In the event that both handles are signalled, the smallest index
+	   * value (us) is returned. As it has been arranged, this ensures that
+	   * we don't drop a signal that we should act on (i.e. semaphore,
+	   * mutex, or condition variable etc).
 	   */
-	  ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
-	  if (sp->state < PThreadStateCanceling)
+	  return 0;
+
+	case 1:
+	  if (sp->cancelRequested)
 	    {
-	      sp->state = PThreadStateCanceling;
-	      sp->cancelState = PTHREAD_CANCEL_DISABLE;
+	      ptw32_mcs_local_node_t stateLock;
+	      /*
+	       * Got cancel request.
+	       * Should handle POSIX and implicit POSIX threads..
+	       * Make sure we haven't been async-canceled in the meantime.
+	       */
+	      ptw32_mcs_lock_acquire (&sp->stateLock, &stateLock);
+	      sp->cancelRequested = 0;
+	      if (sp->state < PThreadStateCanceling)
+		{
+		  sp->state = PThreadStateCanceling;
+		  sp->cancelState = PTHREAD_CANCEL_DISABLE;
+		  ptw32_mcs_lock_release (&stateLock);
+		  ptw32_throw (PTW32_EPS_CANCEL);
+
+		  /* Never reached */
+		}
 	      ptw32_mcs_lock_release (&stateLock);
-	      ptw32_throw (PTW32_EPS_CANCEL);
 
-	      /* Never reached */
+	      /* Should never get to here. */
+	      return EINVAL;
 	    }
-	  ptw32_mcs_lock_release (&stateLock);
-	}
 
-      /* Should never get to here. */
-      result = EINVAL;
-      break;
+	  /*
+	   * A stale unpark (see ptw32_park.c). Wait out the rest of the time.
+	   */
+	  if (timeout != INFINITE)
+	    {
+	      LONGLONG remaining = deadline - ptw32_clock_ns (CLOCK_MONOTONIC);
 
-    default:
-      if (status == WAIT_TIMEOUT)
-	{
-	  result = ETIMEDOUT;
-	}
-      else
-	{
-	  result = EINVAL;
+	      timeout = (remaining > 0) ? (DWORD) ((remaining + 999999) / 1000000) : 0;
+	    }
+	  break;
+
+	default:
+	  if (status == WAIT_TIMEOUT)
+	    {
+	      result = ETIMEDOUT;
+	    }
+	  else
+	    {
+	      result = EINVAL;
+	    }
+	  return (result);
 	}
-      break;
     }
 
-  return (result);
-
 }				/* CancelableWait */
 
 int